@@ -0,0 +1,489 @@
+//
+//  CUBenchmark.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a minimal micro-benchmark harness for the CUGL
+//  benchmark suite. It follows the design of Google Benchmark: each benchmark
+//  is a function that is called with a State object, and which runs the code
+//  under test once per iteration of the state. The harness picks the number
+//  of iterations so that each benchmark runs for a minimum amount of time.
+//
+//  We do not use Google Benchmark directly because CUGL vendors all of its
+//  dependencies, and this suite only needs a small fraction of that library.
+//  However, the JSON output of this harness matches that of Google Benchmark,
+//  so the same tools can be used to compare results between commits.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Author: Walker White
+//  Version: 7/3/24 (CUGL 3.0 reorganization)
+//
+#include "CUBenchmark.h"
+#include <cugl/core/assets/CUJsonValue.h>
+#include <cugl/core/math/CUMathBase.h>
+#include <cugl/core/util/CUStringTools.h>
+#include <SDL.h>
+#include <algorithm>
+#include <cstdio>
+#include <regex>
+
+using namespace cugl;
+using namespace cugl::bench;
+
+/** The largest number of iterations for a single run */
+#define MAX_ITERATIONS  1000000000
+/** The default minimum time for a single run in seconds */
+#define DEFAULT_MIN_TIME    0.5
+
+#pragma mark State
+/**
+ * Creates a state for the given number of iterations and argument.
+ *
+ * @param iterations    The number of iterations to run
+ * @param argument      The benchmark argument
+ */
+State::State(size_t iterations, long argument) :
+_iterations(iterations),
+_remaining(iterations),
+_argument(argument),
+_started(false),
+_running(false),
+_cpustart(0),
+_realtime(0),
+_cputime(0),
+_items(0),
+_bytes(0) {
+}
+
+/**
+ * Stops the timer.
+ *
+ * Use this method with {@link #resumeTiming} to exclude work inside of
+ * the benchmark loop. Both calls have a small overhead, so they should
+ * not be used for very short iterations.
+ */
+void State::pauseTiming() {
+    if (_running) {
+        Timestamp now;
+        std::clock_t cpu = std::clock();
+        _realtime += (double)Timestamp::ellapsedNanos(_start,now);
+        _cputime  += (double)(cpu-_cpustart)*1e9/CLOCKS_PER_SEC;
+        _running = false;
+    }
+}
+
+/**
+ * Restarts the timer.
+ *
+ * Use this method with {@link #pauseTiming} to exclude work inside of
+ * the benchmark loop. Both calls have a small overhead, so they should
+ * not be used for very short iterations.
+ */
+void State::resumeTiming() {
+    if (!_running) {
+        _running = true;
+        _cpustart = std::clock();
+        _start.mark();
+    }
+}
+
+#pragma mark -
+#pragma mark Benchmark
+/**
+ * Registers a benchmark with the given name, function and arguments.
+ *
+ * This method always returns true, so that it can be used to initialize
+ * a static variable.
+ *
+ * @param name  The benchmark name
+ * @param func  The benchmark function
+ * @param args  The arguments to run the benchmark with
+ *
+ * @return true
+ */
+bool Benchmark::add(const std::string name, const std::function<void(State&)>& func,
+                    const std::vector<long>& args) {
+    Benchmark bench;
+    bench.name = name;
+    bench.func = func;
+    bench.args = args;
+    registry().push_back(bench);
+    return true;
+}
+
+/**
+ * Returns the list of registered benchmarks
+ *
+ * @return the list of registered benchmarks
+ */
+std::vector<Benchmark>& Benchmark::registry() {
+    // Function local to avoid the static initialization order problem
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+#pragma mark -
+#pragma mark Output
+/**
+ * Returns the given time (in nanoseconds) as a string with units
+ *
+ * @param nanos The time in nanoseconds
+ *
+ * @return the given time (in nanoseconds) as a string with units
+ */
+static std::string format_time(double nanos) {
+    char buffer[32];
+    if (nanos < 1e4) {
+        std::snprintf(buffer, sizeof(buffer), "%.2f ns", nanos);
+    } else if (nanos < 1e7) {
+        std::snprintf(buffer, sizeof(buffer), "%.2f us", nanos/1e3);
+    } else {
+        std::snprintf(buffer, sizeof(buffer), "%.2f ms", nanos/1e6);
+    }
+    return buffer;
+}
+
+/**
+ * Returns the given rate (per second) as a string with SI prefixes
+ *
+ * @param rate  The rate per second
+ * @param unit  The unit of the rate
+ *
+ * @return the given rate (per second) as a string with SI prefixes
+ */
+static std::string format_rate(double rate, const char* unit) {
+    char buffer[32];
+    if (rate >= 1e9) {
+        std::snprintf(buffer, sizeof(buffer), "%.2fG %s/s", rate/1e9, unit);
+    } else if (rate >= 1e6) {
+        std::snprintf(buffer, sizeof(buffer), "%.2fM %s/s", rate/1e6, unit);
+    } else if (rate >= 1e3) {
+        std::snprintf(buffer, sizeof(buffer), "%.2fk %s/s", rate/1e3, unit);
+    } else {
+        std::snprintf(buffer, sizeof(buffer), "%.2f %s/s", rate, unit);
+    }
+    return buffer;
+}
+
+/**
+ * Returns the name of the SIMD instructions used by the math classes
+ *
+ * @return the name of the SIMD instructions used by the math classes
+ */
+static std::string simd_name() {
+#if defined CU_MATH_VECTOR_AVX2
+    return "avx2";
+#elif defined CU_MATH_VECTOR_SSE
+    return "sse";
+#elif defined CU_MATH_VECTOR_NEON64
+    return "neon";
+#else
+    return "none";
+#endif
+}
+
+/**
+ * Writes the results to the given file in a human readable format.
+ *
+ * @param results   The benchmark results
+ * @param file      The file to write to
+ */
+static void write_console(const std::vector<Runner::Result>& results, FILE* file) {
+    size_t width = 9;
+    for(auto it = results.begin(); it != results.end(); ++it) {
+        width = std::max(width,it->name.size());
+    }
+    std::string line(width+48,'-');
+    std::fprintf(file, "%s\n", line.c_str());
+    std::fprintf(file, "%-*s %15s %15s %12s\n", (int)width, "Benchmark", "Time", "CPU", "Iterations");
+    std::fprintf(file, "%s\n", line.c_str());
+    for(auto it = results.begin(); it != results.end(); ++it) {
+        if (!it->error.empty()) {
+            std::fprintf(file, "%-*s SKIPPED: %s\n", (int)width, it->name.c_str(), it->error.c_str());
+            continue;
+        }
+        std::fprintf(file, "%-*s %15s %15s %12zu", (int)width, it->name.c_str(),
+                     format_time(it->realtime).c_str(), format_time(it->cputime).c_str(),
+                     it->iterations);
+        if (it->bytes > 0) {
+            std::fprintf(file, " %s", format_rate(it->bytes,"B").c_str());
+        }
+        if (it->items > 0) {
+            std::fprintf(file, " %s", format_rate(it->items,"items").c_str());
+        }
+        if (!it->label.empty()) {
+            std::fprintf(file, " %s", it->label.c_str());
+        }
+        std::fprintf(file, "\n");
+    }
+}
+
+/**
+ * Writes the results to the given file in the Google Benchmark JSON format.
+ *
+ * @param results   The benchmark results
+ * @param exec      The name of the executable
+ * @param file      The file to write to
+ */
+static void write_json(const std::vector<Runner::Result>& results, const std::string exec, FILE* file) {
+    std::shared_ptr<JsonValue> root = JsonValue::allocObject();
+
+    char date[64];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", std::localtime(&now));
+
+    std::shared_ptr<JsonValue> context = JsonValue::allocObject();
+    context->appendValue("date", std::string(date));
+    context->appendValue("executable", exec);
+    context->appendValue("num_cpus", (long)SDL_GetCPUCount());
+    context->appendValue("platform", std::string(SDL_GetPlatform()));
+    context->appendValue("simd", simd_name());
+#if defined (NDEBUG)
+    context->appendValue("library_build_type", std::string("release"));
+#else
+    context->appendValue("library_build_type", std::string("debug"));
+#endif
+    root->appendChild("context", context);
+
+    std::shared_ptr<JsonValue> benchmarks = JsonValue::allocArray();
+    for(auto it = results.begin(); it != results.end(); ++it) {
+        std::shared_ptr<JsonValue> entry = JsonValue::allocObject();
+        entry->appendValue("name", it->name);
+        entry->appendValue("run_name", it->name);
+        entry->appendValue("run_type", std::string("iteration"));
+        if (!it->error.empty()) {
+            entry->appendValue("error_occurred", true);
+            entry->appendValue("error_message", it->error);
+            benchmarks->appendChild(entry);
+            continue;
+        }
+        entry->appendValue("iterations", (long)it->iterations);
+        entry->appendValue("real_time", it->realtime);
+        entry->appendValue("cpu_time", it->cputime);
+        entry->appendValue("time_unit", std::string("ns"));
+        if (it->bytes > 0) {
+            entry->appendValue("bytes_per_second", it->bytes);
+        }
+        if (it->items > 0) {
+            entry->appendValue("items_per_second", it->items);
+        }
+        if (!it->label.empty()) {
+            entry->appendValue("label", it->label);
+        }
+        benchmarks->appendChild(entry);
+    }
+    root->appendChild("benchmarks", benchmarks);
+
+    std::string text = root->toString(true);
+    std::fprintf(file, "%s\n", text.c_str());
+}
+
+/**
+ * Writes the results to the given file in the Google Benchmark CSV format.
+ *
+ * @param results   The benchmark results
+ * @param file      The file to write to
+ */
+static void write_csv(const std::vector<Runner::Result>& results, FILE* file) {
+    std::fprintf(file, "name,iterations,real_time,cpu_time,time_unit,bytes_per_second,"
+                       "items_per_second,label,error_occurred,error_message\n");
+    for(auto it = results.begin(); it != results.end(); ++it) {
+        if (!it->error.empty()) {
+            std::fprintf(file, "\"%s\",,,,,,,,true,\"%s\"\n", it->name.c_str(), it->error.c_str());
+            continue;
+        }
+        std::fprintf(file, "\"%s\",%zu,%g,%g,ns,", it->name.c_str(), it->iterations,
+                     it->realtime, it->cputime);
+        if (it->bytes > 0) {
+            std::fprintf(file, "%g", it->bytes);
+        }
+        std::fprintf(file, ",");
+        if (it->items > 0) {
+            std::fprintf(file, "%g", it->items);
+        }
+        std::fprintf(file, ",\"%s\",,\n", it->label.c_str());
+    }
+}
+
+#pragma mark -
+#pragma mark Runner
+/**
+ * Returns the result of running the benchmark with the given argument.
+ *
+ * The benchmark is run with an increasing number of iterations until
+ * it takes at least the minimum time.
+ *
+ * @param bench     The benchmark to run
+ * @param name      The name to report
+ * @param argument  The benchmark argument
+ * @param mintime   The minimum time to run in seconds
+ *
+ * @return the result of running the benchmark with the given argument.
+ */
+Runner::Result Runner::run(const Benchmark& bench, const std::string name,
+                           long argument, double mintime) {
+    Result result;
+    result.name = name;
+    result.iterations = 0;
+    result.realtime = 0;
+    result.cputime = 0;
+    result.items = 0;
+    result.bytes = 0;
+
+    size_t iterations = 1;
+    double target = mintime*1e9;
+    while (true) {
+        State state(iterations,argument);
+        bench.func(state);
+        if (!state._error.empty()) {
+            result.error = state._error;
+            return result;
+        }
+
+        // Same growth policy as Google Benchmark
+        double elapsed = state._realtime;
+        if (elapsed >= target || iterations >= MAX_ITERATIONS) {
+            result.iterations = iterations;
+            result.realtime = elapsed/iterations;
+            result.cputime  = state._cputime/iterations;
+            if (elapsed > 0) {
+                result.items = state._items*1e9/elapsed;
+                result.bytes = state._bytes*1e9/elapsed;
+            }
+            result.label = state._label;
+            return result;
+        }
+
+        double multiplier = 10;
+        if (elapsed > target/10) {
+            multiplier = target*1.4/elapsed;
+        }
+        size_t next = (size_t)(iterations*multiplier);
+        iterations = std::min((size_t)MAX_ITERATIONS,std::max(next,iterations+1));
+    }
+}
+
+/**
+ * Runs the benchmarks specified by the command line arguments.
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ *
+ * @return the process exit code
+ */
+int Runner::main(int argc, char** argv) {
+    std::string filter = ".*";
+    std::string format = "console";
+    std::string output;
+    double mintime = DEFAULT_MIN_TIME;
+    bool listonly = false;
+    for(int ii = 1; ii < argc; ii++) {
+        std::string arg = argv[ii];
+        size_t pos = arg.find('=');
+        std::string key = arg.substr(0,pos);
+        std::string value = pos == std::string::npos ? "" : arg.substr(pos+1);
+        if (key == "--filter" || key == "--benchmark_filter") {
+            filter = value;
+        } else if (key == "--format" || key == "--benchmark_format") {
+            format = value;
+        } else if (key == "--min-time" || key == "--benchmark_min_time") {
+            mintime = strtool::stof(value);
+        } else if (key == "--out" || key == "--benchmark_out") {
+            output = value;
+        } else if (key == "--list" || key == "--benchmark_list_tests") {
+            listonly = true;
+        } else {
+            std::fprintf(stderr, "Usage: %s [--filter=<regex>] [--format=console|json|csv] "
+                                 "[--min-time=<seconds>] [--out=<file>] [--list]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (format != "console" && format != "json" && format != "csv") {
+        std::fprintf(stderr, "Unknown format '%s'\n", format.c_str());
+        return 1;
+    }
+
+    std::regex pattern;
+    try {
+        pattern = std::regex(filter);
+    } catch (const std::regex_error&) {
+        std::fprintf(stderr, "Invalid filter '%s'\n", filter.c_str());
+        return 1;
+    }
+
+    // Expand the arguments
+    std::vector<std::pair<const Benchmark*,long>> jobs;
+    std::vector<std::string> names;
+    for(const Benchmark& bench : Benchmark::registry()) {
+        if (bench.args.empty()) {
+            if (std::regex_search(bench.name,pattern)) {
+                jobs.push_back(std::make_pair(&bench,0L));
+                names.push_back(bench.name);
+            }
+        } else {
+            for(long arg : bench.args) {
+                std::string name = bench.name+"/"+std::to_string(arg);
+                if (std::regex_search(name,pattern)) {
+                    jobs.push_back(std::make_pair(&bench,arg));
+                    names.push_back(name);
+                }
+            }
+        }
+    }
+
+    if (listonly) {
+        for(auto it = names.begin(); it != names.end(); ++it) {
+            std::printf("%s\n", it->c_str());
+        }
+        return 0;
+    }
+
+    std::vector<Result> results;
+    for(size_t ii = 0; ii < jobs.size(); ii++) {
+        // Show progress on the terminal, as the full suite takes a while
+        std::fprintf(stderr, "\r[%zu/%zu] %s", ii+1, jobs.size(), names[ii].c_str());
+        std::fflush(stderr);
+        results.push_back(run(*(jobs[ii].first),names[ii],jobs[ii].second,mintime));
+        std::fprintf(stderr, "\r%*s\r", (int)(names[ii].size()+32), "");
+    }
+
+    FILE* file = stdout;
+    if (!output.empty()) {
+        file = std::fopen(output.c_str(),"w");
+        if (file == nullptr) {
+            std::fprintf(stderr, "Could not open '%s'\n", output.c_str());
+            return 1;
+        }
+    }
+
+    if (format == "json") {
+        write_json(results, argv[0], file);
+    } else if (format == "csv") {
+        write_csv(results, file);
+    } else {
+        write_console(results, file);
+    }
+
+    if (file != stdout) {
+        std::fclose(file);
+    }
+    return 0;
+}
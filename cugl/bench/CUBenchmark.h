@@ -0,0 +1,357 @@
+//
+//  CUBenchmark.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a minimal micro-benchmark harness for the CUGL
+//  benchmark suite. It follows the design of Google Benchmark: each benchmark
+//  is a function that is called with a State object, and which runs the code
+//  under test once per iteration of the state. The harness picks the number
+//  of iterations so that each benchmark runs for a minimum amount of time.
+//
+//  We do not use Google Benchmark directly because CUGL vendors all of its
+//  dependencies, and this suite only needs a small fraction of that library.
+//  However, the JSON output of this harness matches that of Google Benchmark,
+//  so the same tools can be used to compare results between commits.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Author: Walker White
+//  Version: 7/3/24 (CUGL 3.0 reorganization)
+//
+#ifndef __CU_BENCHMARK_H__
+#define __CU_BENCHMARK_H__
+#include <cugl/core/CUBase.h>
+#include <cugl/core/util/CUTimestamp.h>
+#include <functional>
+#include <string>
+#include <vector>
+#include <ctime>
+
+namespace cugl {
+
+    /**
+     * The classes for the CUGL benchmark suite.
+     *
+     * These classes are not part of the CUGL library. They are only built
+     * as part of the cugl_bench target.
+     */
+    namespace bench {
+
+/**
+ * This class is the state of a single benchmark run.
+ *
+ * A benchmark function should perform any setup first, and then loop on
+ * {@link #keepRunning}, executing the code under test once per iteration.
+ * Only the time spent inside of this loop is measured. Work inside the loop
+ * that should not be measured can be excluded with {@link #pauseTiming}
+ * and {@link #resumeTiming}.
+ *
+ * A benchmark may also report the number of items or bytes processed. In
+ * that case, the output includes the throughput of the benchmark.
+ */
+class State {
+private:
+    /** The number of iterations for this run */
+    size_t _iterations;
+    /** The number of iterations remaining */
+    size_t _remaining;
+    /** The argument of this run (0 if there is none) */
+    long _argument;
+    /** Whether the loop has started */
+    bool _started;
+    /** Whether the timer is active */
+    bool _running;
+    /** The start of the current timing interval */
+    Timestamp _start;
+    /** The processor time at the start of the current timing interval */
+    std::clock_t _cpustart;
+    /** The accumulated time in nanoseconds */
+    double _realtime;
+    /** The accumulated processor time in nanoseconds */
+    double _cputime;
+    /** The number of items processed */
+    Uint64 _items;
+    /** The number of bytes processed */
+    Uint64 _bytes;
+    /** An optional label for the output */
+    std::string _label;
+    /** The error message, if the benchmark was skipped */
+    std::string _error;
+
+public:
+    /**
+     * Creates a state for the given number of iterations and argument.
+     *
+     * @param iterations    The number of iterations to run
+     * @param argument      The benchmark argument
+     */
+    State(size_t iterations, long argument);
+
+    /**
+     * Returns true if the benchmark should run another iteration.
+     *
+     * The timer starts on the first call to this method, and stops once
+     * it returns false.
+     *
+     * @return true if the benchmark should run another iteration.
+     */
+    bool keepRunning() {
+        if (_remaining > 0) {
+            if (!_started) {
+                _started = true;
+                resumeTiming();
+            }
+            _remaining--;
+            return true;
+        }
+        if (_running) {
+            pauseTiming();
+        }
+        return false;
+    }
+
+    /**
+     * Returns the number of iterations for this run
+     *
+     * @return the number of iterations for this run
+     */
+    size_t iterations() const { return _iterations; }
+
+    /**
+     * Returns the argument for this run
+     *
+     * Arguments are used to run the same benchmark at different sizes. If
+     * the benchmark was registered without arguments, this value is 0.
+     *
+     * @return the argument for this run
+     */
+    long range() const { return _argument; }
+
+    /**
+     * Stops the timer.
+     *
+     * Use this method with {@link #resumeTiming} to exclude work inside of
+     * the benchmark loop. Both calls have a small overhead, so they should
+     * not be used for very short iterations.
+     */
+    void pauseTiming();
+
+    /**
+     * Restarts the timer.
+     *
+     * Use this method with {@link #pauseTiming} to exclude work inside of
+     * the benchmark loop. Both calls have a small overhead, so they should
+     * not be used for very short iterations.
+     */
+    void resumeTiming();
+
+    /**
+     * Sets the total number of items processed by this run.
+     *
+     * If set, the output includes the items processed per second.
+     *
+     * @param items The total number of items processed
+     */
+    void setItemsProcessed(Uint64 items) { _items = items; }
+
+    /**
+     * Sets the total number of bytes processed by this run.
+     *
+     * If set, the output includes the bytes processed per second.
+     *
+     * @param bytes The total number of bytes processed
+     */
+    void setBytesProcessed(Uint64 bytes) { _bytes = bytes; }
+
+    /**
+     * Sets the label for this run.
+     *
+     * The label is included in the output, and is useful for reporting
+     * extra information (such as the size of a generated data set).
+     *
+     * @param label The label for this run
+     */
+    void setLabel(const std::string label) { _label = label; }
+
+    /**
+     * Marks this benchmark as skipped with the given message.
+     *
+     * The benchmark should return immediately after calling this method.
+     * This is for benchmarks that cannot run in the current environment.
+     *
+     * @param message   The reason the benchmark was skipped
+     */
+    void skipWithError(const std::string message) {
+        _error = message;
+        _remaining = 0;
+    }
+
+    /** Allow the runner to access the measurements */
+    friend class Runner;
+};
+
+/**
+ * Prevents the compiler from optimizing away the given value.
+ *
+ * The result of any computation under test should be passed to this
+ * function. Otherwise the compiler may eliminate the computation entirely.
+ *
+ * @param value The value to preserve
+ */
+template <typename T>
+inline void doNotOptimize(T const& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static const void* volatile sink;
+    sink = &value;
+#endif
+}
+
+/**
+ * This class is a registered benchmark.
+ *
+ * Benchmarks are registered at static initialization time with the macro
+ * CU_BENCHMARK (or CU_BENCHMARK_ARGS for benchmarks that take a size
+ * argument). Each argument is run (and reported) as a separate benchmark.
+ */
+class Benchmark {
+public:
+    /** The benchmark name */
+    std::string name;
+    /** The benchmark function */
+    std::function<void(State&)> func;
+    /** The arguments to run the benchmark with (empty if none) */
+    std::vector<long> args;
+
+    /**
+     * Registers a benchmark with the given name, function and arguments.
+     *
+     * This method always returns true, so that it can be used to initialize
+     * a static variable.
+     *
+     * @param name  The benchmark name
+     * @param func  The benchmark function
+     * @param args  The arguments to run the benchmark with
+     *
+     * @return true
+     */
+    static bool add(const std::string name, const std::function<void(State&)>& func,
+                    const std::vector<long>& args = {});
+
+    /**
+     * Returns the list of registered benchmarks
+     *
+     * @return the list of registered benchmarks
+     */
+    static std::vector<Benchmark>& registry();
+};
+
+/**
+ * This class runs the registered benchmarks and reports the results.
+ *
+ * The runner supports a subset of the Google Benchmark command line:
+ *
+ *      --filter=<regex>    Only run benchmarks whose name matches the regex
+ *      --format=<format>   The output format (console, json, or csv)
+ *      --min-time=<secs>   The minimum time to run each benchmark
+ *      --out=<file>        Write the results to a file instead of stdout
+ *      --list              List the benchmarks without running them
+ *
+ * The JSON output has the same layout as Google Benchmark, so it can be
+ * compared between commits with the Google Benchmark tools.
+ */
+class Runner {
+public:
+    /** A single benchmark measurement */
+    struct Result {
+        /** The benchmark name (with the argument, if any) */
+        std::string name;
+        /** The number of iterations run */
+        size_t iterations;
+        /** The wall clock time per iteration in nanoseconds */
+        double realtime;
+        /** The processor time per iteration in nanoseconds */
+        double cputime;
+        /** The items processed per second (0 if not set) */
+        double items;
+        /** The bytes processed per second (0 if not set) */
+        double bytes;
+        /** The label of the benchmark run */
+        std::string label;
+        /** The error message, if the benchmark was skipped */
+        std::string error;
+    };
+
+    /**
+     * Runs the benchmarks specified by the command line arguments.
+     *
+     * @param argc  The number of command line arguments
+     * @param argv  The command line arguments
+     *
+     * @return the process exit code
+     */
+    static int main(int argc, char** argv);
+
+    /**
+     * Returns the result of running the benchmark with the given argument.
+     *
+     * The benchmark is run with an increasing number of iterations until
+     * it takes at least the minimum time.
+     *
+     * @param bench     The benchmark to run
+     * @param name      The name to report
+     * @param argument  The benchmark argument
+     * @param mintime   The minimum time to run in seconds
+     *
+     * @return the result of running the benchmark with the given argument.
+     */
+    static Result run(const Benchmark& bench, const std::string name,
+                      long argument, double mintime);
+};
+
+    }
+}
+
+/** Concatenates two tokens after expanding them */
+#define CU_BENCH_CONCAT_IMPL(a,b) a##b
+/** Concatenates two tokens after expanding them */
+#define CU_BENCH_CONCAT(a,b) CU_BENCH_CONCAT_IMPL(a,b)
+
+/**
+ * Registers the given benchmark function.
+ *
+ * The function must have the signature void(cugl::bench::State&).
+ */
+#define CU_BENCHMARK(func) \
+    [[maybe_unused]] static const bool CU_BENCH_CONCAT(_cu_bench_,__LINE__) = \
+        cugl::bench::Benchmark::add(#func,func)
+
+/**
+ * Registers the given benchmark function with a list of arguments.
+ *
+ * The function must have the signature void(cugl::bench::State&). It is run
+ * once for each argument, which is available via State#range().
+ */
+#define CU_BENCHMARK_ARGS(func,...) \
+    [[maybe_unused]] static const bool CU_BENCH_CONCAT(_cu_bench_,__LINE__) = \
+        cugl::bench::Benchmark::add(#func,func,{__VA_ARGS__})
+
+#endif /* __CU_BENCHMARK_H__ */
@@ -0,0 +1,218 @@
+//
+//  CUJsonBench.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides the benchmarks for JSON processing. Scene layouts
+//  and asset directories are JSON, and so parsing speed is a large part of
+//  the load time of most games. The benchmarks compare parsing text in
+//  memory, loading a text file, and loading the equivalent binary (CBOR)
+//  file written by BinaryWriter.
+//
+//  The documents are generated with a structure similar to a scene graph
+//  layout: an array of nodes, each with a mix of strings, numbers, and
+//  nested objects.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Author: Walker White
+//  Version: 7/3/24 (CUGL 3.0 reorganization)
+//
+#include "CUBenchmark.h"
+#include <cugl/core/assets/CUJsonValue.h>
+#include <cugl/core/io/CUJsonReader.h>
+#include <cugl/core/io/CUJsonWriter.h>
+#include <cugl/core/io/CUBinaryWriter.h>
+#include <filesystem>
+
+using namespace cugl;
+using namespace cugl::bench;
+
+#pragma mark Data Generation
+/**
+ * Returns a JSON document with the given number of scene nodes
+ *
+ * @param size  The number of scene nodes
+ *
+ * @return a JSON document with the given number of scene nodes
+ */
+static std::shared_ptr<JsonValue> make_document(size_t size) {
+    std::shared_ptr<JsonValue> root = JsonValue::allocObject();
+    root->appendValue("version", 3L);
+    std::shared_ptr<JsonValue> nodes = JsonValue::allocArray();
+    for(size_t ii = 0; ii < size; ii++) {
+        std::shared_ptr<JsonValue> node = JsonValue::allocObject();
+        node->appendValue("name", "node"+std::to_string(ii));
+        node->appendValue("type", std::string(ii % 3 == 0 ? "Image" : "Node"));
+        node->appendValue("visible", ii % 7 != 0);
+
+        std::shared_ptr<JsonValue> data = JsonValue::allocObject();
+        std::shared_ptr<JsonValue> position = JsonValue::allocArray();
+        position->appendValue((double)(ii % 640)+0.5);
+        position->appendValue((double)(ii / 640)*1.25);
+        data->appendChild("position", position);
+        data->appendValue("angle", (double)(ii % 360)*0.0174533);
+        data->appendValue("priority", (long)(ii % 16));
+        data->appendValue("texture", "texture"+std::to_string(ii % 64));
+        node->appendChild("data", data);
+        nodes->appendChild(node);
+    }
+    root->appendChild("nodes", nodes);
+    return root;
+}
+
+/**
+ * Returns the path to a temporary file for the given benchmark data
+ *
+ * @param name  The file name
+ *
+ * @return the path to a temporary file for the given benchmark data
+ */
+static std::string temp_file(const std::string name) {
+    return (std::filesystem::temp_directory_path() / ("cugl_bench_"+name)).string();
+}
+
+/**
+ * Returns the size of the given file in bytes
+ *
+ * @param path  The file path
+ *
+ * @return the size of the given file in bytes
+ */
+static Uint64 file_size(const std::string path) {
+    std::error_code error;
+    auto size = std::filesystem::file_size(path,error);
+    return error ? 0 : (Uint64)size;
+}
+
+#pragma mark -
+#pragma mark Text
+/**
+ * Parses a JSON string in memory
+ *
+ * @param state The benchmark state
+ */
+static void BM_JsonParse(State& state) {
+    std::string text = make_document((size_t)state.range())->toString(false);
+    while (state.keepRunning()) {
+        std::shared_ptr<JsonValue> json = JsonValue::allocWithJson(text);
+        doNotOptimize(json.get());
+    }
+    state.setBytesProcessed(state.iterations()*text.size());
+}
+CU_BENCHMARK_ARGS(BM_JsonParse, 10, 1000, 10000);
+
+/**
+ * Converts a JSON value to a string
+ *
+ * @param state The benchmark state
+ */
+static void BM_JsonPrint(State& state) {
+    std::shared_ptr<JsonValue> json = make_document((size_t)state.range());
+    size_t bytes = 0;
+    while (state.keepRunning()) {
+        std::string text = json->toString(false);
+        bytes += text.size();
+        doNotOptimize(text.data());
+    }
+    state.setBytesProcessed(bytes);
+}
+CU_BENCHMARK_ARGS(BM_JsonPrint, 10, 1000, 10000);
+
+/**
+ * Loads a JSON text file with JsonReader
+ *
+ * @param state The benchmark state
+ */
+static void BM_JsonLoadText(State& state) {
+    std::string path = temp_file("text_"+std::to_string(state.range())+".json");
+    std::shared_ptr<JsonWriter> writer = JsonWriter::alloc(path);
+    if (writer == nullptr) {
+        state.skipWithError("Could not write "+path);
+        return;
+    }
+    writer->writeJson(make_document((size_t)state.range()),false);
+    writer->close();
+
+    while (state.keepRunning()) {
+        std::shared_ptr<JsonReader> reader = JsonReader::alloc(path);
+        std::shared_ptr<JsonValue> json = reader->readJson();
+        doNotOptimize(json.get());
+    }
+    state.setBytesProcessed(state.iterations()*file_size(path));
+    std::filesystem::remove(path);
+}
+CU_BENCHMARK_ARGS(BM_JsonLoadText, 10, 1000, 10000);
+
+#pragma mark -
+#pragma mark Binary
+/**
+ * Loads a binary JSON file with JsonReader
+ *
+ * This is the same document as BM_JsonLoadText, and so the two benchmarks
+ * can be compared directly. The bytes processed is the size of the text
+ * file, to make the throughput comparable.
+ *
+ * @param state The benchmark state
+ */
+static void BM_JsonLoadBinary(State& state) {
+    std::shared_ptr<JsonValue> json = make_document((size_t)state.range());
+    std::string path = temp_file("binary_"+std::to_string(state.range())+".json");
+    std::shared_ptr<BinaryWriter> writer = BinaryWriter::alloc(path);
+    if (writer == nullptr) {
+        state.skipWithError("Could not write "+path);
+        return;
+    }
+    writer->writeJson(json);
+    writer->close();
+
+    Uint64 text = json->toString(false).size();
+    Uint64 binary = file_size(path);
+    while (state.keepRunning()) {
+        std::shared_ptr<JsonReader> reader = JsonReader::alloc(path);
+        std::shared_ptr<JsonValue> result = reader->readJson();
+        doNotOptimize(result.get());
+    }
+    state.setBytesProcessed(state.iterations()*text);
+    state.setLabel("binary is "+std::to_string(binary*100/std::max(text,(Uint64)1))+"% of text");
+    std::filesystem::remove(path);
+}
+CU_BENCHMARK_ARGS(BM_JsonLoadBinary, 10, 1000, 10000);
+
+/**
+ * Writes a binary JSON file with BinaryWriter
+ *
+ * @param state The benchmark state
+ */
+static void BM_JsonWriteBinary(State& state) {
+    std::shared_ptr<JsonValue> json = make_document((size_t)state.range());
+    std::string path = temp_file("write_"+std::to_string(state.range())+".json");
+    while (state.keepRunning()) {
+        std::shared_ptr<BinaryWriter> writer = BinaryWriter::alloc(path);
+        if (writer == nullptr) {
+            state.skipWithError("Could not write "+path);
+            return;
+        }
+        writer->writeJson(json);
+        writer->close();
+    }
+    state.setBytesProcessed(state.iterations()*file_size(path));
+    std::filesystem::remove(path);
+}
+CU_BENCHMARK_ARGS(BM_JsonWriteBinary, 10, 1000, 10000);
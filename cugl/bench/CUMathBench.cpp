@@ -0,0 +1,405 @@
+//
+//  CUMathBench.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides the benchmarks for the math classes. These are the
+//  operations that dominate the CPU side of rendering: vector arithmetic,
+//  matrix products and inverses, and transforming large vertex arrays. Most
+//  benchmarks operate on a batch of values so that the loop overhead is
+//  negligible, and report the number of values processed per second.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Author: Walker White
+//  Version: 7/3/24 (CUGL 3.0 reorganization)
+//
+#include "CUBenchmark.h"
+#include <cugl/core/math/CUVec2.h>
+#include <cugl/core/math/CUVec3.h>
+#include <cugl/core/math/CUVec4.h>
+#include <cugl/core/math/CUMat4.h>
+#include <cugl/core/math/CUAffine2.h>
+#include <cugl/core/math/CUQuaternion.h>
+#include <random>
+
+using namespace cugl;
+using namespace cugl::bench;
+
+/** The number of values in a batch */
+#define BATCH_SIZE  1024
+
+#pragma mark Data Generation
+/**
+ * Returns a random number generator with a fixed seed
+ *
+ * @return a random number generator with a fixed seed
+ */
+static std::mt19937& generator() {
+    static std::mt19937 gen(5416);
+    return gen;
+}
+
+/**
+ * Returns a random float in the range [-1,1]
+ *
+ * @return a random float in the range [-1,1]
+ */
+static float random_float() {
+    static std::uniform_real_distribution<float> dist(-1.0f,1.0f);
+    return dist(generator());
+}
+
+/**
+ * Returns a random (and almost certainly invertible) matrix
+ *
+ * @return a random matrix
+ */
+static Mat4 random_mat4() {
+    Mat4 result;
+    for(int ii = 0; ii < 16; ii++) {
+        result.m[ii] = random_float();
+    }
+    return result;
+}
+
+/**
+ * Returns a random (and almost certainly invertible) affine transform
+ *
+ * @return a random affine transform
+ */
+static Affine2 random_affine() {
+    return Affine2(random_float(),random_float(),random_float(),
+                   random_float(),random_float(),random_float());
+}
+
+/**
+ * Returns a random unit quaternion
+ *
+ * @return a random unit quaternion
+ */
+static Quaternion random_quaternion() {
+    Quaternion result(random_float(),random_float(),random_float(),random_float());
+    return result.normalize();
+}
+
+#pragma mark -
+#pragma mark Vectors
+/**
+ * Normalizes a batch of Vec2 values
+ *
+ * @param state The benchmark state
+ */
+static void BM_Vec2Normalize(State& state) {
+    std::vector<Vec2> data(BATCH_SIZE);
+    for(auto it = data.begin(); it != data.end(); ++it) {
+        it->set(random_float(),random_float());
+    }
+    while (state.keepRunning()) {
+        for(size_t ii = 0; ii < BATCH_SIZE; ii++) {
+            Vec2 v = data[ii];
+            doNotOptimize(v.normalize());
+        }
+    }
+    state.setItemsProcessed(state.iterations()*BATCH_SIZE);
+}
+CU_BENCHMARK(BM_Vec2Normalize);
+
+/**
+ * Computes the cross products of a batch of Vec3 values
+ *
+ * @param state The benchmark state
+ */
+static void BM_Vec3Cross(State& state) {
+    std::vector<Vec3> data(BATCH_SIZE+1);
+    for(auto it = data.begin(); it != data.end(); ++it) {
+        it->set(random_float(),random_float(),random_float());
+    }
+    while (state.keepRunning()) {
+        for(size_t ii = 0; ii < BATCH_SIZE; ii++) {
+            doNotOptimize(data[ii].getCross(data[ii+1]));
+        }
+    }
+    state.setItemsProcessed(state.iterations()*BATCH_SIZE);
+}
+CU_BENCHMARK(BM_Vec3Cross);
+
+/**
+ * Accumulates a batch of Vec4 values
+ *
+ * @param state The benchmark state
+ */
+static void BM_Vec4Add(State& state) {
+    std::vector<Vec4> data(BATCH_SIZE);
+    for(auto it = data.begin(); it != data.end(); ++it) {
+        it->set(random_float(),random_float(),random_float(),random_float());
+    }
+    while (state.keepRunning()) {
+        Vec4 sum;
+        for(size_t ii = 0; ii < BATCH_SIZE; ii++) {
+            sum.add(data[ii]);
+        }
+        doNotOptimize(sum);
+    }
+    state.setItemsProcessed(state.iterations()*BATCH_SIZE);
+}
+CU_BENCHMARK(BM_Vec4Add);
+
+#pragma mark -
+#pragma mark Mat4
+/**
+ * Multiplies a batch of 4x4 matrices
+ *
+ * @param state The benchmark state
+ */
+static void BM_Mat4Multiply(State& state) {
+    std::vector<Mat4> data(BATCH_SIZE+1);
+    for(auto it = data.begin(); it != data.end(); ++it) {
+        *it = random_mat4();
+    }
+    Mat4 result;
+    while (state.keepRunning()) {
+        for(size_t ii = 0; ii < BATCH_SIZE; ii++) {
+            Mat4::multiply(data[ii],data[ii+1],&result);
+            doNotOptimize(result);
+        }
+    }
+    state.setItemsProcessed(state.iterations()*BATCH_SIZE);
+}
+CU_BENCHMARK(BM_Mat4Multiply);
+
+/**
+ * Inverts a batch of 4x4 matrices
+ *
+ * @param state The benchmark state
+ */
+static void BM_Mat4Invert(State& state) {
+    std::vector<Mat4> data(BATCH_SIZE);
+    for(auto it = data.begin(); it != data.end(); ++it) {
+        *it = random_mat4();
+    }
+    Mat4 result;
+    while (state.keepRunning()) {
+        for(size_t ii = 0; ii < BATCH_SIZE; ii++) {
+            Mat4::invert(data[ii],&result);
+            doNotOptimize(result);
+        }
+    }
+    state.setItemsProcessed(state.iterations()*BATCH_SIZE);
+}
+CU_BENCHMARK(BM_Mat4Invert);
+
+/**
+ * Transforms an array of Vec4 values (as floats) by a 4x4 matrix
+ *
+ * @param state The benchmark state
+ */
+static void BM_Mat4TransformArray(State& state) {
+    size_t size = (size_t)state.range();
+    std::vector<float> input(4*size);
+    std::vector<float> output(4*size);
+    for(auto it = input.begin(); it != input.end(); ++it) {
+        *it = random_float();
+    }
+    Mat4 matrix = random_mat4();
+    while (state.keepRunning()) {
+        Mat4::transform(matrix,input.data(),output.data(),size);
+        doNotOptimize(output.data());
+    }
+    state.setItemsProcessed(state.iterations()*size);
+}
+CU_BENCHMARK_ARGS(BM_Mat4TransformArray, 64, 1024, 16384);
+
+/**
+ * Projects an array of Vec3 points by a 4x4 matrix
+ *
+ * @param state The benchmark state
+ */
+static void BM_Mat4TransformPoints(State& state) {
+    size_t size = (size_t)state.range();
+    std::vector<Vec3> input(size);
+    std::vector<Vec4> output(size);
+    for(auto it = input.begin(); it != input.end(); ++it) {
+        it->set(random_float(),random_float(),random_float());
+    }
+    Mat4 matrix = random_mat4();
+    while (state.keepRunning()) {
+        Mat4::transform(matrix,input.data(),output.data(),size);
+        doNotOptimize(output.data());
+    }
+    state.setItemsProcessed(state.iterations()*size);
+}
+CU_BENCHMARK_ARGS(BM_Mat4TransformPoints, 64, 1024, 16384);
+
+#pragma mark -
+#pragma mark Affine2
+/**
+ * Multiplies a batch of affine transforms
+ *
+ * @param state The benchmark state
+ */
+static void BM_Affine2Multiply(State& state) {
+    std::vector<Affine2> data(BATCH_SIZE+1);
+    for(auto it = data.begin(); it != data.end(); ++it) {
+        *it = random_affine();
+    }
+    Affine2 result;
+    while (state.keepRunning()) {
+        for(size_t ii = 0; ii < BATCH_SIZE; ii++) {
+            Affine2::multiply(data[ii],data[ii+1],&result);
+            doNotOptimize(result);
+        }
+    }
+    state.setItemsProcessed(state.iterations()*BATCH_SIZE);
+}
+CU_BENCHMARK(BM_Affine2Multiply);
+
+/**
+ * Inverts a batch of affine transforms
+ *
+ * @param state The benchmark state
+ */
+static void BM_Affine2Invert(State& state) {
+    std::vector<Affine2> data(BATCH_SIZE);
+    for(auto it = data.begin(); it != data.end(); ++it) {
+        *it = random_affine();
+    }
+    Affine2 result;
+    while (state.keepRunning()) {
+        for(size_t ii = 0; ii < BATCH_SIZE; ii++) {
+            Affine2::invert(data[ii],&result);
+            doNotOptimize(result);
+        }
+    }
+    state.setItemsProcessed(state.iterations()*BATCH_SIZE);
+}
+CU_BENCHMARK(BM_Affine2Invert);
+
+/**
+ * Transforms an array of points (as packed floats) by an affine transform
+ *
+ * This is the per-vertex work of a SpriteBatch draw call.
+ *
+ * @param state The benchmark state
+ */
+static void BM_Affine2TransformArray(State& state) {
+    size_t size = (size_t)state.range();
+    std::vector<float> input(2*size);
+    std::vector<float> output(2*size);
+    for(auto it = input.begin(); it != input.end(); ++it) {
+        *it = random_float();
+    }
+    Affine2 transform = random_affine();
+    while (state.keepRunning()) {
+        Affine2::transform(transform,input.data(),output.data(),size);
+        doNotOptimize(output.data());
+    }
+    state.setItemsProcessed(state.iterations()*size);
+}
+CU_BENCHMARK_ARGS(BM_Affine2TransformArray, 64, 1024, 16384);
+
+/**
+ * Transforms the positions of an array of vertices by an affine transform
+ *
+ * The vertices have the same layout as a SpriteVertex (8 floats), so this
+ * measures the strided kernel.
+ *
+ * @param state The benchmark state
+ */
+static void BM_Affine2TransformStrided(State& state) {
+    size_t size = (size_t)state.range();
+    const size_t stride = 8;
+    std::vector<float> vertices(stride*size);
+    for(auto it = vertices.begin(); it != vertices.end(); ++it) {
+        *it = random_float();
+    }
+    Affine2 transform = random_affine();
+    while (state.keepRunning()) {
+        Affine2::transform(transform,vertices.data(),vertices.data(),size,stride,stride);
+        doNotOptimize(vertices.data());
+    }
+    state.setItemsProcessed(state.iterations()*size);
+}
+CU_BENCHMARK_ARGS(BM_Affine2TransformStrided, 64, 1024, 16384);
+
+#pragma mark -
+#pragma mark Quaternion
+/**
+ * Multiplies a batch of quaternions
+ *
+ * @param state The benchmark state
+ */
+static void BM_QuaternionMultiply(State& state) {
+    std::vector<Quaternion> data(BATCH_SIZE+1);
+    for(auto it = data.begin(); it != data.end(); ++it) {
+        *it = random_quaternion();
+    }
+    Quaternion result;
+    while (state.keepRunning()) {
+        for(size_t ii = 0; ii < BATCH_SIZE; ii++) {
+            Quaternion::multiply(data[ii],data[ii+1],&result);
+            doNotOptimize(result);
+        }
+    }
+    state.setItemsProcessed(state.iterations()*BATCH_SIZE);
+}
+CU_BENCHMARK(BM_QuaternionMultiply);
+
+/**
+ * Interpolates a batch of quaternions
+ *
+ * @param state The benchmark state
+ */
+static void BM_QuaternionSlerp(State& state) {
+    std::vector<Quaternion> data(BATCH_SIZE+1);
+    for(auto it = data.begin(); it != data.end(); ++it) {
+        *it = random_quaternion();
+    }
+    Quaternion result;
+    while (state.keepRunning()) {
+        for(size_t ii = 0; ii < BATCH_SIZE; ii++) {
+            Quaternion::slerp(data[ii],data[ii+1],0.25f,&result);
+            doNotOptimize(result);
+        }
+    }
+    state.setItemsProcessed(state.iterations()*BATCH_SIZE);
+}
+CU_BENCHMARK(BM_QuaternionSlerp);
+
+/**
+ * Rotates a batch of vectors by a quaternion
+ *
+ * @param state The benchmark state
+ */
+static void BM_QuaternionRotate(State& state) {
+    std::vector<Vec3> data(BATCH_SIZE);
+    for(auto it = data.begin(); it != data.end(); ++it) {
+        it->set(random_float(),random_float(),random_float());
+    }
+    Quaternion quat = random_quaternion();
+    Vec3 result;
+    while (state.keepRunning()) {
+        for(size_t ii = 0; ii < BATCH_SIZE; ii++) {
+            Quaternion::rotate(data[ii],quat,&result);
+            doNotOptimize(result);
+        }
+    }
+    state.setItemsProcessed(state.iterations()*BATCH_SIZE);
+}
+CU_BENCHMARK(BM_QuaternionRotate);
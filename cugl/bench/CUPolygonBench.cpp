@@ -0,0 +1,295 @@
+//
+//  CUPolygonBench.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides the benchmarks for the polygon tools. Triangulation
+//  and extrusion are typically done when a scene is loaded, but games that
+//  generate geometry on the fly (e.g. wireframes and paths) do this every
+//  frame. Each benchmark is run at several sizes, with the size measured in
+//  the number of vertices of the input.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Author: Walker White
+//  Version: 7/3/24 (CUGL 3.0 reorganization)
+//
+#include "CUBenchmark.h"
+#include <cugl/core/math/CUPath2.h>
+#include <cugl/core/math/CUPoly2.h>
+#include <cugl/core/math/polygon/CUEarclipTriangulator.h>
+#include <cugl/core/math/polygon/CUDelaunayTriangulator.h>
+#include <cugl/core/math/polygon/CUSimpleExtruder.h>
+#include <cugl/core/math/polygon/CUComplexExtruder.h>
+#include <cugl/core/math/polygon/CUClipperBatch.h>
+#include <cugl/core/math/polygon/clipper.hpp>
+#include <cugl/core/util/CUThreadPool.h>
+#include <random>
+
+using namespace cugl;
+using namespace cugl::bench;
+
+#pragma mark Data Generation
+/**
+ * Returns a star-shaped polygon with the given number of vertices
+ *
+ * The vertices alternate between an inner and outer radius, so the polygon
+ * is simple but far from convex. This is a worst case for ear clipping.
+ *
+ * @param size  The number of vertices
+ *
+ * @return a star-shaped polygon with the given number of vertices
+ */
+static Path2 make_star(size_t size) {
+    std::vector<Vec2> points;
+    points.reserve(size);
+    for(size_t ii = 0; ii < size; ii++) {
+        float angle  = (float)(2*M_PI*ii/size);
+        float radius = (ii % 2 == 0) ? 100.0f : 60.0f;
+        points.push_back(Vec2(radius*cosf(angle),radius*sinf(angle)));
+    }
+    Path2 result(points);
+    result.closed = true;
+    return result;
+}
+
+/**
+ * Returns an open, wavy path with the given number of vertices
+ *
+ * The path is a sine wave with several vertices per period, which is
+ * typical of a path generated by a spline.
+ *
+ * @param size  The number of vertices
+ *
+ * @return an open, wavy path with the given number of vertices
+ */
+static Path2 make_wave(size_t size) {
+    std::vector<Vec2> points;
+    points.reserve(size);
+    for(size_t ii = 0; ii < size; ii++) {
+        points.push_back(Vec2(ii*8.0f,30.0f*sinf(ii*0.3f)));
+    }
+    return Path2(points);
+}
+
+#pragma mark -
+#pragma mark Triangulation
+/**
+ * Triangulates a star polygon with the ear clipping triangulator
+ *
+ * @param state The benchmark state
+ */
+static void BM_EarclipTriangulate(State& state) {
+    Path2 path = make_star((size_t)state.range());
+    EarclipTriangulator triangulator;
+    Poly2 poly;
+    while (state.keepRunning()) {
+        triangulator.set(path);
+        triangulator.calculate();
+        triangulator.getPolygon(&poly);
+        doNotOptimize(poly.indices.data());
+        triangulator.clear();
+        poly.clear();
+    }
+    state.setItemsProcessed(state.iterations()*state.range());
+}
+CU_BENCHMARK_ARGS(BM_EarclipTriangulate, 16, 256, 4096);
+
+/**
+ * Triangulates a star polygon with the Delaunay triangulator
+ *
+ * @param state The benchmark state
+ */
+static void BM_DelaunayTriangulate(State& state) {
+    Path2 path = make_star((size_t)state.range());
+    DelaunayTriangulator triangulator;
+    Poly2 poly;
+    while (state.keepRunning()) {
+        triangulator.set(path);
+        triangulator.calculate();
+        triangulator.getPolygon(&poly);
+        doNotOptimize(poly.indices.data());
+        triangulator.clear();
+        poly.clear();
+    }
+    state.setItemsProcessed(state.iterations()*state.range());
+}
+CU_BENCHMARK_ARGS(BM_DelaunayTriangulate, 16, 256, 4096);
+
+#pragma mark -
+#pragma mark Extrusion
+/**
+ * Extrudes an open path with the simple extruder
+ *
+ * @param state The benchmark state
+ */
+static void BM_SimpleExtrude(State& state) {
+    Path2 path = make_wave((size_t)state.range());
+    SimpleExtruder extruder;
+    Poly2 poly;
+    while (state.keepRunning()) {
+        extruder.set(path);
+        extruder.calculate(4.0f);
+        extruder.getPolygon(&poly);
+        doNotOptimize(poly.indices.data());
+        extruder.clear();
+        poly.clear();
+    }
+    state.setItemsProcessed(state.iterations()*state.range());
+}
+CU_BENCHMARK_ARGS(BM_SimpleExtrude, 16, 256, 4096);
+
+/**
+ * Extrudes an open path with the complex extruder
+ *
+ * @param state The benchmark state
+ */
+static void BM_ComplexExtrude(State& state) {
+    Path2 path = make_wave((size_t)state.range());
+    ComplexExtruder extruder;
+    Poly2 poly;
+    while (state.keepRunning()) {
+        extruder.set(path);
+        extruder.calculate(4.0f);
+        extruder.getPolygon(&poly);
+        doNotOptimize(poly.indices.data());
+        extruder.clear();
+        poly.clear();
+    }
+    state.setItemsProcessed(state.iterations()*state.range());
+}
+CU_BENCHMARK_ARGS(BM_ComplexExtrude, 16, 256, 4096);
+
+#pragma mark -
+#pragma mark Clipping
+/**
+ * Returns the given number of random squares
+ *
+ * The squares are placed at random in a fixed region, so the number of
+ * intersections grows with the number of squares.
+ *
+ * @param size  The number of squares
+ * @param seed  The random seed
+ *
+ * @return the given number of random squares
+ */
+static ClipperLib::Paths make_squares(size_t size, unsigned int seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> dist(0,10000);
+    ClipperLib::Paths squares;
+    for(size_t ii = 0; ii < size; ii++) {
+        ClipperLib::cInt x = dist(gen);
+        ClipperLib::cInt y = dist(gen);
+        ClipperLib::Path square;
+        square.push_back(ClipperLib::IntPoint(x,y));
+        square.push_back(ClipperLib::IntPoint(x+500,y));
+        square.push_back(ClipperLib::IntPoint(x+500,y+500));
+        square.push_back(ClipperLib::IntPoint(x,y+500));
+        squares.push_back(square);
+    }
+    return squares;
+}
+
+/**
+ * Computes the union of many overlapping squares with the clipper
+ *
+ * @param state The benchmark state
+ */
+static void BM_ClipperUnion(State& state) {
+    ClipperLib::Paths squares = make_squares((size_t)state.range(), 5416);
+
+    ClipperLib::Paths solution;
+    while (state.keepRunning()) {
+        ClipperLib::Clipper clipper;
+        clipper.AddPaths(squares, ClipperLib::ptSubject, true);
+        clipper.Execute(ClipperLib::ctUnion, solution,
+                        ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+        doNotOptimize(solution.data());
+    }
+    state.setItemsProcessed(state.iterations()*state.range());
+}
+CU_BENCHMARK_ARGS(BM_ClipperUnion, 16, 256, 4096);
+
+/** The number of independent tiles in the batch benchmarks */
+#define BATCH_TILES 64
+
+/**
+ * Clips a set of independent tiles one at a time
+ *
+ * Each tile is the union of 64 squares, minus an offset of its outline.
+ * This is the baseline for BM_ClipperBatch.
+ *
+ * @param state The benchmark state
+ */
+static void BM_ClipperSerial(State& state) {
+    std::vector<ClipperLib::Paths> tiles;
+    for(unsigned int ii = 0; ii < BATCH_TILES; ii++) {
+        tiles.push_back(make_squares(64, ii));
+    }
+    
+    ClipperLib::Paths solution;
+    while (state.keepRunning()) {
+        for(auto it = tiles.begin(); it != tiles.end(); ++it) {
+            ClipperLib::Clipper clipper;
+            clipper.AddPaths(*it, ClipperLib::ptSubject, true);
+            clipper.Execute(ClipperLib::ctUnion, solution,
+                            ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+            ClipperLib::ClipperOffset offset;
+            offset.AddPaths(*it, ClipperLib::jtRound, ClipperLib::etClosedPolygon);
+            offset.Execute(solution, -50);
+            doNotOptimize(solution.data());
+        }
+    }
+    state.setItemsProcessed(state.iterations()*BATCH_TILES);
+}
+CU_BENCHMARK(BM_ClipperSerial);
+
+/**
+ * Clips a set of independent tiles with a ClipperBatch
+ *
+ * The argument is the number of threads in the pool (0 runs the batch
+ * on the calling thread).
+ *
+ * @param state The benchmark state
+ */
+static void BM_ClipperBatch(State& state) {
+    std::shared_ptr<ThreadPool> pool = nullptr;
+    if (state.range() > 0) {
+        pool = ThreadPool::alloc((int)state.range());
+    }
+    std::shared_ptr<ClipperBatch> batch = ClipperBatch::alloc(pool);
+
+    std::vector<ClipperLib::Paths> tiles;
+    for(unsigned int ii = 0; ii < BATCH_TILES; ii++) {
+        tiles.push_back(make_squares(64, ii));
+    }
+    
+    ClipperLib::Paths empty;
+    while (state.keepRunning()) {
+        batch->clear();
+        for(auto it = tiles.begin(); it != tiles.end(); ++it) {
+            batch->addClip(ClipperLib::ctUnion, *it, empty);
+            batch->addOffset(*it, -50);
+        }
+        batch->calculate();
+        doNotOptimize(batch->getSolution(0).data());
+    }
+    state.setItemsProcessed(state.iterations()*BATCH_TILES);
+}
+CU_BENCHMARK_ARGS(BM_ClipperBatch, 0, 2, 4);
@@ -0,0 +1,130 @@
+//
+//  CUSerializerBench.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides the benchmarks for the network serializers. Both
+//  benchmarks serialize and then deserialize a typical state update: an
+//  identifier, position, and velocity for a number of game objects. The
+//  NetcodeSerializer tags every value with its type, while the LWSerializer
+//  (used by the distributed physics) does not.
+//
+//  The NetcodeSerializer benchmark is only available if CUGL was built with
+//  networking support (CU_BENCH_NETCODE).
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Author: Walker White
+//  Version: 7/3/24 (CUGL 3.0 reorganization)
+//
+#include "CUBenchmark.h"
+#include <cugl/physics2/distrib/CULWSerializer.h>
+#include <cugl/physics2/distrib/CULWDeserializer.h>
+#if defined CU_BENCH_NETCODE
+    #include <cugl/netcode/CUNetcodeSerializer.h>
+#endif
+
+using namespace cugl;
+using namespace cugl::bench;
+
+#if defined CU_BENCH_NETCODE
+/**
+ * Serializes and deserializes a state update with NetcodeSerializer
+ *
+ * @param state The benchmark state
+ */
+static void BM_NetcodeSerializerRoundTrip(State& state) {
+    using namespace cugl::netcode;
+    size_t size = (size_t)state.range();
+    NetcodeSerializer serializer;
+    NetcodeDeserializer deserializer;
+    Uint64 bytes = 0;
+    while (state.keepRunning()) {
+        serializer.writeUint32((Uint32)size);
+        for(size_t ii = 0; ii < size; ii++) {
+            serializer.writeUint32((Uint32)ii);
+            serializer.writeFloat(ii*0.5f);
+            serializer.writeFloat(ii*0.25f);
+            serializer.writeFloat(1.0f);
+            serializer.writeFloat(-1.0f);
+        }
+        const std::vector<std::byte>& message = serializer.serialize();
+        bytes += message.size();
+
+        deserializer.receive(message);
+        Uint32 count = deserializer.readUint32();
+        float sum = 0;
+        for(Uint32 ii = 0; ii < count; ii++) {
+            sum += (float)deserializer.readUint32();
+            sum += deserializer.readFloat();
+            sum += deserializer.readFloat();
+            sum += deserializer.readFloat();
+            sum += deserializer.readFloat();
+        }
+        doNotOptimize(sum);
+        serializer.reset();
+        deserializer.reset();
+    }
+    state.setItemsProcessed(state.iterations()*size);
+    state.setBytesProcessed(bytes);
+}
+CU_BENCHMARK_ARGS(BM_NetcodeSerializerRoundTrip, 16, 256, 4096);
+#endif
+
+/**
+ * Serializes and deserializes a state update with LWSerializer
+ *
+ * @param state The benchmark state
+ */
+static void BM_LWSerializerRoundTrip(State& state) {
+    using namespace cugl::physics2::distrib;
+    size_t size = (size_t)state.range();
+    LWSerializer serializer;
+    LWDeserializer deserializer;
+    Uint64 bytes = 0;
+    while (state.keepRunning()) {
+        serializer.writeUint32((Uint32)size);
+        for(size_t ii = 0; ii < size; ii++) {
+            serializer.writeUint32((Uint32)ii);
+            serializer.writeFloat(ii*0.5f);
+            serializer.writeFloat(ii*0.25f);
+            serializer.writeFloat(1.0f);
+            serializer.writeFloat(-1.0f);
+        }
+        const std::vector<std::byte>& message = serializer.serialize();
+        bytes += message.size();
+
+        deserializer.receive(message);
+        Uint32 count = deserializer.readUint32();
+        float sum = 0;
+        for(Uint32 ii = 0; ii < count; ii++) {
+            sum += (float)deserializer.readUint32();
+            sum += deserializer.readFloat();
+            sum += deserializer.readFloat();
+            sum += deserializer.readFloat();
+            sum += deserializer.readFloat();
+        }
+        doNotOptimize(sum);
+        serializer.reset();
+        deserializer.reset();
+    }
+    state.setItemsProcessed(state.iterations()*size);
+    state.setBytesProcessed(bytes);
+}
+CU_BENCHMARK_ARGS(BM_LWSerializerRoundTrip, 16, 256, 4096);
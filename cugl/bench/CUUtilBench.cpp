@@ -0,0 +1,154 @@
+//
+//  CUUtilBench.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides the benchmarks for the utility classes. The free
+//  list is compared against plain heap allocation for the churn typical of
+//  particle systems. The thread pool benchmark measures the overhead of
+//  dispatching a batch of small tasks and waiting for them to complete.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Author: Walker White
+//  Version: 7/3/24 (CUGL 3.0 reorganization)
+//
+#include "CUBenchmark.h"
+#include <cugl/core/util/CUFreeList.h>
+#include <cugl/core/util/CUThreadPool.h>
+#include <cugl/core/math/CUVec2.h>
+#include <atomic>
+#include <thread>
+
+using namespace cugl;
+using namespace cugl::bench;
+
+/** The number of objects allocated per iteration */
+#define CHURN_SIZE  1024
+
+#pragma mark Free Lists
+/**
+ * A particle-sized object for the allocation benchmarks
+ */
+class BenchParticle {
+public:
+    /** The particle position */
+    Vec2 position;
+    /** The particle velocity */
+    Vec2 velocity;
+    /** The remaining lifetime */
+    float life;
+
+    /**
+     * Creates a dead particle
+     */
+    BenchParticle() : life(0) {}
+
+    /**
+     * Resets the particle so that it can be recycled
+     */
+    void reset() {
+        position.setZero();
+        velocity.setZero();
+        life = 0;
+    }
+};
+
+/**
+ * Allocates and frees a batch of objects with a FreeList
+ *
+ * @param state The benchmark state
+ */
+static void BM_FreeListChurn(State& state) {
+    std::shared_ptr<FreeList<BenchParticle>> freelist = FreeList<BenchParticle>::alloc(CHURN_SIZE,true);
+    std::vector<BenchParticle*> live(CHURN_SIZE);
+    while (state.keepRunning()) {
+        for(size_t ii = 0; ii < CHURN_SIZE; ii++) {
+            live[ii] = freelist->malloc();
+            live[ii]->life = 1.0f;
+        }
+        doNotOptimize(live.data());
+        for(size_t ii = 0; ii < CHURN_SIZE; ii++) {
+            freelist->free(live[ii]);
+        }
+    }
+    state.setItemsProcessed(state.iterations()*CHURN_SIZE);
+}
+CU_BENCHMARK(BM_FreeListChurn);
+
+/**
+ * Allocates and frees a batch of objects with new and delete
+ *
+ * This is the baseline for BM_FreeListChurn.
+ *
+ * @param state The benchmark state
+ */
+static void BM_HeapChurn(State& state) {
+    std::vector<BenchParticle*> live(CHURN_SIZE);
+    while (state.keepRunning()) {
+        for(size_t ii = 0; ii < CHURN_SIZE; ii++) {
+            live[ii] = new BenchParticle();
+            live[ii]->life = 1.0f;
+        }
+        doNotOptimize(live.data());
+        for(size_t ii = 0; ii < CHURN_SIZE; ii++) {
+            delete live[ii];
+        }
+    }
+    state.setItemsProcessed(state.iterations()*CHURN_SIZE);
+}
+CU_BENCHMARK(BM_HeapChurn);
+
+#pragma mark -
+#pragma mark Thread Pools
+/**
+ * Dispatches a batch of small tasks to a thread pool and waits for them
+ *
+ * The argument is the number of tasks per batch. The pool has four
+ * threads, which is the default for CUGL.
+ *
+ * @param state The benchmark state
+ */
+static void BM_ThreadPoolDispatch(State& state) {
+    std::shared_ptr<ThreadPool> pool = ThreadPool::alloc(4);
+    if (pool == nullptr) {
+        state.skipWithError("Could not create thread pool");
+        return;
+    }
+
+    size_t size = (size_t)state.range();
+    std::atomic<Uint64> total(0);
+    while (state.keepRunning()) {
+        for(size_t ii = 0; ii < size; ii++) {
+            pool->addTask([&total,ii]() {
+                Uint64 value = ii;
+                for(int jj = 0; jj < 64; jj++) {
+                    value = value*6364136223846793005ULL+1442695040888963407ULL;
+                }
+                total.fetch_add(value & 1);
+            });
+        }
+        while (pool->getPendingCount() > 0) {
+            std::this_thread::yield();
+        }
+    }
+    doNotOptimize(total.load());
+    state.setItemsProcessed(state.iterations()*size);
+}
+CU_BENCHMARK_ARGS(BM_ThreadPoolDispatch, 16, 256, 4096);
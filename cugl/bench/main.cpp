@@ -0,0 +1,46 @@
+//
+//  main.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This is the entry point for the CUGL benchmark suite. The benchmarks do
+//  not need a window or a graphics context, so this program does not create
+//  an Application. It can be built and run on a headless machine (see the
+//  CUGL_HEADLESS option in the CMake build).
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Author: Walker White
+//  Version: 7/3/24 (CUGL 3.0 reorganization)
+//
+// We do not use SDL_main, as there is no application
+#define SDL_MAIN_HANDLED
+#include "CUBenchmark.h"
+
+/**
+ * Runs the benchmarks specified by the command line arguments.
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ *
+ * @return the process exit code
+ */
+int main(int argc, char** argv) {
+    return cugl::bench::Runner::main(argc, argv);
+}
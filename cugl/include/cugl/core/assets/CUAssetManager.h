@@ -51,6 +51,9 @@
 #include <cugl/core/assets/CULoader.h>
 #include <typeinfo>
 #include <future>
+#include <deque>
+#include <mutex>
+#include <atomic>
 
 
 namespace cugl {
@@ -92,11 +95,24 @@ protected:
     std::unordered_map<std::string,size_t> _jsonKeys;
     /** The priorities for each JSON key */
     std::unordered_map<std::string,Uint32> _priority;
-    /** The central thread for managing all of the loaders */
+    /** The worker threads shared by all of the loaders */
     std::shared_ptr<ThreadPool> _workers;
+    /** The thread that processes asset directories (and their barriers) */
+    std::shared_ptr<ThreadPool> _director;
 
     /** State variable to manage reading JSON directories */
-    bool _preload;
+    std::atomic<bool> _preload;
+    
+    /** The pending materialization steps (executed in the main thread) */
+    std::deque<std::function<bool()>> _materials;
+    /** The mutex for the materialization queue */
+    std::mutex _materialMutex;
+    /** Whether the materialization queue is scheduled with the application */
+    bool _pumping;
+    /** The application callback identifier for the materialization queue */
+    Uint32 _pumpid;
+    /** The per-frame time budget for materialization (in microseconds) */
+    Uint32 _budget;
     
     /**
      * Synchronously reads an asset category from a JSON file
@@ -176,12 +192,38 @@ protected:
      * Synchronizes the asset manager to wait until all assets have finished.
      *
      * This method is necessary for assets whose construction depends on
-     * previously loaded assets (e.g. scene graphs). In the current
-     * architecture, this method is only correct if the asset manager loads
-     * assets in a single thread.
+     * previously loaded assets (e.g. scene graphs). It blocks the calling
+     * thread until the worker threads are idle and every loader has
+     * materialized its assets. As materialization takes place in the main
+     * thread, this method must only be called from the directory thread.
      */
     void sync();
     
+    /**
+     * Loads all assets in the given directory, blocking until complete.
+     *
+     * This is the body of an asynchronous directory load. It dispatches each
+     * asset category to the worker threads in priority order, waiting for
+     * each priority level to finish before starting the next. This method
+     * must only be called from the directory thread.
+     *
+     * @param json      The JSON asset directory
+     * @param callback  An optional callback after each asset is loaded
+     */
+    void processDirectory(const std::shared_ptr<JsonValue>& json, LoaderCallback callback);
+    
+    /**
+     * Executes pending materialization steps for this animation frame.
+     *
+     * This method is scheduled with {@link Application#schedule} whenever the
+     * materialization queue is nonempty. It processes materialization steps
+     * until the time budget for this frame is exhausted (though it always
+     * processes at least one step).
+     *
+     * @return true if there are still materialization steps pending
+     */
+    bool pump();
+    
 #pragma mark -
 #pragma mark Constructors
 public:
@@ -191,7 +233,7 @@ public:
      * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an asset 
      * manager on the heap, use one of the static constructors instead.
      */
-    AssetManager() : _preload(false) {}
+    AssetManager() : _preload(false), _pumping(false), _pumpid(0), _budget(0) {}
     
     /**
      * Deletes this asset manager, disposing of all resources.
@@ -208,41 +250,104 @@ public:
     void dispose();
 
     /**
-     * Initializes a new asset manager.
+     * Initializes a new asset manager with the given number of worker threads.
      *
-     * The asset manager has a single thread, as some of the asset loading
-     * operations (particularly fonts) cannot be run in multiple threads
-     * simultaneously. However, it will run in a distinct thread from the
-     * main application.
+     * The worker threads perform the part of asset loading that is safe to
+     * do outside of the main thread (e.g. image decoding and font loading).
+     * Assets of the same priority are loaded in parallel, while loaders of
+     * lower priority wait for all higher priority assets to finish. The
+     * final step of loading (e.g. creating OpenGL objects) always takes
+     * place in the main thread, under a per-frame time budget.
+     *
+     * By default, the asset manager has a single worker thread. A value
+     * close to the number of cores will give the fastest load times.
      *
      * This initializer does not attach any loaders.  It simply creates an 
      * object that is ready to accept loader objects.
      *
+     * @param threads   The number of worker threads
+     *
      * @return true if the asset manager was initialized successfully
      */
-    bool init();
+    bool init(Uint32 threads=1);
 
     
 #pragma mark -
 #pragma mark Static Constructors
     /**
-     * Returns a newly allocated asset manager.
+     * Returns a newly allocated asset manager with the given number of workers.
      *
-     * The asset manager has a single thread, as some of the asset loading
-     * operations (particularly fonts) cannot be run in multiple threads
-     * simultaneously. However, it will run in a distinct thread from the
-     * main application. In addition, confining to one thread allows us to
-     * handle dependencies between loaders.
+     * The worker threads perform the part of asset loading that is safe to
+     * do outside of the main thread (e.g. image decoding and font loading).
+     * Assets of the same priority are loaded in parallel, while loaders of
+     * lower priority wait for all higher priority assets to finish. The
+     * final step of loading (e.g. creating OpenGL objects) always takes
+     * place in the main thread, under a per-frame time budget.
+     *
+     * By default, the asset manager has a single worker thread. A value
+     * close to the number of cores will give the fastest load times.
      *
      * This constructor does not attach any loaders.  It simply creates an
      * object that is ready to accept loader objects.
      *
+     * @param threads   The number of worker threads
+     *
      * @return a newly allocated asset manager.
      */
-    static std::shared_ptr<AssetManager> alloc() {
+    static std::shared_ptr<AssetManager> alloc(Uint32 threads=1) {
         std::shared_ptr<AssetManager> result = std::make_shared<AssetManager>();
-        return (result->init() ? result : nullptr);
+        return (result->init(threads) ? result : nullptr);
+    }
+
+#pragma mark -
+#pragma mark Materialization
+    /**
+     * Returns the number of worker threads for this asset manager.
+     *
+     * @return the number of worker threads for this asset manager.
+     */
+    size_t getThreadCount() const {
+        return _workers == nullptr ? 0 : _workers->getThreadCount();
     }
+    
+    /**
+     * Returns the per-frame time budget for materialization in microseconds.
+     *
+     * Materialization (e.g. creating OpenGL objects) must take place in the
+     * main thread. To keep asynchronous loading from stalling the animation,
+     * the asset manager only materializes assets for this long each frame.
+     * It will always materialize at least one asset per frame. A value of 0
+     * means that there is no budget, and all pending assets are materialized
+     * as soon as possible.
+     *
+     * @return the per-frame time budget for materialization in microseconds.
+     */
+    Uint32 getMaterializeBudget() const { return _budget; }
+    
+    /**
+     * Sets the per-frame time budget for materialization in microseconds.
+     *
+     * Materialization (e.g. creating OpenGL objects) must take place in the
+     * main thread. To keep asynchronous loading from stalling the animation,
+     * the asset manager only materializes assets for this long each frame.
+     * It will always materialize at least one asset per frame. A value of 0
+     * means that there is no budget, and all pending assets are materialized
+     * as soon as possible.
+     *
+     * @param micros    The per-frame time budget in microseconds
+     */
+    void setMaterializeBudget(Uint32 micros) { _budget = micros; }
+    
+    /**
+     * Adds a materialization step to the queue for the main thread.
+     *
+     * This method is used by the attached loaders (via the method
+     * {@link BaseLoader#schedule}), and is safe to call from any thread.
+     * The callback is executed exactly once, regardless of its return value.
+     *
+     * @param callback  The materialization step
+     */
+    void schedule(std::function<bool()> callback);
 
 #pragma mark -
 #pragma mark Loader Management
@@ -590,6 +695,10 @@ public:
      * can.  If any asset fails to load, it will return false.  However, some
      * assets may still be loaded and safe to access.
      *
+     * If this asset manager has more than one worker thread, the work that
+     * is safe to do outside of the main thread is distributed across the
+     * workers. This method still blocks until all assets are loaded.
+     *
      * @param json  The JSON asset directory
      *
      * @return true if all assets specified in the directory were successfully loaded.
@@ -624,6 +733,10 @@ public:
      * can.  If any asset fails to load, it will return false.  However, some
      * assets may still be loaded and safe to access.
      *
+     * If this asset manager has more than one worker thread, the work that
+     * is safe to do outside of the main thread is distributed across the
+     * workers. This method still blocks until all assets are loaded.
+     *
      * @param directory The path to the JSON asset directory
      *
      * @return true if all assets specified in the directory were successfully loaded.
@@ -108,7 +108,7 @@ protected:
         if (callback != nullptr) {
             callback(key,success);
         }
-        _queue.erase(key);
+        this->dequeue(key);
         return success;
     }
     
@@ -132,31 +132,25 @@ protected:
      */
     virtual bool read(const std::string key, const std::string source,
                       LoaderCallback callback, bool async) override {
-        if (_assets.find(key) != _assets.end() || _queue.find(key) != _queue.end()) {
+        if (_assets.find(key) != _assets.end() || this->queued(key)) {
             return false;
         }
         
         bool success = false;
         if (_loader == nullptr || !async) {
-            _queue.emplace(key);
-            if (_reserved > 0) {
-                _reserved--;
-            }
+            this->enqueue(key);
             std::shared_ptr<T> asset = std::make_shared<T>();
             if (asset->preload(source)) {
                 success = materialize(key,asset,callback);
             }
         } else {
             _loader->addTask([=,this](void) {
-                this->_queue.emplace(key);
-                if (_reserved > 0) {
-                    _reserved--;
-                }
+                this->enqueue(key);
                 std::shared_ptr<T> asset = std::make_shared<T>();
                 if (!asset->preload(source)) {
                     asset = nullptr;
                 }
-                Application::get()->schedule([=,this](void){
+                this->schedule([=,this](void){
                     this->materialize(key,asset,callback);
                     return false;
                 });
@@ -191,31 +185,25 @@ protected:
     virtual bool read(const std::shared_ptr<JsonValue>& json,
                       LoaderCallback callback, bool async) override {
         std::string key = json->key();
-        if (_assets.find(key) != _assets.end() || _queue.find(key) != _queue.end()) {
+        if (_assets.find(key) != _assets.end() || this->queued(key)) {
             return false;
         }
         
         bool success = false;
         if (_loader == nullptr || !async) {
-            _queue.emplace(key);
-            if (_reserved > 0) {
-                _reserved--;
-            }
+            this->enqueue(key);
             std::shared_ptr<T> asset = std::make_shared<T>();
             if (asset->preload(json)) {
                 success = materialize(key,asset,callback);
             }
         } else {
             _loader->addTask([=,this](void) {
-                this->_queue.emplace(key);
-                if (_reserved > 0) {
-                    _reserved--;
-                }
+                this->enqueue(key);
                 std::shared_ptr<T> asset = std::make_shared<T>();
                 if (!asset->preload(json)) {
                     asset = nullptr;
                 }
-                Application::get()->schedule([=,this](void){
+                this->schedule([=,this](void){
                     this->materialize(key,asset,callback);
                     return false;
                 });
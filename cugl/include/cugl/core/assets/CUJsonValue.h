@@ -4,8 +4,8 @@
 //
 //  This module a modern C++ alternative to the CUJSON interface for reading
 //  JSON files.  In particular, this gives us better type-checking and memory
-//  management.  With that said, it still uses CUJSON as the underlying parsing
-//  engine.
+//  management.  JSON strings are parsed directly into JsonValue nodes in a
+//  single pass.  CUJSON is only used as the engine for printing.
 //
 //  This class uses our standard shared-pointer architecture.
 //
@@ -47,6 +47,9 @@
 #include <cugl/core/assets/CUJSON.h>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <memory>
 
 namespace cugl {
 
@@ -62,9 +65,9 @@ namespace cugl {
  * if the node is an object type.  Hence the main usage of this feature is to
  * "cast" object nodes to arrays.
  *
- * This class uses CUJSON as the underlying parsing engine.  However, it manages
- * memory automatically so that the user does not need to worry about deleting
- * or allocating memory beyond the initial node itself.
+ * This class parses JSON strings directly, without an intermediate CUJSON
+ * tree.  It manages memory automatically so that the user does not need to
+ * worry about deleting or allocating memory beyond the initial node itself.
  */
 class JsonValue {
 public:
@@ -109,6 +112,14 @@ public:
     /** The children of this node (only non-empty if array or object) */
     std::vector<std::shared_ptr<JsonValue>> _children;
 
+private:
+    /** A single pass parser for JSON strings (defined in the .cpp) */
+    class Parser;
+    /** The position of each child by the hash of its key (only for large objects) */
+    std::unique_ptr<std::unordered_map<size_t, Uint32>> _index;
+
+public:
+
 #pragma mark -
 #pragma mark CUJSON Conversions
     /**
@@ -272,7 +283,29 @@ public:
      *
      * @return  true if the JSON node is initialized properly, false otherwise.
      */
-    bool initWithJson(const std::string json);
+    bool initWithJson(const std::string& json);
+
+    /**
+     * Initializes a new JsonValue from the given JSON string.
+     *
+     * This initializer will parse the JSON string and construct a full JSON
+     * tree for the string, if possible. The children are all owned by this
+     * node will be deleted when this node is deleted (provided there are
+     * no other references).
+     *
+     * The JSON string does not need to be null terminated. It is parsed in a
+     * single pass, directly into the JSON tree, with no intermediate copy.
+     *
+     * If there is a parsing error, this  method will return false.  Detailed
+     * information about the parsing error will be passed to an assert.  Hence
+     * error messages are suppressed if asserts are turned off.
+     *
+     * @param json      The JSON string to parse.
+     * @param length    The number of bytes in the JSON string.
+     *
+     * @return  true if the JSON node is initialized properly, false otherwise.
+     */
+    bool initWithJson(const char* json, size_t length);
 
     
 #pragma mark -
@@ -401,11 +434,36 @@ public:
      *
      * @return a newly allocated JsonValue from the given JSON string.
      */
-    static std::shared_ptr<JsonValue> allocWithJson(const std::string json) {
+    static std::shared_ptr<JsonValue> allocWithJson(const std::string& json) {
         std::shared_ptr<JsonValue> result = std::make_shared<JsonValue>();
         return (result->initWithJson(json) ? result : nullptr);
     }
 
+    /**
+     * Returns a newly allocated JsonValue from the given JSON string.
+     *
+     * This initializer will parse the JSON string and construct a full JSON
+     * tree for the string, if possible. The children are all owned by this
+     * node will be deleted when this node is deleted (provided there are
+     * no other references).
+     *
+     * The JSON string does not need to be null terminated. It is parsed in a
+     * single pass, directly into the JSON tree, with no intermediate copy.
+     *
+     * If there is a parsing error, this  method will return nullptr.  Detailed
+     * information about the parsing error will be passed to an assert.  Hence
+     * error messages are suppressed if asserts are turned off.
+     *
+     * @param json      The JSON string to parse.
+     * @param length    The number of bytes in the JSON string.
+     *
+     * @return a newly allocated JsonValue from the given JSON string.
+     */
+    static std::shared_ptr<JsonValue> allocWithJson(const char* json, size_t length) {
+        std::shared_ptr<JsonValue> result = std::make_shared<JsonValue>();
+        return (result->initWithJson(json,length) ? result : nullptr);
+    }
+
     
 #pragma mark -
 #pragma mark Type
@@ -733,7 +791,7 @@ public:
      *
      * @return true if a child with the specified name exists.
      */
-    bool has(const std::string name) const;
+    bool has(std::string_view name) const;
 
     /**
      * Returns the child at the specified index. 
@@ -767,11 +825,14 @@ public:
      * corrupted and there is more than one child of this name, it will return
      * the first one.
      *
+     * Objects with many children keep a hash index of their keys, so this
+     * lookup is constant time.  Smaller objects are searched linearly.
+     *
      * @param name  The key identifying the child.
      *
      * @return the child with the specified key.
      */
-    std::shared_ptr<JsonValue> get(const std::string name);
+    std::shared_ptr<JsonValue> get(std::string_view name);
     
     /**
      * Returns the child with the specified key.
@@ -781,11 +842,14 @@ public:
      * corrupted and there is more than one child of this name, it will return
      * the first one.
      *
+     * Objects with many children keep a hash index of their keys, so this
+     * lookup is constant time.  Smaller objects are searched linearly.
+     *
      * @param name  The key identifying the child.
      *
      * @return the child with the specified key.
      */
-    const std::shared_ptr<JsonValue> get(const std::string name) const;
+    const std::shared_ptr<JsonValue> get(std::string_view name) const;
     
     
 #pragma mark -
@@ -804,7 +868,7 @@ public:
      *
      * @return the string value of the child with the specified key.
      */
-    const std::string getString (const std::string key, const std::string defaultValue="") const;
+    const std::string getString (std::string_view key, const std::string& defaultValue="") const;
     
     /**
      * Returns the float value of the child with the specified key.
@@ -820,7 +884,7 @@ public:
      *
      * @return the float value of the child with the specified key.
      */
-    float getFloat(const std::string key, float defaultValue=0.0f) const;
+    float getFloat(std::string_view key, float defaultValue=0.0f) const;
     
     /**
      * Returns the double value of the child with the specified key.
@@ -836,7 +900,7 @@ public:
      *
      * @return the double value of the child with the specified key.
      */
-    double getDouble(const std::string key, double defaultValue=0.0) const;
+    double getDouble(std::string_view key, double defaultValue=0.0) const;
     
     /**
      * Returns the long value of the child with the specified key.
@@ -852,7 +916,7 @@ public:
      *
      * @return the long value of the child with the specified key.
      */
-    long getLong(const std::string key, long defaultValue=0L) const;
+    long getLong(std::string_view key, long defaultValue=0L) const;
     
     /**
      * Returns the int value of the child with the specified key.
@@ -868,7 +932,7 @@ public:
      *
      * @return the int value of the child with the specified key.
      */
-    int getInt(const std::string key, int defaultValue=0) const;
+    int getInt(std::string_view key, int defaultValue=0) const;
     
     /**
      * Returns the boolean value of the child with the specified key.
@@ -884,7 +948,7 @@ public:
      *
      * @return the boolean value of the child with the specified key.
      */
-    bool getBool(const std::string key, bool defaultValue=false) const;
+    bool getBool(std::string_view key, bool defaultValue=false) const;
     
 #pragma mark -
 #pragma mark Child Deletion
@@ -914,7 +978,7 @@ public:
      *
      * Returns the child with the specified key and removes it from this node.
      */
-    std::shared_ptr<JsonValue> removeChild(const std::string name);
+    std::shared_ptr<JsonValue> removeChild(std::string_view name);
     
         
 #pragma mark -
@@ -1452,6 +1516,30 @@ public:
 
 
 
+#pragma mark -
+#pragma mark Key Index
+private:
+    /**
+     * Returns the position of the child with the given key, or -1 if none.
+     *
+     * If this node has a key index, that index is used to find the child.
+     * Otherwise, the children are searched linearly.
+     *
+     * @param key   The key identifying the child
+     *
+     * @return the position of the child with the given key, or -1 if none.
+     */
+    Sint32 find(std::string_view key) const;
+    
+    /**
+     * Rebuilds the key index of this node.
+     *
+     * The index is only built for objects with many children. Otherwise
+     * this method deletes any existing index.
+     */
+    void reindex();
+
+public:
 #pragma mark -
 #pragma mark Encoding
     
@@ -51,6 +51,7 @@
 #include <functional>
 #include <unordered_map>
 #include <unordered_set>
+#include <mutex>
 #include <cugl/core/assets/CUJsonValue.h>
 #include <cugl/core/util/CUThreadPool.h>
 
@@ -217,6 +218,21 @@ protected:
      * @return true if the key maps to a loaded asset.
      */
     virtual bool verify(const std::string key) const { return false; }
+    
+    /**
+     * Schedules the materialization step of an asynchronous load.
+     *
+     * Materialization (e.g. creating OpenGL objects) must take place in the
+     * main thread. If this loader is attached to an {@link AssetManager},
+     * the callback is added to the materialization queue of that manager,
+     * which processes these callbacks under a per-frame time budget.
+     * Otherwise, it is passed to {@link Application#schedule}.
+     *
+     * The callback is executed exactly once, regardless of its return value.
+     *
+     * @param callback  The materialization callback
+     */
+    void schedule(std::function<bool()> callback);
    
 public:
 #pragma mark Constructors
@@ -226,7 +242,7 @@ public:
      * NEVER CALL THIS CONSTRUCTOR. As this is an abstract class, you should 
      * call one of the static constructors of the appropriate child class.
      */
-    BaseLoader() : _jsonKey(""), _priority(0), _reserved(0) { }
+    BaseLoader() : _jsonKey(""), _priority(0), _reserved(0), _manager(nullptr) { }
     
     /**
      * Deletes this asset loader, disposing of all resources.
@@ -709,6 +725,8 @@ protected:
 
     /** The assets we are expecting that are not yet loaded */
     std::unordered_set<std::string> _queue;
+    /** The mutex for the queue (as worker threads may modify it) */
+    mutable std::mutex _queueMutex;
     
 public:
 #pragma mark Constructors
@@ -770,20 +788,52 @@ public:
      *
      * @return the number of assets that are actively being loaded.
      */
-    size_t inFlight() const override { return _queue.size(); }
+    size_t inFlight() const override {
+        std::lock_guard<std::mutex> lock(_queueMutex);
+        return _queue.size();
+    }
     
     /**
      * Queues up an asset for loading.
      *
      * This method adds the given key to the queue. It also deducts from the
-     * reserve count if that value is non-zero.
+     * reserve count if that value is non-zero. It is safe to call this method
+     * from a worker thread.
      *
      * @param key   The asset key to queue.
      */
     void enqueue(const std::string key) {
+        std::lock_guard<std::mutex> lock(_queueMutex);
         _queue.emplace(key);
         if (_reserved) { _reserved--; }
     }
+    
+    /**
+     * Removes an asset from the loading queue.
+     *
+     * This method should be called once an asset has finished loading (or
+     * failed to load). It is safe to call this method from a worker thread.
+     *
+     * @param key   The asset key to remove.
+     */
+    void dequeue(const std::string key) {
+        std::lock_guard<std::mutex> lock(_queueMutex);
+        _queue.erase(key);
+    }
+    
+    /**
+     * Returns true if the given asset is currently in the loading queue.
+     *
+     * It is safe to call this method from a worker thread.
+     *
+     * @param key   The asset key to check.
+     *
+     * @return true if the given asset is currently in the loading queue.
+     */
+    bool queued(const std::string key) const {
+        std::lock_guard<std::mutex> lock(_queueMutex);
+        return _queue.find(key) != _queue.end();
+    }
 
     /**
      * Unloads all assets present in this loader.
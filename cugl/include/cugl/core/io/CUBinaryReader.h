@@ -10,6 +10,13 @@
 //  long, etc.  Those types are NOT cross-platform.  For example, a long is
 //  8 bytes on Unix/OS X, but 4 bytes on Win32 platforms.
 //
+//  Large files are memory mapped when the platform supports it, so they are
+//  read without copying them into a buffer. Otherwise (e.g. Android assets)
+//  the file is read in chunks with an SDL stream.
+//
+//  This reader can also decode JSON trees stored in binary form. The binary
+//  format is CBOR (RFC 8949), which is the format written by BinaryWriter.
+//
 //  By default, this module (and every module in the io package) accesses the
 //  application save directory.  If you want to access another directory, you
 //  will need to specify an absolute path for the file name.  Keep in mind that
@@ -54,9 +61,14 @@
 #define __CU_BINARY_READER_H__
 #include <cugl/core/CUBase.h>
 #include <string>
+#include <string_view>
+#include <memory>
 
 namespace cugl {
 
+/** Forward reference to a JSON tree */
+class JsonValue;
+
 /**
  * Simple cross-platform reader for binary files.
  *
@@ -74,6 +86,13 @@ namespace cugl {
  * for the file name.  Keep in mind that absolute paths are very dangerous on
  * mobile devices, because they do not have proper file systems.  You should
  * confine all files to either the asset or the save directory.
+ *
+ * Files of at least a few kilobytes are memory mapped if the platform allows
+ * it (see {@link filetool#file_map}). A mapped file is never copied; the
+ * operating system pages it in as it is read. This is particularly useful
+ * with {@link #readView}, which returns the file contents without copying
+ * them. Files that cannot be mapped (such as Android assets) are read in
+ * chunks from an SDL stream instead.
  */
 class BinaryReader {
 protected:
@@ -94,9 +113,21 @@ protected:
     Uint32      _bufsize;
     /** The current offset in the read buffer */
     Sint32      _bufoff;
+    /** Whether the read buffer is a memory map of the entire file */
+    bool        _mapped;
     
 #pragma mark -
 #pragma mark Internal Methods
+    /**
+     * Replaces the SDL stream with a memory map of the file, if possible.
+     *
+     * If this method succeeds, the read buffer is the entire file and the
+     * SDL stream is closed. If it fails, the reader is unchanged.
+     *
+     * @return true if the file was memory mapped
+     */
+    bool map();
+    
     /**
      * Fills the storage buffer to capacity
      *
@@ -107,6 +138,33 @@ protected:
      */
     void fill(unsigned int bytes=1);
     
+    /**
+     * Returns the next JSON value in CBOR format from the stream
+     *
+     * This method returns nullptr if the stream does not have a valid value.
+     * The depth is the nesting depth of this value, which is used to guard
+     * against stack overflow on malicious data.
+     *
+     * @param depth The nesting depth of this value
+     *
+     * @return the next JSON value in CBOR format from the stream
+     */
+    std::shared_ptr<JsonValue> readJsonValue(int depth);
+    
+    /**
+     * Returns true if the argument of a CBOR head was read successfully
+     *
+     * The argument is the length of a string or collection, or the value of
+     * an integer. The info value is the lower five bits of the initial byte.
+     * This method fails on indefinite lengths, which are not supported.
+     *
+     * @param info  The additional information of the CBOR head
+     * @param value The variable to store the argument
+     *
+     * @return true if the argument of a CBOR head was read successfully
+     */
+    bool readJsonArgument(Uint8 info, Uint64& value);
+    
     
 #pragma mark -
 #pragma mark Constructors
@@ -118,7 +176,8 @@ public:
      * the heap, use one of the static constructors instead.
      */
     BinaryReader() : _name(""), _stream(nullptr), _ssize(-1), _scursor(-1),
-                     _buffer(nullptr), _capacity(0), _bufoff(-1), _bufsize(0) {}
+                     _buffer(nullptr), _capacity(0), _bufoff(-1), _bufsize(0),
+                     _mapped(false) {}
     
     /**
      * Deletes this reader and all of its resources.
@@ -298,6 +357,16 @@ public:
      */
     bool ready(unsigned int bytes=1) const;
     
+    /**
+     * Returns true if this reader is a memory map of the file.
+     *
+     * A memory mapped reader has no read buffer, and {@link #readView} never
+     * copies any data.
+     *
+     * @return true if this reader is a memory map of the file.
+     */
+    bool isMapped() const { return _mapped; }
+    
     
 #pragma mark -
 #pragma mark Single Element Reads
@@ -561,6 +630,48 @@ public:
      * @return the number of doubles read from the stream
      */
     size_t read(double* buffer, size_t maximum, size_t offset=0);
+    
+    /**
+     * Returns a view of the next sequence of bytes in the stream.
+     *
+     * The view will have up to maximum bytes. It will only have fewer if the
+     * stream does not have that many bytes left. The stream advances past
+     * the bytes in the view.
+     *
+     * If the file is memory mapped, the view is a window into the map and no
+     * data is copied. Otherwise, the bytes are read into the buffer of this
+     * reader, and the buffer will grow if it is smaller than the view. In
+     * either case, the view is only valid until the next read, reset, or
+     * close of this reader. Copy the data if you need it longer than that.
+     *
+     * @param maximum   The maximum number of bytes to view
+     *
+     * @return a view of the next sequence of bytes in the stream.
+     */
+    std::string_view readView(size_t maximum);
+    
+#pragma mark -
+#pragma mark JSON Reads
+    /**
+     * Returns a newly allocated JsonValue for the next value in the stream.
+     *
+     * The value must be encoded in CBOR (RFC 8949), as produced by the method
+     * {@link BinaryWriter#writeJson}. The value may be prefixed by the CBOR
+     * self-describe tag, which is how {@link JsonReader} recognizes a binary
+     * JSON file. Unlike text JSON, the binary value requires no parsing of
+     * tokens or number conversion, so it is much faster to load.
+     *
+     * Only the subset of CBOR that corresponds to JSON is supported. Byte
+     * strings, indefinite lengths, and tags (other than self-describe) are
+     * all rejected. Integers that do not fit in a long are stored as doubles.
+     *
+     * If there is a decoding error, this method will return nullptr. Detailed
+     * information about the error will be passed to an assert. Hence error
+     * messages are suppressed if asserts are turned off.
+     *
+     * @return a newly allocated JsonValue for the next value in the stream.
+     */
+    std::shared_ptr<JsonValue> readJson();
 };
 
 }
@@ -10,6 +10,9 @@
 //  long, etc.  Those types are NOT cross-platform.  For example, a long is
 //  8 bytes on Unix/OS X, but 4 bytes on Win32 platforms.
 //
+//  This writer can also encode JSON trees in binary form. The binary format
+//  is CBOR (RFC 8949), which can be decoded by BinaryReader.
+//
 //  By default, this module (and every module in the io package) accesses the
 //  application save directory.  If you want to access another directory, you
 //  will need to specify an absolute path for the file name.  Keep in mind that
@@ -54,8 +57,12 @@
 #define __CU_BINARY_WRITER_H__
 #include <cugl/core/CUBase.h>
 #include <string>
+#include <memory>
 
 namespace cugl {
+
+/** Forward reference to a JSON tree */
+class JsonValue;
     
 /**
  * Simple cross-platform writer for binary files.
@@ -89,6 +96,26 @@ protected:
     /** The current offset in the writer buffer */
     Sint32      _bufoff;
 
+#pragma mark -
+#pragma mark Internal Methods
+    /**
+     * Writes the head of a CBOR data item to the binary file.
+     *
+     * The head is the major type followed by the argument, which is the
+     * length of a string or collection, or the value of an integer. The
+     * argument is written in the fewest bytes possible.
+     *
+     * @param major The CBOR major type (0-7)
+     * @param value The argument of the head
+     */
+    void writeJsonHead(Uint8 major, Uint64 value);
+    
+    /**
+     * Writes the given JSON value (and its descendants) in CBOR format.
+     *
+     * @param json  The JSON value to write
+     */
+    void writeJsonValue(const JsonValue* json);
     
 #pragma mark -
 #pragma mark Constructors
@@ -499,6 +526,51 @@ public:
      */
     void write(const double* array, size_t length, size_t offset=0);
     
+#pragma mark -
+#pragma mark JSON Writes
+    /**
+     * Writes the given JSON value to the binary file.
+     *
+     * The value is encoded in CBOR (RFC 8949), prefixed by the CBOR
+     * self-describe tag. This tag allows {@link JsonReader} to recognize the
+     * file as binary, so binary JSON files can be used anywhere a text JSON
+     * file is expected. They can be read back with {@link BinaryReader#readJson}.
+     *
+     * Numbers with an integral value are encoded as integers. All other
+     * numbers are encoded as single precision floats if that is lossless,
+     * and as double precision floats otherwise. Objects preserve the order
+     * of their keys.
+     *
+     * The value is written to the internal buffer, but is not necessarily
+     * flushed automatically.  It will be written when the buffer reaches
+     * capacity or the file is closed.
+     *
+     * @param json  The JSON value to write
+     */
+    void writeJson(const std::shared_ptr<JsonValue>& json) {
+        writeJson(json.get());
+    }
+    
+    /**
+     * Writes the given JSON value to the binary file.
+     *
+     * The value is encoded in CBOR (RFC 8949), prefixed by the CBOR
+     * self-describe tag. This tag allows {@link JsonReader} to recognize the
+     * file as binary, so binary JSON files can be used anywhere a text JSON
+     * file is expected. They can be read back with {@link BinaryReader#readJson}.
+     *
+     * Numbers with an integral value are encoded as integers. All other
+     * numbers are encoded as single precision floats if that is lossless,
+     * and as double precision floats otherwise. Objects preserve the order
+     * of their keys.
+     *
+     * The value is written to the internal buffer, but is not necessarily
+     * flushed automatically.  It will be written when the buffer reaches
+     * capacity or the file is closed.
+     *
+     * @param json  The JSON value to write
+     */
+    void writeJson(const JsonValue* json);
 };
 
 }
@@ -4,7 +4,8 @@
 //
 //  This module provides extends the basic TextReader to support JSON decoding.
 //  It does not require that the entire file conform to JSON standards; it can
-//  read a JSON string embedded in a larger text file.
+//  read a JSON string embedded in a larger text file. It also recognizes
+//  binary JSON files (CBOR) so that they can replace JSON assets as is.
 //
 //  By default, this module (and every module in the io package) accesses the
 //  application save directory.  If you want to access another directory, you
@@ -164,13 +165,33 @@ public:
      * @return the next available JSON string
      */
     std::string readJsonString();
+    
+    /**
+     * Returns a view of the next available JSON string
+     *
+     * This method is the same as {@link readJsonString()}, except that it does
+     * not copy the string. If the file is memory mapped, the view is a window
+     * into the map. Otherwise it is a window into the buffer of this reader,
+     * which grows to hold the string if necessary. In either case, the view is
+     * only valid until the next read, reset, or close of this reader.
+     *
+     * @return a view of the next available JSON string
+     */
+    std::string_view readJsonView();
 
     /**
      * Returns a newly allocated JsonValue for the next available JSON string.
      * 
-     * This method uses {@link readJsonString()} to extract the next available
+     * This method uses {@link readJsonView()} to extract the next available
      * JSON string and constructs a JsonValue from that.
      *
+     * If this reader is at the start of a binary JSON file (a file written by
+     * {@link BinaryWriter#writeJson}), this method decodes the entire file
+     * with {@link BinaryReader#readJson} instead. Binary files are recognized
+     * by the CBOR self-describe tag. This allows a binary file to replace a
+     * JSON asset without any changes to the loaders. The reader is finished
+     * after reading a binary file.
+     *
      * If there is a parsing error, this  method will return nullptr.  Detailed
      * information about the parsing error will be passed to an assert.  Hence
      * error messages are suppressed if asserts are turned off.
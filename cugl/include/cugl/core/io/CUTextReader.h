@@ -6,6 +6,10 @@
 //  It supports both ASCII and UTF8 encoding. No other encodings are supported
 //  (nor should they be since they are not cross-platform).
 //
+//  Large files are memory mapped when the platform supports it, so they are
+//  read without copying them into a buffer. Otherwise (e.g. Android assets)
+//  the file is read in chunks with an SDL stream.
+//
 //  By default, this module (and every module in the io package) accesses the
 //  application save directory.  If you want to access another directory, you
 //  will need to specify an absolute path for the file name.  Keep in mind that
@@ -50,6 +54,7 @@
 #define __CU_TEXT_READER_H__
 #include <cugl/core/CUBase.h>
 #include <string>
+#include <string_view>
 
 namespace  cugl {
 
@@ -69,6 +74,13 @@ namespace  cugl {
  * for the file name.  Keep in mind that absolute paths are very dangerous on 
  * mobile devices, because they do not have proper file systems.  You should 
  * confine all files to either the asset or the save directory.
+ *
+ * Files of at least a few kilobytes are memory mapped if the platform allows
+ * it (see {@link filetool#file_map}). A mapped file is never copied; the
+ * operating system pages it in as it is read. This is particularly useful
+ * with {@link #readLineView} and {@link #readAllView}, which return the file
+ * contents without copying them. Files that cannot be mapped (such as Android
+ * assets) are read in chunks from an SDL stream instead.
  */
 class TextReader {
 protected:
@@ -89,6 +101,10 @@ protected:
     Uint32      _capacity;
     /** The current offset in the read buffer */
     Sint32      _bufoff;
+    /** The data read from the file (either the buffer or a memory map) */
+    std::string_view _window;
+    /** Whether the file is memory mapped */
+    bool        _mapped;
 
 #pragma mark -
 #pragma mark Internal Methods
@@ -100,6 +116,28 @@ protected:
      */
     void fill();
     
+    /**
+     * Reads another chunk from the file without discarding any unread data.
+     *
+     * Unlike {@link #fill}, this method grows the storage buffer past its
+     * capacity if necessary. That way the unread data is always contiguous,
+     * which allows the read methods to return views. This method returns
+     * false if there was no more data to read.
+     *
+     * @return true if more data was read from the file
+     */
+    bool expand();
+    
+    /**
+     * Replaces the SDL stream with a memory map of the file, if possible.
+     *
+     * If this method succeeds, the window is the entire file and the SDL
+     * stream is closed. If it fails, the reader is unchanged.
+     *
+     * @return true if the file was memory mapped
+     */
+    bool map();
+    
 #pragma mark -
 #pragma mark Constructors
 public:
@@ -110,7 +148,8 @@ public:
      * the heap, use one of the static constructors instead.
      */
     TextReader() : _name(""), _stream(nullptr), _ssize(-1), _scursor(-1),
-                   _sbuffer(""), _cbuffer(nullptr), _capacity(0), _bufoff(-1) {}
+                   _sbuffer(""), _cbuffer(nullptr), _capacity(0), _bufoff(-1),
+                   _mapped(false) {}
     
     /**
      * Deletes this reader and all of its resources.
@@ -286,7 +325,16 @@ public:
      *
      * @return true if there is still data to read
      */
-    bool ready() const { return _bufoff < _sbuffer.size() || _scursor < _ssize; }
+    bool ready() const { return _bufoff < _window.size() || _scursor < _ssize; }
+    
+    /**
+     * Returns true if this reader is a memory map of the file.
+     *
+     * The views returned by a memory mapped reader never copy any data.
+     *
+     * @return true if this reader is a memory map of the file.
+     */
+    bool isMapped() const { return _mapped; }
     
     
 #pragma mark -
@@ -372,6 +420,20 @@ public:
      */
     std::string& readLine(std::string& data);
     
+    /**
+     * Returns a view of a single line of text from the stream
+     *
+     * This method is the same as {@link #readLine}, except that it does not
+     * copy the line. If the file is memory mapped, the view is a window into
+     * the map. Otherwise it is a window into the buffer of this reader, which
+     * grows to hold the line if necessary. In either case, the view is only
+     * valid until the next read, reset, or close of this reader. The view
+     * does not include the newline.
+     *
+     * @return a view of a single line of text from the stream
+     */
+    std::string_view readLineView();
+    
     /**
      * Returns the unread remainder of the stream
      *
@@ -395,6 +457,19 @@ public:
      * @return the argument with the remainder of the stream appended.
      */
     std::string& readAll(std::string& data);
+    
+    /**
+     * Returns a view of the unread remainder of the stream
+     *
+     * This method is the same as {@link #readAll}, except that it does not
+     * copy the data. If the file is memory mapped, the view is a window into
+     * the map. Otherwise the remainder of the file is read into the buffer
+     * of this reader with a single read. In either case, the view is only
+     * valid until the next read, reset, or close of this reader.
+     *
+     * @return a view of the unread remainder of the stream
+     */
+    std::string_view readAllView();
 
     /**
      * Skips over any whitespace in the stream.
@@ -0,0 +1,296 @@
+//
+//  CUAABBTree.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides support for a dynamic bounding volume hierarchy. It
+//  is a binary tree of axis-aligned bounding boxes, and is intended for
+//  broad-phase queries such as view culling. Each leaf of the tree is a proxy
+//  for a user object, and the tree can be queried for all proxies whose
+//  bounds intersect a rectangle.
+//
+//  The design of this tree follows the dynamic tree in Box2D. Leaves are
+//  stored with "fat" bounds, so objects that move a small amount do not need
+//  to be reinserted. The tree is kept balanced with AVL-style rotations.
+//
+//  Because math objects are intended to be on the stack, we do not provide
+//  any shared pointer support in this class.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty. In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Author: Walker White
+//  Version: 7/3/24 (CUGL 3.0 reorganization)
+//
+#ifndef __CU_AABB_TREE_H__
+#define __CU_AABB_TREE_H__
+
+#include <cugl/core/math/CURect.h>
+#include <vector>
+
+namespace cugl {
+
+/**
+ * This class is a dynamic tree of axis-aligned bounding boxes.
+ *
+ * Each object in the tree is represented by a proxy, which is the integer
+ * returned by {@link #insert}. A proxy stores the bounds of the object and
+ * an opaque user pointer. Proxy identifiers are stable until the proxy is
+ * removed, at which point they may be recycled.
+ *
+ * The bounds stored in the tree are enlarged by the margin of the tree. When
+ * a proxy is updated, it is only reinserted if its new bounds escape these
+ * enlarged bounds. Hence objects that jitter or move slowly are cheap to
+ * maintain. A query may return proxies whose actual bounds are just outside
+ * of the query rectangle, but it will never miss a proxy that intersects it.
+ *
+ * Insertion, removal, and update are O(log n) for a balanced tree. A query
+ * is O(log n + k) where k is the number of proxies returned.
+ */
+class AABBTree {
+#pragma mark Values
+private:
+    /** A node in the tree (either a leaf or an internal node) */
+    class Node {
+    public:
+        /** The (enlarged) bounds of this node */
+        Rect bounds;
+        /** The user data for a leaf node */
+        void* data;
+        /** The parent node, or the next free node if this node is unused */
+        Sint32 parent;
+        /** The left child (-1 for a leaf) */
+        Sint32 left;
+        /** The right child (-1 for a leaf) */
+        Sint32 right;
+        /** The height of this node (0 for a leaf, -1 if unused) */
+        Sint32 height;
+
+        /**
+         * Returns true if this node is a leaf
+         *
+         * @return true if this node is a leaf
+         */
+        bool isLeaf() const { return left == -1; }
+    };
+
+    /** The node pool */
+    std::vector<Node> _nodes;
+    /** The root node of the tree (-1 if empty) */
+    Sint32 _root;
+    /** The head of the free list (-1 if none) */
+    Sint32 _free;
+    /** The number of proxies in the tree */
+    size_t _count;
+    /** The amount to enlarge each proxy on insertion */
+    float _margin;
+    /** A stack for traversing the tree (to avoid allocation on queries) */
+    mutable std::vector<Sint32> _stack;
+
+#pragma mark -
+#pragma mark Constructors
+public:
+    /**
+     * Creates an empty tree with the given margin.
+     *
+     * The margin is the amount each proxy is enlarged (on each side) when it
+     * is inserted into the tree. A larger margin means fewer reinsertions
+     * for moving objects, at the cost of less precise queries.
+     *
+     * @param margin    The amount to enlarge each proxy
+     */
+    AABBTree(float margin=0.0f);
+
+    /**
+     * Deletes this tree, releasing all resources.
+     */
+    ~AABBTree() {}
+
+    /**
+     * Removes all proxies from this tree.
+     *
+     * All proxy identifiers are invalid after this call.
+     */
+    void clear();
+
+#pragma mark -
+#pragma mark Proxies
+    /**
+     * Returns the amount each proxy is enlarged in the tree
+     *
+     * @return the amount each proxy is enlarged in the tree
+     */
+    float getMargin() const { return _margin; }
+
+    /**
+     * Returns the number of proxies in this tree
+     *
+     * @return the number of proxies in this tree
+     */
+    size_t size() const { return _count; }
+
+    /**
+     * Returns the height of this tree
+     *
+     * An empty tree has height 0, as does a tree with a single proxy.
+     *
+     * @return the height of this tree
+     */
+    Sint32 getHeight() const {
+        return _root == -1 ? 0 : _nodes[_root].height;
+    }
+
+    /**
+     * Returns a new proxy for the given bounds and user data.
+     *
+     * The bounds are enlarged by the margin of this tree. The user data is
+     * not retained, and it is the responsibility of the caller to remove the
+     * proxy before that data is deleted.
+     *
+     * @param bounds    The object bounds
+     * @param data      The user data
+     *
+     * @return a new proxy for the given bounds and user data.
+     */
+    Sint32 insert(const Rect& bounds, void* data);
+
+    /**
+     * Removes the given proxy from this tree.
+     *
+     * The proxy identifier may be recycled after this call.
+     *
+     * @param proxy     The proxy to remove
+     */
+    void remove(Sint32 proxy);
+
+    /**
+     * Updates the bounds of the given proxy.
+     *
+     * The proxy is only reinserted if the new bounds are not contained in
+     * its enlarged bounds. This method returns true if the proxy was
+     * reinserted.
+     *
+     * @param proxy     The proxy to update
+     * @param bounds    The new object bounds
+     *
+     * @return true if the proxy was reinserted
+     */
+    bool update(Sint32 proxy, const Rect& bounds);
+
+    /**
+     * Returns the user data for the given proxy
+     *
+     * @param proxy     The proxy identifier
+     *
+     * @return the user data for the given proxy
+     */
+    void* getData(Sint32 proxy) const { return _nodes[proxy].data; }
+
+    /**
+     * Returns the (enlarged) bounds of the given proxy
+     *
+     * @param proxy     The proxy identifier
+     *
+     * @return the (enlarged) bounds of the given proxy
+     */
+    const Rect& getBounds(Sint32 proxy) const { return _nodes[proxy].bounds; }
+
+    /**
+     * Returns the (enlarged) bounds of every proxy in this tree
+     *
+     * If the tree is empty, this method returns the zero rectangle.
+     *
+     * @return the (enlarged) bounds of every proxy in this tree
+     */
+    Rect getBounds() const {
+        return _root == -1 ? Rect::ZERO : _nodes[_root].bounds;
+    }
+
+#pragma mark -
+#pragma mark Queries
+    /**
+     * Appends the user data of every proxy intersecting the rectangle.
+     *
+     * The results are appended to the given vector, which is not cleared.
+     * They are in no particular order.
+     *
+     * @param rect      The query rectangle
+     * @param results   The vector to store the results
+     *
+     * @return the number of proxies found
+     */
+    size_t query(const Rect& rect, std::vector<void*>& results) const;
+
+private:
+#pragma mark -
+#pragma mark Internal Helpers
+    /**
+     * Returns a node from the pool, growing it if necessary.
+     *
+     * @return a node from the pool
+     */
+    Sint32 allocNode();
+
+    /**
+     * Returns the given node to the pool.
+     *
+     * @param node  The node to release
+     */
+    void freeNode(Sint32 node);
+
+    /**
+     * Inserts the given leaf node into the tree.
+     *
+     * The sibling is chosen with the surface area heuristic, which for 2d
+     * bounds means minimizing the total perimeter.
+     *
+     * @param leaf  The leaf to insert
+     */
+    void insertLeaf(Sint32 leaf);
+
+    /**
+     * Removes the given leaf node from the tree.
+     *
+     * The node is not returned to the pool.
+     *
+     * @param leaf  The leaf to remove
+     */
+    void removeLeaf(Sint32 leaf);
+
+    /**
+     * Refits the bounds and heights from the given node to the root.
+     *
+     * This method rebalances the tree along the way.
+     *
+     * @param node  The node to start from
+     */
+    void refit(Sint32 node);
+
+    /**
+     * Performs a left or right rotation if the given node is imbalanced.
+     *
+     * @param iA    The node to balance
+     *
+     * @return the new root of the subtree
+     */
+    Sint32 balance(Sint32 iA);
+};
+
+}
+
+#endif /* __CU_AABB_TREE_H__ */
@@ -1049,6 +1049,35 @@ public:
      * The vector is array is treated as a list of 2 element vectors (@see Vec2).
      * The transform is applied in order and written to the output array.
      *
+     * The strides are the distance (in floats) between the start of each
+     * vector. The default stride of 2 is a tightly packed array. A larger
+     * stride allows this method to transform the positions of an array of
+     * vertices (e.g. {@link graphics::SpriteVertex}) in place.
+     *
+     * This method uses SSE, AVX2, or NEON instructions where available. The
+     * input and output may be the same array, but they should not otherwise
+     * overlap.
+     *
+     * @param aff       The transform matrix.
+     * @param input     The array of vectors to transform.
+     * @param output    The array to store the transformed vectors.
+     * @param size      The number of vectors to transform.
+     * @param istride   The stride of the input array
+     * @param ostride   The stride of the output array
+     *
+     * @return A reference to dst for chaining
+     */
+    static float* transform(const Affine2& aff, float const* input, float* output, size_t size,
+                            size_t istride=2, size_t ostride=2);
+
+    /**
+     * Transforms the vector array, and stores the result in dst.
+     *
+     * The transform is applied in order and written to the output array.
+     * This method uses SSE, AVX2, or NEON instructions where available. The
+     * input and output may be the same array, but they should not otherwise
+     * overlap.
+     *
      * @param aff       The transform matrix.
      * @param input     The array of vectors to transform.
      * @param output    The array to store the transformed vectors.
@@ -1056,7 +1085,27 @@ public:
      *
      * @return A reference to dst for chaining
      */
-    static float* transform(const Affine2& aff, float const* input, float* output, size_t size);
+    static Vec2* transform(const Affine2& aff, const Vec2* input, Vec2* output, size_t size);
+
+    /**
+     * Transforms the vectors given as separate coordinate arrays.
+     *
+     * This is the structure-of-arrays version of {@link #transform}. The
+     * x-coordinates and y-coordinates are stored in separate arrays, which
+     * is the fastest layout for vectorized code. The transformed values are
+     * written to xout and yout. This method uses SSE, AVX2, or NEON
+     * instructions where available. The output arrays may be the same as
+     * the input arrays, but they should not otherwise overlap.
+     *
+     * @param aff   The transform matrix.
+     * @param xin   The x-coordinates to transform.
+     * @param yin   The y-coordinates to transform.
+     * @param xout  The array to store the transformed x-coordinates.
+     * @param yout  The array to store the transformed y-coordinates.
+     * @param size  The size of the four arrays.
+     */
+    static void transform(const Affine2& aff, const float* xin, const float* yin,
+                          float* xout, float* yout, size_t size);
 
     /**
      * Transforms the rectangle and stores the result in dst.
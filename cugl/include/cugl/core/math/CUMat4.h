@@ -939,6 +939,8 @@ public:
      * The matrix m2 is on the right. This means that it corresponds to
      * an subsequent transform, when looking at a sequence of transforms.
      *
+     * This method uses SSE or NEON instructions where available.
+     *
      * @param m1    The first matrix to multiply.
      * @param m2    The second matrix to multiply.
      * @param dst   A matrix to store the result in.
@@ -953,6 +955,8 @@ public:
      * The matrix m2 is on the right. This means that it corresponds to
      * an subsequent transform, when looking at a sequence of transforms.
      *
+     * This method uses SSE or NEON instructions where available.
+     *
      * This method assumes the float arrays are in column major order.
      *
      * @param m1    The first matrix to multiply in column-major order
@@ -989,7 +993,7 @@ public:
      * Inverts m1 and stores the result in dst.
      *
      * If the matrix cannot be inverted, this method stores the zero matrix
-     * in dst.
+     * in dst. This method uses SSE or NEON instructions where available.
      *
      * @param m1    The matrix to invert.
      * @param dst   A matrix to store the result in.
@@ -1002,7 +1006,7 @@ public:
      * Inverts m1 and stores the result in dst.
      *
      * If the matrix cannot be inverted, this method stores the zero matrix
-     * in dst.
+     * in dst. This method uses SSE or NEON instructions where available.
      *
      * This method assumes the float arrays are in column major order.
      *
@@ -1608,6 +1612,10 @@ public:
      * The vector is array is treated as a list of 4 element vectors (@see Vec4).
      * The transform is applied in order and written to the output array.
      *
+     * This method uses SSE, AVX2, or NEON instructions where available. The
+     * input and output may be the same array, but they should not otherwise
+     * overlap.
+     *
      * @param mat   	The transform matrix.
      * @param input   	The array of vectors to transform.
      * @param output	The array to store the transformed vectors.
@@ -1624,6 +1632,10 @@ public:
      * The transform is applied in order and written to the output array. The
      * float array for the matrix should be in column major order
      *
+     * This method uses SSE, AVX2, or NEON instructions where available. The
+     * input and output may be the same array, but they should not otherwise
+     * overlap.
+     *
      * @param mat       The transform matrix in column major order
      * @param input     The array of vectors to transform.
      * @param output    The array to store the transformed vectors.
@@ -1633,6 +1645,25 @@ public:
      */
     static float* transform(const float* mat, float const* input, float* output, size_t size);
 
+    /**
+     * Transforms the point array by the given matrix, and stores the result in dst.
+     *
+     * Each point is treated as a 4 element vector with w = 1. The result is
+     * not normalized, so the output contains the homogenous coordinates of
+     * each point. This is what a vertex shader would compute, and is useful
+     * for projecting many points with a camera matrix at once.
+     *
+     * This method uses SSE or NEON instructions where available.
+     *
+     * @param mat       The transform matrix.
+     * @param input     The array of points to transform.
+     * @param output    The array to store the transformed vectors.
+     * @param size      The size of the two arrays.
+     *
+     * @return A reference to dst for chaining
+     */
+    static Vec4* transform(const Mat4& mat, const Vec3* input, Vec4* output, size_t size);
+
 
 #pragma mark -
 #pragma mark Vector Operations
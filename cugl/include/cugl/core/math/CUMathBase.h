@@ -71,6 +71,22 @@ typedef Uint32 CUEnum;
 	#include <cpu-features.h>
 #endif
 
+// Vectorized math support (define CU_MATH_NO_SIMD to disable)
+#if !defined (CU_MATH_NO_SIMD)
+    #if defined (__SSE__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 1)
+        #define CU_MATH_VECTOR_SSE      1
+        #if defined (__AVX2__) && defined (__FMA__)
+            #define CU_MATH_VECTOR_AVX2 1
+            #include <immintrin.h>
+        #else
+            #include <xmmintrin.h>
+        #endif
+    #elif defined (__ARM_NEON) && defined (__aarch64__)
+        #define CU_MATH_VECTOR_NEON64   1
+        #include <arm_neon.h>
+    #endif
+#endif
+
 /**
  * Returns value, clamped to the range [min,max]
  *
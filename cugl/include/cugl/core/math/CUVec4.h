@@ -393,9 +393,9 @@ public:
      */
     Vec4& add(const Vec4 v) {
     #if defined CU_MATH_VECTOR_SSE
-        this->v = _mm_add_ps(this->v,v.v);
+        _mm_storeu_ps(&x,_mm_add_ps(_mm_loadu_ps(&x),_mm_loadu_ps(&v.x)));
     #elif defined CU_MATH_VECTOR_NEON64
-        this->v = vaddq_f32(this->v,v.v);
+        vst1q_f32(&x,vaddq_f32(vld1q_f32(&x),vld1q_f32(&v.x)));
     #else
         x += v.x; y += v.y; z += v.z;  w += v.w;
     #endif
@@ -41,6 +41,7 @@
 #include "CUColor4.h"
 #include "CUSize.h"
 #include "CURect.h"
+#include "CUAABBTree.h"
 #include "CUPolynomial.h"
 #include "CUPoly2.h"
 #include "CUPath2.h"
@@ -0,0 +1,332 @@
+//
+//  CUClipperBatch.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a batch interface to the Clipper library. Clipper
+//  performs boolean operations (union, intersection, and so on) and offsets
+//  on one set of polygons at a time. Games that clip many independent
+//  shapes each frame (e.g. tiled terrain or fog-of-war) can instead queue
+//  the operations as jobs in this class and run them all at once across a
+//  thread pool.
+//
+//  Each thread in the calculation has its own Clipper instances, and these
+//  are reused across jobs and across calculations.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty. In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Author: Walker White
+//  Version: 7/3/24 (CUGL 3.0 reorganization)
+//
+#ifndef __CU_CLIPPER_BATCH_H__
+#define __CU_CLIPPER_BATCH_H__
+
+#include <cugl/core/math/polygon/clipper.hpp>
+#include <memory>
+#include <vector>
+
+namespace cugl {
+
+// Forward declarations
+class ThreadPool;
+
+/**
+ * This class runs a batch of independent Clipper operations in parallel.
+ *
+ * Each job in the batch is either a boolean operation on a subject and
+ * a clip polygon set, or an offset of a polygon set. Jobs are added with
+ * {@link #addClip} and {@link #addOffset}, which return the job position.
+ * Calling {@link #calculate} runs all of the jobs, distributing them across
+ * the thread pool (if there is one). The calling thread participates in the
+ * calculation, and the method returns once all of the jobs are complete.
+ * The results are then available by position with {@link #getSolution}.
+ *
+ * Each thread has its own Clipper and ClipperOffset instances, which are
+ * reused for every job that thread processes. The batch keeps these
+ * instances between calculations, so a batch that is cleared and refilled
+ * every frame does not reallocate them.
+ *
+ * As with Clipper, all coordinates are integers. To clip float geometry,
+ * scale it by a resolution factor (as {@link ComplexExtruder} does).
+ *
+ * This class is not thread safe. Jobs should only be added, calculated, and
+ * read by one thread at a time.
+ */
+class ClipperBatch {
+public:
+    /**
+     * A single Clipper operation in the batch.
+     */
+    class Job {
+    public:
+        /** Whether this job is an offset (as opposed to a boolean operation) */
+        bool offset;
+        /** The boolean operation (if this is not an offset) */
+        ClipperLib::ClipType clipType;
+        /** The fill rule for both the subject and the clip polygons */
+        ClipperLib::PolyFillType fillType;
+        /** The offset joint type (if this is an offset) */
+        ClipperLib::JoinType joinType;
+        /** The offset end type (if this is an offset) */
+        ClipperLib::EndType endType;
+        /** The offset distance (if this is an offset) */
+        double delta;
+        /** The subject polygons (or the polygons to offset) */
+        ClipperLib::Paths subject;
+        /** The clip polygons (if this is not an offset) */
+        ClipperLib::Paths clip;
+        /** The result of this job */
+        ClipperLib::Paths solution;
+        /** Whether this job was successful */
+        bool success;
+
+        /**
+         * Creates an empty union job
+         */
+        Job() :
+        offset(false),
+        clipType(ClipperLib::ctUnion),
+        fillType(ClipperLib::pftNonZero),
+        joinType(ClipperLib::jtRound),
+        endType(ClipperLib::etClosedPolygon),
+        delta(0),
+        success(false) {}
+    };
+
+private:
+    /** An internal class for the state of a calculation */
+    class State;
+
+    /** The jobs in this batch */
+    std::vector<Job> _jobs;
+    /** The thread pool for the calculation (may be nullptr) */
+    std::shared_ptr<ThreadPool> _threads;
+    /** The state of the most recent calculation */
+    std::shared_ptr<State> _state;
+    /** The miter limit for offsets */
+    double _miterLimit;
+    /** The arc tolerance for offsets */
+    double _arcTolerance;
+
+public:
+#pragma mark Constructors
+    /**
+     * Creates a degenerate clipper batch.
+     *
+     * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an object on
+     * the heap, use one of the static constructors instead.
+     */
+    ClipperBatch();
+
+    /**
+     * Deletes this clipper batch, disposing all resources
+     */
+    ~ClipperBatch() { dispose(); }
+
+    /**
+     * Disposes all of the resources used by this batch.
+     *
+     * A disposed batch can be safely reinitialized.
+     */
+    void dispose();
+
+    /**
+     * Initializes a clipper batch for the given thread pool.
+     *
+     * If the thread pool is nullptr, the jobs are run on the calling thread.
+     * The thread pool may be shared with other parts of the application.
+     *
+     * @param threads   The thread pool for the calculation
+     *
+     * @return true if initialization was successful.
+     */
+    bool init(const std::shared_ptr<ThreadPool>& threads);
+
+    /**
+     * Returns a newly allocated clipper batch for the given thread pool.
+     *
+     * If the thread pool is nullptr, the jobs are run on the calling thread.
+     * The thread pool may be shared with other parts of the application.
+     *
+     * @param threads   The thread pool for the calculation
+     *
+     * @return a newly allocated clipper batch for the given thread pool.
+     */
+    static std::shared_ptr<ClipperBatch> alloc(const std::shared_ptr<ThreadPool>& threads) {
+        std::shared_ptr<ClipperBatch> result = std::make_shared<ClipperBatch>();
+        return (result->init(threads) ? result : nullptr);
+    }
+
+#pragma mark Attributes
+    /**
+     * Returns the thread pool for the calculation.
+     *
+     * If this value is nullptr, the jobs are run on the calling thread.
+     *
+     * @return the thread pool for the calculation.
+     */
+    const std::shared_ptr<ThreadPool>& getThreadPool() const { return _threads; }
+
+    /**
+     * Returns the miter limit for offset jobs.
+     *
+     * See the Clipper documentation for ClipperOffset::MiterLimit.
+     *
+     * @return the miter limit for offset jobs.
+     */
+    double getMiterLimit() const { return _miterLimit; }
+
+    /**
+     * Sets the miter limit for offset jobs.
+     *
+     * See the Clipper documentation for ClipperOffset::MiterLimit.
+     *
+     * @param limit The miter limit for offset jobs
+     */
+    void setMiterLimit(double limit) { _miterLimit = limit; }
+
+    /**
+     * Returns the arc tolerance for offset jobs.
+     *
+     * See the Clipper documentation for ClipperOffset::ArcTolerance.
+     *
+     * @return the arc tolerance for offset jobs.
+     */
+    double getArcTolerance() const { return _arcTolerance; }
+
+    /**
+     * Sets the arc tolerance for offset jobs.
+     *
+     * See the Clipper documentation for ClipperOffset::ArcTolerance.
+     *
+     * @param tolerance The arc tolerance for offset jobs
+     */
+    void setArcTolerance(double tolerance) { _arcTolerance = tolerance; }
+
+#pragma mark Jobs
+    /**
+     * Adds a boolean operation to this batch.
+     *
+     * The polygon sets are copied. The batch does not retain any references
+     * to the original data.
+     *
+     * @param type      The boolean operation
+     * @param subject   The subject polygons
+     * @param clip      The clip polygons
+     * @param fill      The fill rule for both polygon sets
+     *
+     * @return the position of the new job
+     */
+    size_t addClip(ClipperLib::ClipType type,
+                   const ClipperLib::Paths& subject, const ClipperLib::Paths& clip,
+                   ClipperLib::PolyFillType fill = ClipperLib::pftNonZero);
+
+    /**
+     * Adds an offset operation to this batch.
+     *
+     * The polygon set is copied. The batch does not retain any references
+     * to the original data. A positive delta grows closed polygons, while a
+     * negative delta shrinks them.
+     *
+     * @param paths     The polygons to offset
+     * @param delta     The offset distance
+     * @param joint     The joint type
+     * @param end       The end type
+     *
+     * @return the position of the new job
+     */
+    size_t addOffset(const ClipperLib::Paths& paths, double delta,
+                     ClipperLib::JoinType joint = ClipperLib::jtRound,
+                     ClipperLib::EndType end = ClipperLib::etClosedPolygon);
+
+    /**
+     * Returns the number of jobs in this batch.
+     *
+     * @return the number of jobs in this batch.
+     */
+    size_t size() const { return _jobs.size(); }
+
+    /**
+     * Returns the job at the given position.
+     *
+     * @param pos   The job position
+     *
+     * @return the job at the given position.
+     */
+    const Job& getJob(size_t pos) const { return _jobs.at(pos); }
+
+    /**
+     * Removes all jobs from this batch.
+     *
+     * The Clipper instances are retained for the next calculation.
+     */
+    void clear() { _jobs.clear(); }
+
+#pragma mark Calculation
+    /**
+     * Performs all of the jobs in this batch.
+     *
+     * The jobs are distributed across the thread pool, and the calling
+     * thread processes jobs as well. This method blocks until all of the
+     * jobs are complete. Jobs are independent, so the order in which they
+     * are processed is undefined.
+     */
+    void calculate();
+
+    /**
+     * Returns the solution of the job at the given position.
+     *
+     * The solution is empty if the calculation has not been performed.
+     *
+     * @param pos   The job position
+     *
+     * @return the solution of the job at the given position.
+     */
+    const ClipperLib::Paths& getSolution(size_t pos) const {
+        return _jobs.at(pos).solution;
+    }
+
+    /**
+     * Returns true if the job at the given position was successful.
+     *
+     * This is false if the calculation has not been performed.
+     *
+     * @param pos   The job position
+     *
+     * @return true if the job at the given position was successful.
+     */
+    bool isSuccessful(size_t pos) const {
+        return _jobs.at(pos).success;
+    }
+};
+
+}
+
+#endif /* __CU_CLIPPER_BATCH_H__ */
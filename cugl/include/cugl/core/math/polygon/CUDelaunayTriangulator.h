@@ -10,6 +10,10 @@
 //
 //      https://github.com/jhasse/poly2tri
 //
+//  Steiner points may also be inserted into (or removed from) a computed
+//  triangulation incrementally, which restores the Delaunay property with
+//  local edge flips instead of running poly2tri again.
+//
 //  Because math objects are intended to be on the stack, we do not provide
 //  any shared pointer support in this class.
 //
@@ -41,6 +45,8 @@
 #include <cugl/core/math/CUPoly2.h>
 #include <poly2tri/poly2tri.h>
 #include <unordered_map>
+#include <utility>
+#include <memory>
 #include <deque>
 #include <vector>
 
@@ -49,6 +55,7 @@ namespace cugl {
 // Forward declarations
 class Path2;
 class Poly2;
+class TriangulationCache;
 
 /**
  * This class is a factory for producing solid Poly2 objects from a set of vertices.
@@ -114,6 +121,9 @@ private:
     bool _dualated;
     /** The Vornoi diagram as a collection of solid Polys */
     std::unordered_map<Uint32, Poly2> _voronoi;
+    
+    /** The (optional) cache for the triangulation results */
+    std::shared_ptr<TriangulationCache> _cache;
 
 public:
     /**
@@ -329,6 +339,91 @@ public:
      */
     void calculateDual();
 
+    /**
+     * Sets the cache for the triangulation results.
+     *
+     * If this triangulator has a cache, {@link #calculate} will first look
+     * for a previous triangulation of the same input (including holes and
+     * Steiner points) and only triangulate on a miss. This is useful for
+     * shapes that are retriangulated often, such as animated or editable
+     * shapes. The cache may be shared with other triangulators.
+     *
+     * A cached triangulation does not have the poly2tri data necessary for
+     * the Voronoi diagram, and so {@link #calculateDual} will triangulate
+     * again if necessary. A nullptr value will disable caching (the default).
+     *
+     * @param cache     The cache for the triangulation results
+     */
+    void setCache(const std::shared_ptr<TriangulationCache>& cache) {
+        _cache = cache;
+    }
+
+    /**
+     * Returns the cache for the triangulation results.
+     *
+     * If this value is nullptr, the triangulator does not cache its results.
+     *
+     * @return the cache for the triangulation results.
+     */
+    const std::shared_ptr<TriangulationCache>& getCache() const {
+        return _cache;
+    }
+
+#pragma mark Incremental Updates
+    /**
+     * Inserts the given Steiner point into the current triangulation.
+     *
+     * If the triangulation has not been computed, this method is the same
+     * as {@link #addSteiner}. Otherwise, it splits the triangle containing
+     * the point and restores the Delaunay property with edge flips. This is
+     * linear in the size of the triangulation, as opposed to recomputing it
+     * from scratch.
+     *
+     * The point must be strictly inside the triangulation (not in a hole or
+     * on the boundary), and it may not coincide with an existing vertex. If
+     * it is not, this method returns false and the point is not added.
+     * Otherwise, the point is added after all other Steiner points, just as
+     * with {@link #addSteiner}.
+     *
+     * Any incremental change discards the Voronoi diagram, which must be
+     * recomputed with {@link #calculateDual}.
+     *
+     * @param point     The Steiner point
+     *
+     * @return true if the point was inserted
+     */
+    bool insertSteiner(Vec2 point);
+
+    /**
+     * Removes the given Steiner point from the current triangulation.
+     *
+     * The index is the position of the point among the Steiner points (in
+     * the order they were added), not its position in the vertex list. All
+     * later Steiner points move down one position. Hull and hole vertices
+     * are constraints, and cannot be removed.
+     *
+     * If the triangulation has not been computed, this method simply
+     * removes the point from the input. Otherwise, it retriangulates the
+     * region around the point and restores the Delaunay property with edge
+     * flips. This is linear in the size of the triangulation, as opposed to
+     * recomputing it from scratch.
+     *
+     * Any incremental change discards the Voronoi diagram, which must be
+     * recomputed with {@link #calculateDual}.
+     *
+     * @param index     The Steiner point position
+     *
+     * @return true if the point was removed
+     */
+    bool removeSteiner(size_t index);
+
+    /**
+     * Returns the number of Steiner points in this triangulator.
+     *
+     * @return the number of Steiner points in this triangulator.
+     */
+    size_t getSteinerCount() const { return _stein.size(); }
+
 #pragma mark Materialization
     /**
      * Returns a list of indices representing the triangulation.
@@ -526,6 +621,44 @@ public:
 #pragma mark Internal Helpers
 
 private:
+    /**
+     * Collects the input vertices into a single list in index order.
+     *
+     * This rebuilds both the vertex list and the reverse look-up table. It
+     * must be called whenever the input changes, as the vertex list stores
+     * pointers into the input.
+     */
+    void gatherVertices();
+
+    /**
+     * Triangulates the current vertex data with poly2tri.
+     *
+     * This is the uncached calculation. It assumes the triangulator has
+     * been reset.
+     */
+    void triangulate();
+
+    /**
+     * Restores the Delaunay property after an incremental change.
+     *
+     * The list contains directed edges that may be illegal. Each edge is
+     * checked against the triangle on the opposite side, and flipped if
+     * the opposite vertex is inside the circumcircle. The edges of a
+     * flipped quadrilateral are then checked in turn. Boundary edges have
+     * no opposite triangle, and so the constraints are never flipped.
+     *
+     * @param edges The edges to check (consumed by this method)
+     */
+    void legalize(std::vector<std::pair<Uint32,Uint32>>& edges);
+
+    /**
+     * Discards the poly2tri state after an incremental change.
+     *
+     * This rebuilds the vertex list and drops the Voronoi diagram, as
+     * neither are valid once the input has changed.
+     */
+    void invalidate();
+
     /**
      * Returns the boundary points for the given Voronoi region.
      *
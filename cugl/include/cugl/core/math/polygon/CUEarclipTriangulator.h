@@ -39,6 +39,7 @@
 #define __CU_EARCLIP_TRIANGULATOR_H__
 
 #include <cugl/core/math/CUVec2.h>
+#include <memory>
 #include <vector>
 
 namespace cugl {
@@ -46,6 +47,7 @@ namespace cugl {
 // Forward declarations
 class Path2;
 class Poly2;
+class TriangulationCache;
 
 /**
  * This class is a factory for producing solid Poly2 objects from a set of vertices.
@@ -98,6 +100,8 @@ private:
     
     /** Whether or not the calculation has been run */
     bool _calculated;
+    /** The (optional) cache for the triangulation results */
+    std::shared_ptr<TriangulationCache> _cache;
 
 #pragma mark -
 #pragma mark Constructors
@@ -285,6 +289,34 @@ public:
      */
     void calculate();
     
+    /**
+     * Sets the cache for the triangulation results.
+     *
+     * If this triangulator has a cache, {@link #calculate} will first look
+     * for a previous triangulation of the same input (including holes)
+     * and only triangulate on a miss. This is useful for shapes that are
+     * retriangulated often, such as animated or editable shapes. The cache
+     * may be shared with other triangulators.
+     *
+     * A nullptr value will disable caching (the default).
+     *
+     * @param cache     The cache for the triangulation results
+     */
+    void setCache(const std::shared_ptr<TriangulationCache>& cache) {
+        _cache = cache;
+    }
+
+    /**
+     * Returns the cache for the triangulation results.
+     *
+     * If this value is nullptr, the triangulator does not cache its results.
+     *
+     * @return the cache for the triangulation results.
+     */
+    const std::shared_ptr<TriangulationCache>& getCache() const {
+        return _cache;
+    }
+
 #pragma mark -
 #pragma mark Materialization
     /**
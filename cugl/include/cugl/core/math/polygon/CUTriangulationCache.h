@@ -0,0 +1,258 @@
+//
+//  CUTriangulationCache.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a cache of triangulation results. Triangulation is
+//  an expensive operation (earclipping is O(n^2)), but shapes that are
+//  animated or edited often cycle through the same outlines. This cache
+//  allows a triangulator to skip the calculation when it has seen the
+//  exact same input before.
+//
+//  Entries are keyed by a content hash of the input vertices (and hole
+//  layout), computed with cugl::hashtool. The cache has a fixed capacity,
+//  and evicts the least recently used entry when it is full.
+//
+//  Unlike the triangulators, this class is intended to be shared, and so it
+//  uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty. In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Author: Walker White
+//  Version: 7/3/24 (CUGL 3.0 reorganization)
+//
+#ifndef __CU_TRIANGULATION_CACHE_H__
+#define __CU_TRIANGULATION_CACHE_H__
+
+#include <cugl/core/math/CUVec2.h>
+#include <unordered_map>
+#include <memory>
+#include <vector>
+#include <mutex>
+#include <list>
+
+namespace cugl {
+
+/**
+ * This class is a cache of triangulation results.
+ *
+ * The cache maps a content hash of the triangulator input to the indices
+ * of the resulting triangulation. To use the cache, attach it to a
+ * triangulator with {@link EarclipTriangulator#setCache} or
+ * {@link DelaunayTriangulator#setCache}. When the triangulator performs a
+ * calculation, it will first check the cache and only triangulate on a
+ * miss. The same cache may be shared by several triangulators (even of
+ * different types), as the key includes the type of triangulator.
+ *
+ * Only the indices are cached. As the triangulators never introduce new
+ * vertices, this is all that is necessary to reconstruct the result.
+ *
+ * The cache has a fixed capacity. When it is full, it evicts the least
+ * recently used entry. This class is thread safe, so the cache can be
+ * shared by triangulators running on different threads.
+ */
+class TriangulationCache {
+private:
+    /** An entry in the cache */
+    class Entry {
+    public:
+        /** The number of vertices in the triangulated input */
+        size_t vertices;
+        /** The triangulation indices */
+        std::vector<Uint32> indices;
+        /** The position of this entry in the recently-used list */
+        std::list<size_t>::iterator position;
+    };
+
+    /** The cached triangulations */
+    std::unordered_map<size_t, Entry> _entries;
+    /** The cache keys, ordered from most to least recently used */
+    std::list<size_t> _order;
+    /** The maximum number of entries in the cache */
+    size_t _capacity;
+    /** The number of lookups that found an entry */
+    Uint64 _hits;
+    /** The number of lookups that did not find an entry */
+    Uint64 _misses;
+    /** A mutex to support sharing across threads */
+    mutable std::mutex _mutex;
+
+public:
+#pragma mark Constructors
+    /**
+     * Creates a degenerate triangulation cache with no capacity.
+     *
+     * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an object on
+     * the heap, use one of the static constructors instead.
+     */
+    TriangulationCache();
+
+    /**
+     * Deletes this triangulation cache, disposing all resources
+     */
+    ~TriangulationCache() { dispose(); }
+
+    /**
+     * Disposes all of the resources used by this cache.
+     *
+     * A disposed cache can be safely reinitialized.
+     */
+    void dispose();
+
+    /**
+     * Initializes a triangulation cache with the given capacity.
+     *
+     * @param capacity  The maximum number of cached triangulations
+     *
+     * @return true if initialization was successful.
+     */
+    bool init(size_t capacity);
+
+    /**
+     * Returns a newly allocated triangulation cache with the given capacity.
+     *
+     * @param capacity  The maximum number of cached triangulations
+     *
+     * @return a newly allocated triangulation cache with the given capacity.
+     */
+    static std::shared_ptr<TriangulationCache> alloc(size_t capacity) {
+        std::shared_ptr<TriangulationCache> result = std::make_shared<TriangulationCache>();
+        return (result->init(capacity) ? result : nullptr);
+    }
+
+    /**
+     * Returns the triangulation cache shared by the scene graph classes.
+     *
+     * This cache is allocated on first use, with a capacity of 64 entries.
+     * It is used by classes like {@link scene2::PolygonNode} that
+     * retriangulate every time their shape changes.
+     *
+     * @return the triangulation cache shared by the scene graph classes.
+     */
+    static std::shared_ptr<TriangulationCache> get();
+
+#pragma mark Keys
+    /**
+     * Returns the cache key for the given triangulation input.
+     *
+     * The key is a content hash of the vertices and the hole layout, as
+     * computed by {@link hashtool#hash_bytes}. The hole layout is an array
+     * of offset-size pairs into the vertex list, as used by the
+     * triangulators. The type is a tag distinguishing the triangulator that
+     * produced the result.
+     *
+     * @param type      The triangulator type tag
+     * @param vertices  The vertices to triangulate
+     * @param vsize     The number of vertices
+     * @param holes     The hole layout
+     * @param hsize     The number of elements in the hole layout
+     *
+     * @return the cache key for the given triangulation input.
+     */
+    static size_t hash(Uint32 type, const Vec2* vertices, size_t vsize,
+                       const size_t* holes, size_t hsize);
+
+#pragma mark Cache Access
+    /**
+     * Returns the maximum number of entries in this cache.
+     *
+     * @return the maximum number of entries in this cache.
+     */
+    size_t getCapacity() const { return _capacity; }
+
+    /**
+     * Sets the maximum number of entries in this cache.
+     *
+     * If the new capacity is less than the current size, the least recently
+     * used entries are evicted.
+     *
+     * @param capacity  The maximum number of entries in this cache
+     */
+    void setCapacity(size_t capacity);
+
+    /**
+     * Returns the number of entries in this cache.
+     *
+     * @return the number of entries in this cache.
+     */
+    size_t size() const;
+
+    /**
+     * Returns the number of lookups that found an entry.
+     *
+     * @return the number of lookups that found an entry.
+     */
+    Uint64 getHits() const;
+
+    /**
+     * Returns the number of lookups that did not find an entry.
+     *
+     * @return the number of lookups that did not find an entry.
+     */
+    Uint64 getMisses() const;
+
+    /**
+     * Stores the cached triangulation for the given key in the buffer.
+     *
+     * The vertex count guards against hash collisions, as an entry is only
+     * returned if it was triangulated from the same number of vertices. If
+     * there is an entry, its indices replace the contents of the buffer and
+     * the entry is marked as most recently used. Otherwise, the buffer is
+     * unchanged.
+     *
+     * @param key       The cache key
+     * @param vertices  The number of vertices in the input
+     * @param buffer    The buffer to store the indices
+     *
+     * @return true if there was an entry for the given key.
+     */
+    bool lookup(size_t key, size_t vertices, std::vector<Uint32>& buffer);
+
+    /**
+     * Stores the given triangulation in the cache.
+     *
+     * If this cache is full, the least recently used entry is evicted. If
+     * there is already an entry for this key, it is replaced.
+     *
+     * @param key       The cache key
+     * @param vertices  The number of vertices in the input
+     * @param indices   The triangulation indices
+     */
+    void store(size_t key, size_t vertices, const std::vector<Uint32>& indices);
+
+    /**
+     * Removes all entries from this cache.
+     *
+     * This method also resets the hit and miss counts.
+     */
+    void clear();
+};
+
+}
+
+#endif /* __CU_TRIANGULATION_CACHE_H__ */
@@ -38,6 +38,8 @@
 #include "CUComplexExtruder.h"
 #include "CUEarclipTriangulator.h"
 #include "CUDelaunayTriangulator.h"
+#include "CUTriangulationCache.h"
+#include "CUClipperBatch.h"
 #include "CUPathSmoother.h"
 
 // Because we are exposing this internally for how
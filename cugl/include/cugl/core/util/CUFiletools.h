@@ -725,6 +725,39 @@ namespace cugl {
      */
     size_t vol_total_space(const std::string path);
     
+#pragma mark -
+#pragma mark File Mapping
+    /**
+     * Returns a read-only memory map of the file for this path name.
+     *
+     * The contents of the file are paged in by the operating system as they
+     * are accessed, so there is no need to copy them into a buffer. The size
+     * of the map is stored in the size parameter. The map must be released
+     * with {@link file_unmap} when it is no longer needed.
+     *
+     * This function only maps files with an absolute path name. It returns
+     * nullptr if the path is relative (e.g. an Android asset, which is stored
+     * in a compressed archive), if the file is empty, or if the platform does
+     * not support memory mapping. In that case, the file should be read with
+     * an SDL stream instead.
+     *
+     * @param path  The file path name
+     * @param size  The variable to store the size of the map
+     *
+     * @return a read-only memory map of the file for this path name.
+     */
+    const char* file_map(const std::string path, size_t& size);
+    
+    /**
+     * Releases a memory map created by {@link file_map}.
+     *
+     * Any pointers into the map are invalid after this function is called.
+     *
+     * @param data  The memory map
+     * @param size  The size of the memory map
+     */
+    void file_unmap(const char* data, size_t size);
+    
     }
 }
 #endif /* __CU_FILE_TOOLS_H__ */
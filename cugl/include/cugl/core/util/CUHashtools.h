@@ -89,6 +89,22 @@ inline void hash_combine(std::size_t& seed, const T& v, Rest... rest) {
     hash_combine(seed, rest...);
 }
     
+/**
+ * Returns a hash code for the given block of memory
+ *
+ * This function hashes the raw bytes of the data, and so it should only be
+ * used on plain data such as vertex or index arrays. Note that this means
+ * that values equal as floats (such as 0 and -0) may have different hashes.
+ * It is intended for content-based cache keys, like those used by
+ * {@link TriangulationCache}.
+ *
+ * @param data  The data to hash
+ * @param size  The number of bytes to hash
+ *
+ * @return a hash code for the given block of memory
+ */
+std::size_t hash_bytes(const void* data, size_t size);
+
 /**
  * Returns a text representation of the given binary data in Base 64
  *
@@ -10,6 +10,10 @@
 //  This class is a singleton and should never be allocated directly.  It
 //  should only be accessed via the static methods get() and open().
 //
+//  Loggers may optionally run in asynchronous mode. In that case the calling
+//  thread only formats the message into a lock-free ring buffer (one per
+//  thread) and a background thread writes the messages to disk in batches.
+//
 //  CUGL MIT License:
 //      This software is provided 'as-is', without any express or implied
 //      warranty.  In no event will the authors be held liable for any damages
@@ -37,6 +41,13 @@
 #include <unordered_map>
 #include <string>
 #include <memory>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdarg>
 
 namespace cugl {
 
@@ -62,6 +73,13 @@ class TextWriter;
  * (defined as {@link #getConsoleLevel}) and will process messages accordingly.
  * Note that the console uses its own timestamps, and so there will be a few
  * microseconds difference between the log file and the console.
+ *
+ * Logging is thread safe. By default, messages are written synchronously on
+ * the calling thread. If you are logging heavily (such as from a game loop or
+ * from several worker threads), you should enable {@link #setAsync}. In that
+ * mode each thread formats its message into its own lock-free ring buffer,
+ * and a background thread writes the messages to the file (and console) in
+ * batches, flushing once per batch.
  */
 class Logger {
 public:
@@ -131,6 +149,28 @@ protected:
     /** Whether this channel is still open. */
     bool _open;
     
+    /** A single-producer, single-consumer queue of pending messages */
+    class Ring;
+    
+    /** The mutex guarding the writer (and the ring registration) */
+    std::mutex _mutex;
+    /** Whether this logger writes asynchronously */
+    bool _async;
+    /** The number of messages each per-thread ring can hold */
+    size_t _ringsize;
+    /** A unique identifier for this logger session (to match thread rings) */
+    uint64_t _serial;
+    /** The per-thread message rings (async mode only) */
+    std::vector<Ring*> _rings;
+    /** The background thread writing messages (async mode only) */
+    std::thread* _worker;
+    /** Whether the background thread should continue running */
+    std::atomic<bool> _active;
+    /** Whether a producer has requested an early drain */
+    std::atomic<bool> _pending;
+    /** The condition variable to wake up the background thread */
+    std::condition_variable _wakeup;
+    
 #pragma mark Constructors
 public:
     /**
@@ -176,6 +216,50 @@ private:
      */
     void expand(size_t size);
     
+    /**
+     * Returns the message ring for the current thread.
+     *
+     * The ring is allocated (and registered with this logger) the first
+     * time a thread logs a message in asynchronous mode.
+     *
+     * @return the message ring for the current thread.
+     */
+    Ring* acquireRing();
+    
+    /**
+     * Enqueues a message for the background thread.
+     *
+     * The message is formatted immediately into the ring buffer of the
+     * calling thread, but the time stamp formatting and all file I/O are
+     * deferred to the background thread. If the ring is full, this method
+     * will wake up the background thread and wait for space.
+     *
+     * @param flevel    The level to write to the file (NO_MSG to skip)
+     * @param clevel    The level to write to the console (NO_MSG to skip)
+     * @param format    The formatting string
+     * @param args      The printf-style subsitution arguments
+     */
+    void enqueue(Level flevel, Level clevel, const char* format, va_list args);
+    
+    /**
+     * Writes all pending asynchronous messages to the file and console.
+     *
+     * Messages from different threads are merged in time stamp order. The
+     * file is flushed once at the end of the batch. This method assumes that
+     * the caller holds the logger mutex.
+     */
+    void drain();
+    
+    /**
+     * Starts the background thread for asynchronous logging.
+     */
+    void startWorker();
+    
+    /**
+     * Stops the background thread, writing any pending messages.
+     */
+    void stopWorker();
+    
 #pragma mark Static Accessors
 public:
     /**
@@ -333,6 +417,40 @@ public:
      */
     void setAutoFlush(bool value);
     
+    /**
+     * Returns true if this logger writes messages asynchronously.
+     *
+     * An asynchronous logger formats each message into a lock-free ring
+     * buffer owned by the calling thread. A background thread then writes
+     * these messages to the file (and console) in batches. This makes the
+     * cost of logging on the calling thread independent of file I/O.
+     *
+     * In asynchronous mode, the auto flush setting is applied per batch and
+     * not per message. Call {@link #flush} to force all pending messages to
+     * be written immediately.
+     *
+     * @return true if this logger writes messages asynchronously.
+     */
+    bool isAsync() const { return _async; }
+    
+    /**
+     * Sets whether this logger writes messages asynchronously.
+     *
+     * An asynchronous logger formats each message into a lock-free ring
+     * buffer owned by the calling thread. A background thread then writes
+     * these messages to the file (and console) in batches. This makes the
+     * cost of logging on the calling thread independent of file I/O.
+     *
+     * The capacity is the number of messages each thread can have pending
+     * before it must wait on the background thread. It is rounded up to a
+     * power of two. Disabling asynchronous mode writes all pending messages
+     * before returning.
+     *
+     * @param value     Whether this logger writes messages asynchronously
+     * @param capacity  The number of pending messages per thread
+     */
+    void setAsync(bool value, size_t capacity=1024);
+    
 #pragma mark Message Logging
     /**
      * Sends a message to this logger.
@@ -408,6 +526,9 @@ public:
      * Otherwise, the file is written after every message. To improve
      * performance, you may wish to disable auto flush if you are writting a
      * large number of messages per animation frame.
+     *
+     * If the logger is asynchronous, this method also writes all messages
+     * still pending in the thread ring buffers.
      */
     void flush();
 
@@ -41,6 +41,7 @@
 #include <queue>
 #include <vector>
 #include <thread>
+#include <atomic>
 
 // std::thread is not safe on Android and Windows platforms
 #if defined (__WINDOWS__) || defined (__ANDROID__)
@@ -93,6 +94,8 @@ private:
     bool _stop;
     /** The number of child threads that are completed */
     int _complete;
+    /** The number of tasks that are either queued or executing */
+    std::atomic<int> _pending;
     
     /**
      * The body function of a single thread.
@@ -124,7 +127,7 @@ public:
      * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate a thread pool 
      * on the heap, use one of the static constructors instead.
      */
-    ThreadPool() :_stop(false), _complete(0) { }
+    ThreadPool() :_stop(false), _complete(0), _pending(0) { }
     
     /**
      * Deletes this thread pool, destroying all resources.
@@ -230,6 +233,25 @@ public:
      * @return whether the thread pool has been shut down.
      */
     bool isShutdown() const { return _workers.size() == _complete; }
+    
+    /**
+     * Returns the number of worker threads in this pool.
+     *
+     * @return the number of worker threads in this pool.
+     */
+    size_t getThreadCount() const { return _workers.size(); }
+    
+    /**
+     * Returns the number of tasks that have not yet completed.
+     *
+     * This value includes both the tasks waiting in the queue and the tasks
+     * currently being executed by a worker. Hence a value of 0 means that
+     * the thread pool is idle. Note that the value may be stale by the time
+     * it is used, unless the caller is the only source of new tasks.
+     *
+     * @return the number of tasks that have not yet completed.
+     */
+    int getPendingCount() const { return _pending.load(); }
   
 private:  
     /** Copying is only allowed via shared pointer. */
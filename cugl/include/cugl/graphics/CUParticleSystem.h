@@ -66,6 +66,7 @@
 #include <cugl/core/math/cu_math.h>
 #include <cugl/core/assets/CUJsonValue.h>
 #include <cugl/core/util/CURandom.h>
+#include <cugl/core/util/CUThreadPool.h>
 #include <cugl/graphics/CUMesh.h>
 
 namespace cugl {
@@ -442,7 +443,13 @@ typedef std::function<bool(float delta, Particle3* part, ParticleInstance* inst)
  * While particle systems are designed for 3d particles, they work perfectly
  * well in 2d scene graphs. In that case, the particle classes should always
  * set the z-value for the particle instances to 0. In addition, you should
- * call {@link #set2d} to prevent unnecessary z-sorting.
+ * call {@link #set2d} to prevent unnecessary z-sorting. Opaque 3d particles
+ * drawn with a depth test do not need z-sorting either (see {@link #setSorted}).
+ *
+ * Particles may be simulated in parallel with {@link #setThreadPool}. In that
+ * case the {@link ParticleUpdater} must be safe to call from several threads
+ * at once. The allocator and deallocator are always called on the thread
+ * calling {@link #update}.
  */
 class ParticleSystem {
 private:
@@ -468,6 +475,17 @@ private:
     int  _oldest;
     /** Whether to optimize this particle system for 2d */
     bool _is2d;
+    /** Whether to sort the instances by distance (3d only) */
+    bool _sorted;
+    /** The radix sort keys (and scratch space) for the instances */
+    std::vector<Uint64> _sortKeys;
+    
+    /** The shared state of a parallel update (defined in the .cpp) */
+    class Update;
+    /** The thread pool for updating particles in parallel (nullptr for none) */
+    std::shared_ptr<ThreadPool> _threads;
+    /** The state of the most recent parallel update */
+    std::shared_ptr<Update> _update;
     
     /** Function pointer for allocating particles */
     ParticleAllocator _allocator;
@@ -851,6 +869,58 @@ public:
      */
     void set2d(bool value) { _is2d = value; }
     
+    /**
+     * Returns whether the particle instances are sorted by camera distance.
+     *
+     * Sorting draws the instances back to front, which is necessary for
+     * translucent particles. Opaque particles drawn with a depth test can
+     * skip this step. This value is ignored if the system is 2d, as 2d
+     * systems are never sorted. By default, this value is true.
+     *
+     * @return whether the particle instances are sorted by camera distance.
+     */
+    bool isSorted() const { return _sorted; }
+    
+    /**
+     * Sets whether the particle instances are sorted by camera distance.
+     *
+     * Sorting draws the instances back to front, which is necessary for
+     * translucent particles. Opaque particles drawn with a depth test can
+     * skip this step. This value is ignored if the system is 2d, as 2d
+     * systems are never sorted. By default, this value is true.
+     *
+     * @param value Whether the particle instances are sorted by camera distance.
+     */
+    void setSorted(bool value) { _sorted = value; }
+    
+    /**
+     * Returns the thread pool for updating particles in parallel.
+     *
+     * If this value is not nullptr, {@link #update} splits the particles
+     * into blocks and simulates them in parallel. The calling thread also
+     * simulates blocks, and only waits on blocks claimed by a worker.
+     *
+     * @return the thread pool for updating particles in parallel.
+     */
+    const std::shared_ptr<ThreadPool>& getThreadPool() const { return _threads; }
+    
+    /**
+     * Sets the thread pool for updating particles in parallel.
+     *
+     * If this value is not nullptr, {@link #update} splits the particles
+     * into blocks and simulates them in parallel. The calling thread also
+     * simulates blocks, and only waits on blocks claimed by a worker.
+     *
+     * The {@link ParticleUpdater} is called from the worker threads, so it
+     * must be thread safe. It may only modify the particle and instance
+     * that it is given.
+     *
+     * @param threads   The thread pool for updating particles in parallel.
+     */
+    void setThreadPool(const std::shared_ptr<ThreadPool>& threads) {
+        _threads = threads;
+    }
+    
 #pragma mark Simulation
     /**
      * Returns the allocation function associated with this system.
@@ -927,6 +997,9 @@ public:
      *
      * Most of the work of this method is implemented by the particle class.
      * This method manages particle emission (with delay) and camera distance.
+     * Dead particles are removed without changing the order of the others.
+     * The instances are then sorted by camera distance, unless this system
+     * is 2d or unsorted (see {@link #setSorted}).
      *
      * @param delta     The time passed in the simulation
      * @param camera    The camera position in world space
@@ -964,6 +1037,46 @@ private:
      */
     Particle3& allocate();
     
+    /**
+     * Simulates the particles in the given range.
+     *
+     * This method advances the life of each particle and calls the updater,
+     * which writes the instance with the same index. It then computes the
+     * camera distance. Dead particles (and their instances) are given a
+     * distance of -1. This method only touches the given range, so disjoint
+     * ranges may be simulated in parallel.
+     *
+     * @param begin     The first particle to simulate
+     * @param end       The particle after the last one to simulate
+     * @param delta     The time passed in the simulation
+     * @param camera    The camera position in world space
+     */
+    void simulate(size_t begin, size_t end, float delta, const Vec3 camera);
+    
+    /**
+     * Removes the dead particles, returning the number left.
+     *
+     * This is a stable partition of the particles and instances. The live
+     * particles keep their relative order, and the dead particles are moved
+     * to the end (after they are passed to the deallocator).
+     *
+     * @param size  The number of particles to compact
+     *
+     * @return the number of live particles
+     */
+    size_t compact(size_t size);
+    
+    /**
+     * Sorts the particles and instances from furthest to nearest.
+     *
+     * This is a radix sort on the bits of the (squared) camera distance,
+     * which are ordered like the distance itself since it is never negative.
+     * The particles are permuted together with their instances.
+     *
+     * @param size  The number of particles to sort
+     */
+    void sort(size_t size);
+    
     /**
      * Allocates the instance buffer for this particle system
      *
@@ -78,6 +78,7 @@ class Path2;
 
 /** Forward references */
 class VertexBuffer;
+class InstanceBuffer;
 class UniformBuffer;
 class TextLayout;
 class Shader;
@@ -133,6 +134,19 @@ class Font;
  * via a uniform block that is provides the data in the order scissor, and then
  * gradient. See SpriteShader.frag for more information.
  *
+ * For large numbers of textured quads, the sprite batch has an optional
+ * instancing mode (see {@link #setInstancing}). In this mode, solid rectangles
+ * are sent to the GPU as a single transform, texture region, and color per
+ * quad, instead of four transformed vertices and six indices. The default
+ * shader supports this mode. A custom shader supports it only if it has the
+ * same instance attributes as SpriteShader.vert.
+ *
+ * By default, the sprite batch streams its vertices through a ring of mapped
+ * regions in the vertex buffer (see {@link #setStreaming}). During a drawing
+ * pass, shapes are written directly into GPU-visible memory, so that a flush
+ * only needs to issue the draw calls. Shapes drawn outside of a pass are
+ * batched in local memory and uploaded at the next flush.
+ *
  * This is an extremely heavy-weight class. There is rarely any need to have more
  * than one of these at a time. If you want to implement your own shader effects,
  * it is better to construct your own custom pipeline with {@link Shader} and
@@ -153,6 +167,14 @@ private:
      */
     class Context;
     
+    /**
+     * A class storing the attributes of a single instanced quad.
+     *
+     * This is the data streamed to the GPU in instancing mode. It is the
+     * (rectangle-adjusted) transform, texture region, and color of a quad.
+     */
+    class Instance;
+    
     /** Whether this sprite batch has been initialized yet */
     bool _initialized;
     /** Whether this sprite batch is currently active */
@@ -165,26 +187,49 @@ private:
     /** The vertex buffer for this sprite batch */
     std::shared_ptr<UniformBuffer> _unifbuff;
     
-    /** The sprite batch vertex mesh */
+    /** The sprite batch vertex mesh (either local or mapped memory) */
     SpriteVertex* _vertData;
+    /** The local vertex memory, used when no region is mapped */
+    SpriteVertex* _vertLocal;
     /** The vertex capacity of the mesh */
     unsigned int _vertMax;
     /** The number of vertices in the current mesh */
     unsigned int _vertSize;
     
-    /** The indices for the vertex mesh */
+    /** The indices for the vertex mesh (either local or mapped memory) */
     GLuint*  _indxData;
+    /** The local index memory, used when no region is mapped */
+    GLuint*  _indxLocal;
     /** The index capacity of the mesh */
     unsigned int _indxMax;
     /** The number of indices in the current mesh */
     unsigned int _indxSize;
     
+    /** The instance buffer for instanced quads */
+    std::shared_ptr<InstanceBuffer> _instbuff;
+    /** The sprite batch instance data */
+    Instance* _instData;
+    /** The instance capacity */
+    unsigned int _instMax;
+    /** The number of instances in the current batch */
+    unsigned int _instSize;
+    /** Whether instancing mode is requested */
+    bool _instancing;
+    /** Whether the current shader supports instancing */
+    bool _instready;
+    /** Whether vertices are streamed through mapped buffer regions */
+    bool _streaming;
+    
     /** The active drawing context */
     Context* _context;
     /** Whether the current context has been used. */
     bool _inflight;
     /** The drawing context history */
     std::vector<Context*> _history;
+    /** The context arena, recycled at every flush (slot 0 is active after a flush) */
+    std::vector<Context*> _arena;
+    /** The number of arena contexts in use */
+    size_t _arenaSize;
     
     /** The active color */
     Color4 _color;
@@ -199,6 +244,8 @@ private:
     unsigned int _vertTotal;
     /** The number of OpenGL calls in this pass (so far) */
     unsigned int _callTotal;
+    /** The number of quad instances drawn in this pass (so far) */
+    unsigned int _instTotal;
     
     
 #pragma mark -
@@ -463,6 +510,78 @@ public:
      */
     unsigned int getCallsMade() const { return _callTotal; }
     
+    /**
+     * Returns the number of instanced quads drawn in the latest pass (so far).
+     *
+     * This value will be reset to 0 whenever begin() is called. Instanced
+     * quads are not included in {@link #getVerticesDrawn}.
+     *
+     * @return the number of instanced quads drawn in the latest pass (so far).
+     */
+    unsigned int getInstancesDrawn() const { return _instTotal; }
+    
+    /**
+     * Returns true if this sprite batch draws rectangles as instances.
+     *
+     * In instancing mode, every solid rectangle (such as a sprite drawn with
+     * one of the {@link #draw} methods taking a rectangle) is sent to the GPU
+     * as a single instance, rather than as four vertices and six indices.
+     * This significantly reduces the bandwidth and CPU cost of drawing large
+     * numbers of sprites. Other shapes are unaffected.
+     *
+     * This mode is false by default. It has no effect if the shader does not
+     * support instancing.
+     *
+     * @return true if this sprite batch draws rectangles as instances.
+     */
+    bool isInstancing() const { return _instancing; }
+    
+    /**
+     * Sets whether this sprite batch draws rectangles as instances.
+     *
+     * In instancing mode, every solid rectangle (such as a sprite drawn with
+     * one of the {@link #draw} methods taking a rectangle) is sent to the GPU
+     * as a single instance, rather than as four vertices and six indices.
+     * This significantly reduces the bandwidth and CPU cost of drawing large
+     * numbers of sprites. Other shapes are unaffected.
+     *
+     * This mode is false by default. It has no effect if the shader does not
+     * support instancing. It may be changed during a drawing pass.
+     *
+     * @param flag  Whether this sprite batch draws rectangles as instances.
+     */
+    void setInstancing(bool flag) { _instancing = flag; }
+    
+    /**
+     * Returns true if this sprite batch streams vertices through mapped memory.
+     *
+     * In streaming mode, the vertex buffer is divided into a ring of regions.
+     * During a drawing pass, shapes are written directly into a mapped region,
+     * and a flush only needs to issue the draw calls. This avoids reallocating
+     * the buffer storage and copying the vertices at every flush.
+     *
+     * This mode is true by default.
+     *
+     * @return true if this sprite batch streams vertices through mapped memory.
+     */
+    bool isStreaming() const { return _streaming; }
+    
+    /**
+     * Sets whether this sprite batch streams vertices through mapped memory.
+     *
+     * In streaming mode, the vertex buffer is divided into a ring of regions.
+     * During a drawing pass, shapes are written directly into a mapped region,
+     * and a flush only needs to issue the draw calls. This avoids reallocating
+     * the buffer storage and copying the vertices at every flush.
+     *
+     * This mode is true by default. It may NOT be changed during a drawing
+     * pass. If the buffer regions cannot be allocated, the sprite batch will
+     * remain in its standard mode.
+     *
+     * @param flag  Whether this sprite batch streams vertices through mapped memory.
+     */
+    void setStreaming(bool flag);
+    
     /**
      * Sets the shader for this sprite batch
      *
@@ -1993,12 +2112,42 @@ private:
     void record();
     
     /**
-     * Deletes the recorded uniforms.
+     * Recycles the recorded uniforms.
      *
-     * This method is called upon flushing or cleanup.
+     * This method is called upon flushing. It resets the context arena, moving
+     * the active context to the first slot. No memory is released, so that the
+     * next frame can record without allocating.
      */
     void unwind();
     
+    /**
+     * Switches the current drawing context to or from instanced quads.
+     *
+     * Instanced quads and regular vertices cannot share a drawing context.
+     * If the context is in-flight with the other kind of data, this method
+     * records it first.
+     *
+     * @param flag  Whether the next shape is an instanced quad
+     */
+    void useInstances(bool flag);
+    
+    /**
+     * Maps the next vertex buffer region for writing, if streaming.
+     *
+     * On success, the vertex and index data will point into the mapped region.
+     * If mapping fails, this sprite batch falls back to its standard mode. This
+     * method does nothing if a region is already mapped.
+     */
+    void mapStream();
+    
+    /**
+     * Unmaps the current vertex buffer region, making it ready to draw.
+     *
+     * The vertex and index data will point to local memory again. This method
+     * does nothing if no region is mapped.
+     */
+    void unmapStream();
+    
     /**
      * Sets the active uniform block to agree with the gradient and stroke.
      *
@@ -2053,6 +2202,23 @@ private:
      */
     unsigned int prepare(const Rect rect, const Affine2& mat);
     
+    /**
+     * Returns the number of instances added to the drawing buffer.
+     *
+     * This method adds the given rectangle as a single instanced quad, but
+     * does not draw it yet. You must call {@link #flush} or {@link #end} to
+     * draw the rectangle. This method will automatically flush if the
+     * maximum number of instances is reached.
+     *
+     * The rectangle will be transformed by the transform matrix.
+     *
+     * @param rect  The rectangle to add to the buffer
+     * @param mat   The transform to apply to the rectangle
+     *
+     * @return the number of instances added to the drawing buffer.
+     */
+    unsigned int prepareInstance(const Rect rect, const Affine2& mat);
+    
     /**
      * Returns the number of vertices added to the drawing buffer.
      *
@@ -282,6 +282,32 @@ public:
     bool initWithData(const void *data, int width, int height,
                       bool mipmaps = false, PixelFormat format = PixelFormat::RGBA);
     
+    /**
+     * Initializes an texture with the given data and precomputed mipmaps.
+     *
+     * Initializing a texture requires the use of the binding point at 0. Any
+     * texture bound to that point will be unbound. In addition, once
+     * initialization is done, this texture will not longer be bound as well.
+     *
+     * The data is the full mipmap chain, stored one level after the other.
+     * Level 0 has the given width and height, and every subsequent level is
+     * half the size (rounded down, but never less than 1) of the previous
+     * one. Unlike {@link #buildMipMaps}, this method does not require the
+     * texture size to be a power of two.
+     *
+     * The data format must match the one given.
+     *
+     * @param data      The texture data for all mipmap levels
+     * @param width     The texture width in pixels
+     * @param height    The texture height in pixels
+     * @param levels    The number of mipmap levels in the data
+     * @param format    The texture data format
+     *
+     * @return true if initialization was successful.
+     */
+    bool initWithMipMaps(const void *data, int width, int height, int levels,
+                         PixelFormat format = PixelFormat::RGBA);
+    
     /**
      * Initializes an texture with the data from the given file.
      *
@@ -354,6 +380,34 @@ public:
         
     }
     
+    /**
+     * Returns a new texture with the given data and precomputed mipmaps.
+     *
+     * Allocating a texture requires the use of the binding point at 0. Any
+     * texture bound to that point will be unbound. In addition, once
+     * initialization is done, this texture will not longer be bound as well.
+     *
+     * The data is the full mipmap chain, stored one level after the other.
+     * Level 0 has the given width and height, and every subsequent level is
+     * half the size (rounded down, but never less than 1) of the previous
+     * one.
+     *
+     * The data format must match the one given.
+     *
+     * @param data      The texture data for all mipmap levels
+     * @param width     The texture width in pixels
+     * @param height    The texture height in pixels
+     * @param levels    The number of mipmap levels in the data
+     * @param format    The texture data format
+     *
+     * @return a new texture with the given data and precomputed mipmaps.
+     */
+    static std::shared_ptr<Texture> allocWithMipMaps(const void *data, int width, int height, int levels,
+                                                     PixelFormat format = PixelFormat::RGBA) {
+        std::shared_ptr<Texture> result = std::make_shared<Texture>();
+        return (result->initWithMipMaps(data, width, height, levels, format) ? result : nullptr);
+    }
+    
     /**
      * Returns a new texture with the data from the given file.
      *
@@ -0,0 +1,253 @@
+//
+//  CUTextureCache.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a disk cache for decoded texture data. Decoding an
+//  image file (and converting it to RGBA) is one of the more expensive steps
+//  at startup. This cache stores the decoded pixels, together with an optional
+//  mipmap chain, in a binary file that can be uploaded to OpenGL directly on
+//  later launches.
+//
+//  Cache files are keyed by a hash of the contents of the source image. Hence
+//  a cache entry is invalidated automatically when its source changes. The
+//  cache does not use OpenGL, and so it is safe to use outside of the main
+//  thread.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty. In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Author: Walker White
+//  Version: 7/3/24 (CUGL 3.0 reorganization)
+//
+#ifndef __CU_TEXTURE_CACHE_H__
+#define __CU_TEXTURE_CACHE_H__
+#include <cugl/core/CUBase.h>
+#include <vector>
+#include <string>
+#include <memory>
+#include <atomic>
+
+namespace cugl {
+
+    /**
+     * The classes and functions needed to construct a graphics pipeline.
+     *
+     * Initially these were part of the core CUGL module (everyone wants graphics,
+     * right). However, after student demand for a headless option that did not
+     * have so many OpenGL dependencies, this was factored out.
+     */
+    namespace graphics {
+
+/**
+ * This class is a disk cache of decoded texture data.
+ *
+ * The method {@link #load} returns the RGBA pixels of an image file. The first
+ * time an image is loaded, it is decoded with SDL_image and the result (with
+ * an optional mipmap chain) is written to the cache directory. Any later load
+ * of the same image reads the cached file instead, skipping both the image
+ * decoder and the pixel format conversion.
+ *
+ * Cache entries are keyed by a hash of the image file contents, so there is
+ * no need to invalidate the cache when assets change. Stale entries are never
+ * read again, and may be removed with {@link #clear}.
+ *
+ * The pixels are stored in the same byte order as {@link TextureLoader#preload},
+ * so they can be passed directly to {@link Texture#initWithMipMaps}. The cache
+ * does not compress pixel data, as there is no portable compressed format
+ * across our desktop and mobile targets.
+ *
+ * All methods of this class are thread-safe.
+ */
+class TextureCache {
+public:
+    /**
+     * The decoded pixel data of a single image
+     */
+    class Image {
+    public:
+        /** The width of mipmap level 0 */
+        Uint32 width;
+        /** The height of mipmap level 0 */
+        Uint32 height;
+        /** The number of mipmap levels (at least 1) */
+        Uint32 levels;
+        /** The RGBA pixels of every mipmap level, one after the other */
+        std::vector<Uint8> data;
+
+        /**
+         * Creates an empty image
+         */
+        Image() : width(0), height(0), levels(0) {}
+    };
+
+private:
+    /** The directory storing the cache files */
+    std::string _directory;
+    /** The number of images read from the cache */
+    std::atomic<size_t> _hits;
+    /** The number of images decoded from their source */
+    std::atomic<size_t> _misses;
+
+#pragma mark Constructors
+public:
+    /**
+     * Creates an uninitialized texture cache.
+     *
+     * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an object on
+     * the heap, use one of the static constructors instead.
+     */
+    TextureCache();
+
+    /**
+     * Deletes this texture cache, disposing all resources
+     */
+    ~TextureCache() { dispose(); }
+
+    /**
+     * Disposes all of the resources used by this texture cache.
+     *
+     * This does not delete the cache files. A disposed texture cache can be
+     * safely reinitialized.
+     */
+    void dispose();
+
+    /**
+     * Initializes a texture cache in the given directory.
+     *
+     * The directory should be an absolute path in a writable location, such
+     * as a subdirectory of {@link Application#getSaveDirectory}. It will be
+     * created if it does not already exist.
+     *
+     * @param directory The directory storing the cache files
+     *
+     * @return true if initialization was successful.
+     */
+    bool init(const std::string directory);
+
+    /**
+     * Returns a newly allocated texture cache in the given directory.
+     *
+     * The directory should be an absolute path in a writable location, such
+     * as a subdirectory of {@link Application#getSaveDirectory}. It will be
+     * created if it does not already exist.
+     *
+     * @param directory The directory storing the cache files
+     *
+     * @return a newly allocated texture cache in the given directory.
+     */
+    static std::shared_ptr<TextureCache> alloc(const std::string directory) {
+        std::shared_ptr<TextureCache> result = std::make_shared<TextureCache>();
+        return (result->init(directory) ? result : nullptr);
+    }
+
+#pragma mark Cache Access
+    /**
+     * Returns the decoded pixel data for the given image file.
+     *
+     * If the image is in the cache, this reads the cache file. Otherwise, it
+     * decodes the image file and writes the result to the cache. If mipmaps
+     * is true, the image will include a full mipmap chain down to 1x1.
+     *
+     * The path should be absolute. This method returns nullptr if the image
+     * could not be loaded.
+     *
+     * @param path      The absolute path to the image file
+     * @param mipmaps   Whether to include a mipmap chain
+     *
+     * @return the decoded pixel data for the given image file.
+     */
+    std::shared_ptr<Image> load(const std::string path, bool mipmaps=false);
+
+    /**
+     * Deletes all cache files in the cache directory.
+     *
+     * This method should not be called while other threads are loading
+     * from this cache.
+     */
+    void clear();
+
+    /**
+     * Returns the directory storing the cache files
+     *
+     * @return the directory storing the cache files
+     */
+    const std::string getDirectory() const { return _directory; }
+
+    /**
+     * Returns the number of images read from the cache
+     *
+     * @return the number of images read from the cache
+     */
+    size_t getHits() const { return _hits.load(); }
+
+    /**
+     * Returns the number of images decoded from their source
+     *
+     * @return the number of images decoded from their source
+     */
+    size_t getMisses() const { return _misses.load(); }
+
+private:
+    /**
+     * Returns the image stored in the given cache file.
+     *
+     * This method returns nullptr if the file does not exist, or if it does
+     * not match the given hash.
+     *
+     * @param path  The cache file
+     * @param hash  The hash of the source image
+     *
+     * @return the image stored in the given cache file.
+     */
+    std::shared_ptr<Image> read(const std::string path, Uint64 hash);
+
+    /**
+     * Writes the image to the given cache file.
+     *
+     * The file is written under a temporary name and then renamed, so that
+     * a concurrent {@link #read} never sees a partial file.
+     *
+     * @param path  The cache file
+     * @param hash  The hash of the source image
+     * @param image The image to write
+     *
+     * @return true if the file was written successfully
+     */
+    bool write(const std::string path, Uint64 hash, const Image& image);
+
+    /** This macro disables the copy constructor (not allowed on caches) */
+    CU_DISALLOW_COPY_AND_ASSIGN(TextureCache);
+};
+
+    }
+}
+
+#endif /* __CU_TEXTURE_CACHE_H__ */
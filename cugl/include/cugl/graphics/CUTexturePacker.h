@@ -0,0 +1,349 @@
+//
+//  CUTexturePacker.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a class for packing several images into one or more
+//  texture atlases. Rendering from a single atlas means that the sprite batch
+//  does not need to flush whenever it switches images, which can reduce the
+//  number of draw calls significantly.
+//
+//  The packer uses the skyline bottom-left heuristic. Each image is surrounded
+//  by a gutter of padding pixels, which are filled by extruding the image
+//  border. This prevents neighboring images from bleeding into each other
+//  when the atlas is filtered or mipmapped.
+//
+//  The packer works purely on CPU pixel data and does not require OpenGL.
+//  Hence it is safe to use it outside of the main thread.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty. In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Author: Walker White
+//  Version: 7/3/24 (CUGL 3.0 reorganization)
+//
+#ifndef __CU_TEXTURE_PACKER_H__
+#define __CU_TEXTURE_PACKER_H__
+#include <cugl/core/CUBase.h>
+#include <cugl/core/math/CURect.h>
+#include <unordered_map>
+#include <vector>
+#include <string>
+#include <memory>
+
+namespace cugl {
+
+    /**
+     * The classes and functions needed to construct a graphics pipeline.
+     *
+     * Initially these were part of the core CUGL module (everyone wants graphics,
+     * right). However, after student demand for a headless option that did not
+     * have so many OpenGL dependencies, this was factored out.
+     */
+    namespace graphics {
+
+/**
+ * This class packs a collection of images into one or more atlas pages.
+ *
+ * To use a packer, add each image with {@link #add} and then call {@link #pack}.
+ * Images are specified as 32-bit pixels (e.g. RGBA). The packer treats each
+ * pixel as an opaque 32-bit value, so the atlas pages have the same byte
+ * order as the images added.
+ *
+ * Every page is a power of two along each dimension, and no larger than
+ * the maximum size of the packer. If the images do not fit on a single page,
+ * the packer will create additional pages. An image that is larger than the
+ * maximum page size (including its gutter) cannot be packed.
+ *
+ * Each image is surrounded by a gutter of {@link #getPadding} pixels on each
+ * side. The gutter is filled by extruding the border of the image, so that
+ * filtering (and low mipmap levels) sample the image edge instead of its
+ * neighbor.
+ *
+ * The pixel regions returned by {@link #getRegion} have their origin in the
+ * top left corner, which matches the layout of image data. Use the method
+ * {@link #getTexCoords} to get the values for {@link Texture#getSubTexture}.
+ */
+class TexturePacker {
+#pragma mark Values
+public:
+    /**
+     * The location of a packed image
+     */
+    class Region {
+    public:
+        /** The index of the page for this image */
+        Uint32 page;
+        /** The pixel bounds of this image in the page (origin top left) */
+        Rect bounds;
+
+        /**
+         * Creates an empty region
+         */
+        Region() : page(0) {}
+    };
+
+private:
+    /** An image waiting to be packed */
+    class Image {
+    public:
+        /** The image name */
+        std::string name;
+        /** The image pixels */
+        std::vector<Uint32> pixels;
+        /** The image width */
+        Uint32 width;
+        /** The image height */
+        Uint32 height;
+    };
+
+    /** A single atlas page */
+    class Page {
+    public:
+        /** The page pixels */
+        std::vector<Uint32> pixels;
+        /** The page width */
+        Uint32 width;
+        /** The page height */
+        Uint32 height;
+    };
+
+    /** The gutter around each image */
+    Uint32 _padding;
+    /** The maximum width or height of a page */
+    Uint32 _maxsize;
+    /** The images waiting to be packed */
+    std::vector<Image> _images;
+    /** The packed atlas pages */
+    std::vector<Page> _pages;
+    /** The location of each packed image */
+    std::unordered_map<std::string, Region> _regions;
+
+#pragma mark Constructors
+public:
+    /**
+     * Creates an uninitialized texture packer.
+     *
+     * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an object on
+     * the heap, use one of the static constructors instead.
+     */
+    TexturePacker();
+
+    /**
+     * Deletes this texture packer, disposing all resources
+     */
+    ~TexturePacker() { dispose(); }
+
+    /**
+     * Disposes all of the resources used by this texture packer.
+     *
+     * A disposed texture packer can be safely reinitialized.
+     */
+    void dispose();
+
+    /**
+     * Initializes a texture packer with the given padding and page size.
+     *
+     * The padding is the gutter (in pixels) around each side of each image.
+     * The maximum size is the largest width or height of a page, and is
+     * rounded down to a power of two.
+     *
+     * @param padding   The gutter around each image
+     * @param maxsize   The maximum width or height of a page
+     *
+     * @return true if initialization was successful.
+     */
+    bool init(Uint32 padding=2, Uint32 maxsize=2048);
+
+    /**
+     * Returns a newly allocated texture packer with the given padding and page size.
+     *
+     * The padding is the gutter (in pixels) around each side of each image.
+     * The maximum size is the largest width or height of a page, and is
+     * rounded down to a power of two.
+     *
+     * @param padding   The gutter around each image
+     * @param maxsize   The maximum width or height of a page
+     *
+     * @return a newly allocated texture packer with the given padding and page size.
+     */
+    static std::shared_ptr<TexturePacker> alloc(Uint32 padding=2, Uint32 maxsize=2048) {
+        std::shared_ptr<TexturePacker> result = std::make_shared<TexturePacker>();
+        return (result->init(padding,maxsize) ? result : nullptr);
+    }
+
+#pragma mark Packing
+    /**
+     * Adds an image to be packed.
+     *
+     * The pixel data is copied, so it is safe to release it after this call.
+     * The pitch is the number of bytes in a row of the image. If it is 0,
+     * the rows are assumed to be tightly packed.
+     *
+     * This method will fail if the name is already in use, or if the packer
+     * has already been packed.
+     *
+     * @param name      The image name
+     * @param pixels    The 32-bit image pixels
+     * @param width     The image width
+     * @param height    The image height
+     * @param pitch     The number of bytes per image row
+     *
+     * @return true if the image was successfully added
+     */
+    bool add(const std::string name, const void* pixels, Uint32 width, Uint32 height, Uint32 pitch=0);
+
+    /**
+     * Packs all of the images added into atlas pages.
+     *
+     * Images are sorted by height before packing, and each page is sized to
+     * the smallest power of two that holds its images. The pixel data of the
+     * original images is released once packing is complete.
+     *
+     * @return true if all images were packed
+     */
+    bool pack();
+
+    /**
+     * Returns true if this packer has been packed.
+     *
+     * @return true if this packer has been packed.
+     */
+    bool isPacked() const { return !_pages.empty(); }
+
+#pragma mark Accessors
+    /**
+     * Returns the gutter around each image
+     *
+     * @return the gutter around each image
+     */
+    Uint32 getPadding() const { return _padding; }
+
+    /**
+     * Returns the maximum width or height of a page
+     *
+     * @return the maximum width or height of a page
+     */
+    Uint32 getMaxSize() const { return _maxsize; }
+
+    /**
+     * Returns the number of atlas pages
+     *
+     * @return the number of atlas pages
+     */
+    size_t getPageCount() const { return _pages.size(); }
+
+    /**
+     * Returns the pixel data of the given page
+     *
+     * @param page  The page index
+     *
+     * @return the pixel data of the given page
+     */
+    const Uint32* getPageData(size_t page) const { return _pages[page].pixels.data(); }
+
+    /**
+     * Returns the pixel width of the given page
+     *
+     * @param page  The page index
+     *
+     * @return the pixel width of the given page
+     */
+    Uint32 getPageWidth(size_t page) const { return _pages[page].width; }
+
+    /**
+     * Returns the pixel height of the given page
+     *
+     * @param page  The page index
+     *
+     * @return the pixel height of the given page
+     */
+    Uint32 getPageHeight(size_t page) const { return _pages[page].height; }
+
+    /**
+     * Returns the names of all packed images
+     *
+     * @return the names of all packed images
+     */
+    std::vector<std::string> getNames() const;
+
+    /**
+     * Returns true if the given image was packed
+     *
+     * @param name  The image name
+     *
+     * @return true if the given image was packed
+     */
+    bool contains(const std::string name) const {
+        return _regions.find(name) != _regions.end();
+    }
+
+    /**
+     * Returns the location of the given image
+     *
+     * If the image was not packed, the region returned is empty.
+     *
+     * @param name  The image name
+     *
+     * @return the location of the given image
+     */
+    Region getRegion(const std::string name) const;
+
+    /**
+     * Returns the texture coordinates of the given image
+     *
+     * The values are returned in the order minS, maxS, minT, maxT, which
+     * is the order used by {@link Texture#getSubTexture}. If the image was
+     * not packed, this returns all zeroes.
+     *
+     * @param name  The image name
+     * @param coords    Array to store the four texture coordinates
+     */
+    void getTexCoords(const std::string name, float* coords) const;
+
+private:
+    /**
+     * Copies the given image into the page, extruding its border into the gutter.
+     *
+     * @param image The image to copy
+     * @param page  The destination page
+     * @param x     The left edge of the image cell (including gutter)
+     * @param y     The top edge of the image cell (including gutter)
+     */
+    void blit(const Image& image, Page& page, Uint32 x, Uint32 y);
+
+    /** This macro disables the copy constructor (not allowed on packers) */
+    CU_DISALLOW_COPY_AND_ASSIGN(TexturePacker);
+};
+
+    }
+}
+
+#endif /* __CU_TEXTURE_PACKER_H__ */
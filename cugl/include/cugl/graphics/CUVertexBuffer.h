@@ -13,6 +13,12 @@
 //  it does not support instancing. For that you will need to use the
 //  InstanceBuffer class, or design your own VertexBuffer abstraction.
 //
+//  A vertex buffer may optionally stream its data through a ring of regions.
+//  In this mode, the caller writes directly into mapped buffer memory, and
+//  fences ensure that a region is never overwritten while the GPU is still
+//  reading from it. This avoids both the buffer orphaning and the extra CPU
+//  copy of the standard load methods.
+//
 //  This class uses our standard shared-pointer architecture.
 //
 //  1. The constructor does not perform any initialization; it just sets all
@@ -50,6 +56,7 @@
 #ifndef __CU_VERTEX_BUFFER_H__
 #define __CU_VERTEX_BUFFER_H__
 #include <string>
+#include <vector>
 #include <unordered_map>
 #include <cugl/graphics/CUGraphicsBase.h>
 #include <cugl/core/math/CUMathBase.h>
@@ -89,6 +96,14 @@ class Shader;
  * buffer has attributes lacking in the shader, they will be ignored. If it is
  * missing attributes that the shader expects, the shader will use the default
  * value for the type.
+ *
+ * By default, data is sent to the vertex buffer with {@link #loadVertexData}
+ * and {@link #loadIndexData}. These methods orphan the GPU storage and copy
+ * the data on every call. For data that changes every frame, it is better to
+ * use streaming mode (see {@link #setStreaming}). In this mode the storage is
+ * divided into a ring of regions, and the data is written directly into
+ * buffer memory with {@link #mapRegion}. Each region is protected by a fence,
+ * so that it is only rewritten once the GPU has finished drawing from it.
  */
 class VertexBuffer {
     //private:
@@ -126,6 +141,21 @@ protected:
     /** The index buffer for drawing a shape */
     GLuint _indxBuffer;
     
+    /** The number of streaming regions (0 if not streaming) */
+    GLuint _regions;
+    /** The current streaming region */
+    GLuint _region;
+    /** The fences guarding each streaming region */
+    std::vector<GLsync> _fences;
+    /** Whether the current region is mapped */
+    bool _mapped;
+    /** Whether the current region has been submitted for drawing */
+    bool _pending;
+    /** The byte offset of the vertices in the current region */
+    GLsizeiptr _vertBase;
+    /** The element offset of the indices in the current region */
+    GLsizeiptr _indxBase;
+    
     /** The shader currently attached to this vertex buffer */
     std::shared_ptr<Shader> _shader;
     
@@ -397,6 +427,90 @@ public:
     void drawDirect(GLenum mode, GLint first, GLsizei count);
     
     
+#pragma mark -
+#pragma mark Streaming
+    /**
+     * Returns true if this vertex buffer is in streaming mode.
+     *
+     * In streaming mode, the buffer storage is divided into a ring of regions,
+     * each of which holds {@link #getCapacity} vertices and indices. Data is
+     * written directly into a region with {@link #mapRegion}, and drawn after
+     * a call to {@link #unmapRegion}.
+     *
+     * @return true if this vertex buffer is in streaming mode.
+     */
+    bool isStreaming() const { return _regions > 0; }
+    
+    /**
+     * Returns the number of streaming regions.
+     *
+     * If this vertex buffer is not in streaming mode, this value is 0.
+     *
+     * @return the number of streaming regions.
+     */
+    GLuint getRegionCount() const { return _regions; }
+    
+    /**
+     * Sets the number of streaming regions, reallocating the buffer storage.
+     *
+     * Setting this value to 0 disables streaming mode. Three regions are
+     * typically enough to guarantee that the CPU never waits on the GPU, as
+     * the driver rarely buffers more than two frames of commands.
+     *
+     * This method discards any data previously loaded into this buffer. It
+     * may not be called while a region is mapped. This method will only
+     * succeed if this buffer is actively bound.
+     *
+     * @param regions   The number of streaming regions
+     *
+     * @return true if the storage was successfully reallocated
+     */
+    bool setStreaming(GLuint regions);
+    
+    /**
+     * Returns true if a streaming region is currently mapped.
+     *
+     * @return true if a streaming region is currently mapped.
+     */
+    bool isMapped() const { return _mapped; }
+    
+    /**
+     * Maps the next streaming region for writing.
+     *
+     * On success, vertices will point to space for {@link #getCapacity}
+     * vertices, and indices will point to space for the same number of
+     * indices. Indices are relative to the start of the region. This memory
+     * should only be written to, as reading it back can be very slow.
+     *
+     * If the GPU is still drawing from the region, this method will block
+     * until it is done. With enough regions this should never happen.
+     *
+     * This method will only succeed if this buffer is actively bound and in
+     * streaming mode.
+     *
+     * @param vertices  Pointer to store the vertex memory
+     * @param indices   Pointer to store the index memory
+     *
+     * @return true if the region was successfully mapped
+     */
+    bool mapRegion(void** vertices, GLuint** indices);
+    
+    /**
+     * Unmaps the current streaming region, making it ready to draw.
+     *
+     * The sizes are the number of vertices and indices written to the region
+     * since it was mapped. Only this data is flushed to the GPU. Once this
+     * method is called, the methods {@link #draw} and {@link #drawDirect}
+     * will use the data in this region, until the next region is mapped.
+     *
+     * This method will only succeed if this buffer is actively bound.
+     *
+     * @param vsize     The number of vertices written
+     * @param isize     The number of indices written
+     */
+    void unmapRegion(GLsizei vsize, GLsizei isize);
+    
+    
 #pragma mark -
 #pragma mark Attributes
     /**
@@ -457,6 +571,14 @@ public:
      */
     void disableAttribute(const std::string name);
     
+private:
+    /**
+     * Points all enabled attributes at the current vertex region.
+     *
+     * This method is necessary because OpenGLES has no base vertex for
+     * indexed drawing. It does nothing if there is no attached shader.
+     */
+    void pointAttributes();
     
 };
 
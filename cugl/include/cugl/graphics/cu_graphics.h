@@ -51,6 +51,8 @@
 #include "CUSpriteBatch.h"
 #include "CUSpriteMesh.h"
 #include "CUSpriteSheet.h"
+#include "CUTexturePacker.h"
+#include "CUTextureCache.h"
 #include "CUTextureRenderer.h"
 #include "CUMeshExtruder.h"
 
@@ -7,6 +7,13 @@
 //  texture parameters.  Hence you may wish to load a texture asset multiple
 //  times, though this is potentially wasteful regarding memory.
 //
+//  A JSON directory entry may also pack several images into a single atlas.
+//  This allows sprites that are drawn together to share a texture, so that a
+//  sprite batch does not need to flush between them.
+//
+//  If the loader has a texture cache, decoded images are stored on disk and
+//  reused on later launches, skipping the image decoder entirely.
+//
 //  As with all of our loaders, this loader is designed to be attached to an
 //  asset manager.  In addition, this class uses our standard shared-pointer
 //  architecture.
@@ -47,6 +54,8 @@
 #define __CU_TEXTURE_LOADER_H__
 #include <cugl/core/assets/CULoader.h>
 #include <cugl/graphics/CUTexture.h>
+#include <cugl/graphics/CUTexturePacker.h>
+#include <cugl/graphics/CUTextureCache.h>
 
 namespace cugl {
 
@@ -81,6 +90,16 @@ namespace scene3 {
  * remainder of asset loading using {@link Application#schedule}.  This is a
  * good template for asset loaders in general.
  *
+ * A JSON directory entry with a "pack" attribute is loaded as an atlas. The
+ * images listed in the pack are combined into one or more atlas pages with a
+ * {@link TexturePacker}, and each image is available as a subtexture under
+ * its own key. Hence the application does not need to know which textures
+ * were packed. See {@link #read} for the details of the entry format.
+ *
+ * A loader may also have an optional {@link TextureCache}. When present, all
+ * images are decoded through the cache, and any mipmaps are precomputed on
+ * the loader thread instead of the main thread.
+ *
  * As with all of our loaders, this loader is designed to be attached to an
  * asset manager. Use the method {@link getHook()} to get the appropriate
  * pointer for attaching the loader.
@@ -101,6 +120,8 @@ protected:
     GLuint _wrapt;
     /** The default support for mipmaps */
     bool _mipmaps;
+    /** The (optional) cache for decoded images */
+    std::shared_ptr<TextureCache> _cache;
     
 #pragma mark Asset Loading
     /**
@@ -179,6 +200,91 @@ protected:
      */
     void materialize(const std::shared_ptr<JsonValue>& json, SDL_Surface* surface, LoaderCallback callback);
     
+    /**
+     * Loads the image for this asset through the texture cache.
+     *
+     * This is an alternative to {@link preload} for a loader with a texture
+     * cache. If mipmaps is true, the image will include a precomputed mipmap
+     * chain. This method is safe to call outside of the main thread.
+     *
+     * @param source    The pathname to the asset
+     * @param mipmaps   Whether to include a mipmap chain
+     *
+     * @return the cached image data
+     */
+    std::shared_ptr<TextureCache::Image> preloadCached(const std::string source, bool mipmaps);
+    
+    /**
+     * Creates an OpenGL texture from cached image data, and assigns it the given key.
+     *
+     * This method finishes the asset loading started in {@link preloadCached}.
+     * This step is not safe to be done in a separate thread.
+     *
+     * The loaded texture will have default parameters for scaling and wrap.
+     * It will have a mipmap if the image data has one.
+     *
+     * This method supports an optional callback function which reports whether
+     * the asset was successfully materialized.
+     *
+     * @param key       The key to access the asset after loading
+     * @param image     The cached image data
+     * @param callback  An optional callback for asynchronous loading
+     */
+    void materialize(const std::string key, const std::shared_ptr<TextureCache::Image>& image,
+                     LoaderCallback callback);
+    
+    /**
+     * Creates an OpenGL texture from cached image data according to the directory entry.
+     *
+     * This method finishes the asset loading started in {@link preloadCached}.
+     * This step is not safe to be done in a separate thread. The directory
+     * entry has the same format as for {@link #read}.
+     *
+     * This method supports an optional callback function which reports whether
+     * the asset was successfully materialized.
+     *
+     * @param json      The asset directory entry
+     * @param image     The cached image data
+     * @param callback  An optional callback for asynchronous loading
+     */
+    void materialize(const std::shared_ptr<JsonValue>& json, const std::shared_ptr<TextureCache::Image>& image,
+                     LoaderCallback callback);
+    
+    /**
+     * Loads and packs the images of an atlas entry outside the main thread.
+     *
+     * This method decodes each image listed in the "pack" attribute of the
+     * directory entry, and packs them into atlas pages. As with {@link preload},
+     * this does not use OpenGL and is safe to call in a separate thread.
+     *
+     * If any image fails to load, it is omitted from the atlas. This method
+     * returns nullptr if no image could be packed.
+     *
+     * @param json      The asset directory entry
+     *
+     * @return the packer with the atlas pages
+     */
+    std::shared_ptr<TexturePacker> preloadPack(const std::shared_ptr<JsonValue>& json);
+    
+    /**
+     * Creates the OpenGL textures for a packed atlas entry.
+     *
+     * This method finishes the asset loading started in {@link preloadPack}.
+     * The first atlas page is assigned the key of the directory entry, and any
+     * additional pages have the key as prefix (together with an underscore _
+     * and the page number). Each packed image is assigned its own key in the
+     * "pack" attribute.
+     *
+     * This method supports an optional callback function which reports whether
+     * the asset was successfully materialized.
+     *
+     * @param json      The asset directory entry
+     * @param packer    The packer with the atlas pages
+     * @param callback  An optional callback for asynchronous loading
+     */
+    void materializePack(const std::shared_ptr<JsonValue>& json,
+                         const std::shared_ptr<TexturePacker>& packer,
+                         LoaderCallback callback);
     
     /**
      * Internal method to support asset loading.
@@ -224,6 +330,16 @@ protected:
      *      "wrapS":        The s-coord wrap rule ("clamp", "repeat", or "mirrored")
      *      "wrapT":        The t-coord wrap rule ("clamp", "repeat", or "mirrored")
      *
+     * Alternatively, the entry may specify an atlas of packed images. Such
+     * an entry replaces "file" with the following values
+     *
+     *      "pack":         An object mapping keys to image paths (or to objects
+     *                      with a "file" attribute)
+     *      "padding":      The gutter around each image in pixels (int)
+     *      "maxsize":      The maximum width or height of an atlas page (int)
+     *
+     * The filter and wrap settings apply to every atlas page.
+     *
      * @param json      The directory entry for the asset
      * @param callback  An optional callback for asynchronous loading
      * @param async     Whether the asset was loaded asynchronously
@@ -241,7 +357,8 @@ protected:
      * are released.
      *
      * This version of the method not only unloads the given {@link Texture},
-     * but also any texture atlases attached to it.
+     * but also any texture atlases attached to it. For a packed entry, it
+     * unloads every atlas page and packed image.
      *
      * @param json      The directory entry for the asset
      *
@@ -279,6 +396,7 @@ public:
         _priority = 0;
         _assets.clear();
         _loader = nullptr;
+        _cache = nullptr;
     }
     
     /**
@@ -423,6 +541,29 @@ public:
      */
     void setMipMaps(bool flag) { _mipmaps = flag; }
     
+    /**
+     * Returns the texture cache for this loader.
+     *
+     * If this value is nullptr (the default), images are decoded from their
+     * source files every time they are loaded.
+     *
+     * @return the texture cache for this loader.
+     */
+    const std::shared_ptr<TextureCache>& getCache() const { return _cache; }
+    
+    /**
+     * Sets the texture cache for this loader.
+     *
+     * If this value is nullptr (the default), images are decoded from their
+     * source files every time they are loaded. Otherwise, images are decoded
+     * once and stored in the cache, and are read from the cache afterwards.
+     *
+     * The cache should only be changed when this loader is idle.
+     *
+     * @param cache The texture cache for this loader.
+     */
+    void setCache(const std::shared_ptr<TextureCache>& cache) { _cache = cache; }
+    
 };
 
     }
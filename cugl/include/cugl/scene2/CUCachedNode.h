@@ -0,0 +1,377 @@
+//
+//  CUCachedNode.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a scene graph node that caches the drawing of its
+//  descendants in a texture. The descendants are drawn once to an offscreen
+//  render target, and every render pass after that draws a single textured
+//  quad. The cache is only drawn again when a descendant changes. This is
+//  ideal for layers that are mostly static, such as backgrounds and props.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Author: Walker White
+//  Version: 7/3/24 (CUGL 3.0 reorganization)
+//
+#ifndef __CU_CACHED_NODE_H__
+#define __CU_CACHED_NODE_H__
+#include <cugl/scene2/CUSceneNode2.h>
+#include <cugl/graphics/CURenderTarget.h>
+
+namespace cugl {
+
+    /**
+     * The classes to construct a 2-d scene graph.
+     *
+     * Even though this is an optional package, this is one of the core features
+     * of CUGL. These classes provide basic UI support (including limited Figma)
+     * support. Any 2-d game will make extensive use of these classes. And
+     * even 3-d games may use these classes for the HUD overlay.
+     */
+    namespace scene2 {
+/**
+ * This is a scene graph node that caches the drawing of its descendants.
+ *
+ * The first time this node is rendered, it draws all of its descendants to
+ * an offscreen {@link graphics::RenderTarget}. After that, rendering this
+ * node draws the texture of that render target as a single quad. The
+ * descendants are only drawn again when one of them changes (see
+ * {@link SceneNode#markDirty}). This replaces many draw calls (and a lot of
+ * vertex generation) with a single quad for layers that rarely change.
+ *
+ * The cache covers the content bounds of this node, in node coordinates.
+ * Any part of a descendant outside of these bounds is clipped. Hence this
+ * node must be given a size before it is rendered. The texture resolution
+ * is the content size times the pixel density (see {@link #getDensity}).
+ *
+ * Descendants are drawn to the cache with a white tint, and the cache is
+ * then tinted with the color of this node. So a descendant that does not
+ * have relative color will still be tinted by this node. In addition, the
+ * cache is exact for opaque content. Translucent content drawn over an
+ * empty part of the cache may appear slightly more transparent.
+ *
+ * A CachedNode is a render barrier in an {@link OrderedNode}. Its
+ * descendants are drawn as a unit with the priority of this node.
+ *
+ * Drawing the cache requires ending and restarting the current pass of the
+ * sprite batch. Therefore the cache is not refreshed in the middle of an
+ * unusual drawing state (e.g. a stencil effect). Furthermore, you should
+ * not mark descendants dirty every frame, as that is slower than drawing
+ * the descendants directly.
+ */
+class CachedNode : public SceneNode {
+#pragma mark Values
+protected:
+    /** The render target storing the cached drawing */
+    std::shared_ptr<graphics::RenderTarget> _target;
+    /** The pixel density of the cache */
+    float _density;
+    /** Whether the cache must be drawn again */
+    bool _cacheDirty;
+    /** The number of times the cache has been drawn */
+    Uint32 _refreshes;
+
+#pragma mark -
+#pragma mark Constructors
+public:
+    /**
+     * Creates an uninitialized cached node.
+     *
+     * You must initialize this CachedNode before use.
+     *
+     * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate a CachedNode
+     * on the heap, use one of the static constructors instead.
+     */
+    CachedNode();
+
+    /**
+     * Deletes this node, disposing all resources
+     */
+    ~CachedNode() { dispose(); }
+
+    /**
+     * Disposes all of the resources used by this node.
+     *
+     * A disposed CachedNode can be safely reinitialized. Any children owned by
+     * this node will be released. They will be deleted if no other object owns
+     * them.
+     *
+     * It is unsafe to call this on a CachedNode that is still currently inside
+     * of a scene graph.
+     */
+    virtual void dispose() override;
+
+    /**
+     * Initializes a node with the given JSON specificaton.
+     *
+     * This initializer is designed to receive the "data" object from the
+     * JSON passed to {@link Scene2Loader}. This JSON format supports all
+     * of the attribute values of its parent class. In addition, it supports
+     * the following additional attribute:
+     *
+     *      "density":  A number representing the pixels per point of the cache
+     *
+     * All attributes are optional. There are no required attributes.
+     *
+     * @param manager   The asset manager handling this asset
+     * @param data      The JSON object specifying the node
+     *
+     * @return true if initialization was successful.
+     */
+    virtual bool initWithData(const AssetManager* manager,
+                              const std::shared_ptr<JsonValue>& data) override;
+
+#pragma mark -
+#pragma mark Static Constructors
+    /**
+     * Returns a newly allocated cached node at the world origin.
+     *
+     * The node has both position and size (0,0). It must be given a size
+     * before it is rendered.
+     *
+     * @return a newly allocated cached node at the world origin.
+     */
+    static std::shared_ptr<CachedNode> alloc() {
+        std::shared_ptr<CachedNode> result = std::make_shared<CachedNode>();
+        return (result->init() ? result : nullptr);
+    }
+
+    /**
+     * Returns a newly allocated cached node with the given size.
+     *
+     * The size defines the content size. The bounding box of the node is
+     * (0,0,width,height) and is anchored in the bottom left corner (0,0).
+     * The node is positioned at the origin in parent space.
+     *
+     * @param size  The size of the node in parent space
+     *
+     * @return a newly allocated cached node with the given size.
+     */
+    static std::shared_ptr<CachedNode> allocWithBounds(const Size size) {
+        std::shared_ptr<CachedNode> result = std::make_shared<CachedNode>();
+        return (result->initWithBounds(size) ? result : nullptr);
+    }
+
+    /**
+     * Returns a newly allocated cached node with the given bounds.
+     *
+     * The rectangle origin is the bottom left corner of the node in parent
+     * space, and corresponds to the origin of the Node space. The size defines
+     * its content width and height in node space. The node anchor is placed
+     * in the bottom left corner.
+     *
+     * @param rect  The bounds of the node in parent space
+     *
+     * @return a newly allocated cached node with the given bounds.
+     */
+    static std::shared_ptr<CachedNode> allocWithBounds(const Rect rect) {
+        std::shared_ptr<CachedNode> result = std::make_shared<CachedNode>();
+        return (result->initWithBounds(rect) ? result : nullptr);
+    }
+
+    /**
+     * Returns a newly allocated cached node with the given JSON specificaton.
+     *
+     * This initializer is designed to receive the "data" object from the
+     * JSON passed to {@link Scene2Loader}. This JSON format supports all
+     * of the attribute values of its parent class. In addition, it supports
+     * the following additional attribute:
+     *
+     *      "density":  A number representing the pixels per point of the cache
+     *
+     * All attributes are optional. There are no required attributes.
+     *
+     * @param manager   The asset manager handling this asset
+     * @param data      The JSON object specifying the node
+     *
+     * @return a newly allocated cached node with the given JSON specificaton.
+     */
+    static std::shared_ptr<CachedNode> allocWithData(const AssetManager* manager,
+                                                     const std::shared_ptr<JsonValue>& data) {
+        std::shared_ptr<CachedNode> result = std::make_shared<CachedNode>();
+        return (result->initWithData(manager,data) ? result : nullptr);
+    }
+
+#pragma mark -
+#pragma mark Attributes
+    /**
+     * Returns the pixel density of the cache.
+     *
+     * This is the number of texture pixels per point of the content size.
+     * By default, it is the pixel density of the display.
+     *
+     * @return the pixel density of the cache.
+     */
+    float getDensity() const { return _density; }
+
+    /**
+     * Sets the pixel density of the cache.
+     *
+     * This is the number of texture pixels per point of the content size.
+     * By default, it is the pixel density of the display. Changing this
+     * value will cause the cache to be drawn again.
+     *
+     * @param density   The pixel density of the cache.
+     */
+    void setDensity(float density);
+
+    /**
+     * Returns true if the cache will be drawn again at the next render.
+     *
+     * @return true if the cache will be drawn again at the next render.
+     */
+    bool isCacheDirty() const { return _cacheDirty; }
+
+    /**
+     * Returns the number of times the cache has been drawn.
+     *
+     * This value is useful for verifying that a layer is truly static.
+     *
+     * @return the number of times the cache has been drawn.
+     */
+    Uint32 getRefreshCount() const { return _refreshes; }
+
+    /**
+     * Returns the texture storing the cached drawing.
+     *
+     * This value is nullptr if the cache has never been drawn.
+     *
+     * @return the texture storing the cached drawing.
+     */
+    std::shared_ptr<graphics::Texture> getTexture() const {
+        return _target == nullptr ? nullptr : _target->getTexture();
+    }
+
+    /**
+     * Sets the untransformed size of the node.
+     *
+     * The content size is the region covered by the cache. Changing the
+     * size will cause the cache to be drawn again.
+     *
+     * @param size  The untransformed size of the node.
+     */
+    virtual void setContentSize(const Size size) override;
+
+    /**
+     * Sets the untransformed size of the node.
+     *
+     * The content size is the region covered by the cache. Changing the
+     * size will cause the cache to be drawn again.
+     *
+     * @param width     The untransformed width of the node.
+     * @param height    The untransformed height of the node.
+     */
+    virtual void setContentSize(float width, float height) override {
+        setContentSize(Size(width, height));
+    }
+
+#pragma mark -
+#pragma mark Rendering
+    /**
+     * Draws this node and all of its children with the given SpriteBatch.
+     *
+     * If the cache is dirty, this method draws the descendants of this node
+     * to the cache first. It then draws the cache as a single quad.
+     *
+     * @param batch     The SpriteBatch to draw with.
+     * @param transform The global transformation matrix.
+     * @param tint      The tint to blend with the node color.
+     */
+    virtual void render(const std::shared_ptr<graphics::SpriteBatch>& batch,
+                        const Affine2& transform, Color4 tint) override;
+
+    /**
+     * Draws this node and all of its children with the given SpriteBatch.
+     *
+     * If the cache is dirty, this method draws the descendants of this node
+     * to the cache first. It then draws the cache as a single quad.
+     *
+     * @param batch     The SpriteBatch to draw with.
+     */
+    virtual void render(const std::shared_ptr<graphics::SpriteBatch>& batch) override {
+        render(batch,Affine2::IDENTITY,Color4::WHITE);
+    }
+
+    /**
+     * Draws the cache of this node via the given SpriteBatch.
+     *
+     * This method only draws the cached texture. It does not refresh the
+     * cache if it is dirty.
+     *
+     * @param batch     The SpriteBatch to draw with.
+     * @param transform The global transformation matrix.
+     * @param tint      The tint to blend with the node color.
+     */
+    virtual void draw(const std::shared_ptr<graphics::SpriteBatch>& batch,
+                      const Affine2& transform, Color4 tint) override;
+
+    /**
+     * Prepares this node to be drawn, returning true if the children should be prepared.
+     *
+     * This method updates the world transform of this node, but always
+     * returns false. The descendants of this node are drawn in cache space
+     * (if they are drawn at all), so preparing them is wasted work.
+     *
+     * @param transform The global transformation matrix.
+     * @param tint      The tint to blend with the node color.
+     *
+     * @return false, as the children of this node should not be prepared.
+     */
+    virtual bool prepare(const Affine2& transform, Color4 tint) override;
+
+protected:
+#pragma mark -
+#pragma mark Internal Helpers
+    /**
+     * Invalidates the cached drawing of this node.
+     *
+     * This method is called whenever a descendant of this node changes.
+     */
+    virtual void invalidateCache() override { _cacheDirty = true; }
+
+    /**
+     * Draws the descendants of this node to the cache.
+     *
+     * If the sprite batch is in the middle of a pass, that pass is ended
+     * and restarted with the same perspective, scissor, color, and blend
+     * state.
+     *
+     * @param batch     The SpriteBatch to draw with.
+     */
+    void refresh(const std::shared_ptr<graphics::SpriteBatch>& batch);
+
+    /** This macro disables the copy constructor (not allowed on scene graphs) */
+    CU_DISALLOW_COPY_AND_ASSIGN(CachedNode);
+};
+    }
+}
+
+#endif /* __CU_CACHED_NODE_H__ */
@@ -548,6 +548,22 @@ public:
     virtual void draw(const std::shared_ptr<graphics::SpriteBatch>& batch,
                       const Affine2& transform, Color4 tint) override;
     
+    /**
+     * Prepares this node to be drawn, returning true if the children should be prepared.
+     *
+     * In addition to updating the world transform, this method generates the
+     * render data for this node if it is not present. This allows a
+     * {@link Scene2} with a thread pool to generate vertices off the main
+     * thread. It is safe to call this method on a worker thread, provided
+     * that no other thread is modifying this node.
+     *
+     * @param transform The global transformation matrix.
+     * @param tint      The tint to blend with the node color.
+     *
+     * @return true if the children of this node should be prepared.
+     */
+    virtual bool prepare(const Affine2& transform, Color4 tint) override;
+    
     /**
      * Refreshes this node to restore the render data.
      */
@@ -11,6 +11,10 @@
 //  class. You should set these values to manually arrange your scene graph
 //  elements
 //
+//  An ordered node can also (optionally) regroup its render queue to reduce
+//  the number of draw calls. Within a priority layer, draws that do not
+//  overlap are gathered together by texture and blend state.
+//
 //  This class uses our standard shared-pointer architecture.
 //
 //  1. The constructor does not perform any initialization; it just sets all
@@ -47,6 +51,7 @@
 #ifndef __CU_ORDERED_NODE_H__
 #define __CU_ORDERED_NODE_H__
 #include <cugl/scene2/CUSceneNode2.h>
+#include <vector>
 
 namespace cugl {
 
@@ -80,7 +85,9 @@ namespace cugl {
  * traversal). In addition, we must call std::sort (currently IntroSort)
  * on all of the descendants every single render pass. However, as long
  * as the number of children of this node is reasonably sized, this should
- * not be an issue.
+ * not be an issue. The render queue and the scissor masks are kept between
+ * passes, so that once the queue has reached its peak size, rendering does
+ * not allocate any memory.
  *
  * An OrderedNode is a render barrier. This means that if one OrderedNode
  * (the first node) is a descendant of another OrderedNode (the second node),
@@ -88,6 +95,15 @@ namespace cugl {
  * node. So it is impossible to interleave other descendants of the second
  * node with descendants of the first node.  This is necessary as the
  * two OrderedNodes may have incompatible orderings.
+ *
+ * Sorting by priority can interleave nodes with different textures, which
+ * forces the {@link graphics::SpriteBatch} to split its draw calls. If you
+ * enable batching (see {@link #setBatching}), this node will regroup the
+ * render queue within each priority layer. A {@link TexturedNode} may be
+ * drawn earlier to join a batch with the same texture and blend state, but
+ * only if it does not overlap any node that it moves in front of. Any other
+ * node that draws (including a nested OrderedNode) is a fixed point that
+ * nothing moves across.
  */
 class OrderedNode : public SceneNode {
 public:
@@ -187,41 +203,28 @@ protected:
      * the scissor value. Normally these are managed by the call stack during
      * a recursive call. To reorder rendering, we have to make this explicit.
      *
-     * This class is essentially a struct with a sort order.
+     * This class is a plain struct with a sort order, so that the render queue
+     * can be rebuilt every pass without allocating. The node pointer is only
+     * valid during the render pass, as the scene graph owns the node.
      */
     class Context {
     public:
         /** The parent of this inner class (as C++ does not have this Java feature) */
         OrderedNode* parent;
         /** The node to be drawn at this step */
-        std::shared_ptr<SceneNode> node;
-        /** The scissor value (possibly nullptr) */
-        std::shared_ptr<graphics::Scissor> scissor;
+        SceneNode* node;
+        /** The index of the scissor mask (-1 for the sprite batch scissor) */
+        Sint32 scissor;
         /** The drawing transform */
         Affine2 transform;
         /** The tint color */
         Color4 tint;
         /** The canonical order (for pre-order and post-order traversals) */
         Uint32 canonical;
-        
-        /**
-         * Creates a drawing context with the given parent object
-         *
-         * @param parent    The parent object for the inner class
-         */
-        Context(OrderedNode* parent);
-        
-        /**
-         * Creates a copy of the given drawing context
-         *
-         * @param copy      The drawing context to copy
-         */
-        Context(const Context& copy);
-
-        /**
-         * Deletes this drawing context, disposing of all resources.
-         */
-        ~Context();
+        /** The next context in the same batch (used by the batching pass) */
+        Context* next;
+        /** Whether the node is a render barrier (an OrderedNode or CachedNode) */
+        bool barrier;
 
         /**
          * Returns the value *a < *b
@@ -236,13 +239,78 @@ protected:
          */
         static bool sortCompare(Context* a, Context* b);
     };
+    
+    /**
+     * A class representing a group of draws in the batching pass.
+     *
+     * A batch is a chain of render contexts that share a texture and blend
+     * state, so that the sprite batch can draw them without a flush. The
+     * bounds are the union of the world space bounds of the nodes in the
+     * chain, and are used to ensure that no node is moved in front of a
+     * node that it overlaps.
+     */
+    class Batch {
+    public:
+        /** The OpenGL texture buffer (0 for no texture) */
+        GLuint texture;
+        /** The gradient (nullptr for none) */
+        const void* gradient;
+        /** The index of the scissor mask */
+        Sint32 scissor;
+        /** The blend equation */
+        GLenum blendEq;
+        /** The source blend factor */
+        GLenum srcFactor;
+        /** The destination blend factor */
+        GLenum dstFactor;
+        /** Whether the nodes are drawn as lines instead of triangles */
+        bool lines;
+        /** Whether this batch is a fixed point that cannot be moved across */
+        bool fixed;
+        /** Whether this batch draws nothing (and so can be moved across) */
+        bool passive;
+        /** The world space bounds of this batch */
+        Rect bounds;
+        /** The first context in this batch */
+        Context* head;
+        /** The last context in this batch */
+        Context* tail;
+        
+        /**
+         * Returns true if this batch has the same drawing state as other.
+         *
+         * @param other The batch to compare
+         *
+         * @return true if this batch has the same drawing state as other.
+         */
+        bool matches(const Batch& other) const {
+            return (texture == other.texture && gradient == other.gradient &&
+                    scissor == other.scissor && blendEq == other.blendEq &&
+                    srcFactor == other.srcFactor && dstFactor == other.dstFactor &&
+                    lines == other.lines);
+        }
+    };
 
-    /** The render queue (always use a deque for this functionality) */
-    std::deque<Context*> _entries;
-    /** The global scissor context (necessary as sprite batches manage this normally) */
-    std::shared_ptr<graphics::Scissor> _viewport;
+    /** The drawing contexts (reused every pass) */
+    std::vector<Context> _entries;
+    /** The render queue, which is sorted (reused every pass) */
+    std::vector<Context*> _queue;
+    /** The scissor masks for scissored descendants (reused every pass) */
+    std::vector<std::shared_ptr<graphics::Scissor>> _scissors;
+    /** The number of scissor masks in use this pass */
+    size_t _scissorSize;
+    /** The scissor of the sprite batch at the start of the render pass */
+    std::shared_ptr<graphics::Scissor> _active;
+    /** The index of the global scissor context (-1 for the sprite batch scissor) */
+    Sint32 _viewport;
     /** The current render order */
     Order _order;
+    /** Whether to regroup the render queue to reduce draw calls */
+    bool _batching;
+    /** The number of batches saved in the latest render pass */
+    Uint32 _batchesSaved;
+    /** The batches for the current priority layer (reused every pass) */
+    std::vector<Batch> _batches;
     
     /**
      * Adds the given node ot the render queue.
@@ -256,7 +324,59 @@ protected:
      * @param transform The global transformation matrix.
      * @param tint      The tint to blend with the node color.
      */
-    void visit(const std::shared_ptr<SceneNode>& node, const Affine2& transform, Color4 tint);
+    void visit(SceneNode* node, const Affine2& transform, Color4 tint);
+    
+    /**
+     * Returns a scissor mask for the given node, intersected with the viewport.
+     *
+     * The scissor mask is taken from a pool that is reused every render pass.
+     * The value returned is the index of the mask in that pool.
+     *
+     * @param scissor   The local scissor mask of the node
+     * @param transform The global transformation matrix of the node
+     *
+     * @return the index of the scissor mask for the given node
+     */
+    Sint32 acquireScissor(const std::shared_ptr<graphics::Scissor>& scissor,
+                          const Affine2& transform);
+    
+    /**
+     * Returns the scissor mask for the given index.
+     *
+     * An index of -1 refers to the scissor of the sprite batch at the start
+     * of the render pass.
+     *
+     * @param index The scissor mask index
+     *
+     * @return the scissor mask for the given index.
+     */
+    const std::shared_ptr<graphics::Scissor>& getMask(Sint32 index) const {
+        return index < 0 ? _active : _scissors[index];
+    }
+    
+    /**
+     * Regroups the sorted render queue to reduce the number of draw calls.
+     *
+     * The queue is processed one priority layer at a time. Within a layer,
+     * a node is moved earlier to join the most recent batch with the same
+     * drawing state, provided that it does not overlap any batch that it
+     * moves in front of. This method also computes the number of batches
+     * saved.
+     */
+    void batchEntries();
+    
+    /**
+     * Regroups the given priority layer of the render queue.
+     *
+     * The layer is the range [start,end) of the (sorted) render queue. The
+     * queue is rewritten in place.
+     *
+     * @param start     The first entry of the layer
+     * @param end       The entry after the last entry of the layer
+     *
+     * @return the number of batches saved in this layer
+     */
+    Uint32 batchLayer(size_t start, size_t end);
     
 #pragma mark -
 #pragma mark Constructors
@@ -338,6 +458,7 @@ public:
      * the following additional attributes:
      *
      *      "order":    The sort order of this node.
+     *      "batching": Whether to regroup draws to reduce draw calls.
      *
      * Sort orders are specified as lower case strings representing the names
      * of the enum with dashes in place of underscores (e.g. "pre-order",
@@ -554,6 +675,7 @@ public:
      * the following additional attributes:
      *
      *      "order":    The sort order of this node.
+     *      "batching": Whether to regroup draws to reduce draw calls.
      *
      * Sort orders are specified as lower case strings representing the names
      * of the enum with dashes in place of underscores (e.g. "pre-order",
@@ -600,6 +722,46 @@ public:
      * @param order The render order of this node
      */
     void setOrder(Order order) { _order = order; }
+    
+    /**
+     * Returns true if this node regroups its render queue to reduce draw calls.
+     *
+     * When batching is enabled, nodes in the same priority layer are gathered
+     * together by texture and blend state, as long as this does not change
+     * the draw order of any two nodes that overlap. This has no effect if the
+     * order is {@link Order#PRE_ORDER}.
+     *
+     * This value is false by default.
+     *
+     * @return true if this node regroups its render queue to reduce draw calls.
+     */
+    bool isBatching() const { return _batching; }
+    
+    /**
+     * Sets whether this node regroups its render queue to reduce draw calls.
+     *
+     * When batching is enabled, nodes in the same priority layer are gathered
+     * together by texture and blend state, as long as this does not change
+     * the draw order of any two nodes that overlap. This has no effect if the
+     * order is {@link Order#PRE_ORDER}.
+     *
+     * Nodes are assumed to draw inside of their content bounds. A node that
+     * draws outside of its bounds may be reordered incorrectly.
+     *
+     * @param value Whether this node regroups its render queue to reduce draw calls.
+     */
+    void setBatching(bool value) { _batching = value; }
+    
+    /**
+     * Returns the number of batches saved in the latest render pass.
+     *
+     * This is the number of drawing state changes (texture, gradient, scissor,
+     * or blend) removed by regrouping the render queue. Each state change
+     * would otherwise force the sprite batch to issue another draw call.
+     *
+     * @return the number of batches saved in the latest render pass.
+     */
+    Uint32 getBatchesSaved() const { return _batchesSaved; }
 
     /**
      * Draws this node and all of its children with the given SpriteBatch.
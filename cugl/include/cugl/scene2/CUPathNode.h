@@ -137,6 +137,14 @@ protected:
     graphics::MeshExtruder _extruder;
     /** The fringe mesh */
     graphics::Mesh<graphics::SpriteVertex> _border;
+    /** Whether the cached extrusion meshes are valid */
+    bool _extruded;
+    /** The content hash of the inputs to the cached extrusion */
+    size_t _extrusion;
+    /** The cached interior mesh, before texturing and shifting */
+    graphics::Mesh<graphics::SpriteVertex> _extmesh;
+    /** The cached fringe mesh, before shifting */
+    graphics::Mesh<graphics::SpriteVertex> _extborder;
     
 public:
 #pragma mark -
@@ -699,9 +707,23 @@ private:
      * Updates the extrusion polygon, based on the current settings.
      *
      * This method uses {@link SimpleExtruder}, as it is safe for framerate
-     * calculation.
+     * calculation. The result is memoized by a hash of the path, the stroke,
+     * the joint, the cap, and the fringe. If none of these have changed since
+     * the last extrusion, this method copies the cached meshes instead of
+     * extruding again. The mesh buffers are reused, so this does not allocate
+     * memory unless the extrusion grows.
      */
     void updateExtrusion();
+    
+    /**
+     * Returns the content hash of the current extrusion inputs.
+     *
+     * The hash includes the path vertices, whether the path is closed, the
+     * stroke width, the joint, the end cap, and the fringe width.
+     *
+     * @return the content hash of the current extrusion inputs.
+     */
+    size_t hashExtrusion() const;
 
     /** This macro disables the copy constructor (not allowed on scene graphs) */
     CU_DISALLOW_COPY_AND_ASSIGN(PathNode);
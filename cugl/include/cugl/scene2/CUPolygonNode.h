@@ -614,6 +614,8 @@ public:
      * Sets the polgon to the vertices expressed in texture space.
      *
      * The vertices will be triangulated with {@link EarclipTriangulator}.
+     * The triangulation uses the shared {@link TriangulationCache}, so shapes
+     * that repeat (such as animation frames) are only triangulated once.
      *
      * @param vertices    The vertices to texture
      */
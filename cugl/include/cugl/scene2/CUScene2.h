@@ -46,6 +46,7 @@
 #include <cugl/core/CUScene.h>
 #include <cugl/scene2/CUSceneNode2.h>
 #include <cugl/graphics/CUSpriteBatch.h>
+#include <cugl/core/util/CUThreadPool.h>
 
 namespace cugl {
 
@@ -93,6 +94,27 @@ protected:
     /** The destination factor for the blend function */
     GLenum _dstFactor;
     
+    /** The visible region of the scene (in scene coordinates) */
+    Rect _viewBounds;
+    /** Whether the visible region is valid (e.g. the scene is rendering) */
+    bool _viewActive;
+    
+    /** Whether the children are indexed by tag and name */
+    bool _indexed;
+    /** Whether removing a child may reorder the remaining children */
+    bool _unordered;
+    /** The children with a nonzero tag, indexed by tag */
+    std::unordered_multimap<unsigned int, scene2::SceneNode*> _tagIndex;
+    /** The children with a nonempty name, indexed by the hash of the name */
+    std::unordered_multimap<size_t, scene2::SceneNode*> _nameIndex;
+    
+    /** The shared state of a parallel prepare pass (defined in the .cpp) */
+    class Prepare;
+    /** The thread pool for preparing nodes in parallel (nullptr for none) */
+    std::shared_ptr<ThreadPool> _threads;
+    /** The state of the most recent prepare pass */
+    std::shared_ptr<Prepare> _prepare;
+    
 #pragma mark -
 #pragma mark Constructors
 public:
@@ -279,6 +301,58 @@ public:
      */
     size_t getChildCount() const { return _children.size(); }
     
+    /**
+     * Returns true if this scene indexes its children by tag and name.
+     *
+     * By default, {@link #getChildByTag} and {@link #getChildByName} search
+     * the children in order. An indexed scene keeps a hash table of its
+     * children, so these lookups (and the removal methods that use them)
+     * take constant time. Children with a tag of 0 or an empty name are
+     * not indexed.
+     *
+     * @return true if this scene indexes its children by tag and name.
+     */
+    bool isIndexed() const { return _indexed; }
+    
+    /**
+     * Sets whether this scene indexes its children by tag and name.
+     *
+     * By default, {@link #getChildByTag} and {@link #getChildByName} search
+     * the children in order. An indexed scene keeps a hash table of its
+     * children, so these lookups (and the removal methods that use them)
+     * take constant time. Children with a tag of 0 or an empty name are
+     * not indexed.
+     *
+     * @param value Whether this scene indexes its children by tag and name.
+     */
+    void setIndexed(bool value);
+    
+    /**
+     * Returns true if removing a child may reorder the remaining children.
+     *
+     * By default, removing a child shifts every child after it, so that the
+     * children remain in the order they were added. In an unordered scene,
+     * the last child is moved into the position of the removed child
+     * instead. This makes removal constant time, but it changes the draw
+     * order of the children.
+     *
+     * @return true if removing a child may reorder the remaining children.
+     */
+    bool isUnordered() const { return _unordered; }
+    
+    /**
+     * Sets whether removing a child may reorder the remaining children.
+     *
+     * By default, removing a child shifts every child after it, so that the
+     * children remain in the order they were added. In an unordered scene,
+     * the last child is moved into the position of the removed child
+     * instead. This makes removal constant time, but it changes the draw
+     * order of the children.
+     *
+     * @param value Whether removing a child may reorder the remaining children.
+     */
+    void setUnordered(bool value) { _unordered = value; }
+    
     /**
      * Returns the child at the given position.
      *
@@ -470,7 +544,8 @@ public:
      * Removes the child at the given position from this Scene.
      *
      * Removing a child alters the position of every child after it. Hence
-     * it is unsafe to cache child positions.
+     * it is unsafe to cache child positions. If this scene is unordered, the
+     * last child is moved into the position instead.
      *
      * @param pos   The position of the child node which will be removed.
      */
@@ -480,7 +555,8 @@ public:
      * Removes a child from this Scene.
      *
      * Removing a child alters the position of every child after it. Hence
-     * it is unsafe to cache child positions.
+     * it is unsafe to cache child positions. If this scene is unordered, the
+     * last child is moved into the position instead.
      *
      * If the child is not in this node, nothing happens.
      *
@@ -551,6 +627,53 @@ public:
         _batch = batch;
     }
     
+    /**
+     * Returns the visible region of this scene in scene coordinates.
+     *
+     * This region is computed at the start of {@link #render} from the
+     * camera, and it is used by any node that culls its children (see
+     * {@link SceneNode#setCulling}). The value is only meaningful during
+     * a call to {@link #render}.
+     *
+     * @return the visible region of this scene in scene coordinates.
+     */
+    const Rect& getViewBounds() const { return _viewBounds; }
+    
+    /**
+     * Returns the thread pool for preparing this scene in parallel.
+     *
+     * If this value is not nullptr, {@link #render} happens in two phases.
+     * First, the scene graph is split into disjoint subtrees, which are
+     * prepared in parallel (see {@link SceneNode#prepare}). This computes
+     * the world transforms and generates the vertices of each node. Then
+     * the main thread traverses the scene graph as normal, submitting the
+     * prepared data to the sprite batch.
+     *
+     * @return the thread pool for preparing this scene in parallel.
+     */
+    const std::shared_ptr<ThreadPool>& getThreadPool() const { return _threads; }
+    
+    /**
+     * Sets the thread pool for preparing this scene in parallel.
+     *
+     * If this value is not nullptr, {@link #render} happens in two phases.
+     * First, the scene graph is split into disjoint subtrees, which are
+     * prepared in parallel (see {@link SceneNode#prepare}). This computes
+     * the world transforms and generates the vertices of each node. Then
+     * the main thread traverses the scene graph as normal, submitting the
+     * prepared data to the sprite batch.
+     *
+     * The main thread participates in the prepare phase, and only waits on
+     * subtrees already claimed by a worker. Hence it is safe to share this
+     * pool with other work (such as asset loading). However, the scene graph
+     * must not be modified by any other thread during {@link #render}.
+     *
+     * @param threads   The thread pool for preparing this scene in parallel.
+     */
+    void setThreadPool(const std::shared_ptr<ThreadPool>& threads) {
+        _threads = threads;
+    }
+    
     /**
      * Draws all of the children in this scene with the given SpriteBatch.
      *
@@ -565,11 +688,45 @@ public:
      */
     virtual void render() override;
     
+protected:
+    /**
+     * Prepares all of the children in this scene in parallel.
+     *
+     * This is the first phase of {@link #render} when this scene has a
+     * thread pool. The scene graph is expanded breadth-first (preparing
+     * each node along the way) until there are enough subtrees to share
+     * among the threads. Those subtrees are then prepared in parallel,
+     * and this method returns once all of them are done.
+     *
+     * This method must be called after the view bounds are computed.
+     */
+    void prepare();
+    
 private:
 #pragma mark -
 #pragma mark Internal Helpers
+    /**
+     * Adds the given child to the tag and name indices of this scene.
+     *
+     * This method does nothing if this scene is not indexed.
+     *
+     * @param child The child to index
+     */
+    void indexChild(scene2::SceneNode* child);
+    
+    /**
+     * Removes the given child from the tag and name indices of this scene.
+     *
+     * This method does nothing if this scene is not indexed.
+     *
+     * @param child The child to remove from the index
+     */
+    void unindexChild(scene2::SceneNode* child);
+    
     // Tightly couple with Node
     friend class SceneNode;
+    // Caches disable culling while drawing to a texture
+    friend class CachedNode;
 };
 
     }
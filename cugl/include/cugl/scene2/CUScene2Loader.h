@@ -106,6 +106,8 @@ protected:
         WIRE,
         /** An ordered node (for non pre-traversals) */
         ORDER,
+        /** A cached node (for static subtrees) */
+        CACHED,
         /** A canvas node for vector graphics */
         CANVAS,
         /** An animation node type */
@@ -47,6 +47,7 @@
 #include <cugl/core/assets/CUJsonValue.h>
 #include <cugl/graphics/CUSpriteBatch.h>
 #include <cugl/graphics/CUScissor.h>
+#include <unordered_map>
 #include <vector>
 #include <string>
 
@@ -175,6 +176,34 @@ protected:
      */
     Affine2  _combined;
     
+    /**
+     * The cached world transform matrix.
+     *
+     * This is the local transform combined with the transform passed to
+     * {@link #render} by the parent. It is only recomputed when this node or
+     * one of its ancestors has changed.
+     */
+    Affine2  _world;
+    /** The cached world tint (the tint color combined with the parent tint) */
+    Color4   _worldTint;
+    /** The parent transform used to compute the cached world transform */
+    Affine2  _worldParent;
+    /** The parent tint used to compute the cached world tint */
+    Color4   _tintParent;
+    /** The tint color used to compute the cached world tint */
+    Color4   _tintLocal;
+    /** Whether the cached world values must be recomputed */
+    bool _worldDirty;
+    /** Whether the cached world values changed at the last update */
+    bool _worldMoved;
+    
+    /** The spatial index of the visible children (nullptr if not culling) */
+    std::shared_ptr<AABBTree> _index;
+    /** The proxy for this node in the spatial index of its parent (-1 if none) */
+    Sint32 _proxy;
+    /** The children that intersected the view at the last render */
+    std::vector<void*> _culled;
+    
     /** The array of children nodes */
     std::vector<std::shared_ptr<SceneNode>> _children;
 
@@ -187,6 +216,15 @@ protected:
 
     /** The (current) child offset of this node (-1 if root) */
     int _childOffset;
+    
+    /** Whether the children are indexed by tag and name */
+    bool _indexed;
+    /** Whether removing a child may reorder the remaining children */
+    bool _unordered;
+    /** The children with a nonzero tag, indexed by tag */
+    std::unordered_multimap<unsigned int, SceneNode*> _tagIndex;
+    /** The children with a nonempty name, indexed by the hash of the name */
+    std::unordered_multimap<size_t, SceneNode*> _nameIndex;
 
     /**
      * An identifying tag.
@@ -373,6 +411,7 @@ public:
      *      "scale":    Either a two-element number array or a single number
      *      "angle":    A number, representing the rotation in DEGREES, not radians
      *      "visible":  A boolean value, representing if the node is visible
+     *      "culling":  A boolean value, representing if the node culls its children
      *
      * All attributes are optional. There are no required attributes.
      *
@@ -534,6 +573,7 @@ public:
      *      "scale":    A two-element number array
      *      "angle":    A number, representing the rotation in DEGREES, not radians
      *      "visible":  A boolean value, representing if the node is visible
+     *      "culling":  A boolean value, representing if the node culls its children
      *
      * All attributes are optional. There are no required attributes.
      *
@@ -570,7 +610,7 @@ public:
      *
      * @param tag   A tag that is used to identify the node easily.
      */
-    void setTag(unsigned int tag) { _tag = tag; }
+    void setTag(unsigned int tag);
     
     /**
      * Returns a string that is used to identify the node.
@@ -592,10 +632,7 @@ public:
      *
      * @param name  A string that is used to identify the node.
      */
-    void setName(const std::string name) {
-        _name = name;
-        _hashOfName = std::hash<std::string>()(_name);
-    }
+    void setName(const std::string name);
 
     /**
      * Returns the class name of this node.
@@ -911,6 +948,22 @@ public:
         return getNodeToParentTransform().transform(Rect(Vec2::ZERO, getContentSize()));
     }
     
+    /**
+     * Returns the bounding box of this node and all of its visible descendants.
+     *
+     * This method returns the minimal axis-aligned bounding box that contains
+     * the bounding box of this node, together with the bounding boxes of all
+     * visible descendants, in the parent's coordinate system. It is the
+     * bounding box used when this node is culled by its parent.
+     *
+     * If this node is culling its children, the bounds of the children are
+     * taken from the spatial index, and so may be slightly larger than the
+     * children themselves.
+     *
+     * @return An AABB of this node and its visible descendants in the parent's coordinates.
+     */
+    Rect getSubtreeBounds() const;
+    
     /**
      * Returns true if point is in the bounds of this node and its ancestors.
      *
@@ -1051,7 +1104,7 @@ public:
      *
      * @param color the color tinting this node.
      */
-    virtual void setColor(Color4 color) { _tintColor = color; }
+    virtual void setColor(Color4 color) { _tintColor = color; markDirty(); }
 
     /**
      * Returns the absolute color tinting this node.
@@ -1082,9 +1135,29 @@ public:
      * children are not visible as well, regardless of their visibility settings.
      * The default value is true, making the node visible.
      *
+     * If the parent of this node is culling its children, an invisible node
+     * is removed from the spatial index of the parent. Hence hiding a node
+     * is a cheap way to remove it from rendering without removing it from
+     * the scene graph.
+     *
      * @param visible   true if the node is visible.
      */
-    void setVisible(bool visible) { _isVisible = visible; }
+    void setVisible(bool visible);
+    
+    /**
+     * Marks this node as changed since it was last drawn.
+     *
+     * A {@link CachedNode} draws its descendants once to a texture, and only
+     * draws them again when one of them is marked as changed. Changes to the
+     * position, size, transform, color, visibility, or children of a node
+     * mark it automatically. However, changes that are specific to a
+     * subclass (such as a new texture or polygon) may not. In that case you
+     * should call this method directly.
+     *
+     * This method has no effect if the node has no {@link CachedNode}
+     * ancestor.
+     */
+    void markDirty();
     
     /**
      * Returns true if this node is tinted by its parent.
@@ -1106,7 +1179,7 @@ public:
      *
      * @param flag  Whether this node is tinted by its parent.
      */
-    void setRelativeColor(bool flag) { _hasParentColor = flag; }
+    void setRelativeColor(bool flag) { _hasParentColor = flag; _worldDirty = true; markDirty(); }
     
     /**
      * Returns the scissor associated with this node.
@@ -1535,6 +1608,62 @@ public:
      * @return The number of children of this node.
      */
     size_t getChildCount() const { return _children.size(); }
+    
+    /**
+     * Returns true if this node indexes its children by tag and name.
+     *
+     * By default, {@link #getChildByTag} and {@link #getChildByName} search
+     * the children in order. An indexed node keeps a hash table of its
+     * children, so these lookups (and the removal methods that use them)
+     * take constant time. This costs some memory for each child, and so it
+     * is only recommended for nodes with many children. Children with a tag
+     * of 0 or an empty name are not indexed.
+     *
+     * @return true if this node indexes its children by tag and name.
+     */
+    bool isIndexed() const { return _indexed; }
+    
+    /**
+     * Sets whether this node indexes its children by tag and name.
+     *
+     * By default, {@link #getChildByTag} and {@link #getChildByName} search
+     * the children in order. An indexed node keeps a hash table of its
+     * children, so these lookups (and the removal methods that use them)
+     * take constant time. This costs some memory for each child, and so it
+     * is only recommended for nodes with many children. Children with a tag
+     * of 0 or an empty name are not indexed.
+     *
+     * @param value Whether this node indexes its children by tag and name.
+     */
+    void setIndexed(bool value);
+    
+    /**
+     * Returns true if removing a child may reorder the remaining children.
+     *
+     * By default, removing a child shifts every child after it, so that the
+     * children remain in the order they were added. In an unordered node,
+     * the last child is moved into the position of the removed child
+     * instead. This makes removal constant time, but it changes the draw
+     * order of the children. It is intended for nodes whose draw order is
+     * not important, or is determined by an {@link OrderedNode}.
+     *
+     * @return true if removing a child may reorder the remaining children.
+     */
+    bool isUnordered() const { return _unordered; }
+    
+    /**
+     * Sets whether removing a child may reorder the remaining children.
+     *
+     * By default, removing a child shifts every child after it, so that the
+     * children remain in the order they were added. In an unordered node,
+     * the last child is moved into the position of the removed child
+     * instead. This makes removal constant time, but it changes the draw
+     * order of the children. It is intended for nodes whose draw order is
+     * not important, or is determined by an {@link OrderedNode}.
+     *
+     * @param value Whether removing a child may reorder the remaining children.
+     */
+    void setUnordered(bool value) { _unordered = value; }
 
     /**
      * Returns the child at the given position.
@@ -1789,7 +1918,8 @@ public:
      * Removes the child at the given position from this Node.
      *
      * Removing a child alters the position of every child after it. Hence
-     * it is unsafe to cache child positions.
+     * it is unsafe to cache child positions. If this node is unordered, the
+     * last child is moved into the position instead.
      *
      * @param pos   The position of the child node which will be removed.
      */
@@ -1799,7 +1929,8 @@ public:
      * Removes a child from this Node.
      *
      * Removing a child alters the position of every child after it. Hence
-     * it is unsafe to cache child positions.
+     * it is unsafe to cache child positions. If this node is unordered, the
+     * last child is moved into the position instead.
      *
      * If the child is not in this node, nothing happens.
      *
@@ -1883,6 +2014,44 @@ public:
         return _priority;
     }
     
+    /**
+     * Returns true if this node culls its children against the view.
+     *
+     * A culling node keeps a spatial index of the bounds of its visible
+     * children (see {@link #getSubtreeBounds}). When the node is rendered as
+     * part of a {@link Scene2}, it only renders the children whose bounds
+     * intersect the visible region of the scene camera. Children are still
+     * rendered in order. This is intended for large worlds where most of
+     * the children are off-screen at any given time.
+     *
+     * Culling is only as precise as the child bounds. A node that draws
+     * outside of its content bounds (or the bounds of its descendants) may
+     * be culled while part of it is still on screen. In addition, culling
+     * assumes that the scene camera is orthographic.
+     *
+     * @return true if this node culls its children against the view.
+     */
+    bool isCulling() const { return _index != nullptr; }
+    
+    /**
+     * Sets whether this node culls its children against the view.
+     *
+     * A culling node keeps a spatial index of the bounds of its visible
+     * children (see {@link #getSubtreeBounds}). When the node is rendered as
+     * part of a {@link Scene2}, it only renders the children whose bounds
+     * intersect the visible region of the scene camera. Children are still
+     * rendered in order. This is intended for large worlds where most of
+     * the children are off-screen at any given time.
+     *
+     * Culling is only as precise as the child bounds. A node that draws
+     * outside of its content bounds (or the bounds of its descendants) may
+     * be culled while part of it is still on screen. In addition, culling
+     * assumes that the scene camera is orthographic.
+     *
+     * @param value Whether this node culls its children against the view.
+     */
+    void setCulling(bool value);
+    
     /**
      * Draws this Node and all of its children with the given SpriteBatch.
      *
@@ -1938,6 +2107,31 @@ public:
     virtual void draw(const std::shared_ptr<graphics::SpriteBatch>& batch, 
                       const Affine2& transform, Color4 tint) {}
     
+    /**
+     * Prepares this Node to be drawn, returning true if the children should be prepared.
+     *
+     * This method only worries about the current node. It updates the cached
+     * world transform and tint, exactly as {@link #render} would. Subclasses
+     * should override this method to generate any render data (e.g. vertices)
+     * that would otherwise be generated lazily in {@link #draw}.
+     *
+     * When a {@link Scene2} has a thread pool, it prepares disjoint subtrees
+     * of the scene graph in parallel before drawing them on the main thread.
+     * Therefore this method may be called from a worker thread. It may only
+     * modify this node, and it must not make any OpenGL calls or modify shared
+     * assets (like fonts). A node that cannot meet these requirements should
+     * leave its render data to {@link #draw}.
+     *
+     * This method returns false if the children of this node should not be
+     * prepared, such as when the node is not visible.
+     *
+     * @param transform The global transformation matrix.
+     * @param tint      The tint to blend with the Node color.
+     *
+     * @return true if the children of this node should be prepared.
+     */
+    virtual bool prepare(const Affine2& transform, Color4 tint);
+    
     
 #pragma mark -
 #pragma mark Layout Automation
@@ -1990,7 +2184,7 @@ private:
      *
      * @param parent    A pointer to the parent node.
      */
-    void setParent(SceneNode* parent) { _parent = parent; }
+    void setParent(SceneNode* parent) { _parent = parent; _worldDirty = true; }
 
     /**
      * Sets the scene graph.
@@ -2020,11 +2214,95 @@ private:
      */
     void updateTransform();
     
+    /**
+     * Updates the cached world transform and tint of this node.
+     *
+     * The values are only recomputed if this node has changed, or if the
+     * parent values have changed. When the transform is the cached world
+     * transform of the parent (the normal case in {@link #render}), the
+     * parent change is known without comparing matrices. Otherwise, the
+     * transform and tint are compared to the values used last time.
+     *
+     * @param transform The global transformation matrix of the parent.
+     * @param tint      The tint of the parent.
+     *
+     * @return true if the cached values changed
+     */
+    bool updateWorld(const Affine2& transform, Color4 tint);
+    
+    /**
+     * Updates the spatial indices containing this node.
+     *
+     * This method should be called whenever the bounds of this node change.
+     * It climbs the scene graph, updating the proxy of this node (or its
+     * ancestor) in the spatial index of every culling ancestor.
+     */
+    void reindex();
+    
+    /**
+     * Computes the children of this node that intersect the view.
+     *
+     * The children are stored in {@link #_culled}, in the order that they
+     * appear in this node. This method returns false if culling is not
+     * possible (because this node is not culling, or because it is not
+     * being rendered by a {@link Scene2}). In that case all children should
+     * be rendered.
+     *
+     * This method must be called after {@link #updateWorld}.
+     *
+     * @return true if the children were culled against the view.
+     */
+    bool queryChildren();
+    
+    /**
+     * Prepares this node and all of its descendants to be drawn.
+     *
+     * This method calls {@link #prepare} on this node, and then recursively
+     * on each child (or each child in view if this node is culling). It
+     * does not use a sprite batch, and so distinct subtrees may be prepared
+     * on different threads at the same time.
+     *
+     * @param transform The global transformation matrix.
+     * @param tint      The tint to blend with the node color.
+     */
+    void prepareSubtree(const Affine2& transform, Color4 tint);
+    
+    /**
+     * Invalidates any drawing cached by this node.
+     *
+     * This method is called by {@link #markDirty} on every ancestor of the
+     * changed node. The default implementation does nothing, as only a
+     * {@link CachedNode} caches its drawing.
+     */
+    virtual void invalidateCache() {}
+    
+    /**
+     * Adds the given child to the tag and name indices of this node.
+     *
+     * This method does nothing if this node is not indexed.
+     *
+     * @param child The child to index
+     */
+    void indexChild(SceneNode* child);
+    
+    /**
+     * Removes the given child from the tag and name indices of this node.
+     *
+     * This method does nothing if this node is not indexed.
+     *
+     * @param child The child to remove from the index
+     */
+    void unindexChild(SceneNode* child);
+    
     // Copying is only allowed via shared pointer.
     CU_DISALLOW_COPY_AND_ASSIGN(SceneNode);
     
     // Tightly couple these two classes
     friend class Scene2;
+    // The render queue reads the cached world transforms
+    friend class OrderedNode;
+    // Caches update the world transform before drawing
+    friend class CachedNode;
 };
     }
 
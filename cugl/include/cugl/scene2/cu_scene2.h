@@ -42,6 +42,7 @@
 #include "CUSpriteNode.h"
 #include "CUMeshNode.h"
 #include "CUOrderedNode.h"
+#include "CUCachedNode.h"
 #include "CUCanvasNode.h"
 #include "CULabel.h"
 #include "CUButton.h"
@@ -0,0 +1,282 @@
+"""
+Script to convert JSON assets to binary JSON
+
+Loading a JSON asset requires tokenizing the text and converting every number
+from a string. For large files (such as scene layouts) this can be a noticeable
+part of the startup time. CUGL supports a binary encoding of JSON that skips
+both steps. This encoding is CBOR (RFC 8949) prefixed by the CBOR self-describe
+tag, and it is the same format written by BinaryWriter::writeJson.
+
+The class JsonReader recognizes this tag, and so a binary file can replace a
+JSON asset without changing its name or any of the loaders (JsonLoader, asset
+directories, and the scene loaders). This script is intended for shipping
+builds. Keep the text files in version control, and convert a copy of the
+asset directory when packaging the application.
+
+Only convert files that are read with JsonReader. Files that are read some
+other way (such as the Contents.json files in an XCode asset catalog) must
+stay as text. For this reason, this script ignores any directory whose name
+has a suffix (e.g. Media.xcassets).
+
+Numbers are encoded exactly as BinaryWriter encodes them. Numbers with an
+integral value are integers. All other numbers are single precision floats
+if that is lossless, and double precision floats otherwise.
+
+Author:  Walker M. White
+Version: 7/10/24
+"""
+import os, os.path
+import shutil
+import struct
+import json
+import argparse
+
+
+# The CBOR self-describe tag 55799
+CBOR_TAG = b'\xd9\xd9\xf7'
+
+# The largest value of a 64 bit integer
+MAX_LONG = 2**63-1
+
+# The smallest value of a 64 bit integer
+MIN_LONG = -2**63
+
+
+#mark JSON OBJECTS
+
+class JsonPairs(list):
+    """
+    A JSON object represented as a list of key-value pairs
+
+    This class distinguishes objects from arrays when encoding.
+    """
+    pass
+
+
+def make_pairs(pairs):
+    """
+    Returns the key-value pairs of a JSON object
+
+    This function is the object_pairs_hook for json.load. Duplicate keys are an
+    error, as they are not supported by JsonValue.
+
+    :param pairs: The key-value pairs of the JSON object
+    :type pairs:  ``list``
+
+    :return: the key-value pairs of a JSON object
+    :rtype:  ``JsonPairs``
+    """
+    keys = set()
+    for (k,v) in pairs:
+        if k in keys:
+            raise ValueError('Duplicate key %s' % repr(k))
+        keys.add(k)
+    return JsonPairs(pairs)
+
+
+#mark ENCODING
+
+def encode_head(major,value):
+    """
+    Returns the head of a CBOR data item
+
+    The head is the major type followed by the argument, which is the length of
+    a string or collection, or the value of an integer. The argument is encoded
+    in the fewest bytes possible.
+
+    :param major: The CBOR major type (0-7)
+    :type major:  ``int``
+
+    :param value: The argument of the head
+    :type value:  ``int``
+
+    :return: the head of a CBOR data item
+    :rtype:  ``bytes``
+    """
+    major <<= 5
+    if value < 24:
+        return struct.pack('>B',major | value)
+    elif value <= 0xff:
+        return struct.pack('>BB',major | 24,value)
+    elif value <= 0xffff:
+        return struct.pack('>BH',major | 25,value)
+    elif value <= 0xffffffff:
+        return struct.pack('>BI',major | 26,value)
+    return struct.pack('>BQ',major | 27,value)
+
+
+def encode_number(value):
+    """
+    Returns the CBOR encoding of a number
+
+    Numbers with an integral value are encoded as integers, provided that they
+    fit in 64 bits. All other numbers are single precision floats if that is
+    lossless, and double precision floats otherwise.
+
+    :param value: The number to encode
+    :type value:  ``int`` or ``float``
+
+    :return: the CBOR encoding of a number
+    :rtype:  ``bytes``
+    """
+    if type(value) == float and value.is_integer() and MIN_LONG <= value <= MAX_LONG:
+        value = int(value)
+    if type(value) == int:
+        if 0 <= value <= MAX_LONG:
+            return encode_head(0,value)
+        elif MIN_LONG <= value < 0:
+            return encode_head(1,-(value+1))
+        value = float(value)
+
+    single = struct.pack('>f',value)
+    if struct.unpack('>f',single)[0] == value:
+        return b'\xfa'+single
+    return b'\xfb'+struct.pack('>d',value)
+
+
+def encode_string(value):
+    """
+    Returns the CBOR encoding of a string
+
+    :param value: The string to encode
+    :type value:  ``str``
+
+    :return: the CBOR encoding of a string
+    :rtype:  ``bytes``
+    """
+    data = value.encode('utf-8')
+    return encode_head(3,len(data))+data
+
+
+def encode(value):
+    """
+    Returns the CBOR encoding of a JSON value (without the self-describe tag)
+
+    JSON objects must be represented as lists of key-value pairs (as produced
+    by the object_pairs_hook of json.load). This preserves the order of the
+    keys, which matters to some of the CUGL loaders.
+
+    :param value: The JSON value to encode
+    :type value:  ``JsonPair``, ``list``, ``str``, ``int``, ``float``, ``bool`` or ``None``
+
+    :return: the CBOR encoding of a JSON value
+    :rtype:  ``bytes``
+    """
+    if value is None:
+        return b'\xf6'
+    elif type(value) == bool:
+        return b'\xf5' if value else b'\xf4'
+    elif type(value) in [int,float]:
+        return encode_number(value)
+    elif type(value) == str:
+        return encode_string(value)
+    elif type(value) == JsonPairs:
+        result = [encode_head(5,len(value))]
+        for (k,v) in value:
+            result.append(encode_string(k))
+            result.append(encode(v))
+        return b''.join(result)
+    elif type(value) == list:
+        result = [encode_head(4,len(value))]
+        for item in value:
+            result.append(encode(item))
+        return b''.join(result)
+    raise TypeError('Value %s is not a JSON value' % repr(value))
+
+
+#mark CONVERSION
+
+def convert_file(source,target):
+    """
+    Converts a JSON file to binary JSON
+
+    The source and target may be the same file. If the source is not valid
+    JSON, or if it is already binary, this function returns False and leaves
+    the target untouched.
+
+    :param source: The JSON file to convert
+    :type source:  ``str``
+
+    :param target: The file to store the binary JSON
+    :type target:  ``str``
+
+    :return: True if the file was converted
+    :rtype:  ``bool``
+    """
+    with open(source,'rb') as file:
+        data = file.read()
+    if data.startswith(CBOR_TAG):
+        return False
+
+    try:
+        value = json.loads(data.decode('utf-8'),object_pairs_hook=make_pairs)
+    except ValueError as e:
+        print('Skipping %s: %s' % (source,e))
+        return False
+
+    with open(target,'wb') as file:
+        file.write(CBOR_TAG)
+        file.write(encode(value))
+    return True
+
+
+def convert_directory(source,target):
+    """
+    Converts every JSON file in a directory to binary JSON
+
+    The directory is searched recursively. Every file in source is copied to
+    target, with the JSON files converted to binary JSON along the way. The
+    source and target may be the same directory, in which case the JSON files
+    are converted in place. Directories with a suffix (e.g. Media.xcassets)
+    are copied as is.
+
+    :param source: The directory to convert
+    :type source:  ``str``
+
+    :param target: The directory to store the result
+    :type target:  ``str``
+
+    :return: The number of files converted
+    :rtype:  ``int``
+    """
+    count = 0
+    for root, dirs, files in os.walk(source):
+        outdir = os.path.join(target,os.path.relpath(root,source))
+        os.makedirs(outdir,exist_ok=True)
+        for item in list(dirs):
+            if os.path.splitext(item)[1]:
+                src = os.path.join(root,item)
+                dst = os.path.join(outdir,item)
+                if os.path.abspath(src) != os.path.abspath(dst):
+                    shutil.copytree(src,dst,dirs_exist_ok=True)
+                dirs.remove(item)
+        for item in files:
+            src = os.path.join(root,item)
+            dst = os.path.join(outdir,item)
+            if os.path.splitext(item)[1].lower() == '.json' and convert_file(src,dst):
+                count += 1
+            elif os.path.abspath(src) != os.path.abspath(dst):
+                shutil.copy2(src,dst)
+    return count
+
+
+def main():
+    """
+    Runs the conversion script
+    """
+    parser = argparse.ArgumentParser(description='Convert JSON assets to binary JSON.')
+    parser.add_argument('source', type=str, help='The JSON file or asset directory')
+    parser.add_argument('target', type=str, nargs='?',
+                        help='The output file or directory (default is in place)')
+    args = parser.parse_args()
+
+    target = args.source if args.target is None else args.target
+    if os.path.isdir(args.source):
+        count = convert_directory(args.source,target)
+        print('Converted %d JSON files' % count)
+    elif convert_file(args.source,target):
+        print('Converted %s' % args.source)
+
+
+if __name__ == '__main__':
+    main()
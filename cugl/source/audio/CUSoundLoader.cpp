@@ -105,7 +105,7 @@ void SoundLoader::materialize(const std::string key, const std::shared_ptr<Sound
     if (callback != nullptr) {
         callback(key,success);
     }
-    _queue.erase(key);
+    dequeue(key);
 }
 
 /**
@@ -127,7 +127,7 @@ void SoundLoader::materialize(const std::string key, const std::shared_ptr<Sound
  * @return true if the asset was successfully loaded
  */
 bool SoundLoader::read(const std::string key, const std::string source, LoaderCallback callback, bool async) {
-    if (_assets.find(key) != _assets.end() || _queue.find(key) != _queue.end()) {
+    if (_assets.find(key) != _assets.end() || queued(key)) {
         return false;
     }
     
@@ -159,7 +159,7 @@ bool SoundLoader::read(const std::string key, const std::string source, LoaderCa
             }
             if (sound != nullptr) {
                 sound->setVolume(_volume);
-                Application::get()->schedule([=,this](void){
+                this->schedule([=,this](void){
                     this->materialize(key,sound,callback);
                     return false;
                 });
@@ -199,7 +199,7 @@ bool SoundLoader::read(const std::shared_ptr<JsonValue>& json, LoaderCallback ca
     float volume = json->getFloat("volume",_volume);
     type = cugl::strtool::tolower(type);
     
-    if (_assets.find(key) != _assets.end() || _queue.find(key) != _queue.end()) {
+    if (_assets.find(key) != _assets.end() || queued(key)) {
         return false;
     }
 
@@ -228,7 +228,7 @@ bool SoundLoader::read(const std::shared_ptr<JsonValue>& json, LoaderCallback ca
             }
             if (sound != nullptr) {
                 sound->setVolume(volume);
-                Application::get()->schedule([=,this](void) {
+                this->schedule([=,this](void) {
                     this->materialize(key,sound,callback);
                     return false;
                 });
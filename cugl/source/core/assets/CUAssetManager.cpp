@@ -47,6 +47,7 @@
 //
 #include <cugl/core/assets/CUAssetManager.h>
 #include <cugl/core/io/CUJsonReader.h>
+#include <cugl/core/util/CUTimestamp.h>
 #include <cugl/core/CUApplication.h>
 
 using namespace cugl;
@@ -54,22 +55,29 @@ using namespace cugl;
 #pragma mark -
 #pragma mark Constructors
 /**
- * Returns a newly allocated asset manager.
+ * Initializes a new asset manager with the given number of worker threads.
  *
- * The asset manager has a single thread, as some of the asset loading
- * operations (particularly fonts) cannot be run in multiple threads
- * simultaneously. However, it will run in a distinct thread from the
- * main application. In addition, confining to one thread allows us to
- * handle dependencies between loaders.
+ * The worker threads perform the part of asset loading that is safe to
+ * do outside of the main thread (e.g. image decoding and font loading).
+ * Assets of the same priority are loaded in parallel, while loaders of
+ * lower priority wait for all higher priority assets to finish. The
+ * final step of loading (e.g. creating OpenGL objects) always takes
+ * place in the main thread, under a per-frame time budget.
  *
- * This constructor does not attach any loaders. It simply creates an
+ * By default, the asset manager has a single worker thread. A value
+ * close to the number of cores will give the fastest load times.
+ *
+ * This initializer does not attach any loaders. It simply creates an
  * object that is ready to accept loader objects.
  *
- * @return a newly allocated asset manager.
+ * @param threads   The number of worker threads
+ *
+ * @return true if the asset manager was initialized successfully
  */
-bool AssetManager::init() {
-    _workers = ThreadPool::alloc(1);
-    return true;
+bool AssetManager::init(Uint32 threads) {
+    _workers  = ThreadPool::alloc(threads > 0 ? threads : 1);
+    _director = ThreadPool::alloc(1);
+    return _workers != nullptr && _director != nullptr;
 }
 
 /**
@@ -80,8 +88,16 @@ bool AssetManager::init() {
  * threads) and reattach all loaders to use the asset manager again.
  */
 void AssetManager::dispose() {
-    detachAll();
+    _director = nullptr;
     _workers = nullptr;
+    detachAll();
+    
+    std::lock_guard<std::mutex> lock(_materialMutex);
+    _materials.clear();
+    if (_pumping && Application::get()) {
+        Application::get()->unschedule(_pumpid);
+    }
+    _pumping = false;
 }
 
 #pragma mark -
@@ -219,26 +235,154 @@ bool AssetManager::purgeCategory(size_t hash, const std::shared_ptr<JsonValue>&
  * Synchronizes the asset manager to wait until all assets have finished.
  *
  * This method is necessary for assets whose construction depends on
- * previously loaded assets (e.g. scene graphs). In the current architecture,
- * this method is only correct if the asset manager loads assets in a
- * single thread.
+ * previously loaded assets (e.g. scene graphs). It blocks the calling
+ * thread until the worker threads are idle and every loader has
+ * materialized its assets. As materialization takes place in the main
+ * thread, this method must only be called from the directory thread.
  */
 void AssetManager::sync() {
-    // This task blocks the task queue until others are complete
-    _workers->addTask([this](void) {
-        bool waiting = true;
-        while (waiting) {
-            bool complete = true;
-            for(auto it = _handlers.begin(); complete && it != _handlers.end(); ++it) {
-                complete = it->second->inFlight() == 0;
+    bool waiting = true;
+    while (waiting) {
+        // Tasks enqueue their keys before they finish, so check workers first
+        bool complete = _workers->getPendingCount() == 0;
+        for(auto it = _handlers.begin(); complete && it != _handlers.end(); ++it) {
+            complete = it->second->inFlight() == 0;
+        }
+        waiting = !complete;
+        if (waiting) {
+            ThreadPool::sleep(1);
+        }
+    }
+}
+
+/**
+ * Loads all assets in the given directory, blocking until complete.
+ *
+ * This is the body of an asynchronous directory load. It dispatches each
+ * asset category to the worker threads in priority order, waiting for
+ * each priority level to finish before starting the next. This method
+ * must only be called from the directory thread.
+ *
+ * @param json      The JSON asset directory
+ * @param callback  An optional callback after each asset is loaded
+ */
+void AssetManager::processDirectory(const std::shared_ptr<JsonValue>& json,
+                                    LoaderCallback callback) {
+    size_t entries = json->size();
+    
+    // Process entries by priority
+    Uint32 curr = 0;
+    Uint32 next = 0;
+    Uint32 err  = 0;
+    while (entries > err) {
+        for(int ii = 0; ii < json->size(); ii++) {
+            std::shared_ptr<JsonValue> child = json->get(ii);
+            auto hash = _jsonKeys.find(child->key());
+            if (hash != _jsonKeys.end()) {
+                auto rank = _priority.find(child->key());
+                CUAssertLog(rank != _priority.end(), "AssetDirectory loaders are corrupted");
+                if (rank->second == curr) {
+                    readCategory(hash->second,child,callback);
+                    entries--;
+                } else if (rank->second > curr) {
+                    // We are looking for the NEXT available rank
+                    if (next == curr) {
+                        next = rank->second;
+                    } else if (rank->second < next) {
+                        next = rank->second;
+                    }
+                }
+            } else {
+                CULogError("Unknown asset category '%s'",child->key().c_str());
+                err++;
             }
-            waiting = !complete;
+        }
+        if (entries != err) {
+            curr = next;
+            sync();
+        }
+    }
+    
+    // One last sync to ensure everything gets materialized
+    sync();
+}
 
-            // Delay a full frame
-            int delay = (int)(1000/Application::get()->getFPS());
-            ThreadPool::sleep(delay);
+#pragma mark -
+#pragma mark Materialization
+/**
+ * Adds a materialization step to the queue for the main thread.
+ *
+ * This method is used by the attached loaders (via the method
+ * {@link BaseLoader#schedule}), and is safe to call from any thread.
+ * The callback is executed exactly once, regardless of its return value.
+ *
+ * @param callback  The materialization step
+ */
+void AssetManager::schedule(std::function<bool()> callback) {
+    std::lock_guard<std::mutex> lock(_materialMutex);
+    _materials.push_back(callback);
+    if (!_pumping) {
+        _pumping = true;
+        _pumpid = Application::get()->schedule([this](void) {
+            return this->pump();
+        }, 0, 0);
+    }
+}
+
+/**
+ * Executes pending materialization steps for this animation frame.
+ *
+ * This method is scheduled with {@link Application#schedule} whenever the
+ * materialization queue is nonempty. It processes materialization steps
+ * until the time budget for this frame is exhausted (though it always
+ * processes at least one step).
+ *
+ * @return true if there are still materialization steps pending
+ */
+bool AssetManager::pump() {
+    Timestamp start;
+    while (true) {
+        std::function<bool()> step;
+        {
+            std::lock_guard<std::mutex> lock(_materialMutex);
+            if (_materials.empty()) {
+                _pumping = false;
+                return false;
+            }
+            step = std::move(_materials.front());
+            _materials.pop_front();
         }
-    });
+        step();
+        
+        Timestamp now;
+        if (_budget > 0 && now.ellapsedMicros(start) >= _budget) {
+            return true;
+        }
+    }
+}
+
+/**
+ * Executes a materialization step from the given loader.
+ *
+ * Materialization (e.g. creating OpenGL objects) must take place in the
+ * main thread. If this loader is attached to an {@link AssetManager},
+ * the callback is added to the materialization queue of that manager,
+ * which processes these callbacks under a per-frame time budget.
+ * Otherwise, it is passed to {@link Application#schedule}.
+ *
+ * The callback is executed exactly once, regardless of its return value.
+ *
+ * @param callback  The materialization callback
+ */
+void BaseLoader::schedule(std::function<bool()> callback) {
+    if (_manager != nullptr) {
+        _manager->schedule(callback);
+    } else {
+        Application::get()->schedule([=](void) {
+            callback();
+            return false;
+        });
+    }
 }
 
 #pragma mark -
@@ -271,11 +415,43 @@ void AssetManager::sync() {
  * can. If any asset fails to load, it will return false. However, some
  * assets may still be loaded and safe to access.
  *
+ * If this asset manager has more than one worker thread, the work that
+ * is safe to do outside of the main thread is distributed across the
+ * workers. This method still blocks until all assets are loaded.
+ *
  * @param json  The JSON asset directory
  *
  * @return true if all assets specified in the directory were successfully loaded.
  */
 bool AssetManager::loadDirectory(const std::shared_ptr<JsonValue>& json) {
+    if (getThreadCount() > 1) {
+        // Decode in the workers, but materialize here in the main thread
+        std::atomic<bool> success(true);
+        loadDirectoryAsync(json, [&](const std::string key, bool result) {
+            if (!result) { success = false; }
+        });
+        
+        bool waiting = true;
+        while (waiting) {
+            std::function<bool()> step = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(_materialMutex);
+                if (!_materials.empty()) {
+                    step = std::move(_materials.front());
+                    _materials.pop_front();
+                }
+            }
+            if (step) {
+                step();
+            } else if (!_preload && _director->getPendingCount() == 0) {
+                waiting = false;
+            } else {
+                ThreadPool::sleep(1);
+            }
+        }
+        return success;
+    }
+    
     bool success = true;
     size_t entries = json->size();
 
@@ -356,6 +532,10 @@ bool AssetManager::loadDirectory(const std::shared_ptr<JsonValue>& json) {
  * can. If any asset fails to load, it will return false. However, some
  * assets may still be loaded and safe to access.
  *
+ * If this asset manager has more than one worker thread, the work that
+ * is safe to do outside of the main thread is distributed across the
+ * workers. This method still blocks until all assets are loaded.
+ *
  * @param directory The path to the JSON asset directory
  *
  * @return true if all assets specified in the directory were successfully loaded.
@@ -411,7 +591,7 @@ bool AssetManager::loadDirectory(const std::string directory) {
  * @param callback  An optional callback after each asset is loaded
  */
 void AssetManager::loadDirectoryAsync(const std::shared_ptr<JsonValue>& json, LoaderCallback callback) {
-    size_t entries = json->size();
+    _preload = true;
     
     // First, estimate the number of things to load
     for(int ii = 0; ii < json->size(); ii++) {
@@ -428,41 +608,11 @@ void AssetManager::loadDirectoryAsync(const std::shared_ptr<JsonValue>& json, Lo
         }
     }
     
-    // Process entries by priority
-    Uint32 curr = 0;
-    Uint32 next = 0;
-    Uint32 err  = 0;
-    while (entries > err) {
-        for(int ii = 0; ii < json->size(); ii++) {
-            std::shared_ptr<JsonValue> child = json->get(ii);
-            auto hash = _jsonKeys.find(child->key());
-            if (hash != _jsonKeys.end()) {
-                auto rank = _priority.find(child->key());
-                CUAssertLog(rank != _priority.end(), "AssetDirectory loaders are corrupted");
-                if (rank->second == curr) {
-                    readCategory(hash->second,child,callback);
-                    entries--;
-                } else if (rank->second > curr) {
-                    // We are looking for the NEXT available rank
-                    if (next == curr) {
-                        next = rank->second;
-                    } else if (rank->second < next) {
-                        next = rank->second;
-                    }
-                }
-            } else {
-                CULogError("Unknown asset category '%s'",child->key().c_str());
-                err++;
-            }
-        }
-        if (entries != err) {
-            curr = next;
-            sync();
-        }
-    }
-    
-    // One last sync to ensure everything gets materialized
-    sync();
+    // The directory thread waits on each priority level in turn
+    _director->addTask([=,this](void) {
+        processDirectory(json,callback);
+        _preload = false;
+    });
 }
 
 /**
@@ -508,15 +658,18 @@ void AssetManager::loadDirectoryAsync(const std::string directory, LoaderCallbac
     _preload = true;
     
     std::shared_ptr<JsonReader> reader = JsonReader::allocWithAsset(directory);
-    if (reader == nullptr && callback != nullptr) {
-        callback("",false);
+    if (reader == nullptr) {
+        _preload = false;
+        if (callback != nullptr) {
+            callback("",false);
+        }
         return;
     }
     
-    _workers->addTask([=,this](void) {
+    // Parse in the directory thread, which then queues the actual load
+    _director->addTask([=,this](void) {
         std::shared_ptr<JsonValue> json = reader->readJson();
         loadDirectoryAsync(json,callback);
-        _preload = false;
     });
 }
 
@@ -78,7 +78,7 @@ bool JsonLoader::materialize(const std::string key, const std::shared_ptr<JsonVa
     if (callback != nullptr) {
         callback(key,success);
     }
-    _queue.erase(key);
+    dequeue(key);
     return success;
 }
 
@@ -101,7 +101,7 @@ bool JsonLoader::materialize(const std::string key, const std::shared_ptr<JsonVa
  * @return true if the asset was successfully loaded
  */
 bool JsonLoader::read(const std::string key, const std::string source, LoaderCallback callback, bool async) {
-    if (_assets.find(key) != _assets.end() || _queue.find(key) != _queue.end()) {
+    if (_assets.find(key) != _assets.end() || queued(key)) {
         return false;
     }
     
@@ -123,7 +123,7 @@ bool JsonLoader::read(const std::string key, const std::string source, LoaderCal
             this->enqueue(key);
             std::shared_ptr<JsonReader> reader = JsonReader::allocWithAsset(path);
             std::shared_ptr<JsonValue> json = (reader == nullptr ? nullptr : reader->readJson());
-            Application::get()->schedule([=,this](void) {
+            this->schedule([=,this](void) {
                 this->materialize(key,json,callback);
                 return false;
             });
@@ -158,7 +158,7 @@ bool JsonLoader::read(const std::string key, const std::string source, LoaderCal
  */
 bool JsonLoader::read(const std::shared_ptr<JsonValue>& json, LoaderCallback callback, bool async) {
     std::string key = json->key();
-    if (_assets.find(key) != _assets.end() || _queue.find(key) != _queue.end()) {
+    if (_assets.find(key) != _assets.end() || queued(key)) {
         return false;
     }
     std::string source = json->asString(UNKNOWN_SOURCE);
@@ -174,7 +174,7 @@ bool JsonLoader::read(const std::shared_ptr<JsonValue>& json, LoaderCallback cal
             this->enqueue(key);
             std::shared_ptr<JsonReader> reader = JsonReader::allocWithAsset(source);
             std::shared_ptr<JsonValue> json = (reader == nullptr ? nullptr : reader->readJson());
-            Application::get()->schedule([=,this](void) {
+            this->schedule([=,this](void) {
                 this->materialize(key,json,callback);
                 return false;
             });
@@ -4,8 +4,8 @@
 //
 //  This module a modern C++ alternative to the CUJSON interface for reading
 //  JSON files.  In particular, this gives us better type-checking and memory
-//  management.  With that said, it still uses CUJSON as the underlying parsing
-//  engine.
+//  management.  JSON strings are parsed directly into JsonValue nodes in a
+//  single pass.  CUJSON is only used as the engine for printing.
 //
 //  This class uses our standard shared-pointer architecture.
 //
@@ -44,6 +44,23 @@
 #include <cugl/core/assets/CUJsonValue.h>
 #include <cugl/core/util/CUDebug.h>
 #include <cugl/core/util/CUStringTools.h>
+#include <cugl/core/math/CUMathBase.h>
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+// The string scanner only needs byte compares
+#if defined (CU_MATH_VECTOR_SSE) && (defined (__SSE2__) || defined (_M_X64))
+    #include <emmintrin.h>
+    #define JSON_SCAN_SSE2  1
+#elif defined (CU_MATH_VECTOR_NEON64)
+    #define JSON_SCAN_NEON  1
+#endif
+
+/** The maximum nesting depth of a JSON string (to protect the stack) */
+#define JSON_MAX_DEPTH  1000
+/** The minimum number of children for an object to have a key index */
+#define JSON_INDEX_MIN  16
 
 using namespace cugl;
 
@@ -55,12 +72,13 @@ using namespace cugl;
  * first line of the error.  It also indicates (via the reference variable) the line on which the error occurred.
  *
  * @param data      The JSON value being parsed
+ * @param end       The end of the JSON value being parsed
  * @param error     The tail of the JSON after encountering an error
  * @param lineno    The variable to store the line number
  *
  * @return the line of JSON with the offending error.
  */
-static std::string isolate_error(const char* data, const char* error, int& lineno) {
+static std::string isolate_error(const char* data, const char* end, const char* error, int& lineno) {
     lineno = 1;
     const char* pos = data;
     while (pos != error) {
@@ -72,7 +90,7 @@ static std::string isolate_error(const char* data, const char* error, int& linen
     size_t len = 0;
     bool goon = true;
     pos = error;
-    while (*pos && goon) {
+    while (pos != end && *pos && goon) {
         if (*pos == '\n') {
             goon = false;
         } else {
@@ -83,6 +101,521 @@ static std::string isolate_error(const char* data, const char* error, int& linen
     return std::string(error,len);
 }
 
+#pragma mark -
+#pragma mark JSON Parser
+/** The exact powers of ten as doubles */
+static const double JSON_POW10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/**
+ * A single pass parser from a JSON string to JsonValue nodes.
+ *
+ * This parser builds the JsonValue tree directly from the source buffer,
+ * with no intermediate CUJSON tree. Strings without escapes are copied
+ * once, straight from the buffer into the node. The buffer does not need
+ * to be null terminated, so it can be a region of a larger file.
+ *
+ * The grammar is the same as the one accepted by CUJSON. In particular,
+ * anything after the first complete value is ignored. Large objects are
+ * indexed as soon as they are complete.
+ */
+class JsonValue::Parser {
+public:
+    /** The start of the JSON string */
+    const char* begin;
+    /** The current parse position */
+    const char* pos;
+    /** The end of the JSON string */
+    const char* end;
+    /** The position of the first error (nullptr if none) */
+    const char* error;
+    /** The current nesting depth */
+    size_t depth;
+    
+    /**
+     * Creates a parser for the given JSON string
+     *
+     * @param data      The JSON string
+     * @param length    The number of bytes in the string
+     */
+    Parser(const char* data, size_t length) :
+    begin(data), pos(data), end(data+length), error(nullptr), depth(0) {}
+    
+    /**
+     * Advances the parse position past any whitespace.
+     *
+     * Like CUJSON, every control character is whitespace.
+     */
+    void skip() {
+#if JSON_SCAN_SSE2
+        const __m128i space = _mm_set1_epi8(32);
+        const __m128i zero  = _mm_setzero_si128();
+        while (end-pos >= 16) {
+            __m128i chunk = _mm_loadu_si128((const __m128i*)pos);
+            __m128i white = _mm_cmpeq_epi8(_mm_min_epu8(chunk,space),chunk);
+            white = _mm_andnot_si128(_mm_cmpeq_epi8(chunk,zero),white);
+            if (_mm_movemask_epi8(white) != 0xFFFF) {
+                break;
+            }
+            pos += 16;
+        }
+#elif JSON_SCAN_NEON
+        const uint8x16_t space = vdupq_n_u8(32);
+        while (end-pos >= 16) {
+            uint8x16_t chunk = vld1q_u8((const uint8_t*)pos);
+            uint8x16_t white = vandq_u8(vcleq_u8(chunk,space),vtstq_u8(chunk,chunk));
+            if (vminvq_u8(white) == 0) {
+                break;
+            }
+            pos += 16;
+        }
+#endif
+        while (pos != end && *pos && (unsigned char)*pos <= 32) {
+            pos++;
+        }
+    }
+    
+    /**
+     * Returns the first quote or backslash at or after the given position.
+     *
+     * If there is no such character, this method returns the end of the
+     * JSON string.
+     *
+     * @param start The position to start scanning
+     *
+     * @return the first quote or backslash at or after the given position.
+     */
+    const char* scan(const char* start) const {
+        const char* curr = start;
+#if JSON_SCAN_SSE2
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i slash = _mm_set1_epi8('\\');
+        while (end-curr >= 16) {
+            __m128i chunk = _mm_loadu_si128((const __m128i*)curr);
+            __m128i found = _mm_or_si128(_mm_cmpeq_epi8(chunk,quote),_mm_cmpeq_epi8(chunk,slash));
+            if (_mm_movemask_epi8(found)) {
+                break;
+            }
+            curr += 16;
+        }
+#elif JSON_SCAN_NEON
+        const uint8x16_t quote = vdupq_n_u8('"');
+        const uint8x16_t slash = vdupq_n_u8('\\');
+        while (end-curr >= 16) {
+            uint8x16_t chunk = vld1q_u8((const uint8_t*)curr);
+            uint8x16_t found = vorrq_u8(vceqq_u8(chunk,quote),vceqq_u8(chunk,slash));
+            if (vmaxvq_u8(found)) {
+                break;
+            }
+            curr += 16;
+        }
+#endif
+        while (curr != end && *curr != '"' && *curr != '\\') {
+            curr++;
+        }
+        return curr;
+    }
+    
+    /**
+     * Returns true if the next characters match the given literal.
+     *
+     * If they match, the parse position is advanced past the literal.
+     *
+     * @param literal   The literal to match
+     * @param length    The length of the literal
+     *
+     * @return true if the next characters match the given literal.
+     */
+    bool match(const char* literal, size_t length) {
+        if ((size_t)(end-pos) >= length && !std::memcmp(pos,literal,length)) {
+            pos += length;
+            return true;
+        }
+        return false;
+    }
+    
+    /**
+     * Reads four hexadecimal digits at the given position.
+     *
+     * @param start The position of the digits
+     * @param value The variable to store the result
+     *
+     * @return true if the digits are valid
+     */
+    bool hex4(const char* start, unsigned& value) const {
+        if (end-start < 4) {
+            return false;
+        }
+        value = 0;
+        for(int ii = 0; ii < 4; ii++) {
+            char c = start[ii];
+            value <<= 4;
+            if (c >= '0' && c <= '9') {
+                value += c-'0';
+            } else if (c >= 'A' && c <= 'F') {
+                value += 10+c-'A';
+            } else if (c >= 'a' && c <= 'f') {
+                value += 10+c-'a';
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+    
+    /**
+     * Parses the string at the current position into the given result.
+     *
+     * The current position must be a quote.
+     *
+     * @param result    The string to store the result
+     *
+     * @return true if the string is valid
+     */
+    bool parseString(std::string& result) {
+        const char* start = pos;
+        const char* curr = scan(start+1);
+        result.assign(start+1,curr);
+        
+        while (curr != end && *curr == '\\') {
+            if (++curr == end) {
+                error = start;
+                return false;
+            }
+            switch (*curr++) {
+                case 'b':
+                    result.push_back('\b');
+                    break;
+                case 'f':
+                    result.push_back('\f');
+                    break;
+                case 'n':
+                    result.push_back('\n');
+                    break;
+                case 'r':
+                    result.push_back('\r');
+                    break;
+                case 't':
+                    result.push_back('\t');
+                    break;
+                case '"':
+                case '\\':
+                case '/':
+                    result.push_back(curr[-1]);
+                    break;
+                case 'u':
+                {
+                    // Transcode UTF-16 to UTF-8
+                    unsigned uc, uc2;
+                    if (!hex4(curr,uc) || (uc >= 0xDC00 && uc <= 0xDFFF) || uc == 0) {
+                        error = start;
+                        return false;
+                    }
+                    curr += 4;
+                    if (uc >= 0xD800 && uc <= 0xDBFF) {
+                        if (end-curr < 6 || curr[0] != '\\' || curr[1] != 'u' ||
+                            !hex4(curr+2,uc2) || uc2 < 0xDC00 || uc2 > 0xDFFF) {
+                            error = start;
+                            return false;
+                        }
+                        curr += 6;
+                        uc = 0x10000 + (((uc & 0x3FF) << 10) | (uc2 & 0x3FF));
+                    }
+                    
+                    if (uc < 0x80) {
+                        result.push_back((char)uc);
+                    } else if (uc < 0x800) {
+                        result.push_back((char)(0xC0 | (uc >> 6)));
+                        result.push_back((char)(0x80 | (uc & 0x3F)));
+                    } else if (uc < 0x10000) {
+                        result.push_back((char)(0xE0 | (uc >> 12)));
+                        result.push_back((char)(0x80 | ((uc >> 6) & 0x3F)));
+                        result.push_back((char)(0x80 | (uc & 0x3F)));
+                    } else {
+                        result.push_back((char)(0xF0 | (uc >> 18)));
+                        result.push_back((char)(0x80 | ((uc >> 12) & 0x3F)));
+                        result.push_back((char)(0x80 | ((uc >> 6) & 0x3F)));
+                        result.push_back((char)(0x80 | (uc & 0x3F)));
+                    }
+                }
+                    break;
+                default:
+                    error = start;
+                    return false;
+            }
+            
+            const char* next = scan(curr);
+            result.append(curr,next);
+            curr = next;
+        }
+        
+        if (curr == end) {
+            error = start;
+            return false;
+        }
+        pos = curr+1;
+        return true;
+    }
+    
+    /**
+     * Parses the number at the current position into the given node.
+     *
+     * The current position must be a digit or a minus sign. Numbers with
+     * at most 15 significant digits and a small exponent are converted
+     * exactly. Integers are stored exactly as longs when they fit.
+     *
+     * @param node  The node to store the result
+     *
+     * @return true if the number is valid
+     */
+    bool parseNumber(JsonValue* node) {
+        bool negative = false;
+        if (*pos == '-') {
+            negative = true;
+            pos++;
+        }
+        
+        Uint64 mantissa = 0;
+        int digits = 0;
+        int scale = 0;
+        bool integral = true;
+        while (pos != end && *pos >= '0' && *pos <= '9') {
+            if (digits < 19) {
+                mantissa = mantissa*10+(*pos-'0');
+                digits += (mantissa != 0);
+            } else {
+                scale++;
+            }
+            pos++;
+        }
+        if (end-pos >= 2 && *pos == '.' && pos[1] >= '0' && pos[1] <= '9') {
+            integral = false;
+            pos++;
+            while (pos != end && *pos >= '0' && *pos <= '9') {
+                if (digits < 19) {
+                    mantissa = mantissa*10+(*pos-'0');
+                    digits += (mantissa != 0);
+                    scale--;
+                }
+                pos++;
+            }
+        }
+        if (pos != end && (*pos == 'e' || *pos == 'E')) {
+            integral = false;
+            pos++;
+            int sign = 1;
+            if (pos != end && *pos == '+') {
+                pos++;
+            } else if (pos != end && *pos == '-') {
+                sign = -1;
+                pos++;
+            }
+            int exponent = 0;
+            while (pos != end && *pos >= '0' && *pos <= '9') {
+                if (exponent < 10000) {
+                    exponent = exponent*10+(*pos-'0');
+                }
+                pos++;
+            }
+            scale += sign*exponent;
+        }
+        
+        double value = (double)mantissa;
+        if (mantissa == 0) {
+            value = 0;
+        } else if (digits <= 15 && scale >= -22 && scale <= 22) {
+            value = scale < 0 ? value/JSON_POW10[-scale] : value*JSON_POW10[scale];
+        } else {
+            value *= std::pow(10.0,scale);
+        }
+        value = negative ? -value : value;
+        
+        node->_type = JsonValue::Type::NumberType;
+        node->_doubleValue = value;
+        if (integral && scale == 0 && mantissa <= (Uint64)LONG_MAX) {
+            node->_longValue = negative ? -(long)mantissa : (long)mantissa;
+        } else if (value >= (double)LONG_MAX) {
+            node->_longValue = LONG_MAX;
+        } else if (value <= (double)LONG_MIN) {
+            node->_longValue = LONG_MIN;
+        } else {
+            node->_longValue = (long)value;
+        }
+        return true;
+    }
+    
+    /**
+     * Parses the array at the current position into the given node.
+     *
+     * The current position must be an open bracket.
+     *
+     * @param node  The node to store the result
+     *
+     * @return true if the array is valid
+     */
+    bool parseArray(JsonValue* node) {
+        node->_type = JsonValue::Type::ArrayType;
+        if (++depth > JSON_MAX_DEPTH) {
+            error = pos;
+            return false;
+        }
+        
+        pos++;
+        skip();
+        if (pos != end && *pos == ']') {
+            pos++;
+            depth--;
+            return true;
+        }
+        
+        while (true) {
+            std::shared_ptr<JsonValue> child = std::make_shared<JsonValue>();
+            child->_parent = node;
+            node->_children.push_back(child);
+            if (!parseValue(child.get())) {
+                return false;
+            }
+            
+            skip();
+            if (pos == end) {
+                error = pos;
+                return false;
+            } else if (*pos == ']') {
+                pos++;
+                depth--;
+                return true;
+            } else if (*pos != ',') {
+                error = pos;
+                return false;
+            }
+            pos++;
+            skip();
+        }
+    }
+    
+    /**
+     * Parses the object at the current position into the given node.
+     *
+     * The current position must be an open brace.
+     *
+     * @param node  The node to store the result
+     *
+     * @return true if the object is valid
+     */
+    bool parseObject(JsonValue* node) {
+        node->_type = JsonValue::Type::ObjectType;
+        if (++depth > JSON_MAX_DEPTH) {
+            error = pos;
+            return false;
+        }
+        
+        pos++;
+        skip();
+        if (pos != end && *pos == '}') {
+            pos++;
+            depth--;
+            return true;
+        }
+        
+        while (true) {
+            if (pos == end || *pos != '"') {
+                error = pos;
+                return false;
+            }
+            
+            std::shared_ptr<JsonValue> child = std::make_shared<JsonValue>();
+            child->_parent = node;
+            node->_children.push_back(child);
+            if (!parseString(child->_key)) {
+                return false;
+            }
+            
+            skip();
+            if (pos == end || *pos != ':') {
+                error = pos;
+                return false;
+            }
+            pos++;
+            skip();
+            if (!parseValue(child.get())) {
+                return false;
+            }
+            
+            skip();
+            if (pos == end) {
+                error = pos;
+                return false;
+            } else if (*pos == '}') {
+                pos++;
+                depth--;
+                node->reindex();
+                return true;
+            } else if (*pos != ',') {
+                error = pos;
+                return false;
+            }
+            pos++;
+            skip();
+        }
+    }
+    
+    /**
+     * Parses the value at the current position into the given node.
+     *
+     * The node should be a newly created null node.
+     *
+     * @param node  The node to store the result
+     *
+     * @return true if the value is valid
+     */
+    bool parseValue(JsonValue* node) {
+        if (pos == end) {
+            error = pos;
+            return false;
+        }
+        
+        switch (*pos) {
+            case '"':
+                node->_type = JsonValue::Type::StringType;
+                return parseString(node->_stringValue);
+            case '[':
+                return parseArray(node);
+            case '{':
+                return parseObject(node);
+            case 'n':
+                if (match("null",4)) {
+                    node->_type = JsonValue::Type::NullType;
+                    return true;
+                }
+                break;
+            case 't':
+                if (match("true",4)) {
+                    node->_type = JsonValue::Type::BoolType;
+                    node->_longValue = 1;
+                    return true;
+                }
+                break;
+            case 'f':
+                if (match("false",5)) {
+                    node->_type = JsonValue::Type::BoolType;
+                    node->_longValue = 0;
+                    return true;
+                }
+                break;
+            default:
+                if (*pos == '-' || (*pos >= '0' && *pos <= '9')) {
+                    return parseNumber(node);
+                }
+                break;
+        }
+        
+        error = pos;
+        return false;
+    }
+};
+
 #pragma mark -
 #pragma mark JSON Conversions
 /**
@@ -181,6 +714,7 @@ std::shared_ptr<JsonValue> JsonValue::toJsonValue(const CUJSON* node) {
         }
     }
     result->_children.assign(items.begin(),items.end());
+    result->reindex();
     
     return result;
 }
@@ -221,6 +755,7 @@ void JsonValue::toJsonValue(JsonValue* value, const CUJSON* node) {
         }
     }
     value->_children.assign(items.begin(),items.end());
+    value->reindex();
 }
 
 /**
@@ -399,17 +934,44 @@ bool JsonValue::init(double value) {
  *
  * @return  true if the JSON node is initialized properly, false otherwise.
  */
-bool JsonValue::initWithJson(const std::string json) {
-    const char *error = NULL;
-    CUJSON* node = CUJSON_ParseWithOpts(json.c_str(), &error, 0);
-    if (node) {
-        toJsonValue(this,node);
-        CUJSON_Delete(node);
+bool JsonValue::initWithJson(const std::string& json) {
+    return initWithJson(json.data(),json.size());
+}
+
+/**
+ * Initializes a new JsonValue from the given JSON string.
+ *
+ * This initializer will parse the JSON string and construct a full JSON
+ * tree for the string, if possible. The children are all owned by this
+ * node will be deleted when this node is deleted (provided there are
+ * no other references).
+ *
+ * The JSON string does not need to be null terminated. It is parsed in a
+ * single pass, directly into the JSON tree, with no intermediate copy.
+ *
+ * If there is a parsing error, this  method will return false.  Detailed
+ * information about the parsing error will be passed to an assert.  Hence
+ * error messages are suppressed if asserts are turned off.
+ *
+ * @param json      The JSON string to parse.
+ * @param length    The number of bytes in the JSON string.
+ *
+ * @return  true if the JSON node is initialized properly, false otherwise.
+ */
+bool JsonValue::initWithJson(const char* json, size_t length) {
+    Parser parser(json,length);
+    parser.skip();
+    if (parser.parseValue(this)) {
         return true;
     }
-    if (error) {
+    
+    _type = Type::NullType;
+    _stringValue.clear();
+    _children.clear();
+    _index = nullptr;
+    if (parser.error) {
         int line = 0;
-        std::string source = isolate_error(json.c_str(),error,line);
+        std::string source = isolate_error(json,parser.end,parser.error,line);
         CUAssertLog(false, "Invalid token at line %d:\n  %s",line,source.c_str());
     } else {
         CUAssertLog(false, "Invalid JSON");
@@ -809,6 +1371,9 @@ void JsonValue::setKey(const std::string key) {
         CUAssertLog(!_parent->has(key), "The key %s is already in use", key.c_str());
     }
     _key = key;
+    if (_parent) {
+        _parent->reindex();
+    }
 }
 
 /**
@@ -839,14 +1404,9 @@ const int JsonValue::index() const {
  *
  * @return true if a child with the specified name exists.
  */
-bool JsonValue::has(const std::string key) const {
+bool JsonValue::has(std::string_view key) const {
     CUAssertLog(isObject(), "Node is not an object type");
-    for(auto it = _children.begin(); it != _children.end(); it++) {
-        if ((*it)->_key == key) {
-            return true;
-        }
-    }
-    return false;
+    return find(key) >= 0;
 }
 
 /**
@@ -889,18 +1449,17 @@ const std::shared_ptr<JsonValue> JsonValue::get(int index) const {
  * corrupted and there is more than one child of this name, it will return
  * the first one.
  *
+ * Objects with many children keep a hash index of their keys, so this
+ * lookup is constant time.  Smaller objects are searched linearly.
+ *
  * @param key   The key identifying the child.
  *
  * @return the child with the specified key.
  */
-std::shared_ptr<JsonValue> JsonValue::get(const std::string key) {
+std::shared_ptr<JsonValue> JsonValue::get(std::string_view key) {
     CUAssertLog(isObject(), "Node is not an object type");
-    for(auto it = _children.begin(); it != _children.end(); it++) {
-        if ((*it)->_key == key) {
-            return *it;
-        }
-    }
-    return nullptr;
+    Sint32 pos = find(key);
+    return pos < 0 ? nullptr : _children[pos];
 }
 
 /**
@@ -911,18 +1470,17 @@ std::shared_ptr<JsonValue> JsonValue::get(const std::string key) {
  * corrupted and there is more than one child of this name, it will return
  * the first one.
  *
+ * Objects with many children keep a hash index of their keys, so this
+ * lookup is constant time.  Smaller objects are searched linearly.
+ *
  * @param key   The key identifying the child.
  *
  * @return the child with the specified key.
  */
-const std::shared_ptr<JsonValue> JsonValue::get(const std::string key) const {
+const std::shared_ptr<JsonValue> JsonValue::get(std::string_view key) const {
     CUAssertLog(isObject(), "Node is not an object type");
-    for(auto it = _children.begin(); it != _children.end(); it++) {
-        if ((*it)->_key == key) {
-            return *it;
-        }
-    }
-    return nullptr;
+    Sint32 pos = find(key);
+    return pos < 0 ? nullptr : _children[pos];
 }
 
 #pragma mark -
@@ -940,8 +1498,9 @@ const std::shared_ptr<JsonValue> JsonValue::get(const std::string key) const {
  *
  * @return the string value of the child with the specified key.
  */
-const std::string JsonValue::getString (const std::string key, const std::string defaultValue) const {
-    JsonValue* child = get(key).get();
+const std::string JsonValue::getString (std::string_view key, const std::string& defaultValue) const {
+    Sint32 pos = find(key);
+    JsonValue* child = pos < 0 ? nullptr : _children[pos].get();
     bool astr = (child != nullptr && child->isValue());
     return astr ? child->asString(defaultValue) : std::string(defaultValue);
 }
@@ -959,8 +1518,9 @@ const std::string JsonValue::getString (const std::string key, const std::string
  *
  * @return the float value of the child with the specified key.
  */
-float JsonValue::getFloat(const std::string key, float defaultValue) const {
-    JsonValue* child = get(key).get();
+float JsonValue::getFloat(std::string_view key, float defaultValue) const {
+    Sint32 pos = find(key);
+    JsonValue* child = pos < 0 ? nullptr : _children[pos].get();
     bool astr = (child != nullptr && child->isNumber());
     return astr ? child->asFloat(defaultValue) : defaultValue;
 }
@@ -978,8 +1538,9 @@ float JsonValue::getFloat(const std::string key, float defaultValue) const {
  *
  * @return the double value of the child with the specified key.
  */
-double JsonValue::getDouble(const std::string key, double defaultValue) const {
-    JsonValue* child = get(key).get();
+double JsonValue::getDouble(std::string_view key, double defaultValue) const {
+    Sint32 pos = find(key);
+    JsonValue* child = pos < 0 ? nullptr : _children[pos].get();
     bool astr = (child != nullptr && child->isNumber());
     return astr ? child->asFloat(defaultValue) : defaultValue;
 }
@@ -997,8 +1558,9 @@ double JsonValue::getDouble(const std::string key, double defaultValue) const {
  *
  * @return the long value of the child with the specified key.
  */
-long JsonValue::getLong(const std::string key, long defaultValue) const {
-    JsonValue* child = get(key).get();
+long JsonValue::getLong(std::string_view key, long defaultValue) const {
+    Sint32 pos = find(key);
+    JsonValue* child = pos < 0 ? nullptr : _children[pos].get();
     bool astr = (child != nullptr && child->isNumber());
     return astr ? child->asLong(defaultValue) : defaultValue;
 }
@@ -1016,8 +1578,9 @@ long JsonValue::getLong(const std::string key, long defaultValue) const {
  *
  * @return the int value of the child with the specified key.
  */
-int JsonValue::getInt (const std::string key, int defaultValue) const {
-    JsonValue* child = get(key).get();
+int JsonValue::getInt (std::string_view key, int defaultValue) const {
+    Sint32 pos = find(key);
+    JsonValue* child = pos < 0 ? nullptr : _children[pos].get();
     bool astr = (child != nullptr && child->isNumber());
     return astr ? child->asInt(defaultValue) : defaultValue;
 }
@@ -1035,8 +1598,9 @@ int JsonValue::getInt (const std::string key, int defaultValue) const {
  *
  * @return the boolean value of the child with the specified key.
  */
-bool JsonValue::getBool(const std::string key, bool defaultValue) const {
-    JsonValue* child = get(key).get();
+bool JsonValue::getBool(std::string_view key, bool defaultValue) const {
+    Sint32 pos = find(key);
+    JsonValue* child = pos < 0 ? nullptr : _children[pos].get();
     bool astr = (child != nullptr && child->isBool());
     return astr ? child->asBool(defaultValue) : defaultValue;
 }
@@ -1060,6 +1624,7 @@ std::shared_ptr<JsonValue> JsonValue::removeChild(int index) {
     std::shared_ptr<JsonValue> result = _children[index];
     _children.erase(_children.begin() + index);
     result->_parent = nullptr;
+    reindex();
     return result;
 }
 
@@ -1075,18 +1640,10 @@ std::shared_ptr<JsonValue> JsonValue::removeChild(int index) {
  *
  * Returns the child with the specified key and removes it from this node.
  */
-std::shared_ptr<JsonValue> JsonValue::removeChild(const std::string key) {
-    auto jt = _children.end();
-    for(auto it = _children.begin(); jt == _children.end() && it != _children.end(); it++) {
-        if ((*it)->_key == key) {
-            jt = it;
-        }
-    }
-    if (jt != _children.end()) {
-        std::shared_ptr<JsonValue> result = *jt;
-        _children.erase(jt);
-        result->_parent = nullptr;
-        return result;
+std::shared_ptr<JsonValue> JsonValue::removeChild(std::string_view key) {
+    Sint32 pos = find(key);
+    if (pos >= 0) {
+        return removeChild(pos);
     }
     return nullptr;
 }
@@ -1106,6 +1663,7 @@ void JsonValue::merge(const std::shared_ptr<JsonValue>& node) {
     node->_key = _key;
     _parent->removeChild(_key);
     node->_parent->_children.push_back(node);
+    node->_parent->reindex();
 }
 
 
@@ -1131,6 +1689,11 @@ void JsonValue::appendChild(const std::shared_ptr<JsonValue>& child) {
                 "The key %s is already in use", child->key().c_str());
     _children.push_back(child);
     child->_parent = this;
+    if (_index != nullptr) {
+        _index->try_emplace(std::hash<std::string_view>()(child->_key),(Uint32)_children.size()-1);
+    } else if (_children.size() >= JSON_INDEX_MIN) {
+        reindex();
+    }
 }
 
 /**
@@ -1156,6 +1719,11 @@ void JsonValue::appendChild(const std::string key, const std::shared_ptr<JsonVal
     child->_key = key;
     _children.push_back(child);
     child->_parent = this;
+    if (_index != nullptr) {
+        _index->try_emplace(std::hash<std::string_view>()(child->_key),(Uint32)_children.size()-1);
+    } else if (_children.size() >= JSON_INDEX_MIN) {
+        reindex();
+    }
 }
 
 /**
@@ -1180,6 +1748,7 @@ void JsonValue::insertChild(unsigned int index, const std::shared_ptr<JsonValue>
     CUAssertLog(isArray() || isObject(), "This node is a value type");
     _children.insert(_children.begin()+index,child);
     child->_parent = this;
+    reindex();
 }
 
 /**
@@ -1209,9 +1778,68 @@ void JsonValue::insertChild(unsigned int index, const std::string key,
     child->_key = key;
     _children.insert(_children.begin()+index,child);
     child->_parent = this;
+    reindex();
 }
 
 
+#pragma mark -
+#pragma mark Key Index
+/**
+ * Returns the position of the child with the given key, or -1 if none.
+ *
+ * If this node has a key index, that index is used to find the child.
+ * Otherwise, the children are searched linearly.
+ *
+ * @param key   The key identifying the child
+ *
+ * @return the position of the child with the given key, or -1 if none.
+ */
+Sint32 JsonValue::find(std::string_view key) const {
+    CUAssertLog(isObject(), "Node is not an object type");
+    if (_index != nullptr) {
+        auto it = _index->find(std::hash<std::string_view>()(key));
+        if (it == _index->end()) {
+            return -1;
+        } else if (it->second < _children.size() && _children[it->second]->_key == key) {
+            return (Sint32)it->second;
+        }
+        // Hash collision; fall through to search
+    }
+    
+    for(size_t pos = 0; pos < _children.size(); pos++) {
+        if (_children[pos]->_key == key) {
+            return (Sint32)pos;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Rebuilds the key index of this node.
+ *
+ * The index is only built for objects with many children. Otherwise
+ * this method deletes any existing index.
+ */
+void JsonValue::reindex() {
+    if (_type != Type::ObjectType || _children.size() < JSON_INDEX_MIN) {
+        _index = nullptr;
+        return;
+    }
+    
+    if (_index == nullptr) {
+        _index = std::make_unique<std::unordered_map<size_t, Uint32>>();
+    } else {
+        _index->clear();
+    }
+    _index->reserve(_children.size());
+    
+    // Keep the first of any duplicate keys
+    std::hash<std::string_view> hasher;
+    for(size_t pos = 0; pos < _children.size(); pos++) {
+        _index->try_emplace(hasher(_children[pos]->_key),(Uint32)pos);
+    }
+}
+
 #pragma mark -
 #pragma mark Encoding
 /**
@@ -85,7 +85,7 @@ bool WidgetLoader::materialize(const std::string key, const std::shared_ptr<Widg
     if (callback != nullptr) {
         callback(key,success);
     }
-    _queue.erase(key);
+    dequeue(key);
     return success;
 }
 
@@ -108,7 +108,7 @@ bool WidgetLoader::materialize(const std::string key, const std::shared_ptr<Widg
  * @return true if the asset was successfully loaded
  */
 bool WidgetLoader::read(const std::string key, const std::string source, LoaderCallback callback, bool async) {
-    if (_assets.find(key) != _assets.end() || _queue.find(key) != _queue.end()) {
+    if (_assets.find(key) != _assets.end() || queued(key)) {
         return false;
     }
     
@@ -132,7 +132,7 @@ bool WidgetLoader::read(const std::string key, const std::string source, LoaderC
             std::shared_ptr<JsonReader> reader = JsonReader::allocWithAsset(path);
             std::shared_ptr<JsonValue> json = (reader == nullptr ? nullptr : reader->readJson());
 			std::shared_ptr<WidgetValue> widget = WidgetValue::alloc(json);
-            Application::get()->schedule([=,this](void) {
+            this->schedule([=,this](void) {
                 this->materialize(key,widget,callback);
                 return false;
             });
@@ -164,7 +164,7 @@ bool WidgetLoader::read(const std::string key, const std::string source, LoaderC
  */
 bool WidgetLoader::read(const std::shared_ptr<JsonValue>& json, LoaderCallback callback, bool async) {
     std::string key = json->key();
-    if (_assets.find(key) != _assets.end() || _queue.find(key) != _queue.end()) {
+    if (_assets.find(key) != _assets.end() || queued(key)) {
         return false;
     }
     std::string source = json->asString(UNKNOWN_SOURCE);
@@ -182,7 +182,7 @@ bool WidgetLoader::read(const std::shared_ptr<JsonValue>& json, LoaderCallback c
             std::shared_ptr<JsonReader> reader = JsonReader::allocWithAsset(source);
             std::shared_ptr<JsonValue> json = (reader == nullptr ? nullptr : reader->readJson());
 			std::shared_ptr<WidgetValue> widget = WidgetValue::alloc(json);
-            Application::get()->schedule([=,this](void) {
+            this->schedule([=,this](void) {
                 this->materialize(key,widget,callback);
                 return false;
             });
@@ -55,10 +55,21 @@
 #include <cugl/core/util/CUEndian.h>
 #include <cugl/core/util/CUFiletools.h>
 #include <cugl/core/CUApplication.h>
+#include <cugl/core/assets/CUJsonValue.h>
+#include <climits>
+#include <cmath>
+#include <cstring>
 
 using namespace cugl;
 
+/** The maximum nesting depth of a binary JSON value */
+#define JSON_MAX_DEPTH  1000
+/** The CBOR self-describe tag */
+#define JSON_CBOR_TAG   55799
+
 #define BUFFSIZE 1024
+/** The minimum file size to memory map (smaller files are cheaper to read) */
+#define MAP_MINIMUM 4096
 
 #pragma mark -
 #pragma mark Constructors
@@ -106,6 +117,9 @@ bool BinaryReader::init(const std::string file, unsigned int capacity) {
     _ssize = SDL_RWsize(_stream);
     _scursor = 0;
     _capacity = capacity;
+    if (_ssize >= MAP_MINIMUM && map()) {
+        return true;
+    }
     _buffer = new char[_capacity];
     _bufsize = 0;
     fill();
@@ -160,6 +174,9 @@ bool BinaryReader::initWithAsset(const std::string file, unsigned int capacity)
     _ssize = SDL_RWsize(_stream);
     _scursor = 0;
     _capacity = capacity;
+    if (_ssize >= MAP_MINIMUM && map()) {
+        return true;
+    }
     _buffer = new char[_capacity];
     _bufsize = 0;
     fill();
@@ -177,11 +194,17 @@ bool BinaryReader::initWithAsset(const std::string file, unsigned int capacity)
  * if the stream has been closed.
  */
 void BinaryReader::reset() {
-    if (_stream) {
+    if (_mapped) {
+        _bufoff = 0;
+        return;
+    } else if (_stream) {
         close();
     }
     _stream = SDL_RWFromFile(_name.c_str(), "rb");
     _ssize  = SDL_RWsize(_stream);
+    if (_ssize >= MAP_MINIMUM && map()) {
+        return;
+    }
     _buffer = new char[_capacity];
     _bufsize = 0;
     _bufoff  = 0;
@@ -200,7 +223,14 @@ void BinaryReader::close() {
         _stream  = nullptr;
         _scursor = 0;
     }
-    if (_buffer) {
+    if (_mapped) {
+        filetool::file_unmap(_buffer,_bufsize);
+        _buffer  = nullptr;
+        _bufsize = 0;
+        _bufoff  = 0;
+        _scursor = 0;
+        _mapped  = false;
+    } else if (_buffer) {
         delete[] _buffer;
         _buffer  = nullptr;
         _bufsize = 0;
@@ -254,6 +284,35 @@ void BinaryReader::fill(unsigned int bytes) {
     _scursor += amt;
 }
 
+/**
+ * Replaces the SDL stream with a memory map of the file, if possible.
+ *
+ * If this method succeeds, the read buffer is the entire file and the
+ * SDL stream is closed. If it fails, the reader is unchanged.
+ *
+ * @return true if the file was memory mapped
+ */
+bool BinaryReader::map() {
+    size_t size = 0;
+    const char* data = filetool::file_map(_name,size);
+    if (data == nullptr) {
+        return false;
+    } else if (size != (size_t)_ssize || size > INT_MAX) {
+        // The buffer offset is 32 bits
+        filetool::file_unmap(data,size);
+        return false;
+    }
+    
+    SDL_RWclose(_stream);
+    _stream  = nullptr;
+    _buffer  = const_cast<char*>(data);
+    _bufsize = (Uint32)size;
+    _bufoff  = 0;
+    _scursor = _ssize;
+    _mapped  = true;
+    return true;
+}
+
 #pragma mark -
 #pragma mark Single Element Reads
 /**
@@ -766,3 +825,302 @@ size_t BinaryReader::read(double* buffer, size_t maximum, size_t offset) {
     return pos-offset;
 }
 
+
+/**
+ * Returns a view of the next sequence of bytes in the stream.
+ *
+ * The view will have up to maximum bytes. It will only have fewer if the
+ * stream does not have that many bytes left. The stream advances past
+ * the bytes in the view.
+ *
+ * If the file is memory mapped, the view is a window into the map and no
+ * data is copied. Otherwise, the bytes are read into the buffer of this
+ * reader, and the buffer will grow if it is smaller than the view. In
+ * either case, the view is only valid until the next read, reset, or
+ * close of this reader. Copy the data if you need it longer than that.
+ *
+ * @param maximum   The maximum number of bytes to view
+ *
+ * @return a view of the next sequence of bytes in the stream.
+ */
+std::string_view BinaryReader::readView(size_t maximum) {
+    CUAssertLog(ready(), "Attempt to read a finished stream");
+    size_t avail = _bufsize-_bufoff;
+    if (avail < maximum && _stream && _scursor < _ssize) {
+        // Make the unread bytes contiguous, growing the buffer if necessary
+        size_t total = avail+(size_t)(_ssize-_scursor);
+        size_t wanted = maximum < total ? maximum : total;
+        if (wanted > _capacity) {
+            char* buffer = new char[wanted];
+            memcpy(buffer, &(_buffer[_bufoff]), avail);
+            delete[] _buffer;
+            _buffer = buffer;
+            _capacity = (Uint32)wanted;
+        } else if (_bufoff > 0) {
+            memmove(_buffer, &(_buffer[_bufoff]), avail);
+        }
+        _bufsize = (Uint32)avail;
+        _bufoff  = 0;
+        
+        while (_bufsize < wanted) {
+            size_t amt = SDL_RWread(_stream, &_buffer[_bufsize], 1, _capacity-_bufsize);
+            if (amt == 0) {
+                break;
+            }
+            _bufsize += (Uint32)amt;
+            _scursor += amt;
+        }
+        avail = _bufsize;
+    }
+    
+    size_t amount = maximum < avail ? maximum : avail;
+    std::string_view result(&(_buffer[_bufoff]),amount);
+    _bufoff += (Sint32)amount;
+    return result;
+}
+
+#pragma mark -
+#pragma mark JSON Reads
+/**
+ * Returns a newly allocated JsonValue for the next value in the stream.
+ *
+ * The value must be encoded in CBOR (RFC 8949), as produced by the method
+ * {@link BinaryWriter#writeJson}. The value may be prefixed by the CBOR
+ * self-describe tag, which is how {@link JsonReader} recognizes a binary
+ * JSON file. Unlike text JSON, the binary value requires no parsing of
+ * tokens or number conversion, so it is much faster to load.
+ *
+ * Only the subset of CBOR that corresponds to JSON is supported. Byte
+ * strings, indefinite lengths, and tags (other than self-describe) are
+ * all rejected. Integers that do not fit in a long are stored as doubles.
+ *
+ * If there is a decoding error, this method will return nullptr. Detailed
+ * information about the error will be passed to an assert. Hence error
+ * messages are suppressed if asserts are turned off.
+ *
+ * @return a newly allocated JsonValue for the next value in the stream.
+ */
+std::shared_ptr<JsonValue> BinaryReader::readJson() {
+    CUAssertLog(ready(), "Attempt to read a finished stream");
+    return readJsonValue(0);
+}
+
+#pragma mark -
+#pragma mark Internal Methods
+/**
+ * Returns true if the argument of a CBOR head was read successfully
+ *
+ * The argument is the length of a string or collection, or the value of
+ * an integer. The info value is the lower five bits of the initial byte.
+ * This method fails on indefinite lengths, which are not supported.
+ *
+ * @param info  The additional information of the CBOR head
+ * @param value The variable to store the argument
+ *
+ * @return true if the argument of a CBOR head was read successfully
+ */
+bool BinaryReader::readJsonArgument(Uint8 info, Uint64& value) {
+    if (info < 24) {
+        value = info;
+        return true;
+    }
+    switch (info) {
+        case 24:
+            if (ready(1)) {
+                value = readByte();
+                return true;
+            }
+            break;
+        case 25:
+            if (ready(2)) {
+                value = readUint16();
+                return true;
+            }
+            break;
+        case 26:
+            if (ready(4)) {
+                value = readUint32();
+                return true;
+            }
+            break;
+        case 27:
+            if (ready(8)) {
+                value = readUint64();
+                return true;
+            }
+            break;
+        default:
+            CUAssertLog(false, "Unsupported CBOR length %d in %s", info, _name.c_str());
+            return false;
+    }
+    CUAssertLog(false, "Unexpected end of binary JSON in %s", _name.c_str());
+    return false;
+}
+
+/**
+ * Returns the next JSON value in CBOR format from the stream
+ *
+ * This method returns nullptr if the stream does not have a valid value.
+ * The depth is the nesting depth of this value, which is used to guard
+ * against stack overflow on malicious data.
+ *
+ * @param depth The nesting depth of this value
+ *
+ * @return the next JSON value in CBOR format from the stream
+ */
+std::shared_ptr<JsonValue> BinaryReader::readJsonValue(int depth) {
+    if (depth > JSON_MAX_DEPTH) {
+        CUAssertLog(false, "Binary JSON in %s is nested too deeply", _name.c_str());
+        return nullptr;
+    } else if (!ready(1)) {
+        CUAssertLog(false, "Unexpected end of binary JSON in %s", _name.c_str());
+        return nullptr;
+    }
+    
+    Uint8 head  = readByte();
+    Uint8 major = head >> 5;
+    Uint8 info  = head & 0x1f;
+    
+    // Simple values and floats do not have a length argument
+    if (major == 7) {
+        switch (info) {
+            case 20:
+                return JsonValue::alloc(false);
+            case 21:
+                return JsonValue::alloc(true);
+            case 22:
+            case 23:
+                return JsonValue::allocNull();
+            case 25:
+                if (ready(2)) {
+                    // Half floats are legal CBOR, but we never write them
+                    Uint16 bits = readUint16();
+                    int exp  = (bits >> 10) & 0x1f;
+                    int mant = bits & 0x3ff;
+                    double value;
+                    if (exp == 0) {
+                        value = std::ldexp((double)mant, -24);
+                    } else if (exp != 31) {
+                        value = std::ldexp((double)(mant+1024), exp-25);
+                    } else {
+                        value = mant == 0 ? INFINITY : NAN;
+                    }
+                    return JsonValue::alloc((bits & 0x8000) ? -value : value);
+                }
+                break;
+            case 26:
+                if (ready(4)) {
+                    return JsonValue::alloc((double)readFloat());
+                }
+                break;
+            case 27:
+                if (ready(8)) {
+                    return JsonValue::alloc(readDouble());
+                }
+                break;
+            default:
+                CUAssertLog(false, "Unsupported CBOR value %d in %s", info, _name.c_str());
+                return nullptr;
+        }
+        CUAssertLog(false, "Unexpected end of binary JSON in %s", _name.c_str());
+        return nullptr;
+    }
+    
+    Uint64 value;
+    if (!readJsonArgument(info, value)) {
+        return nullptr;
+    }
+    
+    std::shared_ptr<JsonValue> result;
+    switch (major) {
+        case 0:
+            if (value <= (Uint64)LONG_MAX) {
+                result = JsonValue::alloc((long)value);
+            } else {
+                result = JsonValue::alloc((double)value);
+            }
+            break;
+        case 1:
+            if (value <= (Uint64)LONG_MAX) {
+                result = JsonValue::alloc(-1L-(long)value);
+            } else {
+                result = JsonValue::alloc(-1.0-(double)value);
+            }
+            break;
+        case 3:
+        {
+            if (value > UINT_MAX || !ready((unsigned int)value)) {
+                CUAssertLog(false, "Unexpected end of binary JSON in %s", _name.c_str());
+                return nullptr;
+            }
+            std::string text((size_t)value,'\0');
+            if (value) {
+                read(text.data(),(size_t)value);
+            }
+            result = JsonValue::alloc(text);
+        }
+            break;
+        case 4:
+            result = JsonValue::allocArray();
+            // Every child needs at least a byte, so this guards the reservation
+            if (value <= UINT_MAX && ready((unsigned int)value)) {
+                result->_children.reserve((size_t)value);
+            }
+            for(Uint64 ii = 0; ii < value; ii++) {
+                std::shared_ptr<JsonValue> child = readJsonValue(depth+1);
+                if (child == nullptr) {
+                    return nullptr;
+                }
+                result->appendChild(child);
+            }
+            break;
+        case 5:
+            result = JsonValue::allocObject();
+            if (value <= UINT_MAX/2 && ready((unsigned int)(2*value))) {
+                result->_children.reserve((size_t)value);
+            }
+            for(Uint64 ii = 0; ii < value; ii++) {
+                Uint64 length;
+                if (!ready(1)) {
+                    CUAssertLog(false, "Unexpected end of binary JSON in %s", _name.c_str());
+                    return nullptr;
+                }
+                head = readByte();
+                if ((head >> 5) != 3) {
+                    CUAssertLog(false, "Binary JSON in %s has a non-string key", _name.c_str());
+                    return nullptr;
+                } else if (!readJsonArgument(head & 0x1f, length)) {
+                    return nullptr;
+                } else if (length > UINT_MAX || !ready((unsigned int)length)) {
+                    CUAssertLog(false, "Unexpected end of binary JSON in %s", _name.c_str());
+                    return nullptr;
+                }
+                std::string key((size_t)length,'\0');
+                if (length) {
+                    read(key.data(),(size_t)length);
+                }
+                if (result->has(key)) {
+                    CUAssertLog(false, "Binary JSON in %s has a duplicate key '%s'",
+                                _name.c_str(), key.c_str());
+                    return nullptr;
+                }
+                std::shared_ptr<JsonValue> child = readJsonValue(depth+1);
+                if (child == nullptr) {
+                    return nullptr;
+                }
+                result->appendChild(key,child);
+            }
+            break;
+        case 6:
+            if (value != JSON_CBOR_TAG) {
+                CUAssertLog(false, "Unsupported CBOR tag %llu in %s",
+                            (unsigned long long)value, _name.c_str());
+                return nullptr;
+            }
+            return readJsonValue(depth);
+        default:
+            CUAssertLog(false, "Binary JSON in %s has an unsupported byte string", _name.c_str());
+            return nullptr;
+    }
+    return result;
+}
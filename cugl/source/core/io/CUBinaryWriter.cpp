@@ -55,6 +55,7 @@
 #include <cugl/core/util/CUDebug.h>
 #include <cugl/core/util/CUFiletools.h>
 #include <cugl/core/CUApplication.h>
+#include <cugl/core/assets/CUJsonValue.h>
 #include <cstring>
 
 using namespace cugl;
@@ -804,3 +805,118 @@ void BinaryWriter::write(const double* array, size_t length, size_t offset) {
     
     _bufoff += skip;
 }
+
+#pragma mark -
+#pragma mark JSON Writes
+/**
+ * Writes the given JSON value to the binary file.
+ *
+ * The value is encoded in CBOR (RFC 8949), prefixed by the CBOR
+ * self-describe tag. This tag allows {@link JsonReader} to recognize the
+ * file as binary, so binary JSON files can be used anywhere a text JSON
+ * file is expected. They can be read back with {@link BinaryReader#readJson}.
+ *
+ * Numbers with an integral value are encoded as integers. All other
+ * numbers are encoded as single precision floats if that is lossless,
+ * and as double precision floats otherwise. Objects preserve the order
+ * of their keys.
+ *
+ * The value is written to the internal buffer, but is not necessarily
+ * flushed automatically.  It will be written when the buffer reaches
+ * capacity or the file is closed.
+ *
+ * @param json  The JSON value to write
+ */
+void BinaryWriter::writeJson(const JsonValue* json) {
+    CUAssertLog(json, "Attempt to write a null JSON value");
+    // The self-describe tag 55799
+    writeUint8(0xd9);
+    writeUint8(0xd9);
+    writeUint8(0xf7);
+    writeJsonValue(json);
+}
+
+#pragma mark -
+#pragma mark Internal Methods
+/**
+ * Writes the head of a CBOR data item to the binary file.
+ *
+ * The head is the major type followed by the argument, which is the
+ * length of a string or collection, or the value of an integer. The
+ * argument is written in the fewest bytes possible.
+ *
+ * @param major The CBOR major type (0-7)
+ * @param value The argument of the head
+ */
+void BinaryWriter::writeJsonHead(Uint8 major, Uint64 value) {
+    major <<= 5;
+    if (value < 24) {
+        writeUint8(major | (Uint8)value);
+    } else if (value <= 0xff) {
+        writeUint8(major | 24);
+        writeUint8((Uint8)value);
+    } else if (value <= 0xffff) {
+        writeUint8(major | 25);
+        writeUint16((Uint16)value);
+    } else if (value <= 0xffffffff) {
+        writeUint8(major | 26);
+        writeUint32((Uint32)value);
+    } else {
+        writeUint8(major | 27);
+        writeUint64(value);
+    }
+}
+
+/**
+ * Writes the given JSON value (and its descendants) in CBOR format.
+ *
+ * @param json  The JSON value to write
+ */
+void BinaryWriter::writeJsonValue(const JsonValue* json) {
+    switch (json->type()) {
+        case JsonValue::Type::NullType:
+            writeUint8(0xf6);
+            break;
+        case JsonValue::Type::BoolType:
+            writeUint8(json->_longValue ? 0xf5 : 0xf4);
+            break;
+        case JsonValue::Type::NumberType:
+        {
+            Sint64 value = (Sint64)json->_longValue;
+            double number = json->_doubleValue;
+            if ((double)value == number) {
+                if (value >= 0) {
+                    writeJsonHead(0,(Uint64)value);
+                } else {
+                    writeJsonHead(1,(Uint64)(-(value+1)));
+                }
+            } else if ((double)(float)number == number) {
+                writeUint8(0xfa);
+                writeFloat((float)number);
+            } else {
+                writeUint8(0xfb);
+                writeDouble(number);
+            }
+        }
+            break;
+        case JsonValue::Type::StringType:
+            writeJsonHead(3,json->_stringValue.size());
+            write(json->_stringValue.data(),json->_stringValue.size());
+            break;
+        case JsonValue::Type::ArrayType:
+            writeJsonHead(4,json->_children.size());
+            for(auto it = json->_children.begin(); it != json->_children.end(); ++it) {
+                writeJsonValue(it->get());
+            }
+            break;
+        case JsonValue::Type::ObjectType:
+            writeJsonHead(5,json->_children.size());
+            for(auto it = json->_children.begin(); it != json->_children.end(); ++it) {
+                const std::string& key = (*it)->_key;
+                writeJsonHead(3,key.size());
+                write(key.data(),key.size());
+                writeJsonValue(it->get());
+            }
+            break;
+    }
+}
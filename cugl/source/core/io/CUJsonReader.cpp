@@ -4,7 +4,8 @@
 //
 //  This module provides extends the basic TextReader to support JSON decoding.
 //  It does not require that the entire file conform to JSON standards; it can
-//  read a JSON string embedded in a larger text file.
+//  read a JSON string embedded in a larger text file. It also recognizes
+//  binary JSON files (CBOR) so that they can replace JSON assets as is.
 //
 //  By default, this module (and every module in the io package) accesses the
 //  application save directory.  If you want to access another directory, you
@@ -47,6 +48,7 @@
 //  Version: 7/3/24 (CUGL 3.0 reorganization)
 //
 #include <cugl/core/io/CUJsonReader.h>
+#include <cugl/core/io/CUBinaryReader.h>
 #include <cugl/core/util/CUDebug.h>
 
 using namespace cugl;
@@ -65,44 +67,68 @@ using namespace cugl;
  * @return the next available JSON string
  */
 std::string JsonReader::readJsonString() {
+    return std::string(readJsonView());
+}
+
+/**
+ * Returns a view of the next available JSON string
+ *
+ * This method is the same as {@link readJsonString()}, except that it does
+ * not copy the string. If the file is memory mapped, the view is a window
+ * into the map. Otherwise it is a window into the buffer of this reader,
+ * which grows to hold the string if necessary. In either case, the view is
+ * only valid until the next read, reset, or close of this reader.
+ *
+ * @return a view of the next available JSON string
+ */
+std::string_view JsonReader::readJsonView() {
     CUAssertLog(ready(), "Attempt to read a finished stream");
     skip();
     
     // Make sure first character a bracket
-    CUAssertLog(_sbuffer[_bufoff] == '{', "JSON is missing initial {");
+    CUAssertLog(_bufoff < _window.size() && _window[_bufoff] == '{', "JSON is missing initial {");
     
     int depth = 0;
-    std::string data;
+    size_t pos = _bufoff;
     // Go until close brace.
-    while (ready()) {
-        fill();
-        int pos = 0;
-        for(auto it = _sbuffer.begin()+_bufoff; it != _sbuffer.end(); ++it) {
-            if (*it == '{') {
+    while (true) {
+        for(; pos < _window.size(); pos++) {
+            char c = _window[pos];
+            if (c == '{') {
                 depth++;
-            } else if (*it == '}') {
+            } else if (c == '}') {
                 depth--;
             }
             if (depth == 0) {
-                data.append(_sbuffer.begin()+_bufoff,it+1);
-                _bufoff += pos+1;
+                std::string_view data = _window.substr(_bufoff,pos+1-_bufoff);
+                _bufoff = (Sint32)(pos+1);
                 return data;
             }
-            pos++;
         }
-        data.append(_sbuffer.begin()+_bufoff,_sbuffer.end());
-        _bufoff =  (int)_sbuffer.size();
+        size_t scanned = pos-_bufoff;
+        if (!expand()) {
+            break;
+        }
+        pos = _bufoff+scanned;
     }
+    _bufoff = (Sint32)_window.size();
     CUAssertLog(false, "JSON is missing closing }");
-    return "";
+    return std::string_view();
 }
 
 /**
  * Returns a newly allocated JsonValue for the next available JSON string.
  *
- * This method uses {@link readJsonString()} to extract the next available
+ * This method uses {@link readJsonView()} to extract the next available
  * JSON string and constructs a JsonValue from that.
  *
+ * If this reader is at the start of a binary JSON file (a file written by
+ * {@link BinaryWriter#writeJson}), this method decodes the entire file
+ * with {@link BinaryReader#readJson} instead. Binary files are recognized
+ * by the CBOR self-describe tag. This allows a binary file to replace a
+ * JSON asset without any changes to the loaders. The reader is finished
+ * after reading a binary file.
+ *
  * If there is a parsing error, this  method will return nullptr.  Detailed
  * information about the parsing error will be passed to an assert.  Hence
  * error messages are suppressed if asserts are turned off.
@@ -110,9 +136,24 @@ std::string JsonReader::readJsonString() {
  * @return a newly allocated JsonValue for the next available JSON string.
  */
 std::shared_ptr<JsonValue> JsonReader::readJson() {
-    std::string data = readJsonString();
+    // Binary files start with the CBOR self-describe tag
+    if (_bufoff == 0 && _scursor == (Sint64)_window.size() && _window.size() >= 3 &&
+        (Uint8)_window[0] == 0xd9 && (Uint8)_window[1] == 0xd9 && (Uint8)_window[2] == 0xf7) {
+        // Reopen the file, as text mode can corrupt binary data on Windows
+        unsigned int capacity = _ssize > _capacity ? (unsigned int)_ssize : _capacity;
+        std::shared_ptr<BinaryReader> reader = BinaryReader::alloc(_name,capacity);
+        _bufoff  = (Sint32)_window.size();
+        _scursor = _ssize;
+        if (reader == nullptr) {
+            CUAssertLog(false, "Could not reopen binary JSON file %s", _name.c_str());
+            return nullptr;
+        }
+        return reader->readJson();
+    }
+    
+    std::string_view data = readJsonView();
     if (!data.empty()) {
-        return JsonValue::allocWithJson(data);
+        return JsonValue::allocWithJson(data.data(),data.size());
     }
     return nullptr;
 }
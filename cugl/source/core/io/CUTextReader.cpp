@@ -52,10 +52,13 @@
 #include <cugl/core/CUApplication.h>
 #include <utf8/utf8.h>
 #include <cctype>
+#include <climits>
 
 using namespace cugl;
 
 #define BUFFSIZE 1024
+/** The minimum file size to memory map (smaller files are cheaper to read) */
+#define MAP_MINIMUM 4096
 
 #pragma mark -
 #pragma mark Constructors
@@ -103,6 +106,9 @@ bool TextReader::init(const std::string file, unsigned int capacity) {
     _ssize = SDL_RWsize(_stream);
     _scursor = 0;
     _capacity = capacity;
+    if (_ssize >= MAP_MINIMUM && map()) {
+        return true;
+    }
     _sbuffer.reserve(_capacity);
     _cbuffer = new char[_capacity];
     fill();
@@ -157,6 +163,9 @@ bool TextReader::initWithAsset(const std::string file, unsigned int capacity) {
     _ssize = SDL_RWsize(_stream);
 	_scursor = 0;
     _capacity = capacity;
+    if (_ssize >= MAP_MINIMUM && map()) {
+        return true;
+    }
     _sbuffer.reserve(_capacity);
     _cbuffer = new char[_capacity];
     fill();
@@ -174,15 +183,22 @@ bool TextReader::initWithAsset(const std::string file, unsigned int capacity) {
  * if the stream has been closed.
  */
 void TextReader::reset() {
-    if (_stream) {
+    if (_mapped) {
+        _bufoff = 0;
+        return;
+    } else if (_stream) {
         close();
     }
     _stream = SDL_RWFromFile(_name.c_str(), "r");
     _ssize  = SDL_RWsize(_stream);
+    _scursor = 0;
+    if (_ssize >= MAP_MINIMUM && map()) {
+        return;
+    }
     _cbuffer = new char[_capacity];
     _sbuffer.clear();
+    _window  = _sbuffer;
     _bufoff  = -1;
-    _scursor = 0;
 }
 
 /**
@@ -201,6 +217,13 @@ void TextReader::close() {
         delete[] _cbuffer;
         _cbuffer = nullptr;
     }
+    if (_mapped) {
+        filetool::file_unmap(_window.data(),_window.size());
+        _window  = std::string_view();
+        _bufoff  = -1;
+        _scursor = 0;
+        _mapped  = false;
+    }
 }
 
 /**
@@ -217,9 +240,72 @@ void TextReader::fill() {
 	}
 
     _bufoff = 0;
+    if (_sbuffer.size() >= _capacity) {
+        // The buffer was expanded past capacity
+        _window = _sbuffer;
+        return;
+    }
     size_t amt = SDL_RWread(_stream, _cbuffer, 1, _capacity-_sbuffer.size());
     _sbuffer.append(_cbuffer,amt);
     _scursor += amt;
+    _window = _sbuffer;
+}
+
+/**
+ * Reads another chunk from the file without discarding any unread data.
+ *
+ * Unlike {@link #fill}, this method grows the storage buffer past its
+ * capacity if necessary. That way the unread data is always contiguous,
+ * which allows the read methods to return views. This method returns
+ * false if there was no more data to read.
+ *
+ * @return true if more data was read from the file
+ */
+bool TextReader::expand() {
+    if (!_stream || _scursor >= _ssize) {
+        return false;
+    } else if (_bufoff > 0) {
+        _sbuffer.erase(_sbuffer.begin(), _sbuffer.begin() + _bufoff);
+    }
+    
+    _bufoff = 0;
+    size_t amt = SDL_RWread(_stream, _cbuffer, 1, _capacity);
+    _sbuffer.append(_cbuffer,amt);
+    _scursor += amt;
+    _window = _sbuffer;
+    if (amt == 0) {
+        // Text mode may make the file shorter than its size
+        _scursor = _ssize;
+    }
+    return amt > 0;
+}
+
+/**
+ * Replaces the SDL stream with a memory map of the file, if possible.
+ *
+ * If this method succeeds, the window is the entire file and the SDL
+ * stream is closed. If it fails, the reader is unchanged.
+ *
+ * @return true if the file was memory mapped
+ */
+bool TextReader::map() {
+    size_t size = 0;
+    const char* data = filetool::file_map(_name,size);
+    if (data == nullptr) {
+        return false;
+    } else if (size != (size_t)_ssize || size > INT_MAX) {
+        // The buffer offset is 32 bits
+        filetool::file_unmap(data,size);
+        return false;
+    }
+    
+    SDL_RWclose(_stream);
+    _stream  = nullptr;
+    _window  = std::string_view(data,size);
+    _bufoff  = 0;
+    _scursor = _ssize;
+    _mapped  = true;
+    return true;
 }
 
 #pragma mark -
@@ -254,11 +340,11 @@ char TextReader::read() {
  */
 std::string& TextReader::read(std::string& data) {
     CUAssertLog(ready(), "Attempt to read a finished stream");
-    if (_bufoff >= _sbuffer.size()) {
+    if (_bufoff >= _window.size()) {
         fill();
     }
 
-    data.push_back(_sbuffer[_bufoff++]);
+    data.push_back(_window[_bufoff++]);
     return data;
 }
 
@@ -291,17 +377,16 @@ std::string TextReader::readUTF8() {
  */
 std::string& TextReader::readUTF8(std::string& data) {
     CUAssertLog(ready(), "Attempt to read a finished stream");
-    if (_bufoff+3 >= _sbuffer.size()) { // Need a full UTF8 sequence
+    if (_bufoff+3 >= _window.size()) { // Need a full UTF8 sequence
         fill();
     }
     
-    size_t orig = data.size();
-    
-    std::string::iterator start = _sbuffer.begin()+_bufoff;
-    utf8::next(start,_sbuffer.end());
+    const char* begin = _window.data()+_bufoff;
+    const char* start = begin;
+    utf8::next(start,_window.data()+_window.size());
     
-    data.append(_sbuffer.begin()+_bufoff,start);
-    _bufoff += (Sint32)(data.size()-orig);
+    data.append(begin,start);
+    _bufoff += (Sint32)(start-begin);
     
     return data;
 }
@@ -339,25 +424,47 @@ std::string TextReader::readLine() {
  * @return the argument with a single line appended from the stream.
  */
 std::string& TextReader::readLine(std::string& data) {
+    std::string_view line = readLineView();
+    data.append(line.data(),line.size());
+    return data;
+}
+
+/**
+ * Returns a view of a single line of text from the stream
+ *
+ * This method is the same as {@link #readLine}, except that it does not
+ * copy the line. If the file is memory mapped, the view is a window into
+ * the map. Otherwise it is a window into the buffer of this reader, which
+ * grows to hold the line if necessary. In either case, the view is only
+ * valid until the next read, reset, or close of this reader. The view
+ * does not include the newline.
+ *
+ * @return a view of a single line of text from the stream
+ */
+std::string_view TextReader::readLineView() {
     CUAssertLog(ready(), "Attempt to read a finished stream");
-    if (_bufoff >= _sbuffer.size()) {
+    if (_bufoff >= _window.size()) {
         fill();
     }
     
-    bool found = false;
-    while (!found) {
-        size_t pos = _sbuffer.find('\n',_bufoff);
-        if (pos != std::string::npos) {
-            data.append(_sbuffer.begin()+_bufoff,_sbuffer.begin()+pos);
-            _bufoff = (Sint32)(pos+1);
-            found = true;
-        } else {
-            data.append(_sbuffer.begin()+_bufoff,_sbuffer.end());
-            _bufoff = (Sint32)_sbuffer.size();
-            fill();
+    size_t pos = _window.find('\n',_bufoff);
+    while (pos == std::string_view::npos) {
+        size_t searched = _window.size()-_bufoff;
+        if (!expand()) {
+            break;
         }
+        pos = _window.find('\n',_bufoff+searched);
     }
-    return data;
+    
+    std::string_view result;
+    if (pos == std::string_view::npos) {
+        result  = _window.substr(_bufoff);
+        _bufoff = (Sint32)_window.size();
+    } else {
+        result  = _window.substr(_bufoff,pos-_bufoff);
+        _bufoff = (Sint32)(pos+1);
+    }
+    return result;
 }
 
 /**
@@ -387,17 +494,46 @@ std::string TextReader::readAll() {
  * @return the argument with the remainder of the stream appended.
  */
 std::string& TextReader::readAll(std::string& data) {
+    std::string_view rest = readAllView();
+    data.append(rest.data(),rest.size());
+    return data;
+}
+
+/**
+ * Returns a view of the unread remainder of the stream
+ *
+ * This method is the same as {@link #readAll}, except that it does not
+ * copy the data. If the file is memory mapped, the view is a window into
+ * the map. Otherwise the remainder of the file is read into the buffer
+ * of this reader with a single read. In either case, the view is only
+ * valid until the next read, reset, or close of this reader.
+ *
+ * @return a view of the unread remainder of the stream
+ */
+std::string_view TextReader::readAllView() {
     CUAssertLog(ready(), "Attempt to read a finished stream");
-    if (_bufoff >= _sbuffer.size()) {
+    if (_bufoff >= _window.size()) {
         fill();
     }
     
-    while (ready()) {
-        data.append(_sbuffer.begin()+_bufoff,_sbuffer.end());
-        _bufoff = (Sint32)_sbuffer.size();
-        fill();
+    if (_stream && _scursor < _ssize) {
+        if (_bufoff > 0) {
+            _sbuffer.erase(_sbuffer.begin(), _sbuffer.begin() + _bufoff);
+        }
+        _bufoff = 0;
+        
+        // Read the rest of the file directly into the buffer
+        size_t orig = _sbuffer.size();
+        _sbuffer.resize(orig+(size_t)(_ssize-_scursor));
+        size_t amt = SDL_RWread(_stream, &_sbuffer[orig], 1, _sbuffer.size()-orig);
+        _sbuffer.resize(orig+amt);
+        _scursor = _ssize;
+        _window  = _sbuffer;
     }
-    return data;
+    
+    std::string_view result = _window.substr(_bufoff);
+    _bufoff = (Sint32)_window.size();
+    return result;
 }
 
 /**
@@ -408,14 +544,14 @@ std::string& TextReader::readAll(std::string& data) {
  */
 void TextReader::skip() {
     CUAssertLog(ready(), "Attempt to read a finished stream");
-    if (_bufoff >= _sbuffer.size()) {
+    if (_bufoff >= _window.size()) {
         fill();
     }
     
     bool found = false;
-    while (isspace(_sbuffer[_bufoff]) && !found) {
+    while (!found && isspace(_window[_bufoff])) {
         _bufoff++;
-        if (_bufoff >= _sbuffer.size()) {
+        if (_bufoff >= _window.size()) {
             if (ready()) {
                 fill();
             } else {
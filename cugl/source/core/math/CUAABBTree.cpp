@@ -0,0 +1,492 @@
+//
+//  CUAABBTree.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides support for a dynamic bounding volume hierarchy. It
+//  is a binary tree of axis-aligned bounding boxes, and is intended for
+//  broad-phase queries such as view culling. Each leaf of the tree is a proxy
+//  for a user object, and the tree can be queried for all proxies whose
+//  bounds intersect a rectangle.
+//
+//  The design of this tree follows the dynamic tree in Box2D. Leaves are
+//  stored with "fat" bounds, so objects that move a small amount do not need
+//  to be reinserted. The tree is kept balanced with AVL-style rotations.
+//
+//  Because math objects are intended to be on the stack, we do not provide
+//  any shared pointer support in this class.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty. In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Author: Walker White
+//  Version: 7/3/24 (CUGL 3.0 reorganization)
+//
+#include <algorithm>
+#include <cugl/core/math/CUAABBTree.h>
+#include <cugl/core/util/CUDebug.h>
+
+using namespace cugl;
+
+/**
+ * Returns the smallest rectangle containing both rectangles
+ *
+ * @param a     The first rectangle
+ * @param b     The second rectangle
+ *
+ * @return the smallest rectangle containing both rectangles
+ */
+static Rect combine(const Rect& a, const Rect& b) {
+    float minX = std::min(a.origin.x, b.origin.x);
+    float minY = std::min(a.origin.y, b.origin.y);
+    float maxX = std::max(a.origin.x+a.size.width,  b.origin.x+b.size.width);
+    float maxY = std::max(a.origin.y+a.size.height, b.origin.y+b.size.height);
+    return Rect(minX, minY, maxX-minX, maxY-minY);
+}
+
+/**
+ * Returns the perimeter of the given rectangle
+ *
+ * This is the 2d analogue of the surface area heuristic.
+ *
+ * @param rect  The rectangle
+ *
+ * @return the perimeter of the given rectangle
+ */
+static float perimeter(const Rect& rect) {
+    return 2.0f*(rect.size.width+rect.size.height);
+}
+
+/**
+ * Returns true if the outer rectangle contains the inner one
+ *
+ * @param outer The containing rectangle
+ * @param inner The contained rectangle
+ *
+ * @return true if the outer rectangle contains the inner one
+ */
+static bool encloses(const Rect& outer, const Rect& inner) {
+    return (outer.origin.x <= inner.origin.x && outer.origin.y <= inner.origin.y &&
+            inner.origin.x+inner.size.width  <= outer.origin.x+outer.size.width &&
+            inner.origin.y+inner.size.height <= outer.origin.y+outer.size.height);
+}
+
+/**
+ * Returns true if the two rectangles overlap
+ *
+ * @param a     The first rectangle
+ * @param b     The second rectangle
+ *
+ * @return true if the two rectangles overlap
+ */
+static bool overlaps(const Rect& a, const Rect& b) {
+    return !(a.origin.x+a.size.width  < b.origin.x || b.origin.x+b.size.width  < a.origin.x ||
+             a.origin.y+a.size.height < b.origin.y || b.origin.y+b.size.height < a.origin.y);
+}
+
+#pragma mark -
+#pragma mark Constructors
+/**
+ * Creates an empty tree with the given margin.
+ *
+ * The margin is the amount each proxy is enlarged (on each side) when it
+ * is inserted into the tree. A larger margin means fewer reinsertions
+ * for moving objects, at the cost of less precise queries.
+ *
+ * @param margin    The amount to enlarge each proxy
+ */
+AABBTree::AABBTree(float margin) :
+_root(-1),
+_free(-1),
+_count(0),
+_margin(margin) {
+}
+
+/**
+ * Removes all proxies from this tree.
+ *
+ * All proxy identifiers are invalid after this call.
+ */
+void AABBTree::clear() {
+    _nodes.clear();
+    _root  = -1;
+    _free  = -1;
+    _count = 0;
+}
+
+#pragma mark -
+#pragma mark Proxies
+/**
+ * Returns a new proxy for the given bounds and user data.
+ *
+ * The bounds are enlarged by the margin of this tree. The user data is
+ * not retained, and it is the responsibility of the caller to remove the
+ * proxy before that data is deleted.
+ *
+ * @param bounds    The object bounds
+ * @param data      The user data
+ *
+ * @return a new proxy for the given bounds and user data.
+ */
+Sint32 AABBTree::insert(const Rect& bounds, void* data) {
+    Sint32 proxy = allocNode();
+    Node* node = &_nodes[proxy];
+    node->bounds.set(bounds.origin.x-_margin, bounds.origin.y-_margin,
+                     bounds.size.width+2*_margin, bounds.size.height+2*_margin);
+    node->data = data;
+    node->height = 0;
+    insertLeaf(proxy);
+    _count++;
+    return proxy;
+}
+
+/**
+ * Removes the given proxy from this tree.
+ *
+ * The proxy identifier may be recycled after this call.
+ *
+ * @param proxy     The proxy to remove
+ */
+void AABBTree::remove(Sint32 proxy) {
+    CUAssertLog(0 <= proxy && proxy < (Sint32)_nodes.size() && _nodes[proxy].isLeaf(),
+                "Proxy %d is not valid", proxy);
+    removeLeaf(proxy);
+    freeNode(proxy);
+    _count--;
+}
+
+/**
+ * Updates the bounds of the given proxy.
+ *
+ * The proxy is only reinserted if the new bounds are not contained in
+ * its enlarged bounds. This method returns true if the proxy was
+ * reinserted.
+ *
+ * @param proxy     The proxy to update
+ * @param bounds    The new object bounds
+ *
+ * @return true if the proxy was reinserted
+ */
+bool AABBTree::update(Sint32 proxy, const Rect& bounds) {
+    CUAssertLog(0 <= proxy && proxy < (Sint32)_nodes.size() && _nodes[proxy].isLeaf(),
+                "Proxy %d is not valid", proxy);
+    if (encloses(_nodes[proxy].bounds, bounds)) {
+        return false;
+    }
+
+    removeLeaf(proxy);
+    _nodes[proxy].bounds.set(bounds.origin.x-_margin, bounds.origin.y-_margin,
+                             bounds.size.width+2*_margin, bounds.size.height+2*_margin);
+    insertLeaf(proxy);
+    return true;
+}
+
+#pragma mark -
+#pragma mark Queries
+/**
+ * Appends the user data of every proxy intersecting the rectangle.
+ *
+ * The results are appended to the given vector, which is not cleared.
+ * They are in no particular order.
+ *
+ * @param rect      The query rectangle
+ * @param results   The vector to store the results
+ *
+ * @return the number of proxies found
+ */
+size_t AABBTree::query(const Rect& rect, std::vector<void*>& results) const {
+    if (_root == -1) {
+        return 0;
+    }
+
+    size_t found = 0;
+    _stack.clear();
+    _stack.push_back(_root);
+    while (!_stack.empty()) {
+        const Node& node = _nodes[_stack.back()];
+        _stack.pop_back();
+        if (overlaps(node.bounds, rect)) {
+            if (node.isLeaf()) {
+                results.push_back(node.data);
+                found++;
+            } else {
+                _stack.push_back(node.left);
+                _stack.push_back(node.right);
+            }
+        }
+    }
+    return found;
+}
+
+#pragma mark -
+#pragma mark Internal Helpers
+/**
+ * Returns a node from the pool, growing it if necessary.
+ *
+ * @return a node from the pool
+ */
+Sint32 AABBTree::allocNode() {
+    Sint32 result;
+    if (_free == -1) {
+        result = (Sint32)_nodes.size();
+        _nodes.emplace_back();
+    } else {
+        result = _free;
+        _free = _nodes[result].parent;
+    }
+
+    Node& node = _nodes[result];
+    node.data = nullptr;
+    node.parent = -1;
+    node.left   = -1;
+    node.right  = -1;
+    node.height = 0;
+    return result;
+}
+
+/**
+ * Returns the given node to the pool.
+ *
+ * @param node  The node to release
+ */
+void AABBTree::freeNode(Sint32 node) {
+    _nodes[node].data = nullptr;
+    _nodes[node].parent = _free;
+    _nodes[node].height = -1;
+    _free = node;
+}
+
+/**
+ * Inserts the given leaf node into the tree.
+ *
+ * The sibling is chosen with the surface area heuristic, which for 2d
+ * bounds means minimizing the total perimeter.
+ *
+ * @param leaf  The leaf to insert
+ */
+void AABBTree::insertLeaf(Sint32 leaf) {
+    if (_root == -1) {
+        _root = leaf;
+        _nodes[leaf].parent = -1;
+        return;
+    }
+
+    // Find the best sibling
+    Rect bounds = _nodes[leaf].bounds;
+    Sint32 index = _root;
+    while (!_nodes[index].isLeaf()) {
+        const Node& node = _nodes[index];
+        float area = perimeter(node.bounds);
+        float combined = perimeter(combine(node.bounds,bounds));
+
+        // Cost of creating a new parent for this node and the leaf
+        float cost = 2.0f*combined;
+
+        // Minimum cost of pushing the leaf further down the tree
+        float inherit = 2.0f*(combined-area);
+
+        const Node& left  = _nodes[node.left];
+        const Node& right = _nodes[node.right];
+        float costL = perimeter(combine(left.bounds,bounds))+inherit;
+        float costR = perimeter(combine(right.bounds,bounds))+inherit;
+        if (!left.isLeaf()) {
+            costL -= perimeter(left.bounds);
+        }
+        if (!right.isLeaf()) {
+            costR -= perimeter(right.bounds);
+        }
+
+        if (cost < costL && cost < costR) {
+            break;
+        }
+        index = (costL < costR ? node.left : node.right);
+    }
+
+    // Create a new parent (this may reallocate the pool)
+    Sint32 sibling = index;
+    Sint32 oldParent = _nodes[sibling].parent;
+    Sint32 newParent = allocNode();
+
+    Node& parent = _nodes[newParent];
+    parent.parent = oldParent;
+    parent.bounds = combine(bounds,_nodes[sibling].bounds);
+    parent.height = _nodes[sibling].height+1;
+    parent.left  = sibling;
+    parent.right = leaf;
+    _nodes[sibling].parent = newParent;
+    _nodes[leaf].parent = newParent;
+
+    if (oldParent == -1) {
+        _root = newParent;
+    } else if (_nodes[oldParent].left == sibling) {
+        _nodes[oldParent].left = newParent;
+    } else {
+        _nodes[oldParent].right = newParent;
+    }
+
+    refit(_nodes[leaf].parent);
+}
+
+/**
+ * Removes the given leaf node from the tree.
+ *
+ * The node is not returned to the pool.
+ *
+ * @param leaf  The leaf to remove
+ */
+void AABBTree::removeLeaf(Sint32 leaf) {
+    if (leaf == _root) {
+        _root = -1;
+        return;
+    }
+
+    Sint32 parent = _nodes[leaf].parent;
+    Sint32 grandParent = _nodes[parent].parent;
+    Sint32 sibling = (_nodes[parent].left == leaf ? _nodes[parent].right : _nodes[parent].left);
+
+    if (grandParent == -1) {
+        _root = sibling;
+        _nodes[sibling].parent = -1;
+        freeNode(parent);
+    } else {
+        if (_nodes[grandParent].left == parent) {
+            _nodes[grandParent].left = sibling;
+        } else {
+            _nodes[grandParent].right = sibling;
+        }
+        _nodes[sibling].parent = grandParent;
+        freeNode(parent);
+        refit(grandParent);
+    }
+    _nodes[leaf].parent = -1;
+}
+
+/**
+ * Refits the bounds and heights from the given node to the root.
+ *
+ * This method rebalances the tree along the way.
+ *
+ * @param node  The node to start from
+ */
+void AABBTree::refit(Sint32 node) {
+    while (node != -1) {
+        node = balance(node);
+
+        Node& current = _nodes[node];
+        const Node& left  = _nodes[current.left];
+        const Node& right = _nodes[current.right];
+        current.height = 1+std::max(left.height,right.height);
+        current.bounds = combine(left.bounds,right.bounds);
+        node = current.parent;
+    }
+}
+
+/**
+ * Performs a left or right rotation if the given node is imbalanced.
+ *
+ * @param iA    The node to balance
+ *
+ * @return the new root of the subtree
+ */
+Sint32 AABBTree::balance(Sint32 iA) {
+    Node& A = _nodes[iA];
+    if (A.isLeaf() || A.height < 2) {
+        return iA;
+    }
+
+    Sint32 iB = A.left;
+    Sint32 iC = A.right;
+    Node& B = _nodes[iB];
+    Node& C = _nodes[iC];
+
+    Sint32 skew = C.height-B.height;
+    if (skew > 1) {
+        // Rotate C up
+        Sint32 iF = C.left;
+        Sint32 iG = C.right;
+        Node& F = _nodes[iF];
+        Node& G = _nodes[iG];
+
+        C.left = iA;
+        C.parent = A.parent;
+        A.parent = iC;
+        if (C.parent == -1) {
+            _root = iC;
+        } else if (_nodes[C.parent].left == iA) {
+            _nodes[C.parent].left = iC;
+        } else {
+            _nodes[C.parent].right = iC;
+        }
+
+        if (F.height > G.height) {
+            C.right = iF;
+            A.right = iG;
+            G.parent = iA;
+            A.bounds = combine(B.bounds,G.bounds);
+            C.bounds = combine(A.bounds,F.bounds);
+            A.height = 1+std::max(B.height,G.height);
+            C.height = 1+std::max(A.height,F.height);
+        } else {
+            C.right = iG;
+            A.right = iF;
+            F.parent = iA;
+            A.bounds = combine(B.bounds,F.bounds);
+            C.bounds = combine(A.bounds,G.bounds);
+            A.height = 1+std::max(B.height,F.height);
+            C.height = 1+std::max(A.height,G.height);
+        }
+        return iC;
+    } else if (skew < -1) {
+        // Rotate B up
+        Sint32 iD = B.left;
+        Sint32 iE = B.right;
+        Node& D = _nodes[iD];
+        Node& E = _nodes[iE];
+
+        B.left = iA;
+        B.parent = A.parent;
+        A.parent = iB;
+        if (B.parent == -1) {
+            _root = iB;
+        } else if (_nodes[B.parent].left == iA) {
+            _nodes[B.parent].left = iB;
+        } else {
+            _nodes[B.parent].right = iB;
+        }
+
+        if (D.height > E.height) {
+            B.right = iD;
+            A.left = iE;
+            E.parent = iA;
+            A.bounds = combine(C.bounds,E.bounds);
+            B.bounds = combine(A.bounds,D.bounds);
+            A.height = 1+std::max(C.height,E.height);
+            B.height = 1+std::max(A.height,D.height);
+        } else {
+            B.right = iE;
+            A.left = iD;
+            D.parent = iA;
+            A.bounds = combine(C.bounds,D.bounds);
+            B.bounds = combine(A.bounds,E.bounds);
+            A.height = 1+std::max(C.height,D.height);
+            B.height = 1+std::max(A.height,E.height);
+        }
+        return iB;
+    }
+    return iA;
+}
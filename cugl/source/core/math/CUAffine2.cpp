@@ -947,23 +947,200 @@ Vec2* Affine2::transform(const Affine2& aff, const Vec2 point, Vec2* dst) {
  * The vector is array is treated as a list of 2 element vectors (@see Vec2).
  * The transform is applied in order and written to the output array.
  *
+ * The strides are the distance (in floats) between the start of each
+ * vector. The default stride of 2 is a tightly packed array. A larger
+ * stride allows this method to transform the positions of an array of
+ * vertices (e.g. {@link graphics::SpriteVertex}) in place.
+ *
+ * This method uses SSE, AVX2, or NEON instructions where available. The
+ * input and output may be the same array, but they should not otherwise
+ * overlap.
+ *
  * @param aff       The transform matrix.
  * @param input     The array of vectors to transform.
  * @param output    The array to store the transformed vectors.
- * @param size      The size of the two arrays.
+ * @param size      The number of vectors to transform.
+ * @param istride   The stride of the input array
+ * @param ostride   The stride of the output array
  *
  * @return A reference to dst for chaining
  */
-float* Affine2::transform(const Affine2& aff, float const* input, float* output, size_t size) {
-    for(size_t ii = 0; ii < size; ii++) {
-        float x = aff.m[0]*input[2*ii]+aff.m[2]*input[2*ii+1]+aff.m[4];
-        float y = aff.m[1]*input[2*ii]+aff.m[3]*input[2*ii+1]+aff.m[5];
-        output[2*ii  ] = x;
-        output[2*ii+1] = y;
+float* Affine2::transform(const Affine2& aff, float const* input, float* output, size_t size,
+                          size_t istride, size_t ostride) {
+    const float* m = aff.m;
+    size_t ii = 0;
+    bool packed = (istride == 2 && ostride == 2);
+#if defined CU_MATH_VECTOR_AVX2
+    if (packed) {
+        // Four interleaved points per register
+        __m256 ma = _mm256_setr_ps(m[0],m[1],m[0],m[1],m[0],m[1],m[0],m[1]);
+        __m256 mb = _mm256_setr_ps(m[2],m[3],m[2],m[3],m[2],m[3],m[2],m[3]);
+        __m256 mt = _mm256_setr_ps(m[4],m[5],m[4],m[5],m[4],m[5],m[4],m[5]);
+        for(; ii+4 <= size; ii += 4) {
+            __m256 p  = _mm256_loadu_ps(input+2*ii);
+            __m256 xx = _mm256_moveldup_ps(p);
+            __m256 yy = _mm256_movehdup_ps(p);
+            _mm256_storeu_ps(output+2*ii, _mm256_fmadd_ps(xx,ma,_mm256_fmadd_ps(yy,mb,mt)));
+        }
+    }
+#endif
+#if defined CU_MATH_VECTOR_SSE
+    // Two interleaved points per register
+    __m128 ma = _mm_setr_ps(m[0],m[1],m[0],m[1]);
+    __m128 mb = _mm_setr_ps(m[2],m[3],m[2],m[3]);
+    __m128 mt = _mm_setr_ps(m[4],m[5],m[4],m[5]);
+    if (packed) {
+        for(; ii+2 <= size; ii += 2) {
+            __m128 p  = _mm_loadu_ps(input+2*ii);
+            __m128 xx = _mm_shuffle_ps(p,p,_MM_SHUFFLE(2,2,0,0));
+            __m128 yy = _mm_shuffle_ps(p,p,_MM_SHUFFLE(3,3,1,1));
+            p = _mm_add_ps(_mm_add_ps(_mm_mul_ps(xx,ma),_mm_mul_ps(yy,mb)),mt);
+            _mm_storeu_ps(output+2*ii, p);
+        }
+    } else {
+        for(; ii+2 <= size; ii += 2) {
+            const float* src = input+ii*istride;
+            float* dst = output+ii*ostride;
+            __m128 p  = _mm_loadl_pi(_mm_setzero_ps(),(const __m64*)src);
+            p = _mm_loadh_pi(p,(const __m64*)(src+istride));
+            __m128 xx = _mm_shuffle_ps(p,p,_MM_SHUFFLE(2,2,0,0));
+            __m128 yy = _mm_shuffle_ps(p,p,_MM_SHUFFLE(3,3,1,1));
+            p = _mm_add_ps(_mm_add_ps(_mm_mul_ps(xx,ma),_mm_mul_ps(yy,mb)),mt);
+            _mm_storel_pi((__m64*)dst,p);
+            _mm_storeh_pi((__m64*)(dst+ostride),p);
+        }
+    }
+#elif defined CU_MATH_VECTOR_NEON64
+    if (packed) {
+        // Deinterleave four points at a time
+        float32x4_t tx = vdupq_n_f32(m[4]);
+        float32x4_t ty = vdupq_n_f32(m[5]);
+        for(; ii+4 <= size; ii += 4) {
+            float32x4x2_t p = vld2q_f32(input+2*ii);
+            float32x4x2_t r;
+            r.val[0] = vfmaq_n_f32(vfmaq_n_f32(tx,p.val[0],m[0]),p.val[1],m[2]);
+            r.val[1] = vfmaq_n_f32(vfmaq_n_f32(ty,p.val[0],m[1]),p.val[1],m[3]);
+            vst2q_f32(output+2*ii, r);
+        }
+    } else {
+        float32x4_t ma = {m[0],m[1],m[0],m[1]};
+        float32x4_t mb = {m[2],m[3],m[2],m[3]};
+        float32x4_t mt = {m[4],m[5],m[4],m[5]};
+        for(; ii+2 <= size; ii += 2) {
+            const float* src = input+ii*istride;
+            float* dst = output+ii*ostride;
+            float32x4_t p  = vcombine_f32(vld1_f32(src),vld1_f32(src+istride));
+            float32x4_t xx = vtrn1q_f32(p,p);
+            float32x4_t yy = vtrn2q_f32(p,p);
+            p = vfmaq_f32(vfmaq_f32(mt,xx,ma),yy,mb);
+            vst1_f32(dst,vget_low_f32(p));
+            vst1_f32(dst+ostride,vget_high_f32(p));
+        }
+    }
+#endif
+    for(; ii < size; ii++) {
+        const float* src = input+ii*istride;
+        float* dst = output+ii*ostride;
+        float x = m[0]*src[0]+m[2]*src[1]+m[4];
+        float y = m[1]*src[0]+m[3]*src[1]+m[5];
+        dst[0] = x;
+        dst[1] = y;
     }
     return output;
 }
 
+/**
+ * Transforms the vector array, and stores the result in dst.
+ *
+ * The transform is applied in order and written to the output array.
+ * This method uses SSE, AVX2, or NEON instructions where available. The
+ * input and output may be the same array, but they should not otherwise
+ * overlap.
+ *
+ * @param aff       The transform matrix.
+ * @param input     The array of vectors to transform.
+ * @param output    The array to store the transformed vectors.
+ * @param size      The size of the two arrays.
+ *
+ * @return A reference to dst for chaining
+ */
+Vec2* Affine2::transform(const Affine2& aff, const Vec2* input, Vec2* output, size_t size) {
+    transform(aff, reinterpret_cast<const float*>(input), reinterpret_cast<float*>(output), size);
+    return output;
+}
+
+/**
+ * Transforms the vectors given as separate coordinate arrays.
+ *
+ * This is the structure-of-arrays version of {@link #transform}. The
+ * x-coordinates and y-coordinates are stored in separate arrays, which
+ * is the fastest layout for vectorized code. The transformed values are
+ * written to xout and yout. This method uses SSE, AVX2, or NEON
+ * instructions where available. The output arrays may be the same as
+ * the input arrays, but they should not otherwise overlap.
+ *
+ * @param aff   The transform matrix.
+ * @param xin   The x-coordinates to transform.
+ * @param yin   The y-coordinates to transform.
+ * @param xout  The array to store the transformed x-coordinates.
+ * @param yout  The array to store the transformed y-coordinates.
+ * @param size  The size of the four arrays.
+ */
+void Affine2::transform(const Affine2& aff, const float* xin, const float* yin,
+                        float* xout, float* yout, size_t size) {
+    const float* m = aff.m;
+    size_t ii = 0;
+#if defined CU_MATH_VECTOR_AVX2
+    {
+        __m256 m0 = _mm256_set1_ps(m[0]);
+        __m256 m1 = _mm256_set1_ps(m[1]);
+        __m256 m2 = _mm256_set1_ps(m[2]);
+        __m256 m3 = _mm256_set1_ps(m[3]);
+        __m256 m4 = _mm256_set1_ps(m[4]);
+        __m256 m5 = _mm256_set1_ps(m[5]);
+        for(; ii+8 <= size; ii += 8) {
+            __m256 x = _mm256_loadu_ps(xin+ii);
+            __m256 y = _mm256_loadu_ps(yin+ii);
+            _mm256_storeu_ps(xout+ii, _mm256_fmadd_ps(x,m0,_mm256_fmadd_ps(y,m2,m4)));
+            _mm256_storeu_ps(yout+ii, _mm256_fmadd_ps(x,m1,_mm256_fmadd_ps(y,m3,m5)));
+        }
+    }
+#endif
+#if defined CU_MATH_VECTOR_SSE
+    __m128 m0 = _mm_set1_ps(m[0]);
+    __m128 m1 = _mm_set1_ps(m[1]);
+    __m128 m2 = _mm_set1_ps(m[2]);
+    __m128 m3 = _mm_set1_ps(m[3]);
+    __m128 m4 = _mm_set1_ps(m[4]);
+    __m128 m5 = _mm_set1_ps(m[5]);
+    for(; ii+4 <= size; ii += 4) {
+        __m128 x = _mm_loadu_ps(xin+ii);
+        __m128 y = _mm_loadu_ps(yin+ii);
+        __m128 rx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x,m0),_mm_mul_ps(y,m2)),m4);
+        __m128 ry = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x,m1),_mm_mul_ps(y,m3)),m5);
+        _mm_storeu_ps(xout+ii, rx);
+        _mm_storeu_ps(yout+ii, ry);
+    }
+#elif defined CU_MATH_VECTOR_NEON64
+    float32x4_t tx = vdupq_n_f32(m[4]);
+    float32x4_t ty = vdupq_n_f32(m[5]);
+    for(; ii+4 <= size; ii += 4) {
+        float32x4_t x = vld1q_f32(xin+ii);
+        float32x4_t y = vld1q_f32(yin+ii);
+        float32x4_t rx = vfmaq_n_f32(vfmaq_n_f32(tx,x,m[0]),y,m[2]);
+        float32x4_t ry = vfmaq_n_f32(vfmaq_n_f32(ty,x,m[1]),y,m[3]);
+        vst1q_f32(xout+ii, rx);
+        vst1q_f32(yout+ii, ry);
+    }
+#endif
+    for(; ii < size; ii++) {
+        float x = m[0]*xin[ii]+m[2]*yin[ii]+m[4];
+        float y = m[1]*xin[ii]+m[3]*yin[ii]+m[5];
+        xout[ii] = x;
+        yout[ii] = y;
+    }
+}
+
 /**
  * Transforms the rectangle and stores the result in dst.
  *
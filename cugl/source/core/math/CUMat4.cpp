@@ -1197,6 +1197,8 @@ float* Mat4::multiply(const float* mat, float scalar, float* dst) {
  * The matrix m2 is on the right.  This means that it corresponds to
  * an subsequent transform, when looking at a sequence of transforms.
  *
+ * This method uses SSE or NEON instructions where available.
+ *
  * @param m1    The first matrix to multiply.
  * @param m2    The second matrix to multiply.
  * @param dst   A matrix to store the result in.
@@ -1204,28 +1206,7 @@ float* Mat4::multiply(const float* mat, float scalar, float* dst) {
  * @return A reference to dst for chaining
  */
 Mat4* Mat4::multiply(const Mat4& m1, const Mat4& m2, Mat4* dst) {
-    float product[16];
-    product[0]  = m2.m[0] * m1.m[0]  + m2.m[4] * m1.m[1] + m2.m[8]   * m1.m[2]  + m2.m[12] * m1.m[3];
-    product[1]  = m2.m[1] * m1.m[0]  + m2.m[5] * m1.m[1] + m2.m[9]   * m1.m[2]  + m2.m[13] * m1.m[3];
-    product[2]  = m2.m[2] * m1.m[0]  + m2.m[6] * m1.m[1] + m2.m[10]  * m1.m[2]  + m2.m[14] * m1.m[3];
-    product[3]  = m2.m[3] * m1.m[0]  + m2.m[7] * m1.m[1] + m2.m[11]  * m1.m[2]  + m2.m[15] * m1.m[3];
-    
-    product[4]  = m2.m[0] * m1.m[4]  + m2.m[4] * m1.m[5] + m2.m[8]   * m1.m[6]  + m2.m[12] * m1.m[7];
-    product[5]  = m2.m[1] * m1.m[4]  + m2.m[5] * m1.m[5] + m2.m[9]   * m1.m[6]  + m2.m[13] * m1.m[7];
-    product[6]  = m2.m[2] * m1.m[4]  + m2.m[6] * m1.m[5] + m2.m[10]  * m1.m[6]  + m2.m[14] * m1.m[7];
-    product[7]  = m2.m[3] * m1.m[4]  + m2.m[7] * m1.m[5] + m2.m[11]  * m1.m[6]  + m2.m[15] * m1.m[7];
-    
-    product[8]  = m2.m[0] * m1.m[8]  + m2.m[4] * m1.m[9] + m2.m[8]   * m1.m[10] + m2.m[12] * m1.m[11];
-    product[9]  = m2.m[1] * m1.m[8]  + m2.m[5] * m1.m[9] + m2.m[9]   * m1.m[10] + m2.m[13] * m1.m[11];
-    product[10] = m2.m[2] * m1.m[8]  + m2.m[6] * m1.m[9] + m2.m[10]  * m1.m[10] + m2.m[14] * m1.m[11];
-    product[11] = m2.m[3] * m1.m[8]  + m2.m[7] * m1.m[9] + m2.m[11]  * m1.m[10] + m2.m[15] * m1.m[11];
-    
-    product[12] = m2.m[0] * m1.m[12] + m2.m[4] * m1.m[13] + m2.m[8]  * m1.m[14] + m2.m[12] * m1.m[15];
-    product[13] = m2.m[1] * m1.m[12] + m2.m[5] * m1.m[13] + m2.m[9]  * m1.m[14] + m2.m[13] * m1.m[15];
-    product[14] = m2.m[2] * m1.m[12] + m2.m[6] * m1.m[13] + m2.m[10] * m1.m[14] + m2.m[14] * m1.m[15];
-    product[15] = m2.m[3] * m1.m[12] + m2.m[7] * m1.m[13] + m2.m[11] * m1.m[14] + m2.m[15] * m1.m[15];
-    
-    std::memcpy(&(dst->m[0]), &(product[0]), MATRIX_SIZE);
+    multiply(m1.m, m2.m, dst->m);
     return dst;
 }
 
@@ -1235,6 +1216,8 @@ Mat4* Mat4::multiply(const Mat4& m1, const Mat4& m2, Mat4* dst) {
  * The matrix m2 is on the right.  This means that it corresponds to
  * an subsequent transform, when looking at a sequence of transforms.
  *
+ * This method uses SSE or NEON instructions where available.
+ *
  * This method assumes the float arrays are in column major order.
  *
  * @param m1    The first matrix to multiply in column-major order
@@ -1244,6 +1227,45 @@ Mat4* Mat4::multiply(const Mat4& m1, const Mat4& m2, Mat4* dst) {
  * @return A reference to dst for chaining
  */
 float* Mat4::multiply(const float* m1, const float* m2, float* dst) {
+#if defined CU_MATH_VECTOR_SSE
+    // Each column of the product is a combination of the columns of m2
+    __m128 c0 = _mm_loadu_ps(m2);
+    __m128 c1 = _mm_loadu_ps(m2+4);
+    __m128 c2 = _mm_loadu_ps(m2+8);
+    __m128 c3 = _mm_loadu_ps(m2+12);
+    __m128 r0 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0,_mm_set1_ps(m1[0])), _mm_mul_ps(c1,_mm_set1_ps(m1[1]))),
+                           _mm_add_ps(_mm_mul_ps(c2,_mm_set1_ps(m1[2])), _mm_mul_ps(c3,_mm_set1_ps(m1[3]))));
+    __m128 r1 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0,_mm_set1_ps(m1[4])), _mm_mul_ps(c1,_mm_set1_ps(m1[5]))),
+                           _mm_add_ps(_mm_mul_ps(c2,_mm_set1_ps(m1[6])), _mm_mul_ps(c3,_mm_set1_ps(m1[7]))));
+    __m128 r2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0,_mm_set1_ps(m1[8])), _mm_mul_ps(c1,_mm_set1_ps(m1[9]))),
+                           _mm_add_ps(_mm_mul_ps(c2,_mm_set1_ps(m1[10])),_mm_mul_ps(c3,_mm_set1_ps(m1[11]))));
+    __m128 r3 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0,_mm_set1_ps(m1[12])),_mm_mul_ps(c1,_mm_set1_ps(m1[13]))),
+                           _mm_add_ps(_mm_mul_ps(c2,_mm_set1_ps(m1[14])),_mm_mul_ps(c3,_mm_set1_ps(m1[15]))));
+    // Support the case where dst is m1 or m2.
+    _mm_storeu_ps(dst,   r0);
+    _mm_storeu_ps(dst+4, r1);
+    _mm_storeu_ps(dst+8, r2);
+    _mm_storeu_ps(dst+12,r3);
+#elif defined CU_MATH_VECTOR_NEON64
+    // Each column of the product is a combination of the columns of m2
+    float32x4_t c0 = vld1q_f32(m2);
+    float32x4_t c1 = vld1q_f32(m2+4);
+    float32x4_t c2 = vld1q_f32(m2+8);
+    float32x4_t c3 = vld1q_f32(m2+12);
+    float32x4_t a0 = vld1q_f32(m1);
+    float32x4_t a1 = vld1q_f32(m1+4);
+    float32x4_t a2 = vld1q_f32(m1+8);
+    float32x4_t a3 = vld1q_f32(m1+12);
+    float32x4_t r0 = vfmaq_laneq_f32(vfmaq_laneq_f32(vfmaq_laneq_f32(vmulq_laneq_f32(c0,a0,0),c1,a0,1),c2,a0,2),c3,a0,3);
+    float32x4_t r1 = vfmaq_laneq_f32(vfmaq_laneq_f32(vfmaq_laneq_f32(vmulq_laneq_f32(c0,a1,0),c1,a1,1),c2,a1,2),c3,a1,3);
+    float32x4_t r2 = vfmaq_laneq_f32(vfmaq_laneq_f32(vfmaq_laneq_f32(vmulq_laneq_f32(c0,a2,0),c1,a2,1),c2,a2,2),c3,a2,3);
+    float32x4_t r3 = vfmaq_laneq_f32(vfmaq_laneq_f32(vfmaq_laneq_f32(vmulq_laneq_f32(c0,a3,0),c1,a3,1),c2,a3,2),c3,a3,3);
+    // Support the case where dst is m1 or m2.
+    vst1q_f32(dst,   r0);
+    vst1q_f32(dst+4, r1);
+    vst1q_f32(dst+8, r2);
+    vst1q_f32(dst+12,r3);
+#else
     float product[16];
     product[0]  = m2[0] * m1[0]  + m2[4] * m1[1] + m2[8]   * m1[2]  + m2[12] * m1[3];
     product[1]  = m2[1] * m1[0]  + m2[5] * m1[1] + m2[9]   * m1[2]  + m2[13] * m1[3];
@@ -1266,6 +1288,7 @@ float* Mat4::multiply(const float* m1, const float* m2, float* dst) {
     product[15] = m2[3] * m1[12] + m2[7] * m1[13] + m2[11] * m1[14] + m2[15] * m1[15];
     
     std::memcpy(dst, &(product[0]), MATRIX_SIZE);
+#endif
     return dst;
 }
 
@@ -1358,7 +1381,7 @@ float* Mat4::transpose(const float* m1, float* dst) {
  * Inverts m1 and stores the result in dst.
  *
  * If the matrix cannot be inverted, this method stores the zero matrix
- * in dst.
+ * in dst. This method uses SSE or NEON instructions where available.
  *
  * @param m1    The matrix to negate.
  * @param dst   A matrix to store the result in.
@@ -1366,52 +1389,7 @@ float* Mat4::transpose(const float* m1, float* dst) {
  * @return A reference to dst for chaining
  */
 Mat4* Mat4::invert(const Mat4& m1, Mat4* dst) {
-    float a0 = m1.m[0]  * m1.m[5] -  m1.m[1]  * m1.m[4];
-    float a1 = m1.m[0]  * m1.m[6] -  m1.m[2]  * m1.m[4];
-    float a2 = m1.m[0]  * m1.m[7] -  m1.m[3]  * m1.m[4];
-    float a3 = m1.m[1]  * m1.m[6] -  m1.m[2]  * m1.m[5];
-    float a4 = m1.m[1]  * m1.m[7] -  m1.m[3]  * m1.m[5];
-    float a5 = m1.m[2]  * m1.m[7] -  m1.m[3]  * m1.m[6];
-    float b0 = m1.m[8]  * m1.m[13] - m1.m[9]  * m1.m[12];
-    float b1 = m1.m[8]  * m1.m[14] - m1.m[10] * m1.m[12];
-    float b2 = m1.m[8]  * m1.m[15] - m1.m[11] * m1.m[12];
-    float b3 = m1.m[9]  * m1.m[14] - m1.m[10] * m1.m[13];
-    float b4 = m1.m[9]  * m1.m[15] - m1.m[11] * m1.m[13];
-    float b5 = m1.m[10] * m1.m[15] - m1.m[11] * m1.m[14];
-    
-    // Calculate the determinant.
-    float det = a0 * b5 - a1 * b4 + a2 * b3 + a3 * b2 - a4 * b1 + a5 * b0;
-    
-    // Close to zero, can't invert.
-    if (fabs(det) <= CU_MATH_FLOAT_SMALL) {
-        dst->setZero();
-        return dst;
-    }
-    
-    // Support the case where m1 == dst.
-    Mat4 inverse;
-    inverse.m[0]  =  m1.m[5]  * b5 - m1.m[6]  * b4 + m1.m[7]  * b3;
-    inverse.m[1]  = -m1.m[1]  * b5 + m1.m[2]  * b4 - m1.m[3]  * b3;
-    inverse.m[2]  =  m1.m[13] * a5 - m1.m[14] * a4 + m1.m[15] * a3;
-    inverse.m[3]  = -m1.m[9]  * a5 + m1.m[10] * a4 - m1.m[11] * a3;
-    
-    inverse.m[4]  = -m1.m[4]  * b5 + m1.m[6]  * b2 - m1.m[7]  * b1;
-    inverse.m[5]  =  m1.m[0]  * b5 - m1.m[2]  * b2 + m1.m[3]  * b1;
-    inverse.m[6]  = -m1.m[12] * a5 + m1.m[14] * a2 - m1.m[15] * a1;
-    inverse.m[7]  =  m1.m[8]  * a5 - m1.m[10] * a2 + m1.m[11] * a1;
-    
-    inverse.m[8]  =  m1.m[4]  * b4 - m1.m[5]  * b2 + m1.m[7]  * b0;
-    inverse.m[9]  = -m1.m[0]  * b4 + m1.m[1]  * b2 - m1.m[3]  * b0;
-    inverse.m[10] =  m1.m[12] * a4 - m1.m[13] * a2 + m1.m[15] * a0;
-    inverse.m[11] = -m1.m[8]  * a4 + m1.m[9]  * a2 - m1.m[11] * a0;
-    
-    inverse.m[12] = -m1.m[4]  * b3 + m1.m[5]  * b1 - m1.m[6]  * b0;
-    inverse.m[13] =  m1.m[0]  * b3 - m1.m[1]  * b1 + m1.m[2]  * b0;
-    inverse.m[14] = -m1.m[12] * a3 + m1.m[13] * a1 - m1.m[14] * a0;
-    inverse.m[15] =  m1.m[8]  * a3 - m1.m[9]  * a1 + m1.m[10] * a0;
-    
-    multiply(inverse, 1.0f / det, dst);
-
+    invert(m1.m, dst->m);
     return dst;
 }
 
@@ -1419,7 +1397,7 @@ Mat4* Mat4::invert(const Mat4& m1, Mat4* dst) {
  * Inverts m1 and stores the result in dst.
  *
  * If the matrix cannot be inverted, this method stores the zero matrix
- * in dst.
+ * in dst. This method uses SSE or NEON instructions where available.
  *
  * This method assumes the float arrays are in column major order.
  *
@@ -1451,6 +1429,57 @@ float* Mat4::invert(const float* m1, float* dst) {
         return dst;
     }
     
+#if defined CU_MATH_VECTOR_SSE
+    // Each column of the adjugate combines these four vectors with the
+    // 2x2 determinants (the b terms on top, the a terms on bottom)
+    __m128 ra = _mm_setr_ps( m1[5],  -m1[1],  m1[13], -m1[9]  );
+    __m128 rb = _mm_setr_ps( m1[6],  -m1[2],  m1[14], -m1[10] );
+    __m128 rc = _mm_setr_ps( m1[7],  -m1[3],  m1[15], -m1[11] );
+    __m128 rd = _mm_setr_ps(-m1[4],   m1[0], -m1[12],  m1[8]  );
+    __m128 k0 = _mm_setr_ps(b0,b0,a0,a0);
+    __m128 k1 = _mm_setr_ps(b1,b1,a1,a1);
+    __m128 k2 = _mm_setr_ps(b2,b2,a2,a2);
+    __m128 k3 = _mm_setr_ps(b3,b3,a3,a3);
+    __m128 k4 = _mm_setr_ps(b4,b4,a4,a4);
+    __m128 k5 = _mm_setr_ps(b5,b5,a5,a5);
+    __m128 scale = _mm_set1_ps(1.0f / det);
+    
+    __m128 col0 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(ra,k5),_mm_mul_ps(rb,k4)),_mm_mul_ps(rc,k3));
+    __m128 col1 = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(rd,k5),_mm_mul_ps(rb,k2)),_mm_mul_ps(rc,k1));
+    __m128 col2 = _mm_sub_ps(_mm_mul_ps(rc,k0),_mm_add_ps(_mm_mul_ps(rd,k4),_mm_mul_ps(ra,k2)));
+    __m128 col3 = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(rd,k3),_mm_mul_ps(ra,k1)),_mm_mul_ps(rb,k0));
+    
+    // Support the case where m1 == dst.
+    _mm_storeu_ps(dst,   _mm_mul_ps(col0,scale));
+    _mm_storeu_ps(dst+4, _mm_mul_ps(col1,scale));
+    _mm_storeu_ps(dst+8, _mm_mul_ps(col2,scale));
+    _mm_storeu_ps(dst+12,_mm_mul_ps(col3,scale));
+#elif defined CU_MATH_VECTOR_NEON64
+    // Each column of the adjugate combines these four vectors with the
+    // 2x2 determinants (the b terms on top, the a terms on bottom)
+    float32x4_t ra = {  m1[5],  -m1[1],  m1[13], -m1[9]  };
+    float32x4_t rb = {  m1[6],  -m1[2],  m1[14], -m1[10] };
+    float32x4_t rc = {  m1[7],  -m1[3],  m1[15], -m1[11] };
+    float32x4_t rd = { -m1[4],   m1[0], -m1[12],  m1[8]  };
+    float32x4_t k0 = { b0, b0, a0, a0 };
+    float32x4_t k1 = { b1, b1, a1, a1 };
+    float32x4_t k2 = { b2, b2, a2, a2 };
+    float32x4_t k3 = { b3, b3, a3, a3 };
+    float32x4_t k4 = { b4, b4, a4, a4 };
+    float32x4_t k5 = { b5, b5, a5, a5 };
+    float scale = 1.0f / det;
+    
+    float32x4_t col0 = vfmaq_f32(vfmsq_f32(vmulq_f32(ra,k5),rb,k4),rc,k3);
+    float32x4_t col1 = vfmsq_f32(vfmaq_f32(vmulq_f32(rd,k5),rb,k2),rc,k1);
+    float32x4_t col2 = vfmsq_f32(vfmsq_f32(vmulq_f32(rc,k0),rd,k4),ra,k2);
+    float32x4_t col3 = vfmsq_f32(vfmaq_f32(vmulq_f32(rd,k3),ra,k1),rb,k0);
+    
+    // Support the case where m1 == dst.
+    vst1q_f32(dst,   vmulq_n_f32(col0,scale));
+    vst1q_f32(dst+4, vmulq_n_f32(col1,scale));
+    vst1q_f32(dst+8, vmulq_n_f32(col2,scale));
+    vst1q_f32(dst+12,vmulq_n_f32(col3,scale));
+#else
     // Support the case where m1 == dst.
     float inverse[16];
     inverse[0]  =  m1[5]  * b5 - m1[6]  * b4 + m1[7]  * b3;
@@ -1474,6 +1503,7 @@ float* Mat4::invert(const float* m1, float* dst) {
     inverse[15] =  m1[8]  * a3 - m1[9]  * a1 + m1[10] * a0;
     
     multiply(inverse, 1.0f / det, dst);
+#endif
     return dst;
 }
 
@@ -1762,6 +1792,10 @@ Vec4* Mat4::transform(const Mat4& mat, const Vec4 vec, Vec4* dst) {
  * The vector is array is treated as a list of 4 element vectors (@see Vec4).
  * The transform is applied in order and written to the output array.
  *
+ * This method uses SSE, AVX2, or NEON instructions where available. The
+ * input and output may be the same array, but they should not otherwise
+ * overlap.
+ *
  * @param mat       The transform matrix.
  * @param input     The array of vectors to transform.
  * @param output    The array to store the transformed vectors.
@@ -1770,21 +1804,7 @@ Vec4* Mat4::transform(const Mat4& mat, const Vec4 vec, Vec4* dst) {
  * @return A reference to dst for chaining
  */
 float* Mat4::transform(const Mat4& mat, float const* input, float* output, size_t size) {
-    CUAssertLog(output, "Destination vector is null");
-    for(size_t ii = 0; ii < size; ii++) {
-        // Handle case where v == dst.
-        float x = input[ii*4] * mat.m[0] + input[ii*4+1] * mat.m[4] + input[ii*4+2] * mat.m[8]  + input[ii*4+3] * mat.m[12];
-        float y = input[ii*4] * mat.m[1] + input[ii*4+1] * mat.m[5] + input[ii*4+2] * mat.m[9]  + input[ii*4+3] * mat.m[13];
-        float z = input[ii*4] * mat.m[2] + input[ii*4+1] * mat.m[6] + input[ii*4+2] * mat.m[10] + input[ii*4+3] * mat.m[14];
-        float w = input[ii*4] * mat.m[3] + input[ii*4+1] * mat.m[7] + input[ii*4+2] * mat.m[11] + input[ii*4+3] * mat.m[15];
-        
-        output[ii*4  ] = x;
-        output[ii*4+1] = y;
-        output[ii*4+2] = z;
-        output[ii*4+3] = w;
-    }
-
-    return output;
+    return transform(mat.m, input, output, size);
 }
 
 /**
@@ -1793,6 +1813,10 @@ float* Mat4::transform(const Mat4& mat, float const* input, float* output, size_
  * The vector is array is treated as a list of 4 element vectors (@see Vec4).
  * The transform is applied in order and written to the output array.
  *
+ * This method uses SSE, AVX2, or NEON instructions where available. The
+ * input and output may be the same array, but they should not otherwise
+ * overlap.
+ *
  * @param mat       The transform matrix in column major order
  * @param input     The array of vectors to transform.
  * @param output    The array to store the transformed vectors.
@@ -1802,7 +1826,50 @@ float* Mat4::transform(const Mat4& mat, float const* input, float* output, size_
  */
 float* Mat4::transform(const float* mat, float const* input, float* output, size_t size) {
     CUAssertLog(output, "Destination vector is null");
-    for(size_t ii = 0; ii < size; ii++) {
+    size_t ii = 0;
+#if defined CU_MATH_VECTOR_AVX2
+    // Two vectors per register
+    __m256 wc0 = _mm256_broadcast_ps((const __m128*)mat);
+    __m256 wc1 = _mm256_broadcast_ps((const __m128*)(mat+4));
+    __m256 wc2 = _mm256_broadcast_ps((const __m128*)(mat+8));
+    __m256 wc3 = _mm256_broadcast_ps((const __m128*)(mat+12));
+    for(; ii+2 <= size; ii += 2) {
+        __m256 p = _mm256_loadu_ps(input+4*ii);
+        __m256 r = _mm256_mul_ps(wc0,_mm256_permute_ps(p,_MM_SHUFFLE(0,0,0,0)));
+        r = _mm256_fmadd_ps(wc1,_mm256_permute_ps(p,_MM_SHUFFLE(1,1,1,1)),r);
+        r = _mm256_fmadd_ps(wc2,_mm256_permute_ps(p,_MM_SHUFFLE(2,2,2,2)),r);
+        r = _mm256_fmadd_ps(wc3,_mm256_permute_ps(p,_MM_SHUFFLE(3,3,3,3)),r);
+        _mm256_storeu_ps(output+4*ii, r);
+    }
+#endif
+#if defined CU_MATH_VECTOR_SSE
+    __m128 c0 = _mm_loadu_ps(mat);
+    __m128 c1 = _mm_loadu_ps(mat+4);
+    __m128 c2 = _mm_loadu_ps(mat+8);
+    __m128 c3 = _mm_loadu_ps(mat+12);
+    for(; ii < size; ii++) {
+        __m128 p  = _mm_loadu_ps(input+4*ii);
+        __m128 lo = _mm_add_ps(_mm_mul_ps(c0,_mm_shuffle_ps(p,p,_MM_SHUFFLE(0,0,0,0))),
+                               _mm_mul_ps(c1,_mm_shuffle_ps(p,p,_MM_SHUFFLE(1,1,1,1))));
+        __m128 hi = _mm_add_ps(_mm_mul_ps(c2,_mm_shuffle_ps(p,p,_MM_SHUFFLE(2,2,2,2))),
+                               _mm_mul_ps(c3,_mm_shuffle_ps(p,p,_MM_SHUFFLE(3,3,3,3))));
+        _mm_storeu_ps(output+4*ii, _mm_add_ps(lo,hi));
+    }
+#elif defined CU_MATH_VECTOR_NEON64
+    float32x4_t c0 = vld1q_f32(mat);
+    float32x4_t c1 = vld1q_f32(mat+4);
+    float32x4_t c2 = vld1q_f32(mat+8);
+    float32x4_t c3 = vld1q_f32(mat+12);
+    for(; ii < size; ii++) {
+        float32x4_t p = vld1q_f32(input+4*ii);
+        float32x4_t r = vmulq_laneq_f32(c0,p,0);
+        r = vfmaq_laneq_f32(r,c1,p,1);
+        r = vfmaq_laneq_f32(r,c2,p,2);
+        r = vfmaq_laneq_f32(r,c3,p,3);
+        vst1q_f32(output+4*ii, r);
+    }
+#endif
+    for(; ii < size; ii++) {
         // Handle case where v == dst.
         float x = input[ii*4] * mat[0] + input[ii*4+1] * mat[4] + input[ii*4+2] * mat[8]  + input[ii*4+3] * mat[12];
         float y = input[ii*4] * mat[1] + input[ii*4+1] * mat[5] + input[ii*4+2] * mat[9]  + input[ii*4+3] * mat[13];
@@ -1817,6 +1884,62 @@ float* Mat4::transform(const float* mat, float const* input, float* output, size
     return output;
 }
 
+/**
+ * Transforms the point array by the given matrix, and stores the result in dst.
+ *
+ * Each point is treated as a 4 element vector with w = 1. The result is
+ * not normalized, so the output contains the homogenous coordinates of
+ * each point. This is what a vertex shader would compute, and is useful
+ * for projecting many points with a camera matrix at once.
+ *
+ * This method uses SSE or NEON instructions where available.
+ *
+ * @param mat       The transform matrix.
+ * @param input     The array of points to transform.
+ * @param output    The array to store the transformed vectors.
+ * @param size      The size of the two arrays.
+ *
+ * @return A reference to dst for chaining
+ */
+Vec4* Mat4::transform(const Mat4& mat, const Vec3* input, Vec4* output, size_t size) {
+    CUAssertLog(output, "Destination vector is null");
+    const float* m = mat.m;
+#if defined CU_MATH_VECTOR_SSE
+    __m128 c0 = _mm_loadu_ps(m);
+    __m128 c1 = _mm_loadu_ps(m+4);
+    __m128 c2 = _mm_loadu_ps(m+8);
+    __m128 c3 = _mm_loadu_ps(m+12);
+    for(size_t ii = 0; ii < size; ii++) {
+        const Vec3& p = input[ii];
+        __m128 lo = _mm_add_ps(_mm_mul_ps(c0,_mm_set1_ps(p.x)),_mm_mul_ps(c1,_mm_set1_ps(p.y)));
+        __m128 hi = _mm_add_ps(_mm_mul_ps(c2,_mm_set1_ps(p.z)),c3);
+        _mm_storeu_ps(&(output[ii].x), _mm_add_ps(lo,hi));
+    }
+#elif defined CU_MATH_VECTOR_NEON64
+    float32x4_t c0 = vld1q_f32(m);
+    float32x4_t c1 = vld1q_f32(m+4);
+    float32x4_t c2 = vld1q_f32(m+8);
+    float32x4_t c3 = vld1q_f32(m+12);
+    for(size_t ii = 0; ii < size; ii++) {
+        const Vec3& p = input[ii];
+        float32x4_t r = vfmaq_n_f32(c3,c0,p.x);
+        r = vfmaq_n_f32(r,c1,p.y);
+        r = vfmaq_n_f32(r,c2,p.z);
+        vst1q_f32(&(output[ii].x), r);
+    }
+#else
+    for(size_t ii = 0; ii < size; ii++) {
+        const Vec3& p = input[ii];
+        float x = p.x * m[0] + p.y * m[4] + p.z * m[8]  + m[12];
+        float y = p.x * m[1] + p.y * m[5] + p.z * m[9]  + m[13];
+        float z = p.x * m[2] + p.y * m[6] + p.z * m[10] + m[14];
+        float w = p.x * m[3] + p.y * m[7] + p.z * m[11] + m[15];
+        output[ii].set(x,y,z,w);
+    }
+#endif
+    return output;
+}
+
 #pragma mark -
 #pragma mark Conversion Methods
 
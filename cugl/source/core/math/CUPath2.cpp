@@ -1042,11 +1042,7 @@ Path2& Path2::operator*=(const Vec2 scale) {
  * @return This path with the vertices transformed
  */
 Path2& Path2::operator*=(const Affine2& transform) {
-    Vec2 tmp;
-    for(auto it = vertices.begin(); it != vertices.end(); ++it) {
-        Affine2::transform(transform,*it,&tmp);
-        *it = tmp;
-    }
+    Affine2::transform(transform, vertices.data(), vertices.data(), vertices.size());
     return *this;
 }
 
@@ -757,11 +757,7 @@ Poly2& Poly2::operator*=(const Vec2 scale) {
  * @return This polygon with the vertices transformed
  */
 Poly2& Poly2::operator*=(const Affine2& transform) {
-    Vec2 tmp;
-    for(auto it = vertices.begin(); it != vertices.end(); ++it) {
-        Affine2::transform(transform, *it, &tmp);
-        *it = tmp;
-    }
+    Affine2::transform(transform, vertices.data(), vertices.data(), vertices.size());
     return *this;
 }
 
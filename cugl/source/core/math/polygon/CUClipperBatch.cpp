@@ -0,0 +1,309 @@
+//
+//  CUClipperBatch.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a batch interface to the Clipper library. Clipper
+//  performs boolean operations (union, intersection, and so on) and offsets
+//  on one set of polygons at a time. Games that clip many independent
+//  shapes each frame (e.g. tiled terrain or fog-of-war) can instead queue
+//  the operations as jobs in this class and run them all at once across a
+//  thread pool.
+//
+//  Each thread in the calculation has its own Clipper instances, and these
+//  are reused across jobs and across calculations.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty. In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Author: Walker White
+//  Version: 7/3/24 (CUGL 3.0 reorganization)
+//
+#include <cugl/core/math/polygon/CUClipperBatch.h>
+#include <cugl/core/util/CUThreadPool.h>
+#include <cugl/core/util/CUDebug.h>
+#include <condition_variable>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+using namespace cugl;
+
+/** The default miter limit (the Clipper default) */
+#define DEFAULT_MITER   2.0
+/** The default arc tolerance (the Clipper default) */
+#define DEFAULT_ARC     0.25
+
+#pragma mark Calculation State
+/**
+ * The shared state of a batch calculation.
+ *
+ * This state is shared (via a shared pointer) by the batch and every task
+ * that it submits to the thread pool. A task that is still waiting in the
+ * pool after the calculation is complete only touches this state, so it is
+ * safe for that task to outlive the batch.
+ */
+class ClipperBatch::State {
+public:
+    /**
+     * The reusable Clipper instances for a single thread
+     */
+    class Worker {
+    public:
+        /** The clipper for boolean operations */
+        ClipperLib::Clipper clipper;
+        /** The clipper for offsets */
+        ClipperLib::ClipperOffset offset;
+    };
+
+    /** The jobs to process */
+    Job* jobs;
+    /** The number of jobs to process */
+    size_t size;
+    /** The Clipper instances, one for each thread in the calculation */
+    std::vector<std::unique_ptr<Worker>> workers;
+    /** The index of the next job to claim */
+    std::atomic<size_t> next;
+    /** The index of the next worker to claim */
+    std::atomic<size_t> slot;
+    /** The number of jobs not yet complete */
+    size_t remaining;
+    /** The miter limit for offsets */
+    double miterLimit;
+    /** The arc tolerance for offsets */
+    double arcTolerance;
+    /** The mutex protecting the remaining count */
+    std::mutex mutex;
+    /** The condition signaled when the remaining count reaches 0 */
+    std::condition_variable done;
+
+    /**
+     * Creates an empty calculation state
+     */
+    State() : jobs(nullptr), size(0), next(0), slot(0), remaining(0),
+    miterLimit(DEFAULT_MITER), arcTolerance(DEFAULT_ARC) {}
+
+    /**
+     * Processes jobs until there are none left to claim.
+     *
+     * This method is called by the calling thread and every worker thread.
+     */
+    void run() {
+        size_t count = 0;
+        size_t pos = next.fetch_add(1);
+        if (pos >= size) {
+            return;
+        }
+
+        Worker* worker = workers[slot.fetch_add(1)].get();
+        do {
+            process(worker, jobs+pos);
+            count++;
+        } while ((pos = next.fetch_add(1)) < size);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        remaining -= count;
+        if (remaining == 0) {
+            done.notify_all();
+        }
+    }
+
+    /**
+     * Processes a single job with the given Clipper instances
+     *
+     * @param worker    The Clipper instances
+     * @param job       The job to process
+     */
+    void process(Worker* worker, Job* job) {
+        job->solution.clear();
+        if (job->offset) {
+            ClipperLib::ClipperOffset* offset = &(worker->offset);
+            offset->Clear();
+            offset->MiterLimit = miterLimit;
+            offset->ArcTolerance = arcTolerance;
+            offset->AddPaths(job->subject, job->joinType, job->endType);
+            offset->Execute(job->solution, job->delta);
+            job->success = true;
+        } else {
+            ClipperLib::Clipper* clipper = &(worker->clipper);
+            clipper->Clear();
+            clipper->AddPaths(job->subject, ClipperLib::ptSubject, true);
+            clipper->AddPaths(job->clip, ClipperLib::ptClip, true);
+            job->success = clipper->Execute(job->clipType, job->solution,
+                                            job->fillType, job->fillType);
+        }
+    }
+};
+
+#pragma mark -
+#pragma mark Constructors
+/**
+ * Creates a degenerate clipper batch.
+ *
+ * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an object on
+ * the heap, use one of the static constructors instead.
+ */
+ClipperBatch::ClipperBatch() :
+_threads(nullptr),
+_state(nullptr),
+_miterLimit(DEFAULT_MITER),
+_arcTolerance(DEFAULT_ARC) {
+}
+
+/**
+ * Disposes all of the resources used by this batch.
+ *
+ * A disposed batch can be safely reinitialized.
+ */
+void ClipperBatch::dispose() {
+    _jobs.clear();
+    _threads = nullptr;
+    _state = nullptr;
+    _miterLimit = DEFAULT_MITER;
+    _arcTolerance = DEFAULT_ARC;
+}
+
+/**
+ * Initializes a clipper batch for the given thread pool.
+ *
+ * If the thread pool is nullptr, the jobs are run on the calling thread.
+ * The thread pool may be shared with other parts of the application.
+ *
+ * @param threads   The thread pool for the calculation
+ *
+ * @return true if initialization was successful.
+ */
+bool ClipperBatch::init(const std::shared_ptr<ThreadPool>& threads) {
+    if (_state != nullptr) {
+        CUAssertLog(false, "Batch is already initialized");
+        return false;
+    }
+    _threads = threads;
+    _state = std::make_shared<State>();
+    return true;
+}
+
+#pragma mark -
+#pragma mark Jobs
+/**
+ * Adds a boolean operation to this batch.
+ *
+ * The polygon sets are copied. The batch does not retain any references
+ * to the original data.
+ *
+ * @param type      The boolean operation
+ * @param subject   The subject polygons
+ * @param clip      The clip polygons
+ * @param fill      The fill rule for both polygon sets
+ *
+ * @return the position of the new job
+ */
+size_t ClipperBatch::addClip(ClipperLib::ClipType type,
+                             const ClipperLib::Paths& subject, const ClipperLib::Paths& clip,
+                             ClipperLib::PolyFillType fill) {
+    _jobs.emplace_back();
+    Job* job = &(_jobs.back());
+    job->offset = false;
+    job->clipType = type;
+    job->fillType = fill;
+    job->subject = subject;
+    job->clip = clip;
+    return _jobs.size()-1;
+}
+
+/**
+ * Adds an offset operation to this batch.
+ *
+ * The polygon set is copied. The batch does not retain any references
+ * to the original data. A positive delta grows closed polygons, while a
+ * negative delta shrinks them.
+ *
+ * @param paths     The polygons to offset
+ * @param delta     The offset distance
+ * @param joint     The joint type
+ * @param end       The end type
+ *
+ * @return the position of the new job
+ */
+size_t ClipperBatch::addOffset(const ClipperLib::Paths& paths, double delta,
+                               ClipperLib::JoinType joint, ClipperLib::EndType end) {
+    _jobs.emplace_back();
+    Job* job = &(_jobs.back());
+    job->offset = true;
+    job->joinType = joint;
+    job->endType = end;
+    job->delta = delta;
+    job->subject = paths;
+    return _jobs.size()-1;
+}
+
+#pragma mark -
+#pragma mark Calculation
+/**
+ * Performs all of the jobs in this batch.
+ *
+ * The jobs are distributed across the thread pool, and the calling
+ * thread processes jobs as well. This method blocks until all of the
+ * jobs are complete. Jobs are independent, so the order in which they
+ * are processed is undefined.
+ */
+void ClipperBatch::calculate() {
+    CUAssertLog(_state != nullptr, "Batch is not initialized");
+    if (_jobs.empty()) {
+        return;
+    }
+
+    // A task from a previous calculation may still hold the old state
+    if (_state.use_count() > 1) {
+        _state = std::make_shared<State>();
+    }
+    std::shared_ptr<State> state = _state;
+
+    size_t threads = _threads == nullptr ? 0 : _threads->getThreadCount();
+    size_t tasks = std::min(threads, _jobs.size()-1);
+    while (state->workers.size() < tasks+1) {
+        state->workers.push_back(std::make_unique<State::Worker>());
+    }
+
+    state->jobs = _jobs.data();
+    state->size = _jobs.size();
+    state->miterLimit = _miterLimit;
+    state->arcTolerance = _arcTolerance;
+    state->next = 0;
+    state->slot = 0;
+    state->remaining = _jobs.size();
+    for(size_t ii = 0; ii < tasks; ii++) {
+        _threads->addTask([state]() { state->run(); });
+    }
+
+    // Do not wait on tasks that no worker has started
+    state->run();
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->done.wait(lock, [&]() { return state->remaining == 0; });
+}
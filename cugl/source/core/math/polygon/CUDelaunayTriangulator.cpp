@@ -10,6 +10,10 @@
 //
 //      https://github.com/jhasse/poly2tri
 //
+//  Steiner points may also be inserted into (or removed from) a computed
+//  triangulation incrementally, which restores the Delaunay property with
+//  local edge flips instead of running poly2tri again.
+//
 //  Because math objects are intended to be on the stack, we do not provide
 //  any shared pointer support in this class.
 //
@@ -36,13 +40,19 @@
 //  Version: 7/3/24 (CUGL 3.0 reorganization)
 //
 #include <cugl/core/math/polygon/CUDelaunayTriangulator.h>
+#include <cugl/core/math/polygon/CUEarclipTriangulator.h>
+#include <cugl/core/math/polygon/CUTriangulationCache.h>
 #include <cugl/core/math/CUPoly2.h>
 #include <cugl/core/math/CUPath2.h>
 #include <cugl/core/util/CUDebug.h>
+#include <algorithm>
 #include <deque>
 
 using namespace cugl;
 
+/** The tag identifying this triangulator in a TriangulationCache */
+#define CACHE_TAG   2
+
 /**
  * Returns the point of intersection of a ray with the bounding box.
  *
@@ -110,6 +120,87 @@ static Vec2 get_interior(const Vec2& start, const Vec2& end, const Rect& box) {
     return result;
 }
 
+/**
+ * Returns twice the signed area of the triangle abc
+ *
+ * The value is positive if the triangle is counter-clockwise, negative if
+ * it is clockwise, and zero if the points are colinear.
+ *
+ * @param a     The first triangle vertex
+ * @param b     The second triangle vertex
+ * @param c     The third triangle vertex
+ *
+ * @return twice the signed area of the triangle abc
+ */
+static double orient(const p2t::Point* a, const p2t::Point* b, const p2t::Point* c) {
+    return (b->x-a->x)*(c->y-a->y)-(b->y-a->y)*(c->x-a->x);
+}
+
+/**
+ * Returns true if d is strictly inside the circumcircle of triangle abc
+ *
+ * The triangle abc is assumed to be counter-clockwise.
+ *
+ * @param a     The first triangle vertex
+ * @param b     The second triangle vertex
+ * @param c     The third triangle vertex
+ * @param d     The point to test
+ *
+ * @return true if d is strictly inside the circumcircle of triangle abc
+ */
+static bool in_circle(const p2t::Point* a, const p2t::Point* b,
+                      const p2t::Point* c, const p2t::Point* d) {
+    double adx = a->x-d->x, ady = a->y-d->y;
+    double bdx = b->x-d->x, bdy = b->y-d->y;
+    double cdx = c->x-d->x, cdy = c->y-d->y;
+    double ad = adx*adx+ady*ady;
+    double bd = bdx*bdx+bdy*bdy;
+    double cd = cdx*cdx+cdy*cdy;
+    double det = adx*(bdy*cd-bd*cdy)-ady*(bdx*cd-bd*cdx)+ad*(bdx*cdy-bdy*cdx);
+    return det > 0;
+}
+
+/**
+ * Returns the triangle containing the directed edge ab, or -1 if none
+ *
+ * Triangles are counter-clockwise, so each interior edge appears in one
+ * direction in each of its two triangles. If the triangle exists, the
+ * third vertex is stored in the given pointer.
+ *
+ * @param indices   The triangulation indices
+ * @param a         The edge start
+ * @param b         The edge end
+ * @param third     Pointer to store the third vertex
+ *
+ * @return the triangle containing the directed edge ab, or -1 if none
+ */
+static long find_edge(const std::vector<Uint32>& indices, Uint32 a, Uint32 b, Uint32* third) {
+    for(size_t ii = 0; ii < indices.size(); ii += 3) {
+        for(int jj = 0; jj < 3; jj++) {
+            if (indices[ii+jj] == a && indices[ii+(jj+1)%3] == b) {
+                *third = indices[ii+(jj+2)%3];
+                return (long)(ii/3);
+            }
+        }
+    }
+    return -1;
+}
+
+/**
+ * Sets the given triangle to the vertices a, b, c
+ *
+ * @param indices   The triangulation indices
+ * @param tri       The triangle position
+ * @param a         The first triangle vertex
+ * @param b         The second triangle vertex
+ * @param c         The third triangle vertex
+ */
+static void set_triangle(std::vector<Uint32>& indices, size_t tri, Uint32 a, Uint32 b, Uint32 c) {
+    indices[3*tri  ] = a;
+    indices[3*tri+1] = b;
+    indices[3*tri+2] = c;
+}
+
 #pragma mark -
 #pragma mark Constructors
 /**
@@ -373,6 +464,7 @@ void DelaunayTriangulator::reset() {
     _vertices.clear();
     _idxmap.clear();
     _indices.clear();
+    _extended.clear();
     _voronoi.clear();
     _calculated = false;
     _dualated = false;
@@ -401,68 +493,36 @@ void DelaunayTriangulator::clear() {
  */
 void DelaunayTriangulator::calculate() {
     reset();
-
-    // Set up the triangulator
-    _vertices.reserve(_hull.size());
-    for(size_t ii = 0; ii < _hull.size(); ii++) {
-        p2t::Point* p = &(_hull[ii]);
-        _idxmap.emplace(p,_vertices.size());
-        _vertices.push_back(p);
-    }
-    _triangulator = new p2t::CDT(_vertices);
-    
-    std::vector<p2t::Point*> hole;
-    for(auto it = _holes.begin(); it != _holes.end(); ++it) {
-        hole.clear();
-        size_t next = _vertices.size()+it->size();
-        hole.reserve(it->size());
-        _vertices.reserve(next);
-        for(size_t ii = 0; ii < it->size(); ii++) {
-            p2t::Point* p = &(it->at(ii));
-            hole.push_back(p);
-            _idxmap.emplace(p,_vertices.size());
-            _vertices.push_back(p);
-        }
-        _triangulator->AddHole(hole);
+    if (_cache == nullptr) {
+        triangulate();
+        return;
     }
     
-    size_t next = _vertices.size()+_stein.size();
-    _vertices.reserve(next);
-    for(size_t ii = 0; ii < _stein.size(); ii++) {
-        p2t::Point* p = &(_stein[ii]);
-        _idxmap.emplace(p,_vertices.size());
-        _vertices.push_back(p);
-        _triangulator->AddPoint(p);
+    // The key needs a contiguous copy of the input
+    gatherVertices();
+    std::vector<Vec2> input;
+    std::vector<size_t> layout;
+    input.reserve(_vertices.size());
+    for(auto it = _vertices.begin(); it != _vertices.end(); ++it) {
+        input.push_back(Vec2((float)(*it)->x,(float)(*it)->y));
     }
-    
-    _triangulator->Triangulate();
-    
-    // Extract the information
-    std::vector<p2t::Triangle*> tris = _triangulator->GetTriangles();
-    _indices.reserve(3*tris.size());
-    for(auto it = tris.begin(); it != tris.end(); ++it) {
-        // poly2tri points are automatically CCW
-        for(int ii = 0; ii < 3; ii++) {
-            p2t::Point* p = (*it)->GetPoint(ii);
-            auto search = _idxmap.find(p);
-            CUAssertLog(search != _idxmap.end(), "Triangulation introduced an unknown vertex");
-            _indices.push_back(search->second);
-        }
+    layout.reserve(_holes.size()+1);
+    for(auto it = _holes.begin(); it != _holes.end(); ++it) {
+        layout.push_back(it->size());
     }
+    layout.push_back(_stein.size());
 
-    std::list<p2t::Triangle*> map = _triangulator->GetMap();
-    _extended.reserve(3*map.size());
-    for(auto it = tris.begin(); it != tris.end(); ++it) {
-        // poly2tri points are automatically CCW
-        for(int ii = 0; ii < 3; ii++) {
-            p2t::Point* p = (*it)->GetPoint(ii);
-            auto search = _idxmap.find(p);
-            CUAssertLog(search != _idxmap.end(), "Extended triangulation introduced an unknown vertex");
-            _extended.push_back(search->second);
-        }
+    size_t key = TriangulationCache::hash(CACHE_TAG, input.data(), input.size(),
+                                          layout.data(), layout.size());
+    if (_cache->lookup(key, input.size(), _indices)) {
+        // poly2tri only produces the interior triangles
+        _extended = _indices;
+        _calculated = true;
+        return;
     }
-
-    _calculated = true;
+    
+    triangulate();
+    _cache->store(key, _vertices.size(), _indices);
 }
 
 /**
@@ -474,8 +534,10 @@ void DelaunayTriangulator::calculate() {
  * missing triangles are interpolated.
  */
 void DelaunayTriangulator::calculateDual() {
-    if (!_calculated) {
-        calculate();
+    if (!_calculated || _triangulator == nullptr) {
+        // Cached and incremental results do not have poly2tri data
+        reset();
+        triangulate();
     }
     _voronoi.clear();
     
@@ -517,6 +579,230 @@ void DelaunayTriangulator::calculateDual() {
     _dualated = true;
 }
 
+#pragma mark -
+#pragma mark Incremental Updates
+/**
+ * Inserts the given Steiner point into the current triangulation.
+ *
+ * If the triangulation has not been computed, this method is the same
+ * as {@link #addSteiner}. Otherwise, it splits the triangle containing
+ * the point and restores the Delaunay property with edge flips. This is
+ * linear in the size of the triangulation, as opposed to recomputing it
+ * from scratch.
+ *
+ * The point must be strictly inside the triangulation (not in a hole or
+ * on the boundary), and it may not coincide with an existing vertex. If
+ * it is not, this method returns false and the point is not added.
+ * Otherwise, the point is added after all other Steiner points, just as
+ * with {@link #addSteiner}.
+ *
+ * Any incremental change discards the Voronoi diagram, which must be
+ * recomputed with {@link #calculateDual}.
+ *
+ * @param point     The Steiner point
+ *
+ * @return true if the point was inserted
+ */
+bool DelaunayTriangulator::insertSteiner(Vec2 point) {
+    if (!_calculated) {
+        addSteiner(point);
+        return true;
+    }
+    
+    // Locate the triangle (or interior edge) containing the point
+    p2t::Point pt(point.x,point.y);
+    long target = -1;
+    int edge = -1;
+    for(size_t ii = 0; target < 0 && ii < _indices.size(); ii += 3) {
+        double o[3];
+        int zeros = 0;
+        bool inside = true;
+        for(int jj = 0; inside && jj < 3; jj++) {
+            o[jj] = orient(_vertices[_indices[ii+jj]],_vertices[_indices[ii+(jj+1)%3]],&pt);
+            inside = o[jj] >= 0;
+            zeros += o[jj] == 0 ? 1 : 0;
+        }
+        if (inside) {
+            if (zeros > 1) {
+                // Coincides with a vertex
+                return false;
+            }
+            target = (long)(ii/3);
+            for(int jj = 0; zeros == 1 && jj < 3; jj++) {
+                if (o[jj] == 0) {
+                    edge = jj;
+                }
+            }
+        }
+    }
+    if (target < 0) {
+        return false;
+    }
+    
+    Uint32 a = _indices[3*target];
+    Uint32 b = _indices[3*target+1];
+    Uint32 c = _indices[3*target+2];
+    long neighbor = -1;
+    Uint32 d = 0;
+    if (edge >= 0) {
+        // Rotate so the point is on edge ab
+        Uint32 tri[3] = { a, b, c };
+        a = tri[edge];
+        b = tri[(edge+1)%3];
+        c = tri[(edge+2)%3];
+        neighbor = find_edge(_indices, b, a, &d);
+        if (neighbor < 0) {
+            // Cannot split a constraint
+            return false;
+        }
+    }
+    
+    // Steiner points are last, so existing indices are unchanged
+    _stein.push_back(pt);
+    invalidate();
+    Uint32 p = (Uint32)(_vertices.size()-1);
+    
+    std::vector<std::pair<Uint32,Uint32>> edges;
+    if (edge < 0) {
+        set_triangle(_indices, target, a, b, p);
+        _indices.push_back(b); _indices.push_back(c); _indices.push_back(p);
+        _indices.push_back(c); _indices.push_back(a); _indices.push_back(p);
+        edges.push_back(std::make_pair(a,b));
+        edges.push_back(std::make_pair(b,c));
+        edges.push_back(std::make_pair(c,a));
+    } else {
+        set_triangle(_indices, target, a, p, c);
+        set_triangle(_indices, neighbor, b, p, d);
+        _indices.push_back(p); _indices.push_back(b); _indices.push_back(c);
+        _indices.push_back(p); _indices.push_back(a); _indices.push_back(d);
+        edges.push_back(std::make_pair(b,c));
+        edges.push_back(std::make_pair(c,a));
+        edges.push_back(std::make_pair(a,d));
+        edges.push_back(std::make_pair(d,b));
+    }
+    legalize(edges);
+    _extended = _indices;
+    return true;
+}
+
+/**
+ * Removes the given Steiner point from the current triangulation.
+ *
+ * The index is the position of the point among the Steiner points (in
+ * the order they were added), not its position in the vertex list. All
+ * later Steiner points move down one position. Hull and hole vertices
+ * are constraints, and cannot be removed.
+ *
+ * If the triangulation has not been computed, this method simply
+ * removes the point from the input. Otherwise, it retriangulates the
+ * region around the point and restores the Delaunay property with edge
+ * flips. This is linear in the size of the triangulation, as opposed to
+ * recomputing it from scratch.
+ *
+ * Any incremental change discards the Voronoi diagram, which must be
+ * recomputed with {@link #calculateDual}.
+ *
+ * @param index     The Steiner point position
+ *
+ * @return true if the point was removed
+ */
+bool DelaunayTriangulator::removeSteiner(size_t index) {
+    if (index >= _stein.size()) {
+        return false;
+    } else if (!_calculated) {
+        _stein.erase(_stein.begin()+index);
+        return true;
+    }
+    
+    Uint32 v = (Uint32)(_vertices.size()-_stein.size()+index);
+    
+    // Find the fan of triangles around the point, and its link
+    std::vector<size_t> fan;
+    std::unordered_map<Uint32, Uint32> link;
+    for(size_t ii = 0; ii < _indices.size(); ii += 3) {
+        for(int jj = 0; jj < 3; jj++) {
+            if (_indices[ii+jj] == v) {
+                fan.push_back(ii/3);
+                link.emplace(_indices[ii+(jj+1)%3],_indices[ii+(jj+2)%3]);
+            }
+        }
+    }
+    
+    // Walk the link in counter-clockwise order
+    std::vector<Uint32> ring;
+    if (!fan.empty()) {
+        Uint32 start = link.begin()->first;
+        Uint32 curr  = start;
+        do {
+            ring.push_back(curr);
+            auto search = link.find(curr);
+            curr = search == link.end() ? start : search->second;
+        } while (curr != start && ring.size() <= link.size());
+    }
+    
+    if (fan.size() < 3 || ring.size() != fan.size()) {
+        // The point was not interior, so fall back to a full calculation
+        _stein.erase(_stein.begin()+index);
+        calculate();
+        return true;
+    }
+    
+    // Triangulate the hole left by the point
+    std::vector<Vec2> positions;
+    positions.reserve(ring.size());
+    for(auto it = ring.begin(); it != ring.end(); ++it) {
+        positions.push_back(Vec2((float)_vertices[*it]->x,(float)_vertices[*it]->y));
+    }
+    EarclipTriangulator earclip;
+    earclip.set(positions);
+    earclip.calculate();
+    std::vector<Uint32> patch = earclip.getTriangulation();
+    
+    // The patch has two fewer triangles than the fan
+    size_t patches = patch.size()/3;
+    if (patches+2 != fan.size()) {
+        _stein.erase(_stein.begin()+index);
+        calculate();
+        return true;
+    }
+
+    std::vector<std::pair<Uint32,Uint32>> edges;
+    for(size_t ii = 0; ii < patches; ii++) {
+        Uint32 a = ring[patch[3*ii]];
+        Uint32 b = ring[patch[3*ii+1]];
+        Uint32 c = ring[patch[3*ii+2]];
+        set_triangle(_indices, fan[ii], a, b, c);
+        edges.push_back(std::make_pair(a,b));
+        edges.push_back(std::make_pair(b,c));
+        edges.push_back(std::make_pair(c,a));
+    }
+    std::sort(fan.begin()+patches, fan.end());
+    for(size_t ii = fan.size(); ii > patches; ii--) {
+        _indices.erase(_indices.begin()+3*fan[ii-1],_indices.begin()+3*fan[ii-1]+3);
+    }
+    
+    // Later Steiner points move down
+    for(auto it = _indices.begin(); it != _indices.end(); ++it) {
+        if (*it > v) {
+            (*it)--;
+        }
+    }
+    for(auto it = edges.begin(); it != edges.end(); ++it) {
+        if (it->first > v) {
+            it->first--;
+        }
+        if (it->second > v) {
+            it->second--;
+        }
+    }
+    
+    _stein.erase(_stein.begin()+index);
+    invalidate();
+    legalize(edges);
+    _extended = _indices;
+    return true;
+}
+
 #pragma mark -
 #pragma mark Materialization
 /**
@@ -725,6 +1011,157 @@ Poly2* DelaunayTriangulator::getMapPolygon(Poly2* buffer) const {
     return buffer;
 }
 
+#pragma mark -
+#pragma mark Internal Computation
+/**
+ * Collects the input vertices into a single list in index order.
+ *
+ * This rebuilds both the vertex list and the reverse look-up table. It
+ * must be called whenever the input changes, as the vertex list stores
+ * pointers into the input.
+ */
+void DelaunayTriangulator::gatherVertices() {
+    _vertices.clear();
+    _idxmap.clear();
+    size_t total = _hull.size()+_stein.size();
+    for(auto it = _holes.begin(); it != _holes.end(); ++it) {
+        total += it->size();
+    }
+    _vertices.reserve(total);
+    for(size_t ii = 0; ii < _hull.size(); ii++) {
+        p2t::Point* p = &(_hull[ii]);
+        _idxmap.emplace(p,_vertices.size());
+        _vertices.push_back(p);
+    }
+    for(auto it = _holes.begin(); it != _holes.end(); ++it) {
+        for(size_t ii = 0; ii < it->size(); ii++) {
+            p2t::Point* p = &(it->at(ii));
+            _idxmap.emplace(p,_vertices.size());
+            _vertices.push_back(p);
+        }
+    }
+    for(size_t ii = 0; ii < _stein.size(); ii++) {
+        p2t::Point* p = &(_stein[ii]);
+        _idxmap.emplace(p,_vertices.size());
+        _vertices.push_back(p);
+    }
+}
+
+/**
+ * Triangulates the current vertex data with poly2tri.
+ *
+ * This is the uncached calculation. It assumes the triangulator has
+ * been reset.
+ */
+void DelaunayTriangulator::triangulate() {
+    gatherVertices();
+    
+    // poly2tri attaches edges to the points, which are stale on a recalculation
+    for(auto it = _vertices.begin(); it != _vertices.end(); ++it) {
+        (*it)->edge_list.clear();
+    }
+
+    // Set up the triangulator
+    size_t offset = _hull.size();
+    _triangulator = new p2t::CDT(std::vector<p2t::Point*>(_vertices.begin(),_vertices.begin()+offset));
+    
+    std::vector<p2t::Point*> hole;
+    for(auto it = _holes.begin(); it != _holes.end(); ++it) {
+        hole.assign(_vertices.begin()+offset,_vertices.begin()+offset+it->size());
+        _triangulator->AddHole(hole);
+        offset += it->size();
+    }
+    
+    for(size_t ii = offset; ii < _vertices.size(); ii++) {
+        _triangulator->AddPoint(_vertices[ii]);
+    }
+    
+    _triangulator->Triangulate();
+    
+    // Extract the information
+    std::vector<p2t::Triangle*> tris = _triangulator->GetTriangles();
+    _indices.reserve(3*tris.size());
+    for(auto it = tris.begin(); it != tris.end(); ++it) {
+        // poly2tri points are automatically CCW
+        for(int ii = 0; ii < 3; ii++) {
+            p2t::Point* p = (*it)->GetPoint(ii);
+            auto search = _idxmap.find(p);
+            CUAssertLog(search != _idxmap.end(), "Triangulation introduced an unknown vertex");
+            _indices.push_back(search->second);
+        }
+    }
+
+    std::list<p2t::Triangle*> map = _triangulator->GetMap();
+    _extended.reserve(3*map.size());
+    for(auto it = tris.begin(); it != tris.end(); ++it) {
+        // poly2tri points are automatically CCW
+        for(int ii = 0; ii < 3; ii++) {
+            p2t::Point* p = (*it)->GetPoint(ii);
+            auto search = _idxmap.find(p);
+            CUAssertLog(search != _idxmap.end(), "Extended triangulation introduced an unknown vertex");
+            _extended.push_back(search->second);
+        }
+    }
+
+    _calculated = true;
+}
+
+
+/**
+ * Restores the Delaunay property after an incremental change.
+ *
+ * The list contains directed edges that may be illegal. Each edge is
+ * checked against the triangle on the opposite side, and flipped if
+ * the opposite vertex is inside the circumcircle. The edges of a
+ * flipped quadrilateral are then checked in turn. Boundary edges have
+ * no opposite triangle, and so the constraints are never flipped.
+ *
+ * @param edges The edges to check (consumed by this method)
+ */
+void DelaunayTriangulator::legalize(std::vector<std::pair<Uint32,Uint32>>& edges) {
+    // Round-off can make cocircular points flip back and forth
+    size_t limit = 4*_indices.size()+edges.size();
+    while (!edges.empty() && limit > 0) {
+        Uint32 a = edges.back().first;
+        Uint32 b = edges.back().second;
+        edges.pop_back();
+        limit--;
+
+        Uint32 c = 0;
+        Uint32 d = 0;
+        long t1 = find_edge(_indices, a, b, &c);
+        long t2 = find_edge(_indices, b, a, &d);
+        if (t1 < 0 || t2 < 0) {
+            continue;
+        }
+        
+        if (in_circle(_vertices[a], _vertices[b], _vertices[c], _vertices[d])) {
+            set_triangle(_indices, t1, c, a, d);
+            set_triangle(_indices, t2, c, d, b);
+            edges.push_back(std::make_pair(a,d));
+            edges.push_back(std::make_pair(d,b));
+            edges.push_back(std::make_pair(b,c));
+            edges.push_back(std::make_pair(c,a));
+        }
+    }
+}
+
+/**
+ * Discards the poly2tri state after an incremental change.
+ *
+ * This rebuilds the vertex list and drops the Voronoi diagram, as
+ * neither are valid once the input has changed.
+ */
+void DelaunayTriangulator::invalidate() {
+    if (_triangulator != nullptr) {
+        delete _triangulator;
+        _triangulator = nullptr;
+    }
+    gatherVertices();
+    _voronoi.clear();
+    _dualated = false;
+}
+
 #pragma mark -
 #pragma mark Voronoi
 /**
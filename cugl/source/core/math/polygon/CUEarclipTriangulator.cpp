@@ -36,12 +36,16 @@
 //  Version: 7/3/24 (CUGL 3.0 reorganization)
 //
 #include <cugl/core/math/polygon/CUEarclipTriangulator.h>
+#include <cugl/core/math/polygon/CUTriangulationCache.h>
 #include <cugl/core/math/CUPoly2.h>
 #include <cugl/core/math/CUPath2.h>
 #include <cugl/core/util/CUDebug.h>
 
 using namespace cugl;
 
+/** The tag identifying this triangulator in a TriangulationCache */
+#define CACHE_TAG   1
+
 #pragma mark Support Class
 /**
  * An internal class that manages vertex data
@@ -503,9 +507,23 @@ void EarclipTriangulator::clear() {
 void EarclipTriangulator::calculate() {
     reset();
     if (_exterior > 0) {
+        size_t key = 0;
+        if (_cache != nullptr) {
+            key = TriangulationCache::hash(CACHE_TAG, _input.data(), _input.size(),
+                                           _holes.data(), _holes.size());
+            if (_cache->lookup(key, _input.size(), _output)) {
+                _calculated = true;
+                return;
+            }
+        }
+        
         allocateVertices();
         removeHoles();
         computeTriangles();
+        
+        if (_cache != nullptr) {
+            _cache->store(key, _input.size(), _output);
+        }
     }
     _calculated = true;
 }
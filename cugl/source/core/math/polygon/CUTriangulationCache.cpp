@@ -0,0 +1,275 @@
+//
+//  CUTriangulationCache.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a cache of triangulation results. Triangulation is
+//  an expensive operation (earclipping is O(n^2)), but shapes that are
+//  animated or edited often cycle through the same outlines. This cache
+//  allows a triangulator to skip the calculation when it has seen the
+//  exact same input before.
+//
+//  Entries are keyed by a content hash of the input vertices (and hole
+//  layout), computed with cugl::hashtool. The cache has a fixed capacity,
+//  and evicts the least recently used entry when it is full.
+//
+//  Unlike the triangulators, this class is intended to be shared, and so it
+//  uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty. In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Author: Walker White
+//  Version: 7/3/24 (CUGL 3.0 reorganization)
+//
+#include <cugl/core/math/polygon/CUTriangulationCache.h>
+#include <cugl/core/util/CUHashtools.h>
+#include <cugl/core/util/CUDebug.h>
+
+using namespace cugl;
+
+/** The capacity of the shared triangulation cache */
+#define SHARED_CAPACITY 64
+
+#pragma mark Constructors
+/**
+ * Creates a degenerate triangulation cache with no capacity.
+ *
+ * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an object on
+ * the heap, use one of the static constructors instead.
+ */
+TriangulationCache::TriangulationCache() :
+_capacity(0),
+_hits(0),
+_misses(0) {
+}
+
+/**
+ * Disposes all of the resources used by this cache.
+ *
+ * A disposed cache can be safely reinitialized.
+ */
+void TriangulationCache::dispose() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries.clear();
+    _order.clear();
+    _capacity = 0;
+    _hits = 0;
+    _misses = 0;
+}
+
+/**
+ * Initializes a triangulation cache with the given capacity.
+ *
+ * @param capacity  The maximum number of cached triangulations
+ *
+ * @return true if initialization was successful.
+ */
+bool TriangulationCache::init(size_t capacity) {
+    if (_capacity > 0) {
+        CUAssertLog(false, "Cache is already initialized");
+        return false;
+    } else if (capacity == 0) {
+        CUAssertLog(false, "Cache capacity must be positive");
+        return false;
+    }
+    _capacity = capacity;
+    _entries.reserve(capacity);
+    return true;
+}
+
+/**
+ * Returns the triangulation cache shared by the scene graph classes.
+ *
+ * This cache is allocated on first use, with a capacity of 64 entries.
+ * It is used by classes like {@link scene2::PolygonNode} that
+ * retriangulate every time their shape changes.
+ *
+ * @return the triangulation cache shared by the scene graph classes.
+ */
+std::shared_ptr<TriangulationCache> TriangulationCache::get() {
+    static std::shared_ptr<TriangulationCache> cache = alloc(SHARED_CAPACITY);
+    return cache;
+}
+
+#pragma mark -
+#pragma mark Keys
+/**
+ * Returns the cache key for the given triangulation input.
+ *
+ * The key is a content hash of the vertices and the hole layout, as
+ * computed by {@link hashtool#hash_bytes}. The hole layout is an array
+ * of offset-size pairs into the vertex list, as used by the
+ * triangulators. The type is a tag distinguishing the triangulator that
+ * produced the result.
+ *
+ * @param type      The triangulator type tag
+ * @param vertices  The vertices to triangulate
+ * @param vsize     The number of vertices
+ * @param holes     The hole layout
+ * @param hsize     The number of elements in the hole layout
+ *
+ * @return the cache key for the given triangulation input.
+ */
+size_t TriangulationCache::hash(Uint32 type, const Vec2* vertices, size_t vsize,
+                                const size_t* holes, size_t hsize) {
+    size_t result = 0;
+    size_t points = hashtool::hash_bytes(vertices, vsize*sizeof(Vec2));
+    size_t layout = hsize == 0 ? 0 : hashtool::hash_bytes(holes, hsize*sizeof(size_t));
+    hashtool::hash_combine(result, type, vsize, points, layout);
+    return result;
+}
+
+#pragma mark -
+#pragma mark Cache Access
+/**
+ * Sets the maximum number of entries in this cache.
+ *
+ * If the new capacity is less than the current size, the least recently
+ * used entries are evicted.
+ *
+ * @param capacity  The maximum number of entries in this cache
+ */
+void TriangulationCache::setCapacity(size_t capacity) {
+    CUAssertLog(capacity > 0, "Cache capacity must be positive");
+    std::lock_guard<std::mutex> lock(_mutex);
+    _capacity = capacity;
+    while (_order.size() > _capacity) {
+        _entries.erase(_order.back());
+        _order.pop_back();
+    }
+}
+
+/**
+ * Returns the number of entries in this cache.
+ *
+ * @return the number of entries in this cache.
+ */
+size_t TriangulationCache::size() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _entries.size();
+}
+
+/**
+ * Returns the number of lookups that found an entry.
+ *
+ * @return the number of lookups that found an entry.
+ */
+Uint64 TriangulationCache::getHits() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _hits;
+}
+
+/**
+ * Returns the number of lookups that did not find an entry.
+ *
+ * @return the number of lookups that did not find an entry.
+ */
+Uint64 TriangulationCache::getMisses() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _misses;
+}
+
+/**
+ * Stores the cached triangulation for the given key in the buffer.
+ *
+ * The vertex count guards against hash collisions, as an entry is only
+ * returned if it was triangulated from the same number of vertices. If
+ * there is an entry, its indices replace the contents of the buffer and
+ * the entry is marked as most recently used. Otherwise, the buffer is
+ * unchanged.
+ *
+ * @param key       The cache key
+ * @param vertices  The number of vertices in the input
+ * @param buffer    The buffer to store the indices
+ *
+ * @return true if there was an entry for the given key.
+ */
+bool TriangulationCache::lookup(size_t key, size_t vertices, std::vector<Uint32>& buffer) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto search = _entries.find(key);
+    if (search == _entries.end() || search->second.vertices != vertices) {
+        _misses++;
+        return false;
+    }
+
+    Entry* entry = &(search->second);
+    _order.splice(_order.begin(), _order, entry->position);
+    buffer.assign(entry->indices.begin(), entry->indices.end());
+    _hits++;
+    return true;
+}
+
+/**
+ * Stores the given triangulation in the cache.
+ *
+ * If this cache is full, the least recently used entry is evicted. If
+ * there is already an entry for this key, it is replaced.
+ *
+ * @param key       The cache key
+ * @param vertices  The number of vertices in the input
+ * @param indices   The triangulation indices
+ */
+void TriangulationCache::store(size_t key, size_t vertices, const std::vector<Uint32>& indices) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_capacity == 0) {
+        return;
+    }
+
+    auto search = _entries.find(key);
+    if (search != _entries.end()) {
+        Entry* entry = &(search->second);
+        entry->vertices = vertices;
+        entry->indices = indices;
+        _order.splice(_order.begin(), _order, entry->position);
+        return;
+    }
+
+    while (_order.size() >= _capacity) {
+        _entries.erase(_order.back());
+        _order.pop_back();
+    }
+
+    _order.push_front(key);
+    Entry* entry = &(_entries[key]);
+    entry->vertices = vertices;
+    entry->indices = indices;
+    entry->position = _order.begin();
+}
+
+/**
+ * Removes all entries from this cache.
+ *
+ * This method also resets the hit and miss counts.
+ */
+void TriangulationCache::clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries.clear();
+    _order.clear();
+    _hits = 0;
+    _misses = 0;
+}
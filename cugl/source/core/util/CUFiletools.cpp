@@ -56,6 +56,11 @@
     #include <dirent.h>
 #endif
 
+#if !defined (__WINDOWS__)
+    #include <sys/mman.h>
+    #include <fcntl.h>
+#endif
+
 
 
 namespace cugl {
@@ -1752,5 +1757,103 @@ size_t vol_total_space(const std::string path) {
 #endif
 }
 
+#pragma mark -
+#pragma mark File Mapping
+/**
+ * Returns a read-only memory map of the file for this path name.
+ *
+ * The contents of the file are paged in by the operating system as they
+ * are accessed, so there is no need to copy them into a buffer. The size
+ * of the map is stored in the size parameter. The map must be released
+ * with {@link file_unmap} when it is no longer needed.
+ *
+ * This function only maps files with an absolute path name. It returns
+ * nullptr if the path is relative (e.g. an Android asset, which is stored
+ * in a compressed archive), if the file is empty, or if the platform does
+ * not support memory mapping. In that case, the file should be read with
+ * an SDL stream instead.
+ *
+ * @param path  The file path name
+ * @param size  The variable to store the size of the map
+ *
+ * @return a read-only memory map of the file for this path name.
+ */
+const char* file_map(const std::string path, size_t& size) {
+    size = 0;
+    if (!is_absolute(path)) {
+        return nullptr;
+    }
+    
+    std::string fullpath = normalize_path(path);
+#if defined (__WINDOWS__)
+    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+    std::wstring wide = converter.from_bytes(fullpath);
+    HANDLE file = CreateFileW(wide.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return nullptr;
+    }
+    
+    LARGE_INTEGER length;
+    if (!GetFileSizeEx(file, &length) || length.QuadPart <= 0) {
+        CloseHandle(file);
+        return nullptr;
+    }
+    
+    // The view keeps the mapping alive after the handles are closed
+    HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (mapping == NULL) {
+        return nullptr;
+    }
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (data == NULL) {
+        return nullptr;
+    }
+    size = (size_t)length.QuadPart;
+    return (const char*)data;
+#else
+    int file = open(fullpath.c_str(), O_RDONLY);
+    if (file < 0) {
+        return nullptr;
+    }
+    
+    struct stat status;
+    if (fstat(file, &status) != 0 || !S_ISREG(status.st_mode) || status.st_size <= 0) {
+        ::close(file);
+        return nullptr;
+    }
+    
+    // The map keeps the file alive after it is closed
+    void* data = mmap(NULL, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    ::close(file);
+    if (data == MAP_FAILED) {
+        return nullptr;
+    }
+    size = (size_t)status.st_size;
+    return (const char*)data;
+#endif
+}
+
+/**
+ * Releases a memory map created by {@link file_map}.
+ *
+ * Any pointers into the map are invalid after this function is called.
+ *
+ * @param data  The memory map
+ * @param size  The size of the memory map
+ */
+void file_unmap(const char* data, size_t size) {
+    if (data == nullptr) {
+        return;
+    }
+#if defined (__WINDOWS__)
+    UnmapViewOfFile(data);
+#else
+    munmap((void*)data, size);
+#endif
+}
+
 }
 }
@@ -31,6 +31,7 @@
 #include <cugl/core/util/CUHashtools.h>
 #include <cugl/core/util/CUDebug.h>
 #include <random>
+#include <string_view>
 #include <stduuid/uuid.h>
 #include <SDL_app.h>
 
@@ -39,6 +40,26 @@
 
 // String for Base 64 conversion
 #define BASE64_ALPHA "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"
+
+/**
+ * Returns a hash code for the given block of memory
+ *
+ * This function hashes the raw bytes of the data, and so it should only be
+ * used on plain data such as vertex or index arrays. Note that this means
+ * that values equal as floats (such as 0 and -0) may have different hashes.
+ * It is intended for content-based cache keys, like those used by
+ * {@link TriangulationCache}.
+ *
+ * @param data  The data to hash
+ * @param size  The number of bytes to hash
+ *
+ * @return a hash code for the given block of memory
+ */
+std::size_t cugl::hashtool::hash_bytes(const void* data, size_t size) {
+    std::hash<std::string_view> hasher;
+    return hasher(std::string_view((const char*)data,size));
+}
+
 /**
  * Returns a text representation of the given binary data in Base 64
  *
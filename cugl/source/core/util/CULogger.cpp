@@ -42,11 +42,19 @@
 #include <cstring>
 #include <iomanip>
 #include <sstream>
+#include <algorithm>
 
 using namespace cugl;
 
 // The buffer size allocated for time stampes
 #define STAMP_SIZE 64
+// The inline text capacity of an asynchronous log record
+#define RECORD_SIZE 232
+// The maximum time (in milliseconds) the background writer sleeps
+#define DRAIN_INTERVAL 10
+
+/** The next serial number to assign a logger session */
+static std::atomic<uint64_t> _nextserial(1);
 
 /** The list of all active logs */
 std::unordered_map<std::string, std::shared_ptr<Logger>> Logger::_channels;
@@ -118,8 +126,8 @@ static SDL_LogPriority level2sdl(Logger::Level level) {
  *
  * @return the length of the string written to the buffer
  */
-static size_t stamp_time(char* buffer, size_t size) {
-    auto now = std::chrono::system_clock::now();
+static size_t stamp_time(char* buffer, size_t size,
+                         std::chrono::system_clock::time_point now) {
     auto micro = std::chrono::duration_cast<std::chrono::microseconds>(now.time_since_epoch()) % 1000000;
 
     auto timer = std::chrono::system_clock::to_time_t(now);
@@ -136,6 +144,94 @@ static size_t stamp_time(char* buffer, size_t size) {
     return limit;
 }
 
+/**
+ * Stores the current time stamp in the given buffer.
+ *
+ * The times stamp includes the date and time up to the nearest microsecond.
+ *
+ * @param buffer    The buffer to store the time stamp
+ * @param size      The size of the buffer
+ *
+ * @return the length of the string written to the buffer
+ */
+static size_t stamp_time(char* buffer, size_t size) {
+    return stamp_time(buffer, size, std::chrono::system_clock::now());
+}
+
+#pragma mark -
+#pragma mark Asynchronous Rings
+/**
+ * A single message pending in an asynchronous log ring.
+ *
+ * Short messages are formatted directly into the record. Messages that are
+ * too long spill to the heap, and are freed by the background writer.
+ */
+typedef struct {
+    /** The level to write to the file (NO_MSG to skip) */
+    Logger::Level flevel;
+    /** The level to write to the console (NO_MSG to skip) */
+    Logger::Level clevel;
+    /** The time at which the message was logged */
+    std::chrono::system_clock::time_point time;
+    /** The heap allocated message text (if too long for the record) */
+    char* spill;
+    /** The inline message text */
+    char text[RECORD_SIZE];
+} LogRecord;
+
+/**
+ * A single-producer, single-consumer ring of pending log messages.
+ *
+ * Each thread that logs asynchronously owns exactly one ring per logger. The
+ * producer (the logging thread) only advances the head, while the consumer
+ * (the background writer) only advances the tail. Hence no locks are needed
+ * to enqueue a message.
+ */
+class Logger::Ring {
+public:
+    /** The message slots (capacity is a power of two) */
+    LogRecord* slots;
+    /** The capacity mask */
+    size_t mask;
+    /** The next slot to write (owned by the producer) */
+    alignas(64) std::atomic<size_t> head;
+    /** The next slot to read (owned by the consumer) */
+    alignas(64) std::atomic<size_t> tail;
+    
+    /**
+     * Creates a ring with the given capacity (a power of two)
+     *
+     * @param capacity  The ring capacity
+     */
+    Ring(size_t capacity) : mask(capacity-1), head(0), tail(0) {
+        slots = new LogRecord[capacity];
+    }
+    
+    /**
+     * Deletes this ring, releasing any spilled messages
+     */
+    ~Ring() {
+        size_t last = head.load(std::memory_order_acquire);
+        for(size_t ii = tail.load(std::memory_order_relaxed); ii != last; ii++) {
+            if (slots[ii & mask].spill) {
+                std::free(slots[ii & mask].spill);
+            }
+        }
+        delete[] slots;
+    }
+};
+
+/**
+ * Returns the message text of a log record
+ *
+ * @param record    The log record
+ *
+ * @return the message text of a log record
+ */
+static inline const char* record_text(const LogRecord* record) {
+    return record->spill ? record->spill : record->text;
+}
+
 #pragma mark -
 #pragma mark Constructors
 /**
@@ -150,7 +246,13 @@ _consLevel(Level::NO_MSG),
 _buffer(nullptr),
 _capacity(0),
 _autof(false),
-_open(false) {
+_open(false),
+_async(false),
+_ringsize(0),
+_serial(0),
+_worker(nullptr),
+_active(false),
+_pending(false) {
 }
 
 /**
@@ -159,7 +261,20 @@ _open(false) {
  * A disposed logger can be safely reinitialized.
  */
 void Logger::dispose() {
-    _writer->close();
+    stopWorker();
+    if (_writer != nullptr) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        drain();
+    }
+    for(auto it = _rings.begin(); it != _rings.end(); ++it) {
+        delete *it;
+    }
+    _rings.clear();
+    _async  = false;
+    _serial = 0;
+    if (_writer != nullptr) {
+        _writer->close();
+    }
     _writer = nullptr;
     _open  = false;
     _autof = false;
@@ -198,6 +313,7 @@ bool Logger::init(const std::string channel, Level level) {
     _fileLevel = level;
     if (_writer != nullptr) {
         _open = true;
+        _serial = _nextserial++;
         _capacity = 256;
         _buffer = (char*)std::malloc(_capacity*sizeof(char));
         _category = _nextcategory++;
@@ -351,6 +467,7 @@ bool Logger::close(const std::string channel) {
  */
 void Logger::setLogLevel(Level level) {
     if (_open) {
+        std::lock_guard<std::mutex> lock(_mutex);
         _writer->flush();
         _fileLevel = level;
     }
@@ -391,6 +508,7 @@ void Logger::setConsoleLevel(Level level) {
  */
 void Logger::setAutoFlush(bool value) {
     if (_open) {
+        std::lock_guard<std::mutex> lock(_mutex);
         _autof = value;
         if (value) {
             _writer->flush();
@@ -398,6 +516,229 @@ void Logger::setAutoFlush(bool value) {
     }
 }
 
+/**
+ * Sets whether this logger writes messages asynchronously.
+ *
+ * An asynchronous logger formats each message into a lock-free ring
+ * buffer owned by the calling thread. A background thread then writes
+ * these messages to the file (and console) in batches. This makes the
+ * cost of logging on the calling thread independent of file I/O.
+ *
+ * The capacity is the number of messages each thread can have pending
+ * before it must wait on the background thread. It is rounded up to a
+ * power of two. Disabling asynchronous mode writes all pending messages
+ * before returning.
+ *
+ * @param value     Whether this logger writes messages asynchronously
+ * @param capacity  The number of pending messages per thread
+ */
+void Logger::setAsync(bool value, size_t capacity) {
+    if (!_open || value == _async) {
+        return;
+    }
+    
+    if (value) {
+        size_t size = 2;
+        while (size < capacity) {
+            size *= 2;
+        }
+        _ringsize = size;
+        _async = true;
+        startWorker();
+    } else {
+        // Rings persist (threads cache them) until the logger is disposed
+        _async = false;
+        stopWorker();
+    }
+}
+
+#pragma mark -
+#pragma mark Asynchronous Logging
+/**
+ * Returns the message ring for the current thread.
+ *
+ * The ring is allocated (and registered with this logger) the first
+ * time a thread logs a message in asynchronous mode.
+ *
+ * @return the message ring for the current thread.
+ */
+Logger::Ring* Logger::acquireRing() {
+    // Logger sessions have unique serials, so stale entries never match
+    thread_local std::vector<std::pair<uint64_t,Ring*>> cache;
+    for(auto it = cache.begin(); it != cache.end(); ++it) {
+        if (it->first == _serial) {
+            return it->second;
+        }
+    }
+    
+    Ring* ring = new Ring(_ringsize);
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _rings.push_back(ring);
+    }
+    cache.push_back(std::make_pair(_serial,ring));
+    return ring;
+}
+
+/**
+ * Enqueues a message for the background thread.
+ *
+ * The message is formatted immediately into the ring buffer of the
+ * calling thread, but the time stamp formatting and all file I/O are
+ * deferred to the background thread. If the ring is full, this method
+ * will wake up the background thread and wait for space.
+ *
+ * @param flevel    The level to write to the file (NO_MSG to skip)
+ * @param clevel    The level to write to the console (NO_MSG to skip)
+ * @param format    The formatting string
+ * @param args      The printf-style subsitution arguments
+ */
+void Logger::enqueue(Level flevel, Level clevel, const char* format, va_list args) {
+    if (flevel == Level::NO_MSG && clevel == Level::NO_MSG) {
+        return;
+    }
+    
+    Ring* ring = acquireRing();
+    size_t head = ring->head.load(std::memory_order_relaxed);
+    while (head-ring->tail.load(std::memory_order_acquire) > ring->mask) {
+        _pending.store(true,std::memory_order_relaxed);
+        _wakeup.notify_one();
+        std::this_thread::yield();
+    }
+    
+    LogRecord* record = ring->slots+(head & ring->mask);
+    record->flevel = flevel;
+    record->clevel = clevel;
+    record->time = std::chrono::system_clock::now();
+    record->spill = nullptr;
+    
+    va_list copy;
+    va_copy(copy, args);
+    int size = vsnprintf(record->text, RECORD_SIZE, format, args);
+    if (size >= RECORD_SIZE) {
+        record->spill = (char*)std::malloc((size+1)*sizeof(char));
+        if (record->spill) {
+            vsnprintf(record->spill, size+1, format, copy);
+        }
+    }
+    va_end(copy);
+    
+    ring->head.store(head+1,std::memory_order_release);
+    if (head-ring->tail.load(std::memory_order_relaxed) >= ring->mask/2) {
+        _pending.store(true,std::memory_order_relaxed);
+        _wakeup.notify_one();
+    }
+}
+
+/**
+ * Writes all pending asynchronous messages to the file and console.
+ *
+ * Messages from different threads are merged in time stamp order. The
+ * file is flushed once at the end of the batch. This method assumes that
+ * the caller holds the logger mutex.
+ */
+void Logger::drain() {
+    if (_rings.empty()) {
+        return;
+    }
+    
+    std::vector<std::pair<LogRecord*,size_t>> batch;
+    std::vector<size_t> stops;
+    stops.reserve(_rings.size());
+    for(size_t ii = 0; ii < _rings.size(); ii++) {
+        Ring* ring = _rings[ii];
+        size_t last = ring->head.load(std::memory_order_acquire);
+        for(size_t jj = ring->tail.load(std::memory_order_relaxed); jj != last; jj++) {
+            batch.push_back(std::make_pair(ring->slots+(jj & ring->mask),ii));
+        }
+        stops.push_back(last);
+    }
+    
+    if (batch.empty()) {
+        return;
+    }
+    
+    std::stable_sort(batch.begin(), batch.end(),
+                     [](const std::pair<LogRecord*,size_t>& a,
+                        const std::pair<LogRecord*,size_t>& b) {
+        return a.first->time < b.first->time;
+    });
+    
+    bool written = false;
+    for(auto it = batch.begin(); it != batch.end(); ++it) {
+        LogRecord* record = it->first;
+        const char* text = record_text(record);
+        if (record->flevel != Level::NO_MSG) {
+            stamp_time(_timestamp,STAMP_SIZE,record->time);
+            _writer->write(_timestamp);
+            _writer->write(' ');
+            _writer->write(level2name(record->flevel));
+            _writer->write(": [");
+            _writer->write(_name);
+            _writer->write("] ");
+            _writer->write(text);
+            _writer->write('\n');
+            written = true;
+        }
+        if (record->clevel != Level::NO_MSG) {
+            SDL_LogMessage(SDL_LOG_CATEGORY_CUSTOM, level2sdl(record->clevel),
+                           "[%s] %s",_name.c_str(),text);
+        }
+        if (record->spill) {
+            std::free(record->spill);
+            record->spill = nullptr;
+        }
+    }
+    
+    for(size_t ii = 0; ii < _rings.size(); ii++) {
+        _rings[ii]->tail.store(stops[ii],std::memory_order_release);
+    }
+    
+    if (written && _autof) {
+        _writer->flush();
+    }
+}
+
+/**
+ * Starts the background thread for asynchronous logging.
+ */
+void Logger::startWorker() {
+    if (_worker) {
+        return;
+    }
+    _active.store(true);
+    _worker = new std::thread([this]() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (_active.load()) {
+            _wakeup.wait_for(lock, std::chrono::milliseconds(DRAIN_INTERVAL), [this] {
+                return !_active.load() || _pending.load(std::memory_order_relaxed);
+            });
+            _pending.store(false,std::memory_order_relaxed);
+            drain();
+        }
+        drain();
+        _writer->flush();
+    });
+}
+
+/**
+ * Stops the background thread, writing any pending messages.
+ */
+void Logger::stopWorker() {
+    if (!_worker) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _active.store(false);
+    }
+    _wakeup.notify_all();
+    _worker->join();
+    delete _worker;
+    _worker = nullptr;
+}
+
+#pragma mark -
 #pragma mark Message Logging
 /**
  * Sends a message to this logger.
@@ -419,6 +760,14 @@ void Logger::log(const std::string format, ...) {
     }
     
     va_list args;
+    if (_async) {
+        va_start (args, format);
+        enqueue(_fileLevel, _consLevel, format.c_str(), args);
+        va_end(args);
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(_mutex);
     va_start (args, format);
     size_t size = vsnprintf(nullptr, 0, format.c_str(), args)+1;
     va_end(args);
@@ -475,6 +824,14 @@ void Logger::log(const char* format, ...) {
     }
 
     va_list args;
+    if (_async) {
+        va_start (args, format);
+        enqueue(_fileLevel, _consLevel, format, args);
+        va_end(args);
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(_mutex);
     va_start (args, format);
     size_t size = vsnprintf(nullptr, 0, format, args)+1;
     va_end(args);
@@ -531,6 +888,25 @@ void Logger::log(Level level, const std::string format, ...) {
     }
 
     va_list args;
+    if (_async) {
+        Level flevel = Level::NO_MSG;
+        Level clevel = Level::NO_MSG;
+        if ((int)_fileLevel > (int)Level::NO_MSG &&
+            (int)level > (int)Level::NO_MSG &&
+            (int)level <= (int)_fileLevel) {
+            flevel = level;
+        }
+        if ((int)_consLevel > (int)Level::NO_MSG &&
+            (int)level > (int)Level::NO_MSG) {
+            clevel = level;
+        }
+        va_start (args, format);
+        enqueue(flevel, clevel, format.c_str(), args);
+        va_end(args);
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(_mutex);
     va_start (args, format);
     size_t size = vsnprintf(nullptr, 0, format.c_str(), args)+_name.size()+4;
     va_end(args);
@@ -590,6 +966,25 @@ void Logger::log(Level level, const char* format, ...) {
     }
 
     va_list args;
+    if (_async) {
+        Level flevel = Level::NO_MSG;
+        Level clevel = Level::NO_MSG;
+        if ((int)_fileLevel > (int)Level::NO_MSG &&
+            (int)level > (int)Level::NO_MSG &&
+            (int)level <= (int)_fileLevel) {
+            flevel = level;
+        }
+        if ((int)_consLevel > (int)Level::NO_MSG &&
+            (int)level > (int)Level::NO_MSG) {
+            clevel = level;
+        }
+        va_start (args, format);
+        enqueue(flevel, clevel, format, args);
+        va_end(args);
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(_mutex);
     va_start (args, format);
     size_t size = vsnprintf(nullptr, 0, format, args)+_name.size()+4;
     va_end(args);
@@ -635,9 +1030,14 @@ void Logger::log(Level level, const char* format, ...) {
  * Otherwise, the file is written after every message. To improve
  * performance, you may wish to disable auto flush if you are writting a
  * large number of messages per animation frame.
+ *
+ * If the logger is asynchronous, this method also writes all messages
+ * still pending in the thread ring buffers.
  */
 void Logger::flush() {
     if (_open) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        drain();
         _writer->flush();
     }
 }
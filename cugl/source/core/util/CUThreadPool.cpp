@@ -103,6 +103,7 @@ void ThreadPool::threadFunc() {
         }
         // Perform the current task
         task();
+        _pending--;
     }
     _complete++;
 }
@@ -135,6 +136,7 @@ int ThreadPool::sdlThreadFunc(void* ptr) {
         }
         // Perform the current task
         task();
+        self->_pending--;
     }
     self->_complete++;
     return 0;
@@ -156,6 +158,7 @@ int ThreadPool::sdlThreadFunc(void* ptr) {
  */
 void ThreadPool::addTask(const std::function<void()> &task){
     std::unique_lock<std::mutex> lk(_queueMutex);
+    _pending++;
     _taskQueue.emplace(task);
     _taskCondition.notify_one();
 }
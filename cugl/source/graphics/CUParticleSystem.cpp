@@ -62,10 +62,19 @@
 //
 #include <cugl/graphics/CUParticleSystem.h>
 #include <cugl/graphics/CUInstanceBuffer.h>
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
 
 using namespace cugl;
 using namespace cugl::graphics;
 
+/** The number of particles simulated by a single task */
+#define UPDATE_BLOCK    1024
+/** The number of bits in a radix sort digit */
+#define RADIX_BITS      8
+
 #pragma mark Particle Vertex
 /**
  * Creates a new ParticleVertex from the given JSON value.
@@ -201,6 +210,66 @@ ParticleEmitter::ParticleEmitter(const std::shared_ptr<JsonValue>& data) {
     if (interval < 0) { interval = 0; }
 }
 
+#pragma mark -
+#pragma mark Update State
+/**
+ * The shared state of a parallel particle update.
+ *
+ * This state is shared (via a shared pointer) by the particle system and
+ * every task that it submits to the thread pool. A task that is still
+ * waiting in the pool after the update is complete finds no blocks left to
+ * claim, so it never touches the particle system again.
+ */
+class ParticleSystem::Update {
+public:
+    /** The particle system being updated */
+    ParticleSystem* system;
+    /** The time passed in the simulation */
+    float delta;
+    /** The camera position in world space */
+    Vec3 camera;
+    /** The number of particles to simulate */
+    size_t size;
+    /** The number of blocks of particles */
+    size_t blocks;
+    /** The index of the next block to claim */
+    std::atomic<size_t> next;
+    /** The number of blocks not yet simulated */
+    size_t remaining;
+    /** The mutex protecting the remaining count */
+    std::mutex mutex;
+    /** The condition signaled when the remaining count reaches 0 */
+    std::condition_variable done;
+    
+    /**
+     * Creates an empty update state
+     */
+    Update() : system(nullptr), delta(0), size(0), blocks(0), next(0), remaining(0) {}
+    
+    /**
+     * Simulates blocks until there are none left to claim.
+     *
+     * This method is called by the updating thread and every worker thread.
+     */
+    void run() {
+        size_t count = 0;
+        size_t pos;
+        while ((pos = next.fetch_add(1)) < blocks) {
+            size_t begin = pos*UPDATE_BLOCK;
+            system->simulate(begin, std::min(begin+UPDATE_BLOCK,size), delta, camera);
+            count++;
+        }
+        
+        if (count > 0) {
+            std::lock_guard<std::mutex> lock(mutex);
+            remaining -= count;
+            if (remaining == 0) {
+                done.notify_all();
+            }
+        }
+    }
+};
+
 #pragma mark -
 #pragma mark Particle System
 
@@ -218,7 +287,8 @@ _capacity(0),
 _allocated(0),
 _greedy(false),
 _oldest(0),
-_is2d(false) {}
+_is2d(false),
+_sorted(true) {}
 
 /**
  * Disposes the emitters and allocation lists for this particle system.
@@ -238,7 +308,11 @@ void ParticleSystem::dispose() {
         _allocated = 0;
         _greedy = false;
         _is2d = false;
+        _sorted = true;
         _oldest = 0;
+        _sortKeys.clear();
+        _threads = nullptr;
+        _update = nullptr;
     }
 }
 
@@ -482,63 +556,55 @@ void ParticleSystem::removeEmitter(const std::string key) {
  *
  * Most of the work of this method is implemented by the particle class.
  * This method manages particle emission (with delay) and camera distance.
+ * Dead particles are removed without changing the order of the others.
+ * The instances are then sorted by camera distance, unless this system
+ * is 2d or unsorted (see {@link #setSorted}).
  *
  * @param delta     The time passed in the simulation
  * @param camera    The camera position in world space
  */
 void ParticleSystem::update(float delta, const Vec3 camera) {
-    // Compute the camera location with respect to this system
-    float step;
-
     _duration += delta;
     emit(delta);
     
     // Now update the particles
-    size_t offset = 0;
-    for(size_t pos = 0; pos < _allocated; pos++) {
-        Particle3& curr = _particles[pos];
-
-        // Step forward in time
-        step = delta-curr.delay;
-        curr.life -= step;
-        
-        bool dispose = curr.life <= 0.0f;
-        if (!dispose && _updater != nullptr) {
-            if (_updater(step, &curr, _instances+offset)) {
-                // Update the camera distance
-                Vec4 vector = _instances[offset].position;
-                Vec3 position(vector.x,vector.y,vector.z);
-                curr.distance = (position-camera).lengthSquared();
-                _instances[offset++].distance = curr.distance;
-            } else {
-                dispose = true;
-            }
+    size_t blocks = (_allocated+UPDATE_BLOCK-1)/UPDATE_BLOCK;
+    if (_threads == nullptr || blocks < 2) {
+        simulate(0, _allocated, delta, camera);
+    } else {
+        // A task from a previous update may still hold the old state
+        if (_update == nullptr || _update.use_count() > 1) {
+            _update = std::make_shared<Update>();
         }
+        std::shared_ptr<Update> state = _update;
+        state->system = this;
+        state->delta  = delta;
+        state->camera = camera;
+        state->size   = _allocated;
+        state->blocks = blocks;
+        state->next = 0;
+        state->remaining = blocks;
         
-        if (dispose) {
-            if (_deallocator) {
-                _deallocator(&curr);
-            }
-            // Put the particle at the end
-            curr.distance = -1.0f;
+        size_t tasks = std::min((size_t)_threads->getThreadCount(), blocks-1);
+        for(size_t ii = 0; ii < tasks; ii++) {
+            _threads->addTask([state]() { state->run(); });
         }
-
-        curr.delay = 0;
-    }
         
-    std::sort(_particles,_particles+_allocated,[](const Particle3 &a, const Particle3 &b) {
-        return a.distance > b.distance;
-    });
-
+        // Do not wait on tasks that no worker has started
+        state->run();
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->done.wait(lock, [&]() { return state->remaining == 0; });
+    }
+    
+    size_t alive = compact(_allocated);
+    
     // Only sort the instances if not 2d
-    if (!_is2d) {
-        std::sort(_instances,_instances+offset,[](const ParticleInstance &a, const ParticleInstance &b) {
-            return a.distance > b.distance;
-        });
+    if (!_is2d && _sorted) {
+        sort(alive);
     }
     
     // Reset any changes used for greedy allocation
-    _allocated = offset;
+    _allocated = alive;
     _greedy = false;
     _oldest = 0;
 
@@ -621,6 +687,148 @@ Particle3& ParticleSystem::allocate() {
 }
 
 
+/**
+ * Simulates the particles in the given range.
+ *
+ * This method advances the life of each particle and calls the updater,
+ * which writes the instance with the same index. It then computes the
+ * camera distance. Dead particles (and their instances) are given a
+ * distance of -1. This method only touches the given range, so disjoint
+ * ranges may be simulated in parallel.
+ *
+ * @param begin     The first particle to simulate
+ * @param end       The particle after the last one to simulate
+ * @param delta     The time passed in the simulation
+ * @param camera    The camera position in world space
+ */
+void ParticleSystem::simulate(size_t begin, size_t end, float delta, const Vec3 camera) {
+    for(size_t pos = begin; pos < end; pos++) {
+        Particle3& curr = _particles[pos];
+        ParticleInstance& inst = _instances[pos];
+
+        // Step forward in time
+        float step = delta-curr.delay;
+        curr.life -= step;
+        curr.delay = 0;
+        
+        if (curr.life > 0.0f && _updater != nullptr && _updater(step, &curr, &inst)) {
+            // Update the camera distance
+            float dx = inst.position.x-camera.x;
+            float dy = inst.position.y-camera.y;
+            float dz = inst.position.z-camera.z;
+            curr.distance = dx*dx+dy*dy+dz*dz;
+        } else {
+            curr.distance = -1.0f;
+        }
+        inst.distance = curr.distance;
+    }
+}
+
+/**
+ * Removes the dead particles, returning the number left.
+ *
+ * This is a stable partition of the particles and instances. The live
+ * particles keep their relative order, and the dead particles are moved
+ * to the end (after they are passed to the deallocator).
+ *
+ * @param size  The number of particles to compact
+ *
+ * @return the number of live particles
+ */
+size_t ParticleSystem::compact(size_t size) {
+    size_t alive = 0;
+    for(size_t pos = 0; pos < size; pos++) {
+        Particle3& curr = _particles[pos];
+        if (curr.distance < 0.0f) {
+            if (_deallocator) {
+                _deallocator(&curr);
+            }
+            continue;
+        }
+        if (alive != pos) {
+            std::swap(_particles[alive], curr);
+            _instances[alive] = _instances[pos];
+        }
+        alive++;
+    }
+    return alive;
+}
+
+/**
+ * Sorts the particles and instances from furthest to nearest.
+ *
+ * This is a radix sort on the bits of the (squared) camera distance,
+ * which are ordered like the distance itself since it is never negative.
+ * The particles are permuted together with their instances.
+ *
+ * @param size  The number of particles to sort
+ */
+void ParticleSystem::sort(size_t size) {
+    if (size < 2) {
+        return;
+    }
+    if (_sortKeys.size() < 2*size) {
+        _sortKeys.resize(2*_capacity);
+    }
+    
+    // The high word is the key (inverted for descending order), the low the index
+    Uint64* src = _sortKeys.data();
+    Uint64* dst = src+size;
+    for(size_t ii = 0; ii < size; ii++) {
+        Uint32 bits;
+        std::memcpy(&bits, &_instances[ii].distance, sizeof(Uint32));
+        src[ii] = ((Uint64)(~bits) << 32) | ii;
+    }
+    
+    const size_t radix = 1 << RADIX_BITS;
+    size_t count[radix];
+    for(int shift = 32; shift < 64; shift += RADIX_BITS) {
+        std::fill(count, count+radix, 0);
+        for(size_t ii = 0; ii < size; ii++) {
+            count[(src[ii] >> shift) & (radix-1)]++;
+        }
+        
+        // Skip digits shared by every key
+        if (count[(src[0] >> shift) & (radix-1)] == size) {
+            continue;
+        }
+        
+        size_t offset = 0;
+        for(size_t ii = 0; ii < radix; ii++) {
+            size_t amount = count[ii];
+            count[ii] = offset;
+            offset += amount;
+        }
+        for(size_t ii = 0; ii < size; ii++) {
+            dst[count[(src[ii] >> shift) & (radix-1)]++] = src[ii];
+        }
+        std::swap(src,dst);
+    }
+    
+    // Apply the permutation in place, one cycle at a time
+    const Uint64 mask = 0xFFFFFFFF00000000ULL;
+    for(size_t ii = 0; ii < size; ii++) {
+        size_t next = (Uint32)src[ii];
+        if (next == ii) {
+            continue;
+        }
+        
+        Particle3 part = _particles[ii];
+        ParticleInstance inst = _instances[ii];
+        size_t curr = ii;
+        while (next != ii) {
+            _particles[curr] = _particles[next];
+            _instances[curr] = _instances[next];
+            src[curr] = (src[curr] & mask) | curr;
+            curr = next;
+            next = (Uint32)src[curr];
+        }
+        _particles[curr] = part;
+        _instances[curr] = inst;
+        src[curr] = (src[curr] & mask) | curr;
+    }
+}
+
 /**
  * Allocates the instance buffer for this particle system
  */
@@ -47,6 +47,7 @@
 #include <cugl/core/math/cu_math.h>
 #include <cugl/graphics/CUSpriteBatch.h>
 #include <cugl/graphics/CUVertexBuffer.h>
+#include <cugl/graphics/CUInstanceBuffer.h>
 #include <cugl/graphics/CUTexture.h>
 #include <cugl/graphics/CUShader.h>
 #include <cugl/graphics/CUFont.h>
@@ -85,6 +86,13 @@ using namespace cugl::graphics;
 
 #pragma mark PIPELINE FLAGS
 
+/** The number of vertex buffer regions in streaming mode */
+#define STREAM_REGIONS  3
+/** The number of drawing contexts preallocated in the arena */
+#define CONTEXT_RESERVE 32
+/** The distance (in floats) between vertex positions (position is the first attribute) */
+#define VERTEX_STRIDE   (sizeof(SpriteVertex)/sizeof(float))
+
 /** The drawing type for a textured mesh */
 #define TYPE_TEXTURE    1
 /** The drawing type for a gradient mesh */
@@ -176,14 +184,16 @@ public:
     Context() {
         first = 0;
         last  = 0;
+        ifirst = 0;
+        ilast  = 0;
+        instanced = false;
         command  = GL_TRIANGLES;
         blendEq  = GL_FUNC_ADD;
         srcRGB   = GL_SRC_ALPHA;
         srcAlpha = GL_SRC_ALPHA;
         dstRGB   = GL_ONE_MINUS_SRC_ALPHA;
         dstAlpha = GL_ONE_MINUS_SRC_ALPHA;
-        perspective = std::make_shared<Mat4>();
-        perspective->setIdentity();
+        perspective.setIdentity();
         stencil  = StencilEffect::NATIVE;
         cleared  = STENCIL_NONE;
         texture  = nullptr;
@@ -200,8 +210,30 @@ public:
      * @param copy  The uniforms to copy
      */
     Context(Context* copy) {
+        set(copy);
+    }
+    
+    /**
+     * Disposes this collection of uniforms
+     */
+    ~Context() {
+        release();
+    }
+    
+    /**
+     * Sets this context to be a copy of the given uniforms
+     *
+     * This is the recording copy, so the stencil clear, the dirty bits, and
+     * the uniform block push are NOT copied.
+     *
+     * @param copy  The uniforms to copy
+     */
+    void set(Context* copy) {
         first = copy->first;
         last  = copy->last;
+        ifirst = copy->ifirst;
+        ilast  = copy->ilast;
+        instanced = copy->instanced;
         type  = copy->type;
         command  = copy->command;
         blendEq  = copy->blendEq;
@@ -220,18 +252,23 @@ public:
     }
     
     /**
-     * Disposes this collection of uniforms
+     * Releases the resources held by this collection of uniforms
+     *
+     * This allows a recycled context to let go of its texture while it
+     * waits in the arena.
      */
-    ~Context() {
+    void release() {
         first = 0;
         last  = 0;
+        ifirst = 0;
+        ilast  = 0;
+        instanced = false;
         command  = GL_FALSE;
         blendEq  = GL_FALSE;
         srcRGB   = GL_FALSE;
         srcAlpha = GL_FALSE;
         dstRGB   = GL_FALSE;
         dstAlpha = GL_FALSE;
-        perspective = nullptr;
         stencil  = StencilEffect::NATIVE;
         cleared  = STENCIL_NONE;
         texture  = nullptr;
@@ -251,14 +288,16 @@ public:
         }
         first = 0;
         last  = 0;
+        ifirst = 0;
+        ilast  = 0;
+        instanced = false;
         command  = GL_TRIANGLES;
         blendEq  = GL_FUNC_ADD;
         srcRGB   = GL_SRC_ALPHA;
         srcAlpha = GL_SRC_ALPHA;
         dstRGB   = GL_ONE_MINUS_SRC_ALPHA;
         dstAlpha = GL_ONE_MINUS_SRC_ALPHA;
-        perspective = std::make_shared<Mat4>();
-        perspective->setIdentity();
+        perspective.setIdentity();
         stencil  = StencilEffect::NATIVE;
         cleared  = STENCIL_NONE;
         texture  = nullptr;
@@ -273,6 +312,12 @@ public:
     GLuint first;
     /** The last vertex index position for this set of uniforms */
     GLuint last;
+    /** The first instance position for this set of uniforms */
+    GLuint ifirst;
+    /** The last instance position for this set of uniforms */
+    GLuint ilast;
+    /** Whether this context draws instanced quads instead of vertices */
+    bool instanced;
     /** The drawing type for the shader */
     GLint type;
     /** The stored drawing command */
@@ -292,7 +337,7 @@ public:
     /** The stencil buffer to clear */
     GLenum cleared;
     /** The stored perspective matrix */
-    std::shared_ptr<Mat4> perspective;
+    Mat4 perspective;
     /** The stored texture */
     std::shared_ptr<Texture> texture;
     /** The radius for our blur function */
@@ -305,6 +350,33 @@ public:
     bool pushed;
 };
 
+#pragma mark -
+#pragma mark Instance
+/**
+ * A class storing the attributes of a single instanced quad.
+ *
+ * The quad is the unit square transformed by matrix and offset, so the
+ * rectangle origin and size are folded into the transform. This is 44
+ * bytes per quad, compared to 136 bytes for four {@link SpriteVertex}
+ * values and six indices.
+ */
+class SpriteBatch::Instance {
+public:
+    /** The columns of the linear transform (scaled by the quad size) */
+    GLfloat matrix[4];
+    /** The translation of the quad origin */
+    GLfloat offset[2];
+    /** The texture coordinates as minS, minT, maxS, maxT */
+    GLfloat texrect[4];
+    /** The packed quad color */
+    GLuint  color;
+};
+
+/** The corners of the template quad for instancing */
+static const GLfloat QUAD_CORNERS[8] = { 0, 0, 1, 0, 1, 1, 0, 1 };
+/** The indices of the template quad for instancing */
+static const GLuint  QUAD_INDICES[6] = { 0, 1, 2, 0, 2, 3 };
+
 #pragma mark -
 #pragma mark Constructors
 /**
@@ -317,17 +389,28 @@ _initialized(false),
 _active(false),
 _inflight(false),
 _vertData(nullptr),
+_vertLocal(nullptr),
 _indxData(nullptr),
+_indxLocal(nullptr),
 _color(Color4f::WHITE),
 _context(nullptr),
 _vertMax(0),
 _vertSize(0),
 _indxMax(0),
 _indxSize(0),
+_instData(nullptr),
+_instMax(0),
+_instSize(0),
+_instancing(false),
+_instready(false),
+_streaming(false),
+_arenaSize(0),
 _vertTotal(0),
-_callTotal(0) {
+_callTotal(0),
+_instTotal(0) {
     _shader = nullptr;
     _vertbuff = nullptr;
+    _instbuff = nullptr;
     _unifbuff = nullptr;
     _gradient = nullptr;
     _scissor  = nullptr;
@@ -339,21 +422,38 @@ _callTotal(0) {
  * You must reinitialize the sprite batch to use it.
  */
 void SpriteBatch::dispose() {
-    if (_vertData) {
-        delete[] _vertData; _vertData = nullptr;
+    // Data may point to mapped memory, which the vertex buffer releases
+    _vertData = nullptr;
+    _indxData = nullptr;
+    if (_vertLocal) {
+        delete[] _vertLocal; _vertLocal = nullptr;
     }
-    if (_indxData) {
-        delete[] _indxData; _indxData = nullptr;
+    if (_indxLocal) {
+        delete[] _indxLocal; _indxLocal = nullptr;
     }
-    if (_context != nullptr) {
-        delete _context; _context = nullptr;
+    if (_instData) {
+        delete[] _instData; _instData = nullptr;
     }
+    for(auto it = _arena.begin(); it != _arena.end(); ++it) {
+        delete *it;
+    }
+    _arena.clear();
+    _history.clear();
+    _arenaSize = 0;
+    _context = nullptr;
     _shader = nullptr;
     _vertbuff = nullptr;
+    _instbuff = nullptr;
     _unifbuff = nullptr;
     _gradient = nullptr;
     _scissor  = nullptr;
     
+    _instMax  = 0;
+    _instSize = 0;
+    _instancing = false;
+    _instready  = false;
+    _instTotal  = 0;
+    _streaming  = false;
     _vertMax  = 0;
     _vertSize = 0;
     _indxMax  = 0;
@@ -451,9 +551,11 @@ bool SpriteBatch::init(unsigned int capacity, const std::shared_ptr<Shader>& sha
 
     // Set up data arrays;
     _vertMax = capacity;
-    _vertData = new SpriteVertex[_vertMax];
+    _vertLocal = new SpriteVertex[_vertMax];
+    _vertData  = _vertLocal;
     _indxMax = capacity*3;
-    _indxData = new GLuint[_indxMax];
+    _indxLocal = new GLuint[_indxMax];
+    _indxData  = _indxLocal;
 
     // TODO: Refactor this into ShaderData
     _vertbuff = VertexBuffer::alloc(_indxMax,sizeof(SpriteVertex));
@@ -465,7 +567,28 @@ bool SpriteBatch::init(unsigned int capacity, const std::shared_ptr<Shader>& sha
                               offsetof(SpriteVertex,texcoord));
     _vertbuff->setupAttribute("aGradCoord",2, GL_FLOAT, GL_FALSE,
                               offsetof(SpriteVertex,gradcoord));
+    
+    // The instance buffer draws the unit quad once per instance
+    _instMax  = std::max(capacity/4,1u);
+    _instData = new Instance[_instMax];
+    _instbuff = InstanceBuffer::alloc(6,2*sizeof(GLfloat),_instMax,sizeof(Instance));
+    _instbuff->setupAttribute("aPosition", 2, GL_FLOAT, GL_FALSE, 0);
+    _instbuff->setupInstanceAttribute("aInstMatrix", 4, GL_FLOAT, GL_FALSE,
+                                      offsetof(Instance,matrix));
+    _instbuff->setupInstanceAttribute("aInstOffset", 2, GL_FLOAT, GL_FALSE,
+                                      offsetof(Instance,offset));
+    _instbuff->setupInstanceAttribute("aInstTexRect",4, GL_FLOAT, GL_FALSE,
+                                      offsetof(Instance,texrect));
+    _instbuff->setupInstanceAttribute("aInstColor",  4, GL_UNSIGNED_BYTE, GL_TRUE,
+                                      offsetof(Instance,color));
+    _instready = (_shader->getAttributeLocation("aInstOffset") >= 0);
+    if (_instready) {
+        _instbuff->attach(_shader);
+        _instbuff->loadVertexData(QUAD_CORNERS, 4, GL_STATIC_DRAW);
+        _instbuff->loadIndexData(QUAD_INDICES, 6, GL_STATIC_DRAW);
+    }
     _vertbuff->attach(_shader);
+    _streaming = _vertbuff->setStreaming(STREAM_REGIONS);
     
     
     // Create uniform buffer (this has its own backing array)
@@ -484,7 +607,14 @@ bool SpriteBatch::init(unsigned int capacity, const std::shared_ptr<Shader>& sha
 
     _shader->setUniformBlock("uContext",_unifbuff);
     
-    _context = new Context();
+    // Preallocate the context arena; the first slot is the active context
+    _arena.reserve(CONTEXT_RESERVE);
+    for(int ii = 0; ii < CONTEXT_RESERVE; ii++) {
+        _arena.push_back(new Context());
+    }
+    _history.reserve(CONTEXT_RESERVE);
+    _arenaSize = 1;
+    _context = _arena[0];
     _context->dirty = DIRTY_ALL_VALS;
     return true;
 }
@@ -518,11 +648,42 @@ void SpriteBatch::setShader(const std::shared_ptr<Shader>& shader) {
     CUAssertLog(_active, "Attempt to reassign shader while drawing is active");
     CUAssertLog(shader != nullptr, "Shader cannot be null");
     _vertbuff->detach();
+    _instbuff->detach();
     _shader = shader;
+    _instready = (_shader->getAttributeLocation("aInstOffset") >= 0);
+    if (_instready) {
+        _instbuff->attach(_shader);
+        _instbuff->loadVertexData(QUAD_CORNERS, 4, GL_STATIC_DRAW);
+        _instbuff->loadIndexData(QUAD_INDICES, 6, GL_STATIC_DRAW);
+    }
     _vertbuff->attach(_shader);
     _shader->setUniformBlock("uContext", _unifbuff);
 }
 
+/**
+ * Sets whether this sprite batch streams vertices through mapped memory.
+ *
+ * In streaming mode, the vertex buffer is divided into a ring of regions.
+ * During a drawing pass, shapes are written directly into a mapped region,
+ * and a flush only needs to issue the draw calls. This avoids reallocating
+ * the buffer storage and copying the vertices at every flush.
+ *
+ * This mode is true by default. It may NOT be changed during a drawing
+ * pass. If the buffer regions cannot be allocated, the sprite batch will
+ * remain in its standard mode.
+ *
+ * @param flag  Whether this sprite batch streams vertices through mapped memory.
+ */
+void SpriteBatch::setStreaming(bool flag) {
+    CUAssertLog(!_active, "Attempt to change streaming while drawing is active");
+    if (_streaming == flag) {
+        return;
+    }
+    _vertbuff->bind();
+    bool success = _vertbuff->setStreaming(flag ? STREAM_REGIONS : 0);
+    _streaming = flag && success;
+}
+
 
 /**
  * Sets the active perspective matrix of this sprite batch
@@ -534,10 +695,9 @@ void SpriteBatch::setShader(const std::shared_ptr<Shader>& shader) {
  * @param perspective   The active perspective matrix for this sprite batch
  */
 void SpriteBatch::setPerspective(const Mat4& perspective) {
-    if (_context->perspective.get() != &perspective) {
+    if (_context->perspective != perspective) {
         if (_inflight) { record(); }
-        auto matrix = std::make_shared<Mat4>(perspective);
-        _context->perspective = matrix;
+        _context->perspective = perspective;
         _context->dirty = _context->dirty | DIRTY_PERSPECTIVE;
     }
 }
@@ -551,7 +711,7 @@ void SpriteBatch::setPerspective(const Mat4& perspective) {
  * @return the active perspective matrix of this sprite batch
  */
 const Mat4& SpriteBatch::getPerspective() const {
-    return *(_context->perspective.get());
+    return _context->perspective;
 }
 
 /**
@@ -1057,9 +1217,18 @@ void SpriteBatch::begin() {
     _vertbuff->bind();
     _unifbuff->bind(false);
     _unifbuff->deactivate();
+    if (_instready) {
+        _shader->setUniform1i("uInstanced", 0);
+    }
+    
+    // Shapes batched outside of a pass stay in local memory until flushed
+    if (_vertSize == 0 && _indxSize == 0) {
+        mapStream();
+    }
     _active = true;
     _callTotal = 0;
     _vertTotal = 0;
+    _instTotal = 0;
 }
 
 /**
@@ -1070,7 +1239,11 @@ void SpriteBatch::begin() {
  */
 void SpriteBatch::end() {
     CUAssertLog(_active,"SpriteBatch is not active");
+    // Deactivate first so that the flush does not map a new region
+    _active = false;
     flush();
+    _vertbuff->bind();
+    unmapStream();
     _context->reset();
     _context->dirty = DIRTY_ALL_VALS;
 
@@ -1078,7 +1251,6 @@ void SpriteBatch::end() {
     stencil::applyEffect(StencilEffect::NONE, _shader);
     
     _shader->unbind();
-    _active = false;
 }
 
 
@@ -1095,23 +1267,37 @@ void SpriteBatch::end() {
  * restoring the OpenGL state.
  */
 void SpriteBatch::flush() {
-    if (_indxSize == 0 || _vertSize == 0) {
+    if ((_indxSize == 0 || _vertSize == 0) && _instSize == 0) {
         return;
-    } else if (_context->first != _indxSize) {
+    } else if (_context->first != _indxSize || _context->ifirst != _instSize) {
         record();
     }
     
-    // Load all the vertex data at once
+    // Load all the vertex data at once (unless it is already on the GPU)
     _vertbuff->bind();
-    _vertbuff->loadVertexData(_vertData, _vertSize);
-    _vertbuff->loadIndexData(_indxData, _indxSize);
+    if (_vertbuff->isMapped()) {
+        unmapStream();
+    } else if (_indxSize > 0) {
+        _vertbuff->loadVertexData(_vertData, _vertSize);
+        _vertbuff->loadIndexData(_indxData, _indxSize);
+    }
     _unifbuff->activate();
     _unifbuff->flush();
     
     // Chunk the uniforms
+    bool instanced = false;
     std::shared_ptr<Texture> previous = _context->texture;
     for(auto it = _history.begin(); it != _history.end(); ++it) {
         Context* next = *it;
+        if (next->instanced != instanced) {
+            instanced = next->instanced;
+            if (instanced) {
+                _instbuff->bind();
+            } else {
+                _vertbuff->bind();
+            }
+            _shader->setUniform1i("uInstanced", instanced ? 1 : 0);
+        }
         if (next->dirty & DIRTY_BLENDEQUATION) {
             _shader->setBlendEquation(next->blendEq);
         }
@@ -1127,7 +1313,7 @@ void SpriteBatch::flush() {
              _shader->setUniform1i("uType", next->type);
         }
         if (next->dirty & DIRTY_PERSPECTIVE) {
-            _shader->setUniformMat4("uPerspective",*(next->perspective.get()));
+            _shader->setUniformMat4("uPerspective",next->perspective);
         }
         if (next->dirty & DIRTY_TEXTURE) {
             previous = next->texture;
@@ -1148,21 +1334,43 @@ void SpriteBatch::flush() {
             stencil::applyEffect(next->stencil, _shader);
         }
         
-        GLuint amt = next->last-next->first;
-        _vertbuff->draw(next->command, amt, next->first);
-        _callTotal++;
+        if (next->instanced) {
+            // No base instance in OpenGLES, so stream each range separately
+            GLuint amt = next->ilast-next->ifirst;
+            if (amt > 0) {
+                _instbuff->loadInstanceData(_instData+next->ifirst, amt);
+                _instbuff->drawInstanced(GL_TRIANGLES, 6, amt);
+                _callTotal++;
+            }
+        } else {
+            GLuint amt = next->last-next->first;
+            _vertbuff->draw(next->command, amt, next->first);
+            _callTotal++;
+        }
     }
     
+    if (instanced) {
+        _vertbuff->bind();
+        _shader->setUniform1i("uInstanced", 0);
+    }
     _unifbuff->deactivate();
     
     // Increment the counters
     _vertTotal += _indxSize;
+    _instTotal += _instSize;
     
     _vertSize = _indxSize = 0;
+    _instSize = 0;
     unwind();
     _context->first = 0;
     _context->last  = 0;
+    _context->ifirst = 0;
+    _context->ilast  = 0;
     _context->blockptr = -1;
+    
+    if (_active) {
+        mapStream();
+    }
 }
 
 
@@ -2411,24 +2619,93 @@ void SpriteBatch::drawText(const std::shared_ptr<TextLayout>& text,
  * will use the correct set of uniforms.
  */
 void SpriteBatch::record() {
-    Context* next = new Context(_context);
+    if (_arenaSize == _arena.size()) {
+        _arena.push_back(new Context());
+    }
+    Context* next = _arena[_arenaSize++];
+    next->set(_context);
     _context->last = _indxSize;
+    _context->ilast = _instSize;
     next->first = _indxSize;
+    next->ifirst = _instSize;
     _history.push_back(_context);
     _context = next;
     _inflight = false;
 }
 
 /**
- * Deletes the recorded uniforms.
+ * Recycles the recorded uniforms.
  *
- * This method is called upon flushing or cleanup.
+ * This method is called upon flushing. It resets the context arena, moving
+ * the active context to the first slot. No memory is released, so that the
+ * next frame can record without allocating.
  */
 void SpriteBatch::unwind() {
     for(auto it = _history.begin(); it != _history.end(); ++it) {
-        delete *it;
+        (*it)->release();
     }
     _history.clear();
+    
+    Context* first = _arena[0];
+    if (_context != first) {
+        *first = *_context;
+        _context->release();
+        _context = first;
+    }
+    _arenaSize = 1;
+}
+
+/**
+ * Switches the current drawing context to or from instanced quads.
+ *
+ * Instanced quads and regular vertices cannot share a drawing context.
+ * If the context is in-flight with the other kind of data, this method
+ * records it first.
+ *
+ * @param flag  Whether the next shape is an instanced quad
+ */
+void SpriteBatch::useInstances(bool flag) {
+    if (_context->instanced != flag) {
+        if (_inflight) { record(); }
+        _context->instanced = flag;
+    }
+}
+
+/**
+ * Maps the next vertex buffer region for writing, if streaming.
+ *
+ * On success, the vertex and index data will point into the mapped region.
+ * If mapping fails, this sprite batch falls back to its standard mode. This
+ * method does nothing if a region is already mapped.
+ */
+void SpriteBatch::mapStream() {
+    if (!_streaming || _vertbuff->isMapped()) {
+        return;
+    }
+    void* vertices;
+    GLuint* indices;
+    if (_vertbuff->mapRegion(&vertices, &indices)) {
+        _vertData = reinterpret_cast<SpriteVertex*>(vertices);
+        _indxData = indices;
+    } else {
+        CUWarn("SpriteBatch could not map vertex memory; streaming disabled");
+        _streaming = false;
+    }
+}
+
+/**
+ * Unmaps the current vertex buffer region, making it ready to draw.
+ *
+ * The vertex and index data will point to local memory again. This method
+ * does nothing if no region is mapped.
+ */
+void SpriteBatch::unmapStream() {
+    if (!_vertbuff->isMapped()) {
+        return;
+    }
+    _vertbuff->unmapRegion(_vertSize, _indxSize);
+    _vertData = _vertLocal;
+    _indxData = _indxLocal;
 }
 
 /**
@@ -2497,6 +2774,9 @@ void SpriteBatch::blurTexture(const std::shared_ptr<Texture>& texture, GLfloat s
  * @return the number of vertices added to the drawing buffer.
  */
 unsigned int SpriteBatch::prepare(const Rect rect) {
+    if (_instancing && _instready && _context->command == GL_TRIANGLES) {
+        return prepareInstance(rect,Affine2::IDENTITY);
+    }
     if (_vertSize+4 >= _vertMax ||  _indxSize+8 >= _indxMax) {
         flush();
     }
@@ -2515,6 +2795,7 @@ unsigned int SpriteBatch::prepare(const Rect rect) {
         ttmax = 1.0f; ttmin = 0.0f;
     }
     
+    useInstances(false);
     setUniformBlock(_context);
     Poly2 poly;
     makeRect(poly, rect, _context->command == GL_TRIANGLES);
@@ -2564,6 +2845,9 @@ unsigned int SpriteBatch::prepare(const Rect rect) {
  * @return the number of vertices added to the drawing buffer.
  */
 unsigned int SpriteBatch::prepare(const Rect rect, const Affine2& mat) {
+    if (_instancing && _instready && _context->command == GL_TRIANGLES) {
+        return prepareInstance(rect,mat);
+    }
     if (_vertSize+4 > _vertMax ||  _indxSize+8 > _indxMax) {
         flush();
     }
@@ -2582,6 +2866,7 @@ unsigned int SpriteBatch::prepare(const Rect rect, const Affine2& mat) {
         ttmax = 1.0f; ttmin = 0.0f;
     }
     
+    useInstances(false);
     setUniformBlock(_context);
     Poly2 poly;
     makeRect(poly, rect, _context->command == GL_TRIANGLES);
@@ -2616,6 +2901,56 @@ unsigned int SpriteBatch::prepare(const Rect rect, const Affine2& mat) {
     return ii;
 }
 
+/**
+ * Returns the number of instances added to the drawing buffer.
+ *
+ * This method adds the given rectangle as a single instanced quad, but
+ * does not draw it yet. You must call {@link #flush} or {@link #end} to
+ * draw the rectangle. This method will automatically flush if the
+ * maximum number of instances is reached.
+ *
+ * The rectangle will be transformed by the transform matrix.
+ *
+ * @param rect  The rectangle to add to the buffer
+ * @param mat   The transform to apply to the rectangle
+ *
+ * @return the number of instances added to the drawing buffer.
+ */
+unsigned int SpriteBatch::prepareInstance(const Rect rect, const Affine2& mat) {
+    if (_instSize >= _instMax) {
+        flush();
+    }
+    
+    useInstances(true);
+    setUniformBlock(_context);
+    
+    Texture* texture = _context->texture.get();
+    Instance* inst = _instData+_instSize;
+    if (texture != nullptr) {
+        inst->texrect[0] = texture->getMinS();
+        inst->texrect[1] = texture->getMinT();
+        inst->texrect[2] = texture->getMaxS();
+        inst->texrect[3] = texture->getMaxT();
+    } else {
+        inst->texrect[0] = 0.0f; inst->texrect[1] = 0.0f;
+        inst->texrect[2] = 1.0f; inst->texrect[3] = 1.0f;
+    }
+    
+    // Fold the rectangle into the transform
+    const float* m = mat.m;
+    inst->matrix[0] = m[0]*rect.size.width;
+    inst->matrix[1] = m[1]*rect.size.width;
+    inst->matrix[2] = m[2]*rect.size.height;
+    inst->matrix[3] = m[3]*rect.size.height;
+    inst->offset[0] = m[0]*rect.origin.x+m[2]*rect.origin.y+m[4];
+    inst->offset[1] = m[1]*rect.origin.x+m[3]*rect.origin.y+m[5];
+    inst->color = _color.getPacked();
+    
+    _instSize++;
+    _inflight = true;
+    return 1;
+}
+
 /**
  * Returns the number of vertices added to the drawing buffer.
  *
@@ -2659,6 +2994,7 @@ unsigned int SpriteBatch::prepare(const Poly2& poly) {
         ttmax = 1.0f; ttmin = 0.0f;
     }
     
+    useInstances(false);
     setUniformBlock(_context);
     unsigned int vstart = _vertSize;
     int ii = 0;
@@ -2740,6 +3076,7 @@ unsigned int SpriteBatch::prepare(const Poly2& poly, const Vec2 off) {
         ttmax = 1.0f; ttmin = 0.0f;
     }
     
+    useInstances(false);
     setUniformBlock(_context);
     unsigned int vstart = _vertSize;
     int ii = 0;
@@ -2819,14 +3156,13 @@ unsigned int SpriteBatch::prepare(const Poly2& poly, const Affine2& mat) {
         ttmax = 1.0f; ttmin = 0.0f;
     }
     
+    useInstances(false);
     setUniformBlock(_context);
     unsigned int vstart = _vertSize;
     int ii = 0;
     GLuint clr = _color.getPacked();
     for(auto it = poly.vertices.begin(); it != poly.vertices.end(); ++it) {
         Vec2 point = *it;
-        _vertData[vstart+ii].position = point*mat;
-
         float s = point.x/twidth;
         float t = 1-point.y/theight;
 
@@ -2837,6 +3173,9 @@ unsigned int SpriteBatch::prepare(const Poly2& poly, const Affine2& mat) {
         _vertData[vstart+ii].color = clr;
         ii++;
     }
+    Affine2::transform(mat, reinterpret_cast<const float*>(poly.vertices.data()),
+                       reinterpret_cast<float*>(_vertData+vstart),
+                       poly.vertices.size(), 2, VERTEX_STRIDE);
     
     int jj = 0;
     unsigned int istart = _indxSize;
@@ -2872,6 +3211,7 @@ unsigned int SpriteBatch::chunkify(const Poly2& poly, const Affine2& mat) {
     const std::vector<cugl::Vec2>* vertices = &(poly.vertices);
     const std::vector<Uint32>* indices = &(poly.indices);
     
+    useInstances(false);
     setUniformBlock(_context);
     int chunksize = _context->command == GL_TRIANGLES ? 3 : 2;
     unsigned int start = _vertSize;
@@ -2950,21 +3290,23 @@ unsigned int SpriteBatch::prepare(const Mesh<SpriteVertex>& mesh, const Affine2&
         flush();
     }
     
+    useInstances(false);
     setUniformBlock(_context);
-    int ii = 0;
+    int ii = (int)mesh.vertices.size();
     tint = tint && _color != Color4::WHITE;
-    for(auto it = mesh.vertices.begin(); it != mesh.vertices.end(); ++it) {
-        _vertData[_vertSize+ii] = *it;
-        _vertData[_vertSize+ii].position = it->position*mat;
-        if (tint) {
-            Uint32 c = marshall(_vertData[_vertSize+ii].color);
+    std::copy(mesh.vertices.begin(), mesh.vertices.end(), _vertData+_vertSize);
+    Affine2::transform(mat, reinterpret_cast<const float*>(mesh.vertices.data()),
+                       reinterpret_cast<float*>(_vertData+_vertSize),
+                       ii, VERTEX_STRIDE, VERTEX_STRIDE);
+    if (tint) {
+        for(int kk = 0; kk < ii; kk++) {
+            Uint32 c = marshall(mesh.vertices[kk].color);
             Uint32 r = round(_color.r*((c >> 24)/255.0f));
             Uint32 g = round(_color.g*(((c >> 16) & 0xff)/255.0f));
             Uint32 b = round(_color.b*(((c >> 8) & 0xff)/255.0f));
             Uint32 a = round(_color.a*((c & 0xff)/255.0f));
-            _vertData[_vertSize+ii].color = marshall(r << 24 | g << 16 | b << 8 | a);
+            _vertData[_vertSize+kk].color = marshall(r << 24 | g << 16 | b << 8 | a);
         }
-        ii++;
     }
     
     int jj = 0;
@@ -2996,6 +3338,7 @@ unsigned int SpriteBatch::prepare(const Mesh<SpriteVertex>& mesh, const Affine2&
 unsigned int SpriteBatch::chunkify(const Mesh<SpriteVertex>& mesh, const Affine2& mat, bool tint) {
     std::unordered_map<Uint32, Uint32> offsets;
     
+    useInstances(false);
     setUniformBlock(_context);
     int chunksize = _context->command == GL_TRIANGLES ? 3 : 2;
     unsigned int start = _vertSize;
@@ -3013,13 +3356,14 @@ unsigned int SpriteBatch::chunkify(const Mesh<SpriteVertex>& mesh, const Affine2
             } else {
                 int pos = mesh.indices[ii+jj];
                 _indxData[_indxSize] = _vertSize;
-                _vertData[_vertSize] = mesh.vertices[pos];
-                _vertData[_vertSize].position *= mat;
+                SpriteVertex vert = mesh.vertices[pos];
+                vert.position *= mat;
                 if (tint) {
-                    Color4 shade(_vertData[_vertSize].color);
+                    Color4 shade(vert.color);
                     shade *= _color;
-                    _vertData[_vertSize].color = shade.getPacked();
+                    vert.color = shade.getPacked();
                 }
+                _vertData[_vertSize] = vert;
                 _vertSize++;
             }
             _indxSize++;
@@ -3058,21 +3402,23 @@ unsigned int SpriteBatch::prepare(const SpriteVertex* vertices, size_t size, con
         flush();
     }
     
+    useInstances(false);
     setUniformBlock(_context);
-    int ii = 0;
+    int ii = (int)size;
     tint = tint && _color != Color4::WHITE;
-    for(size_t kk = 0; kk < size; kk++) {
-        _vertData[_vertSize+ii] = vertices[kk];
-        _vertData[_vertSize+ii].position = vertices[kk].position*mat;
-        if (tint) {
-            Uint32 c = marshall(_vertData[_vertSize+ii].color);
+    std::copy(vertices, vertices+size, _vertData+_vertSize);
+    Affine2::transform(mat, reinterpret_cast<const float*>(vertices),
+                       reinterpret_cast<float*>(_vertData+_vertSize),
+                       size, VERTEX_STRIDE, VERTEX_STRIDE);
+    if (tint) {
+        for(size_t kk = 0; kk < size; kk++) {
+            Uint32 c = marshall(vertices[kk].color);
             Uint32 r = round(_color.r*((c >> 24)/255.0f));
             Uint32 g = round(_color.g*(((c >> 16) & 0xff)/255.0f));
             Uint32 b = round(_color.b*(((c >> 8) & 0xff)/255.0f));
             Uint32 a = round(_color.a*((c & 0xff)/255.0f));
-            _vertData[_vertSize+ii].color = marshall(r << 24 | g << 16 | b << 8 | a);
+            _vertData[_vertSize+kk].color = marshall(r << 24 | g << 16 | b << 8 | a);
         }
-        ii++;
     }
     
     int jj = 0;
@@ -3105,6 +3451,7 @@ unsigned int SpriteBatch::prepare(const SpriteVertex* vertices, size_t size, con
  * @return the number of vertices added to the drawing buffer.
  */
 unsigned int SpriteBatch::chunkify(const SpriteVertex* vertices, size_t size, const Affine2& mat, bool tint) {
+    useInstances(false);
     setUniformBlock(_context);
 
     const int chunksize = 3;
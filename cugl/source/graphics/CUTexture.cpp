@@ -33,6 +33,7 @@
 #include <SDL.h>
 #include <SDL_image.h>
 #include <sstream>
+#include <algorithm>
 #include <cugl/core/util/CUDebug.h>
 #include <cugl/core/util/CUFiletools.h>
 #include <cugl/graphics/CUTexture.h>
@@ -292,6 +293,68 @@ bool Texture::initWithData(const void *data, int width, int height, bool mipmaps
     return true;
 }
 
+/**
+ * Initializes an texture with the given data and precomputed mipmaps.
+ *
+ * Initializing a texture requires the use of texture offset 0.  Any texture
+ * bound to that offset will be unbound.  In addition, once initialization
+ * is done, this texture will not longer be bound as well.
+ *
+ * The data is the full mipmap chain, stored one level after the other.
+ * Level 0 has the given width and height, and every subsequent level is
+ * half the size (rounded down, but never less than 1) of the previous
+ * one. Unlike {@link #buildMipMaps}, this method does not require the
+ * texture size to be a power of two.
+ *
+ * The data format must match the one given.
+ *
+ * @param data      The texture data for all mipmap levels
+ * @param width     The texture width in pixels
+ * @param height    The texture height in pixels
+ * @param levels    The number of mipmap levels in the data
+ * @param format    The texture data format
+ *
+ * @return true if initialization was successful.
+ */
+bool Texture::initWithMipMaps(const void *data, int width, int height, int levels, Texture::PixelFormat format) {
+    CUAssertLog(levels > 0, "Mipmap level count %d is not valid",levels);
+    if (!initWithData(data, width, height, false, format)) {
+        return false;
+    }
+    if (levels <= 1) {
+        return true;
+    }
+    
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, _buffer);
+    
+    GLint  internal = internal_format(format);
+    GLenum datatype = format_type(format);
+    const Uint8* bytes = (const Uint8*)data;
+    size_t bsize = getByteSize();
+    size_t offset = 0;
+    int w = width;
+    int h = height;
+    for(int level = 1; level < levels; level++) {
+        offset += bsize*w*h;
+        w = std::max(1,w/2);
+        h = std::max(1,h/2);
+        glTexImage2D(GL_TEXTURE_2D, level, internal, w, h, 0, (GLenum)format, datatype, bytes+offset);
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels-1);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    
+    GLenum error = glGetError();
+    if (error) {
+        CULogError("Could not initialize mipmaps. %s", gl_error_name(error).c_str());
+        dispose();
+        return false;
+    }
+    
+    _hasMipmaps = true;
+    return true;
+}
+
 /**
  * Initializes an texture with the data from the given file.
  *
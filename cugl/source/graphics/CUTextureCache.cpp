@@ -0,0 +1,410 @@
+//
+//  CUTextureCache.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a disk cache for decoded texture data. Decoding an
+//  image file (and converting it to RGBA) is one of the more expensive steps
+//  at startup. This cache stores the decoded pixels, together with an optional
+//  mipmap chain, in a binary file that can be uploaded to OpenGL directly on
+//  later launches.
+//
+//  Cache files are keyed by a hash of the contents of the source image. Hence
+//  a cache entry is invalidated automatically when its source changes. The
+//  cache does not use OpenGL, and so it is safe to use outside of the main
+//  thread.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty. In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Author: Walker White
+//  Version: 7/3/24 (CUGL 3.0 reorganization)
+//
+#include <cugl/graphics/CUTextureCache.h>
+#include <cugl/core/util/CUDebug.h>
+#include <cugl/core/util/CUFiletools.h>
+#include <SDL.h>
+#include <SDL_image.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+using namespace cugl;
+using namespace cugl::graphics;
+
+/** The magic number identifying a cache file ('CUTX') */
+#define CACHE_MAGIC     0x58545543
+/** The cache file version; increment when the layout changes */
+#define CACHE_VERSION   1
+/** The suffix for cache files */
+#define CACHE_SUFFIX    "cutex"
+
+/** A counter to give each temporary file a unique name */
+static std::atomic<Uint32> _nexttemp(0);
+
+#pragma mark -
+#pragma mark Cache File
+/**
+ * The header at the start of every cache file.
+ *
+ * Cache files are never shared between machines, so the header (and the
+ * pixel data) use the native byte order.
+ */
+typedef struct {
+    /** The magic number CACHE_MAGIC */
+    Uint32 magic;
+    /** The cache file version */
+    Uint32 version;
+    /** The hash of the source image (and load settings) */
+    Uint64 hash;
+    /** The width of mipmap level 0 */
+    Uint32 width;
+    /** The height of mipmap level 0 */
+    Uint32 height;
+    /** The number of mipmap levels */
+    Uint32 levels;
+    /** The number of bytes of pixel data */
+    Uint32 size;
+} CacheHeader;
+
+/**
+ * Returns the 64-bit FNV-1a hash of the given data
+ *
+ * @param data  The data to hash
+ * @param size  The number of bytes to hash
+ * @param seed  The initial hash value
+ *
+ * @return the 64-bit FNV-1a hash of the given data
+ */
+static Uint64 fnv_hash(const Uint8* data, size_t size, Uint64 seed=0xcbf29ce484222325ULL) {
+    Uint64 hash = seed;
+    for(size_t ii = 0; ii < size; ii++) {
+        hash ^= data[ii];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+/**
+ * Returns the number of bytes in a mipmap chain of the given size
+ *
+ * @param width     The width of level 0
+ * @param height    The height of level 0
+ * @param levels    The number of mipmap levels
+ *
+ * @return the number of bytes in a mipmap chain of the given size
+ */
+static size_t chain_size(Uint32 width, Uint32 height, Uint32 levels) {
+    size_t result = 0;
+    for(Uint32 ii = 0; ii < levels; ii++) {
+        result += 4*(size_t)width*height;
+        width  = std::max(1u,width/2);
+        height = std::max(1u,height/2);
+    }
+    return result;
+}
+
+/**
+ * Fills in the mipmap chain of the given image.
+ *
+ * Level 0 must already be present. Each subsequent level is computed with a
+ * 2x2 box filter of the previous one. Odd rows and columns are clamped to
+ * the edge of the previous level.
+ *
+ * @param image The image to process
+ */
+static void build_mipmaps(TextureCache::Image& image) {
+    Uint32 levels = 1;
+    for(Uint32 size = std::max(image.width,image.height); size > 1; size /= 2) {
+        levels++;
+    }
+    image.levels = levels;
+    image.data.resize(chain_size(image.width,image.height,levels));
+
+    Uint32 sw = image.width;
+    Uint32 sh = image.height;
+    Uint8* src = image.data.data();
+    for(Uint32 level = 1; level < levels; level++) {
+        Uint32 dw = std::max(1u,sw/2);
+        Uint32 dh = std::max(1u,sh/2);
+        Uint8* dst = src+4*(size_t)sw*sh;
+        for(Uint32 y = 0; y < dh; y++) {
+            const Uint8* row0 = src+4*(size_t)std::min(2*y,sh-1)*sw;
+            const Uint8* row1 = src+4*(size_t)std::min(2*y+1,sh-1)*sw;
+            Uint8* out = dst+4*(size_t)y*dw;
+            for(Uint32 x = 0; x < dw; x++) {
+                Uint32 x0 = 4*std::min(2*x,sw-1);
+                Uint32 x1 = 4*std::min(2*x+1,sw-1);
+                for(Uint32 c = 0; c < 4; c++) {
+                    Uint32 sum = row0[x0+c]+row0[x1+c]+row1[x0+c]+row1[x1+c];
+                    out[4*x+c] = (Uint8)((sum+2)/4);
+                }
+            }
+        }
+        src = dst;
+        sw = dw;
+        sh = dh;
+    }
+}
+
+#pragma mark -
+#pragma mark Constructors
+/**
+ * Creates an uninitialized texture cache.
+ *
+ * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an object on
+ * the heap, use one of the static constructors instead.
+ */
+TextureCache::TextureCache() :
+_hits(0),
+_misses(0) {
+}
+
+/**
+ * Disposes all of the resources used by this texture cache.
+ *
+ * This does not delete the cache files. A disposed texture cache can be
+ * safely reinitialized.
+ */
+void TextureCache::dispose() {
+    _directory.clear();
+    _hits = 0;
+    _misses = 0;
+}
+
+/**
+ * Initializes a texture cache in the given directory.
+ *
+ * The directory should be an absolute path in a writable location, such
+ * as a subdirectory of {@link Application#getSaveDirectory}. It will be
+ * created if it does not already exist.
+ *
+ * @param directory The directory storing the cache files
+ *
+ * @return true if initialization was successful.
+ */
+bool TextureCache::init(const std::string directory) {
+    if (!_directory.empty()) {
+        CUAssertLog(false, "Texture cache is already initialized");
+        return false;
+    }
+    std::string path = filetool::normalize_path(directory);
+    if (!filetool::is_dir(path) && !filetool::dir_create(path)) {
+        CULogError("Could not create texture cache at %s",path.c_str());
+        return false;
+    }
+    _directory = path;
+    if (_directory.back() != filetool::path_sep) {
+        _directory.push_back(filetool::path_sep);
+    }
+    return true;
+}
+
+#pragma mark -
+#pragma mark Cache Access
+/**
+ * Returns the decoded pixel data for the given image file.
+ *
+ * If the image is in the cache, this reads the cache file. Otherwise, it
+ * decodes the image file and writes the result to the cache. If mipmaps
+ * is true, the image will include a full mipmap chain down to 1x1.
+ *
+ * The path should be absolute. This method returns nullptr if the image
+ * could not be loaded.
+ *
+ * @param path      The absolute path to the image file
+ * @param mipmaps   Whether to include a mipmap chain
+ *
+ * @return the decoded pixel data for the given image file.
+ */
+std::shared_ptr<TextureCache::Image> TextureCache::load(const std::string path, bool mipmaps) {
+    // Read the source bytes once, both to hash and (if needed) to decode
+    SDL_RWops* source = SDL_RWFromFile(path.c_str(), "rb");
+    if (source == nullptr) {
+        CULogError("Could not open image %s. %s", path.c_str(), SDL_GetError());
+        return nullptr;
+    }
+    Sint64 length = SDL_RWsize(source);
+    std::vector<Uint8> bytes(length > 0 ? (size_t)length : 0);
+    size_t amount = length > 0 ? SDL_RWread(source, bytes.data(), 1, bytes.size()) : 0;
+    SDL_RWclose(source);
+    if (amount != bytes.size() || bytes.empty()) {
+        CULogError("Could not read image %s", path.c_str());
+        return nullptr;
+    }
+
+    Uint8 settings[2] = { (Uint8)mipmaps, (Uint8)CU_MEMORY_ORDER };
+    Uint64 hash = fnv_hash(bytes.data(), bytes.size());
+    hash = fnv_hash(settings, sizeof(settings), hash);
+
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx", (unsigned long long)hash);
+    std::string file = _directory+name+"."+CACHE_SUFFIX;
+
+    std::shared_ptr<Image> image = read(file, hash);
+    if (image != nullptr) {
+        _hits++;
+        return image;
+    }
+
+    SDL_Surface* surface = IMG_Load_RW(SDL_RWFromConstMem(bytes.data(), (int)bytes.size()), 1);
+    if (surface == nullptr) {
+        CULogError("Could not decode image %s. %s", path.c_str(), SDL_GetError());
+        return nullptr;
+    }
+
+    SDL_Surface* normal;
+#if CU_MEMORY_ORDER == CU_ORDER_REVERSED
+    normal = SDL_ConvertSurfaceFormat(surface,SDL_PIXELFORMAT_ABGR8888,0);
+#else
+    normal = SDL_ConvertSurfaceFormat(surface,SDL_PIXELFORMAT_RGBA8888,0);
+#endif
+    SDL_FreeSurface(surface);
+    if (normal == nullptr) {
+        CULogError("Could not process image %s. %s", path.c_str(), SDL_GetError());
+        return nullptr;
+    }
+
+    image = std::make_shared<Image>();
+    image->width  = normal->w;
+    image->height = normal->h;
+    image->levels = 1;
+    image->data.resize(4*(size_t)normal->w*normal->h);
+    const Uint8* pixels = (const Uint8*)normal->pixels;
+    for(int row = 0; row < normal->h; row++) {
+        std::memcpy(image->data.data()+4*(size_t)row*normal->w, pixels+(size_t)row*normal->pitch, 4*(size_t)normal->w);
+    }
+    SDL_FreeSurface(normal);
+
+    if (mipmaps) {
+        build_mipmaps(*image);
+    }
+    _misses++;
+    write(file, hash, *image);
+    return image;
+}
+
+/**
+ * Deletes all cache files in the cache directory.
+ *
+ * This method should not be called while other threads are loading
+ * from this cache.
+ */
+void TextureCache::clear() {
+    std::vector<std::string> files = filetool::dir_contents(_directory);
+    for(auto it = files.begin(); it != files.end(); ++it) {
+        if (filetool::base_suffix(*it) == CACHE_SUFFIX) {
+            filetool::file_delete(*it);
+        }
+    }
+}
+
+/**
+ * Returns the image stored in the given cache file.
+ *
+ * This method returns nullptr if the file does not exist, or if it does
+ * not match the given hash.
+ *
+ * @param path  The cache file
+ * @param hash  The hash of the source image
+ *
+ * @return the image stored in the given cache file.
+ */
+std::shared_ptr<TextureCache::Image> TextureCache::read(const std::string path, Uint64 hash) {
+    SDL_RWops* file = SDL_RWFromFile(path.c_str(), "rb");
+    if (file == nullptr) {
+        return nullptr;
+    }
+
+    CacheHeader header;
+    bool valid = SDL_RWread(file, &header, sizeof(CacheHeader), 1) == 1;
+    valid = valid && header.magic == CACHE_MAGIC && header.version == CACHE_VERSION;
+    valid = valid && header.hash == hash && header.levels > 0;
+    valid = valid && header.size == chain_size(header.width, header.height, header.levels);
+
+    std::shared_ptr<Image> image = nullptr;
+    if (valid) {
+        image = std::make_shared<Image>();
+        image->width  = header.width;
+        image->height = header.height;
+        image->levels = header.levels;
+        image->data.resize(header.size);
+        if (SDL_RWread(file, image->data.data(), 1, header.size) != header.size) {
+            image = nullptr;
+        }
+    }
+    SDL_RWclose(file);
+    return image;
+}
+
+/**
+ * Writes the image to the given cache file.
+ *
+ * The file is written under a temporary name and then renamed, so that
+ * a concurrent {@link #read} never sees a partial file.
+ *
+ * @param path  The cache file
+ * @param hash  The hash of the source image
+ * @param image The image to write
+ *
+ * @return true if the file was written successfully
+ */
+bool TextureCache::write(const std::string path, Uint64 hash, const Image& image) {
+    std::string temp = path+"."+std::to_string(_nexttemp++);
+    SDL_RWops* file = SDL_RWFromFile(temp.c_str(), "wb");
+    if (file == nullptr) {
+        CULogError("Could not write texture cache %s. %s", temp.c_str(), SDL_GetError());
+        return false;
+    }
+
+    CacheHeader header;
+    std::memset(&header, 0, sizeof(CacheHeader));
+    header.magic   = CACHE_MAGIC;
+    header.version = CACHE_VERSION;
+    header.hash    = hash;
+    header.width   = image.width;
+    header.height  = image.height;
+    header.levels  = image.levels;
+    header.size    = (Uint32)image.data.size();
+
+    bool success = SDL_RWwrite(file, &header, sizeof(CacheHeader), 1) == 1;
+    success = success && SDL_RWwrite(file, image.data.data(), 1, image.data.size()) == image.data.size();
+    success = (SDL_RWclose(file) == 0) && success;
+
+    if (success && std::rename(temp.c_str(), path.c_str()) != 0) {
+        // Windows will not rename over an existing file
+        std::remove(path.c_str());
+        success = std::rename(temp.c_str(), path.c_str()) == 0;
+    }
+    if (!success) {
+        std::remove(temp.c_str());
+    }
+    return success;
+}
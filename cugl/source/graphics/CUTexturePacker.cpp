@@ -0,0 +1,508 @@
+//
+//  CUTexturePacker.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a class for packing several images into one or more
+//  texture atlases. Rendering from a single atlas means that the sprite batch
+//  does not need to flush whenever it switches images, which can reduce the
+//  number of draw calls significantly.
+//
+//  The packer uses the skyline bottom-left heuristic. Each image is surrounded
+//  by a gutter of padding pixels, which are filled by extruding the image
+//  border. This prevents neighboring images from bleeding into each other
+//  when the atlas is filtered or mipmapped.
+//
+//  The packer works purely on CPU pixel data and does not require OpenGL.
+//  Hence it is safe to use it outside of the main thread.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty. In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Author: Walker White
+//  Version: 7/3/24 (CUGL 3.0 reorganization)
+//
+#include <cugl/graphics/CUTexturePacker.h>
+#include <cugl/core/util/CUDebug.h>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+
+using namespace cugl;
+using namespace cugl::graphics;
+
+#pragma mark -
+#pragma mark Skyline
+namespace {
+
+/**
+ * Returns the smallest power of two greater than or equal to value
+ *
+ * @param value The value to round up
+ *
+ * @return the smallest power of two greater than or equal to value
+ */
+Uint32 next_pot(Uint32 value) {
+    Uint32 result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+/**
+ * A skyline bottom-left rectangle packer.
+ *
+ * The skyline is the upper envelope of all rectangles placed so far, stored
+ * as a sequence of horizontal segments. A new rectangle is placed on the
+ * segment that minimizes its top edge, breaking ties by the left edge. While
+ * this wastes the space underneath overhangs, it is fast and packs sorted
+ * sprites well.
+ */
+class Skyline {
+public:
+    /** A horizontal segment of the skyline */
+    struct Segment {
+        Uint32 x;
+        Uint32 y;
+        Uint32 width;
+    };
+
+    /** The skyline width */
+    Uint32 width;
+    /** The skyline height */
+    Uint32 height;
+    /** The highest point of the skyline */
+    Uint32 extent;
+    /** The skyline segments, ordered left to right */
+    std::vector<Segment> segments;
+
+    /**
+     * Creates an empty skyline of the given size
+     *
+     * @param w The skyline width
+     * @param h The skyline height
+     */
+    Skyline(Uint32 w, Uint32 h) : width(w), height(h), extent(0) {
+        segments.push_back({0,0,w});
+    }
+
+    /**
+     * Returns the bottom of a rectangle placed at the given segment
+     *
+     * If the rectangle does not fit, this returns false.
+     *
+     * @param index The segment index
+     * @param w     The rectangle width
+     * @param h     The rectangle height
+     * @param y     Variable to store the rectangle bottom
+     *
+     * @return true if the rectangle fits at the given segment
+     */
+    bool fit(size_t index, Uint32 w, Uint32 h, Uint32& y) const {
+        Uint32 x = segments[index].x;
+        if (x+w > width) {
+            return false;
+        }
+        y = 0;
+        Uint32 remain = w;
+        for(size_t ii = index; remain > 0; ii++) {
+            y = std::max(y,segments[ii].y);
+            if (y+h > height) {
+                return false;
+            }
+            remain -= std::min(remain,segments[ii].width);
+        }
+        return true;
+    }
+
+    /**
+     * Places a rectangle of the given size, returning its origin
+     *
+     * If the rectangle does not fit, this returns false.
+     *
+     * @param w     The rectangle width
+     * @param h     The rectangle height
+     * @param x     Variable to store the rectangle left edge
+     * @param y     Variable to store the rectangle bottom edge
+     *
+     * @return true if the rectangle was placed
+     */
+    bool insert(Uint32 w, Uint32 h, Uint32& x, Uint32& y) {
+        size_t best = segments.size();
+        Uint32 bestTop = height+1;
+        Uint32 bestX = width;
+        for(size_t ii = 0; ii < segments.size(); ii++) {
+            Uint32 ypos;
+            if (fit(ii,w,h,ypos)) {
+                Uint32 top = ypos+h;
+                if (top < bestTop || (top == bestTop && segments[ii].x < bestX)) {
+                    best = ii;
+                    bestTop = top;
+                    bestX = segments[ii].x;
+                }
+            }
+        }
+        if (best == segments.size()) {
+            return false;
+        }
+
+        x = bestX;
+        y = bestTop-h;
+        extent = std::max(extent,bestTop);
+
+        // Replace the covered segments with the new one
+        segments.insert(segments.begin()+best, {x,bestTop,w});
+        size_t ii = best+1;
+        while (ii < segments.size()) {
+            Segment& prev = segments[ii-1];
+            Segment& curr = segments[ii];
+            if (curr.x >= prev.x+prev.width) {
+                break;
+            }
+            Uint32 shrink = prev.x+prev.width-curr.x;
+            if (shrink >= curr.width) {
+                segments.erase(segments.begin()+ii);
+            } else {
+                curr.x += shrink;
+                curr.width -= shrink;
+                break;
+            }
+        }
+
+        // Merge neighbors of equal height
+        for(ii = 1; ii < segments.size();) {
+            if (segments[ii-1].y == segments[ii].y) {
+                segments[ii-1].width += segments[ii].width;
+                segments.erase(segments.begin()+ii);
+            } else {
+                ii++;
+            }
+        }
+        return true;
+    }
+};
+
+}
+
+#pragma mark -
+#pragma mark Constructors
+/**
+ * Creates an uninitialized texture packer.
+ *
+ * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an object on
+ * the heap, use one of the static constructors instead.
+ */
+TexturePacker::TexturePacker() :
+_padding(0),
+_maxsize(0) {
+}
+
+/**
+ * Disposes all of the resources used by this texture packer.
+ *
+ * A disposed texture packer can be safely reinitialized.
+ */
+void TexturePacker::dispose() {
+    _images.clear();
+    _pages.clear();
+    _regions.clear();
+    _padding = 0;
+    _maxsize = 0;
+}
+
+/**
+ * Initializes a texture packer with the given padding and page size.
+ *
+ * The padding is the gutter (in pixels) around each side of each image.
+ * The maximum size is the largest width or height of a page, and is
+ * rounded down to a power of two.
+ *
+ * @param padding   The gutter around each image
+ * @param maxsize   The maximum width or height of a page
+ *
+ * @return true if initialization was successful.
+ */
+bool TexturePacker::init(Uint32 padding, Uint32 maxsize) {
+    if (_maxsize) {
+        CUAssertLog(false, "Texture packer is already initialized");
+        return false;
+    } else if (maxsize == 0) {
+        CUAssertLog(false, "Maximum page size must be positive");
+        return false;
+    }
+    _padding = padding;
+    _maxsize = next_pot(maxsize);
+    if (_maxsize > maxsize) {
+        _maxsize >>= 1;
+    }
+    return true;
+}
+
+#pragma mark -
+#pragma mark Packing
+/**
+ * Adds an image to be packed.
+ *
+ * The pixel data is copied, so it is safe to release it after this call.
+ * The pitch is the number of bytes in a row of the image. If it is 0,
+ * the rows are assumed to be tightly packed.
+ *
+ * This method will fail if the name is already in use, or if the packer
+ * has already been packed.
+ *
+ * @param name      The image name
+ * @param pixels    The 32-bit image pixels
+ * @param width     The image width
+ * @param height    The image height
+ * @param pitch     The number of bytes per image row
+ *
+ * @return true if the image was successfully added
+ */
+bool TexturePacker::add(const std::string name, const void* pixels,
+                        Uint32 width, Uint32 height, Uint32 pitch) {
+    if (isPacked()) {
+        CULogError("Cannot add '%s' to a packed atlas", name.c_str());
+        return false;
+    } else if (pixels == nullptr || width == 0 || height == 0) {
+        CULogError("Image '%s' has no pixel data", name.c_str());
+        return false;
+    }
+    for(auto it = _images.begin(); it != _images.end(); ++it) {
+        if (it->name == name) {
+            CULogError("Image '%s' is already in the atlas", name.c_str());
+            return false;
+        }
+    }
+
+    if (pitch == 0) {
+        pitch = width*sizeof(Uint32);
+    }
+
+    Image image;
+    image.name = name;
+    image.width = width;
+    image.height = height;
+    image.pixels.resize(width*height);
+    const Uint8* src = (const Uint8*)pixels;
+    for(Uint32 row = 0; row < height; row++) {
+        std::memcpy(image.pixels.data()+row*width, src+row*pitch, width*sizeof(Uint32));
+    }
+    _images.push_back(std::move(image));
+    return true;
+}
+
+/**
+ * Packs all of the images added into atlas pages.
+ *
+ * Images are sorted by height before packing, and each page is sized to
+ * the smallest power of two that holds its images. The pixel data of the
+ * original images is released once packing is complete.
+ *
+ * @return true if all images were packed
+ */
+bool TexturePacker::pack() {
+    if (isPacked()) {
+        CULogError("Texture atlas is already packed");
+        return false;
+    }
+
+    bool success = true;
+    Uint32 gutter = 2*_padding;
+    std::vector<size_t> remain;
+    for(size_t ii = 0; ii < _images.size(); ii++) {
+        const Image& image = _images[ii];
+        if (image.width+gutter > _maxsize || image.height+gutter > _maxsize) {
+            CULogError("Image '%s' is too large for the atlas", image.name.c_str());
+            success = false;
+        } else {
+            remain.push_back(ii);
+        }
+    }
+
+    // Tallest first (then widest) gives the skyline the best chance
+    std::stable_sort(remain.begin(), remain.end(), [this](size_t a, size_t b) {
+        const Image& ia = _images[a];
+        const Image& ib = _images[b];
+        if (ia.height != ib.height) {
+            return ia.height > ib.height;
+        }
+        return ia.width > ib.width;
+    });
+
+    struct Placement {
+        size_t image;
+        Uint32 x;
+        Uint32 y;
+    };
+
+    while (!remain.empty()) {
+        // Start from the smallest square that could hold everything left
+        Uint64 area = 0;
+        Uint32 minw = 0;
+        Uint32 minh = 0;
+        for(auto it = remain.begin(); it != remain.end(); ++it) {
+            const Image& image = _images[*it];
+            area += (Uint64)(image.width+gutter)*(image.height+gutter);
+            minw = std::max(minw,image.width+gutter);
+            minh = std::max(minh,image.height+gutter);
+        }
+        Uint32 side = next_pot((Uint32)std::ceil(std::sqrt((double)area)));
+        Uint32 width  = std::min(_maxsize,std::max(side,next_pot(minw)));
+        Uint32 height = std::min(_maxsize,std::max(side,next_pot(minh)));
+
+        std::vector<Placement> placed;
+        std::vector<size_t> rejected;
+        Uint32 extent = 0;
+        while (true) {
+            placed.clear();
+            rejected.clear();
+            Skyline skyline(width,height);
+            for(auto it = remain.begin(); it != remain.end(); ++it) {
+                const Image& image = _images[*it];
+                Uint32 x, y;
+                if (skyline.insert(image.width+gutter,image.height+gutter,x,y)) {
+                    placed.push_back({*it,x,y});
+                } else {
+                    rejected.push_back(*it);
+                }
+            }
+            extent = skyline.extent;
+            if (rejected.empty() || (width == _maxsize && height == _maxsize)) {
+                break;
+            } else if (width <= height && width < _maxsize) {
+                width <<= 1;
+            } else {
+                height <<= 1;
+            }
+        }
+
+        // Trim any unused rows from the page
+        height = std::min(height,next_pot(extent));
+
+        Page page;
+        page.width = width;
+        page.height = height;
+        page.pixels.resize((size_t)width*height,0);
+        Uint32 index = (Uint32)_pages.size();
+        for(auto it = placed.begin(); it != placed.end(); ++it) {
+            const Image& image = _images[it->image];
+            blit(image,page,it->x,it->y);
+
+            Region region;
+            region.page = index;
+            region.bounds.origin.set(it->x+_padding,it->y+_padding);
+            region.bounds.size.set(image.width,image.height);
+            _regions[image.name] = region;
+        }
+        _pages.push_back(std::move(page));
+        remain = std::move(rejected);
+    }
+
+    _images.clear();
+    return success;
+}
+
+/**
+ * Copies the given image into the page, extruding its border into the gutter.
+ *
+ * @param image The image to copy
+ * @param page  The destination page
+ * @param x     The left edge of the image cell (including gutter)
+ * @param y     The top edge of the image cell (including gutter)
+ */
+void TexturePacker::blit(const Image& image, Page& page, Uint32 x, Uint32 y) {
+    Uint32 rows = image.height+2*_padding;
+    for(Uint32 row = 0; row < rows; row++) {
+        Uint32 srow = row < _padding ? 0 : std::min(row-_padding,image.height-1);
+        const Uint32* src = image.pixels.data()+(size_t)srow*image.width;
+        Uint32* dst = page.pixels.data()+(size_t)(y+row)*page.width+x;
+        std::fill(dst, dst+_padding, src[0]);
+        std::memcpy(dst+_padding, src, image.width*sizeof(Uint32));
+        std::fill(dst+_padding+image.width, dst+2*_padding+image.width, src[image.width-1]);
+    }
+}
+
+#pragma mark -
+#pragma mark Accessors
+/**
+ * Returns the names of all packed images
+ *
+ * @return the names of all packed images
+ */
+std::vector<std::string> TexturePacker::getNames() const {
+    std::vector<std::string> result;
+    result.reserve(_regions.size());
+    for(auto it = _regions.begin(); it != _regions.end(); ++it) {
+        result.push_back(it->first);
+    }
+    return result;
+}
+
+/**
+ * Returns the location of the given image
+ *
+ * If the image was not packed, the region returned is empty.
+ *
+ * @param name  The image name
+ *
+ * @return the location of the given image
+ */
+TexturePacker::Region TexturePacker::getRegion(const std::string name) const {
+    auto it = _regions.find(name);
+    if (it == _regions.end()) {
+        return Region();
+    }
+    return it->second;
+}
+
+/**
+ * Returns the texture coordinates of the given image
+ *
+ * The values are returned in the order minS, maxS, minT, maxT, which
+ * is the order used by {@link Texture#getSubTexture}. If the image was
+ * not packed, this returns all zeroes.
+ *
+ * @param name  The image name
+ * @param coords    Array to store the four texture coordinates
+ */
+void TexturePacker::getTexCoords(const std::string name, float* coords) const {
+    auto it = _regions.find(name);
+    if (it == _regions.end()) {
+        std::memset(coords, 0, 4*sizeof(float));
+        return;
+    }
+    const Page& page = _pages[it->second.page];
+    const Rect& bounds = it->second.bounds;
+    coords[0] = bounds.origin.x/page.width;
+    coords[1] = (bounds.origin.x+bounds.size.width)/page.width;
+    coords[2] = bounds.origin.y/page.height;
+    coords[3] = (bounds.origin.y+bounds.size.height)/page.height;
+}
@@ -13,6 +13,12 @@
 //  it does not support instancing. For that you will need to use the
 //  InstanceBuffer class, or design your own VertexBuffer abstraction.
 //
+//  A vertex buffer may optionally stream its data through a ring of regions.
+//  In this mode, the caller writes directly into mapped buffer memory, and
+//  fences ensure that a region is never overwritten while the GPU is still
+//  reading from it. This avoids both the buffer orphaning and the extra CPU
+//  copy of the standard load methods.
+//
 //  This class uses our standard shared-pointer architecture.
 //
 //  1. The constructor does not perform any initialization; it just sets all
@@ -51,10 +57,14 @@
 #include <cugl/graphics/CUVertexBuffer.h>
 #include <cugl/graphics/CUShader.h>
 #include <cugl/graphics/CUTexture.h>
+#include <algorithm>
 
 using namespace cugl;
 using namespace cugl::graphics;
 
+/** The time to wait on a fence before checking again (in nanoseconds) */
+#define FENCE_TIMEOUT 1000000000
+
 #pragma mark Constructors
 /**
  * Creates an uninitialized vertex buffer.
@@ -65,7 +75,13 @@ VertexBuffer::VertexBuffer() :
 _vertArray(0),
 _vertBuffer(0),
 _indxBuffer(0),
-_stride(0) {
+_stride(0),
+_regions(0),
+_region(0),
+_mapped(false),
+_pending(false),
+_vertBase(0),
+_indxBase(0) {
     _shader = nullptr;
 }
 
@@ -137,6 +153,18 @@ void VertexBuffer::dispose() {
     if (!_vertArray) {
         return;
     }
+    if (_mapped) {
+        glBindBuffer(GL_ARRAY_BUFFER, _vertBuffer);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indxBuffer);
+        glUnmapBuffer(GL_ELEMENT_ARRAY_BUFFER);
+    }
+    for(auto it = _fences.begin(); it != _fences.end(); ++it) {
+        if (*it) {
+            glDeleteSync(*it);
+        }
+    }
+    _fences.clear();
     _enabled.clear();
     _attributes.clear();
     glDeleteBuffers(1,&_indxBuffer);
@@ -147,6 +175,12 @@ void VertexBuffer::dispose() {
     _vertArray  = 0;
     _shader = nullptr;
     _stride = 0;
+    _regions = 0;
+    _region  = 0;
+    _mapped  = false;
+    _pending = false;
+    _vertBase = 0;
+    _indxBase = 0;
 }
 
 
@@ -217,7 +251,7 @@ void VertexBuffer::attach(const std::shared_ptr<Shader>& shader) {
 				glEnableVertexAttribArray(pos);
 				glVertexAttribPointer(pos,it->second.size,it->second.type,
 									  it->second.norm,_stride,
-									  reinterpret_cast<void*>(it->second.offset));
+									  reinterpret_cast<void*>(it->second.offset+_vertBase));
                 glVertexAttribDivisor(pos,0);
 			} else {
 				glDisableVertexAttribArray(pos);
@@ -288,11 +322,22 @@ void VertexBuffer::loadVertexData(const void * data, GLsizei size, GLenum usage)
     // Assert causes problems on android emulator for now
     //CUAssertLog(isBound(), "Vertex buffer is not bound");
     CUAssertLog(size <= _size, "Data exceeds maximum capacity: %d > %d",size,_size);
+    CUAssertLog(!_mapped, "Cannot load data while a region is mapped");
     glBindBuffer( GL_ARRAY_BUFFER, _vertBuffer );
     GLenum error = glGetError();
     CUAssertLog(error == GL_NO_ERROR, "VertexBuffer: %s", gl_error_name(error).c_str());
 
-    if (usage == GL_STATIC_DRAW) {
+    if (_regions > 0) {
+        // Orphan the whole ring and draw from the start
+        glBufferData(GL_ARRAY_BUFFER, _stride*_size*_regions, NULL, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, _stride*size, data);
+        _region  = 0;
+        _pending = true;
+        if (_vertBase != 0) {
+            _vertBase = 0;
+            pointAttributes();
+        }
+    } else if (usage == GL_STATIC_DRAW) {
         glBufferData( GL_ARRAY_BUFFER, _stride * size, data, usage );
     } else {
         // Buffer orphaning
@@ -338,8 +383,16 @@ void VertexBuffer::loadIndexData(const void * data, GLsizei size, GLenum usage)
     // Assert causes problems on android emulator for now
     //CUAssertLog(isBound(), "Vertex buffer is not bound");
     CUAssertLog(size <= _size, "Data exceeds maximum capacity: %d > %d",size,_size);
+    CUAssertLog(!_mapped, "Cannot load data while a region is mapped");
     glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, _indxBuffer );
-    if (usage == GL_STATIC_DRAW) {
+    if (_regions > 0) {
+        // Orphan the whole ring and draw from the start
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint)*_size*_regions, NULL, GL_STREAM_DRAW);
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, sizeof(GLuint)*size, data);
+        _region   = 0;
+        _pending  = true;
+        _indxBase = 0;
+    } else if (usage == GL_STATIC_DRAW) {
         glBufferData( GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint)*size, data, usage );
     } else {
         // Buffer orphaning
@@ -377,7 +430,7 @@ void VertexBuffer::draw(GLenum mode, GLsizei count, GLsizei offset) {
     // Assert causes problems on android emulator for now
     //CUAssertLog(isBound(), "Vertex buffer is not bound");
     if (count == 0) { return; }
-    glDrawElements(mode, count, GL_UNSIGNED_INT, (void*)(offset * sizeof(GLuint)));
+    glDrawElements(mode, count, GL_UNSIGNED_INT, (void*)((offset+_indxBase) * sizeof(GLuint)));
     GLenum error = glGetError();
     CUAssertLog(error == GL_NO_ERROR, "VertexBuffer: %s", gl_error_name(error).c_str());
 }
@@ -414,6 +467,186 @@ void VertexBuffer::drawDirect(GLenum mode, GLint first, GLsizei count) {
     CUAssertLog(error == GL_NO_ERROR, "VertexBuffer: %s", gl_error_name(error).c_str());
 }
 
+#pragma mark -
+#pragma mark Streaming
+/**
+ * Sets the number of streaming regions, reallocating the buffer storage.
+ *
+ * Setting this value to 0 disables streaming mode. Three regions are
+ * typically enough to guarantee that the CPU never waits on the GPU, as
+ * the driver rarely buffers more than two frames of commands.
+ *
+ * This method discards any data previously loaded into this buffer. It
+ * may not be called while a region is mapped. This method will only
+ * succeed if this buffer is actively bound.
+ *
+ * @param regions   The number of streaming regions
+ *
+ * @return true if the storage was successfully reallocated
+ */
+bool VertexBuffer::setStreaming(GLuint regions) {
+    CUAssertLog(_vertBuffer, "VertexBuffer has not be initialized.");
+    CUAssertLog(!_mapped, "Cannot change streaming while a region is mapped");
+    if (_mapped) {
+        return false;
+    }
+    
+    for(auto it = _fences.begin(); it != _fences.end(); ++it) {
+        if (*it) {
+            glDeleteSync(*it);
+        }
+    }
+    _fences.clear();
+    _fences.resize(regions,0);
+    _regions = regions;
+    _region  = 0;
+    _pending = false;
+    _indxBase = 0;
+    _vertBase = 0;
+    
+    GLsizei amt = std::max(regions,1u);
+    glBindBuffer(GL_ARRAY_BUFFER, _vertBuffer);
+    glBufferData(GL_ARRAY_BUFFER, _stride*_size*amt, NULL, GL_STREAM_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indxBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint)*_size*amt, NULL, GL_STREAM_DRAW);
+    pointAttributes();
+    
+    GLenum error = glGetError();
+    if (error != GL_NO_ERROR) {
+        CULogError("Could not allocate streaming regions. %s", gl_error_name(error).c_str());
+        _fences.clear();
+        _regions = 0;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Maps the next streaming region for writing.
+ *
+ * On success, vertices will point to space for {@link #getCapacity}
+ * vertices, and indices will point to space for the same number of
+ * indices. Indices are relative to the start of the region. This memory
+ * should only be written to, as reading it back can be very slow.
+ *
+ * If the GPU is still drawing from the region, this method will block
+ * until it is done. With enough regions this should never happen.
+ *
+ * This method will only succeed if this buffer is actively bound and in
+ * streaming mode.
+ *
+ * @param vertices  Pointer to store the vertex memory
+ * @param indices   Pointer to store the index memory
+ *
+ * @return true if the region was successfully mapped
+ */
+bool VertexBuffer::mapRegion(void** vertices, GLuint** indices) {
+    CUAssertLog(_regions > 0, "VertexBuffer is not streaming");
+    CUAssertLog(!_mapped, "A region is already mapped");
+    if (_regions == 0 || _mapped) {
+        return false;
+    }
+    
+    // Fence the region just drawn and move on to the next
+    if (_pending) {
+        if (_fences[_region]) {
+            glDeleteSync(_fences[_region]);
+        }
+        _fences[_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        _region = (_region+1) % _regions;
+        _pending = false;
+    }
+    
+    // Wait for the GPU to release this region
+    GLsync fence = _fences[_region];
+    if (fence) {
+        GLenum status = glClientWaitSync(fence, 0, 0);
+        while (status == GL_TIMEOUT_EXPIRED) {
+            status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT);
+        }
+        if (status == GL_WAIT_FAILED) {
+            GLenum error = glGetError();
+            CUWarn("Streaming fence failed. %s", gl_error_name(error).c_str());
+        }
+        glDeleteSync(fence);
+        _fences[_region] = 0;
+    }
+    
+    const GLbitfield access = (GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT |
+                               GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_FLUSH_EXPLICIT_BIT);
+    GLsizeiptr vbytes = (GLsizeiptr)_stride*_size;
+    GLsizeiptr ibytes = (GLsizeiptr)sizeof(GLuint)*_size;
+    
+    glBindBuffer(GL_ARRAY_BUFFER, _vertBuffer);
+    void* vdata = glMapBufferRange(GL_ARRAY_BUFFER, vbytes*_region, vbytes, access);
+    if (vdata == NULL) {
+        GLenum error = glGetError();
+        CULogError("Could not map vertex region. %s", gl_error_name(error).c_str());
+        return false;
+    }
+    
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indxBuffer);
+    void* idata = glMapBufferRange(GL_ELEMENT_ARRAY_BUFFER, ibytes*_region, ibytes, access);
+    if (idata == NULL) {
+        GLenum error = glGetError();
+        CULogError("Could not map index region. %s", gl_error_name(error).c_str());
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        return false;
+    }
+    
+    *vertices = vdata;
+    *indices  = reinterpret_cast<GLuint*>(idata);
+    _mapped = true;
+    return true;
+}
+
+/**
+ * Unmaps the current streaming region, making it ready to draw.
+ *
+ * The sizes are the number of vertices and indices written to the region
+ * since it was mapped. Only this data is flushed to the GPU. Once this
+ * method is called, the methods {@link #draw} and {@link #drawDirect}
+ * will use the data in this region, until the next region is mapped.
+ *
+ * This method will only succeed if this buffer is actively bound.
+ *
+ * @param vsize     The number of vertices written
+ * @param isize     The number of indices written
+ */
+void VertexBuffer::unmapRegion(GLsizei vsize, GLsizei isize) {
+    CUAssertLog(_mapped, "No region is mapped");
+    CUAssertLog(vsize <= _size, "Data exceeds maximum capacity: %d > %d",vsize,_size);
+    CUAssertLog(isize <= _size, "Data exceeds maximum capacity: %d > %d",isize,_size);
+    if (!_mapped) {
+        return;
+    }
+    
+    glBindBuffer(GL_ARRAY_BUFFER, _vertBuffer);
+    if (vsize > 0) {
+        glFlushMappedBufferRange(GL_ARRAY_BUFFER, 0, (GLsizeiptr)_stride*vsize);
+    }
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indxBuffer);
+    if (isize > 0) {
+        glFlushMappedBufferRange(GL_ELEMENT_ARRAY_BUFFER, 0, sizeof(GLuint)*isize);
+    }
+    glUnmapBuffer(GL_ELEMENT_ARRAY_BUFFER);
+    _mapped  = false;
+    _pending = true;
+    
+    // There is no base vertex in OpenGLES, so move the attributes instead
+    GLsizeiptr base = (GLsizeiptr)_stride*_size*_region;
+    if (base != _vertBase) {
+        _vertBase = base;
+        pointAttributes();
+    }
+    _indxBase = (GLsizeiptr)_size*_region;
+    
+    GLenum error = glGetError();
+    CUAssertLog(error == GL_NO_ERROR, "VertexBuffer: %s", gl_error_name(error).c_str());
+}
+
+
 #pragma mark -
 #pragma mark Attributes
 /**
@@ -465,7 +698,7 @@ void VertexBuffer::setupAttribute(const std::string name, GLint size, GLenum typ
         } else {
             glEnableVertexAttribArray(pos);
             glVertexAttribPointer(pos,data.size,data.type,data.norm,_stride,
-                                  reinterpret_cast<GLvoid*>(data.offset));
+                                  reinterpret_cast<GLvoid*>(data.offset+_vertBase));
             glVertexAttribDivisor(pos,0);
         }
         
@@ -517,3 +750,26 @@ void VertexBuffer::disableAttribute(const std::string name) {
 		}
 	}    
 }
+
+/**
+ * Points all enabled attributes at the current vertex region.
+ *
+ * This method is necessary because OpenGLES has no base vertex for
+ * indexed drawing. It does nothing if there is no attached shader.
+ */
+void VertexBuffer::pointAttributes() {
+    if (_shader == nullptr) {
+        return;
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, _vertBuffer);
+    for(auto it = _attributes.begin(); it != _attributes.end(); ++it) {
+        if (_enabled[it->first]) {
+            GLint pos = glGetAttribLocation(_shader->getProgram(), it->first.c_str());
+            if (pos != -1) {
+                glVertexAttribPointer(pos,it->second.size,it->second.type,
+                                      it->second.norm,_stride,
+                                      reinterpret_cast<void*>(it->second.offset+_vertBase));
+            }
+        }
+    }
+}
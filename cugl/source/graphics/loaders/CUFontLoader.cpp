@@ -47,6 +47,7 @@
 #include <cugl/core/util/CUFiletools.h>
 #include <cugl/core/CUApplication.h>
 #include <SDL_ttf.h>
+#include <mutex>
 
 using namespace cugl;
 using namespace cugl::graphics;
@@ -58,6 +59,15 @@ using namespace cugl::graphics;
 /** The default character set (ASCII) */
 #define UNKNOWN_SIZE    12
 
+/**
+ * The lock for opening font faces
+ *
+ * All fonts share a single FreeType library, and opening a face is not safe
+ * to do from several threads at once. Once open, each face can be rasterized
+ * independently, so atlas generation does not need this lock.
+ */
+static std::mutex _faceMutex;
+
 #pragma mark -
 #pragma mark Constructor
 
@@ -99,7 +109,11 @@ std::shared_ptr<Font> FontLoader::preload(const std::string source, const std::s
     std::string root = Application::get()->getAssetDirectory();
     std::string path = root+source;
 
-    std::shared_ptr<Font> result = Font::alloc(path.c_str(),size);
+    std::shared_ptr<Font> result;
+    {
+        std::lock_guard<std::mutex> lock(_faceMutex);
+        result = Font::alloc(path.c_str(),size);
+    }
     if (result == nullptr) {
         return result;
     }
@@ -164,7 +178,11 @@ std::shared_ptr<Font> FontLoader::preload(const std::shared_ptr<JsonValue>& json
     Uint32 stretch = json->getInt("stretch",0);
     Uint32 shrink  = json->getInt("shrink", 0);
 
-    std::shared_ptr<Font> result = Font::alloc(source.c_str(),size);
+    std::shared_ptr<Font> result;
+    {
+        std::lock_guard<std::mutex> lock(_faceMutex);
+        result = Font::alloc(source.c_str(),size);
+    }
     if (result == nullptr) {
         return result;
     }
@@ -215,7 +233,7 @@ bool FontLoader::materialize(const std::string key, const std::shared_ptr<Font>&
     if (callback != nullptr) {
         callback(key,success);
     }
-    _queue.erase(key);
+    dequeue(key);
     return success;
 }
 
@@ -240,7 +258,7 @@ bool FontLoader::materialize(const std::string key, const std::shared_ptr<Font>&
  */
 bool FontLoader::read(const std::string key, const std::string source, int size,
                       LoaderCallback callback, bool async) {
-    if (_assets.find(key) != _assets.end() || _queue.find(key) != _queue.end()) {
+    if (_assets.find(key) != _assets.end() || queued(key)) {
         return false;
     }
     
@@ -253,7 +271,7 @@ bool FontLoader::read(const std::string key, const std::string source, int size,
         _loader->addTask([=,this](void) {
             this->enqueue(key);
             std::shared_ptr<Font> font = this->preload(source,_charset,size);
-            Application::get()->schedule([=,this](void){
+            this->schedule([=,this](void){
                 this->materialize(key,font,callback);
                 return false;
             });
@@ -295,7 +313,7 @@ bool FontLoader::read(const std::string key, const std::string source, int size,
  */
 bool FontLoader::read(const std::shared_ptr<JsonValue>& json, LoaderCallback callback, bool async) {
     std::string key = json->key();
-    if (_assets.find(key) != _assets.end() || _queue.find(key) != _queue.end()) {
+    if (_assets.find(key) != _assets.end() || queued(key)) {
         return false;
     }
     
@@ -308,7 +326,7 @@ bool FontLoader::read(const std::shared_ptr<JsonValue>& json, LoaderCallback cal
         _loader->addTask([=,this](void) {
             this->enqueue(key);
             std::shared_ptr<Font> font = this->preload(json);
-            Application::get()->schedule([=,this](void){
+            this->schedule([=,this](void){
                 this->materialize(key,font,callback);
                 return false;
             });
@@ -131,7 +131,7 @@ bool GradientLoader::materialize(const std::string key,
         callback(key,success);
     }
     
-    _queue.erase(key);
+    dequeue(key);
     return success;
 }
 
@@ -158,7 +158,7 @@ bool GradientLoader::materialize(const std::string key,
  */
 bool GradientLoader::read(const std::string key, const std::string source,
                           LoaderCallback callback, bool async) {
-    if (_assets.find(key) != _assets.end() || _queue.find(key) != _queue.end()) {
+    if (_assets.find(key) != _assets.end() || queued(key)) {
         return false;
     }
 
@@ -171,7 +171,7 @@ bool GradientLoader::read(const std::string key, const std::string source,
         _loader->addTask([=,this](void) {
             this->enqueue(key);
             std::shared_ptr<Gradient> gradient = this->preload(key,source);
-            Application::get()->schedule([=,this](void){
+            this->schedule([=,this](void){
                 this->materialize(key,gradient,callback);
                 return false;
             });
@@ -205,7 +205,7 @@ bool GradientLoader::read(const std::string key, const std::string source,
 bool GradientLoader::read(const std::shared_ptr<JsonValue>& json,
                             LoaderCallback callback, bool async) {
     std::string key = json->key();
-    if (_assets.find(key) != _assets.end() || _queue.find(key) != _queue.end()) {
+    if (_assets.find(key) != _assets.end() || queued(key)) {
         return false;
     }
 
@@ -218,7 +218,7 @@ bool GradientLoader::read(const std::shared_ptr<JsonValue>& json,
         _loader->addTask([=,this](void) {
             this->enqueue(key);
             std::shared_ptr<Gradient> gradient = this->preload(json);
-            Application::get()->schedule([=,this](void){
+            this->schedule([=,this](void){
                 this->materialize(key,gradient,callback);
                 return false;
             });
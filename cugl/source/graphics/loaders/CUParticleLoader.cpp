@@ -138,7 +138,7 @@ bool ParticleLoader::materialize(const std::string key,
         callback(key,success);
     }
     
-    _queue.erase(key);
+    dequeue(key);
     return success;
 }
 
@@ -165,7 +165,7 @@ bool ParticleLoader::materialize(const std::string key,
  */
 bool ParticleLoader::read(const std::string key, const std::string source,
                           LoaderCallback callback, bool async) {
-    if (_assets.find(key) != _assets.end() || _queue.find(key) != _queue.end()) {
+    if (_assets.find(key) != _assets.end() || queued(key)) {
         return false;
     }
 
@@ -178,7 +178,7 @@ bool ParticleLoader::read(const std::string key, const std::string source,
         _loader->addTask([=,this](void) {
             this->enqueue(key);
             std::shared_ptr<ParticleSystem> system = this->preload(key,source);
-            Application::get()->schedule([=,this](void){
+            this->schedule([=,this](void){
                 this->materialize(key,system,callback);
                 return false;
             });
@@ -213,7 +213,7 @@ bool ParticleLoader::read(const std::string key, const std::string source,
 bool ParticleLoader::read(const std::shared_ptr<JsonValue>& json,
                           LoaderCallback callback, bool async) {
     std::string key = json->key();
-    if (_assets.find(key) != _assets.end() || _queue.find(key) != _queue.end()) {
+    if (_assets.find(key) != _assets.end() || queued(key)) {
         return false;
     }
 
@@ -226,7 +226,7 @@ bool ParticleLoader::read(const std::shared_ptr<JsonValue>& json,
         _loader->addTask([=,this](void) {
             this->enqueue(key);
             std::shared_ptr<ParticleSystem> system = this->preload(json);
-            Application::get()->schedule([=,this](void){
+            this->schedule([=,this](void){
                 this->materialize(key,system,callback);
                 return false;
             });
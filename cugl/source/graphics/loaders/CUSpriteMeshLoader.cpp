@@ -138,7 +138,7 @@ bool SpriteMeshLoader::materialize(const std::string key,
     if (callback != nullptr) {
         callback(key,success);
     }
-    _queue.erase(key);
+    dequeue(key);
     return success;
 }
 
@@ -165,7 +165,7 @@ bool SpriteMeshLoader::materialize(const std::string key,
  */
 bool SpriteMeshLoader::read(const std::string key, const std::string source,
                             LoaderCallback callback, bool async) {
-    if (_assets.find(key) != _assets.end() || _queue.find(key) != _queue.end()) {
+    if (_assets.find(key) != _assets.end() || queued(key)) {
         return false;
     }
 
@@ -178,7 +178,7 @@ bool SpriteMeshLoader::read(const std::string key, const std::string source,
         _loader->addTask([=,this](void) {
             this->enqueue(key);
             std::shared_ptr<SpriteMesh> mesh = this->preload(key,source);
-            Application::get()->schedule([=,this](void){
+            this->schedule([=,this](void){
                 this->materialize(key,mesh,callback);
                 return false;
             });
@@ -212,7 +212,7 @@ bool SpriteMeshLoader::read(const std::string key, const std::string source,
 bool SpriteMeshLoader::read(const std::shared_ptr<JsonValue>& json,
                             LoaderCallback callback, bool async) {
     std::string key = json->key();
-    if (_assets.find(key) != _assets.end() || _queue.find(key) != _queue.end()) {
+    if (_assets.find(key) != _assets.end() || queued(key)) {
         return false;
     }
 
@@ -225,7 +225,7 @@ bool SpriteMeshLoader::read(const std::shared_ptr<JsonValue>& json,
         _loader->addTask([=,this](void) {
             this->enqueue(key);
             std::shared_ptr<SpriteMesh> mesh = this->preload(json);
-            Application::get()->schedule([=,this](void){
+            this->schedule([=,this](void){
                 this->materialize(key,mesh,callback);
                 return false;
             });
@@ -7,6 +7,13 @@
 //  texture parameters.  Hence you may wish to load a texture asset multiple
 //  times, though this is potentially wasteful regarding memory.
 //
+//  A JSON directory entry may also pack several images into a single atlas.
+//  This allows sprites that are drawn together to share a texture, so that a
+//  sprite batch does not need to flush between them.
+//
+//  If the loader has a texture cache, decoded images are stored on disk and
+//  reused on later launches, skipping the image decoder entirely.
+//
 //  As with all of our loaders, this loader is designed to be attached to an
 //  asset manager.  In addition, this class uses our standard shared-pointer
 //  architecture.
@@ -147,7 +154,7 @@ void TextureLoader::materialize(const std::string key, SDL_Surface* surface, Loa
         callback(key,success);
     }
     SDL_FreeSurface(surface);
-    _queue.erase(key);
+    dequeue(key);
 }
                                 
 /**
@@ -207,7 +214,252 @@ void TextureLoader::materialize(const std::shared_ptr<JsonValue>& json, SDL_Surf
         callback(key,success);
     }
     SDL_FreeSurface(surface);
-    _queue.erase(key);
+    dequeue(key);
+}
+
+/**
+ * Loads the image for this asset through the texture cache.
+ *
+ * This is an alternative to {@link preload} for a loader with a texture
+ * cache. If mipmaps is true, the image will include a precomputed mipmap
+ * chain. This method is safe to call outside of the main thread.
+ *
+ * @param source    The pathname to the asset
+ * @param mipmaps   Whether to include a mipmap chain
+ *
+ * @return the cached image data
+ */
+std::shared_ptr<TextureCache::Image> TextureLoader::preloadCached(const std::string source, bool mipmaps) {
+    bool absolute = cugl::filetool::is_absolute(source);
+    CUAssertLog(!absolute, "This loader does not accept absolute paths for assets");
+
+    std::string root = Application::get()->getAssetDirectory();
+    return _cache->load(root+source,mipmaps);
+}
+
+/**
+ * Creates an OpenGL texture from cached image data, and assigns it the given key.
+ *
+ * This method finishes the asset loading started in {@link preloadCached}.
+ * This step is not safe to be done in a separate thread.
+ *
+ * The loaded texture will have default parameters for scaling and wrap.
+ * It will have a mipmap if the image data has one.
+ *
+ * This method supports an optional callback function which reports whether
+ * the asset was successfully materialized.
+ *
+ * @param key       The key to access the asset after loading
+ * @param image     The cached image data
+ * @param callback  An optional callback for asynchronous loading
+ */
+void TextureLoader::materialize(const std::string key, const std::shared_ptr<TextureCache::Image>& image,
+                                LoaderCallback callback) {
+    std::shared_ptr<Texture> texture = nullptr;
+    if (image != nullptr) {
+        texture = Texture::allocWithMipMaps(image->data.data(), image->width, image->height, image->levels);
+    }
+    
+    bool success = false;
+    if (texture != nullptr) {
+        _assets[key] = texture;
+        texture->bind();
+        texture->setMinFilter(_minfilter);
+        texture->setMagFilter(_magfilter);
+        texture->setWrapS(_wraps);
+        texture->setWrapT(_wrapt);
+        texture->unbind();
+        success = true;
+    }
+    
+    if (callback != nullptr) {
+        callback(key,success);
+    }
+    dequeue(key);
+}
+
+/**
+ * Creates an OpenGL texture from cached image data according to the directory entry.
+ *
+ * This method finishes the asset loading started in {@link preloadCached}.
+ * This step is not safe to be done in a separate thread. The directory
+ * entry has the same format as for {@link #read}.
+ *
+ * This method supports an optional callback function which reports whether
+ * the asset was successfully materialized.
+ *
+ * @param json      The asset directory entry
+ * @param image     The cached image data
+ * @param callback  An optional callback for asynchronous loading
+ */
+void TextureLoader::materialize(const std::shared_ptr<JsonValue>& json, const std::shared_ptr<TextureCache::Image>& image,
+                                LoaderCallback callback) {
+    std::shared_ptr<Texture> texture = nullptr;
+    if (image != nullptr) {
+        texture = Texture::allocWithMipMaps(image->data.data(), image->width, image->height, image->levels);
+    }
+    std::string key = json->key();
+
+    bool success = false;
+    if (texture != nullptr) {
+        GLuint minflt = gl_filter(json->getString("minfilter","nearest"));
+        GLuint magflt = gl_filter(json->getString("magfilter","linear"));
+        GLuint wrapS = gl_wrap(json->getString("wrapS","clamp"));
+        GLuint wrapT = gl_wrap(json->getString("wrapT","clamp"));
+        
+        texture->setName(json->getString("file",UNKNOWN_SOURCE));
+        _assets[key] = texture;
+        texture->bind();
+        texture->setMinFilter(minflt);
+        texture->setMagFilter(magflt);
+        texture->setWrapS(wrapS);
+        texture->setWrapT(wrapT);
+        texture->unbind();
+        parseAtlas(json,texture);
+        
+        success = true;
+    }
+    
+    if (callback != nullptr) {
+        callback(key,success);
+    }
+    dequeue(key);
+}
+
+/**
+ * Loads and packs the images of an atlas entry outside the main thread.
+ *
+ * This method decodes each image listed in the "pack" attribute of the
+ * directory entry, and packs them into atlas pages. As with {@link preload},
+ * this does not use OpenGL and is safe to call in a separate thread.
+ *
+ * If any image fails to load, it is omitted from the atlas. This method
+ * returns nullptr if no image could be packed.
+ *
+ * @param json      The asset directory entry
+ *
+ * @return the packer with the atlas pages
+ */
+std::shared_ptr<TexturePacker> TextureLoader::preloadPack(const std::shared_ptr<JsonValue>& json) {
+    JsonValue* child = json->get("pack").get();
+    if (child == nullptr || child->size() == 0) {
+        return nullptr;
+    }
+    
+    Uint32 padding = json->getInt("padding",2);
+    Uint32 maxsize = json->getInt("maxsize",2048);
+    std::shared_ptr<TexturePacker> packer = TexturePacker::alloc(padding,maxsize);
+    if (packer == nullptr) {
+        return nullptr;
+    }
+    
+    bool empty = true;
+    for(int ii = 0; ii < child->size(); ii++) {
+        JsonValue* item = child->get(ii).get();
+        std::string source = item->isString() ? item->asString() : item->getString("file",UNKNOWN_SOURCE);
+        if (_cache != nullptr) {
+            std::shared_ptr<TextureCache::Image> image = preloadCached(source,false);
+            if (image == nullptr) {
+                CULogError("Could not load '%s' for atlas '%s'",source.c_str(),json->key().c_str());
+                continue;
+            }
+            empty = !packer->add(item->key(),image->data.data(),image->width,image->height) && empty;
+            continue;
+        }
+        
+        SDL_Surface* surface = preload(source);
+        if (surface == nullptr) {
+            CULogError("Could not load '%s' for atlas '%s'",source.c_str(),json->key().c_str());
+            continue;
+        }
+        empty = !packer->add(item->key(),surface->pixels,surface->w,surface->h,surface->pitch) && empty;
+        SDL_FreeSurface(surface);
+    }
+    
+    if (empty) {
+        return nullptr;
+    }
+    packer->pack();
+    return packer;
+}
+
+/**
+ * Creates the OpenGL textures for a packed atlas entry.
+ *
+ * This method finishes the asset loading started in {@link preloadPack}.
+ * The first atlas page is assigned the key of the directory entry, and any
+ * additional pages have the key as prefix (together with an underscore _
+ * and the page number). Each packed image is assigned its own key in the
+ * "pack" attribute.
+ *
+ * This method supports an optional callback function which reports whether
+ * the asset was successfully materialized.
+ *
+ * @param json      The asset directory entry
+ * @param packer    The packer with the atlas pages
+ * @param callback  An optional callback for asynchronous loading
+ */
+void TextureLoader::materializePack(const std::shared_ptr<JsonValue>& json,
+                                    const std::shared_ptr<TexturePacker>& packer,
+                                    LoaderCallback callback) {
+    std::string key = json->key();
+    bool success = (packer != nullptr);
+    
+    std::vector<std::shared_ptr<Texture>> pages;
+    if (success) {
+        GLuint minflt = gl_filter(json->getString("minfilter","nearest"));
+        GLuint magflt = gl_filter(json->getString("magfilter","linear"));
+        GLuint wrapS = gl_wrap(json->getString("wrapS","clamp"));
+        GLuint wrapT = gl_wrap(json->getString("wrapT","clamp"));
+        bool mipmaps = json->getBool("mipmaps",false);
+        
+        for(size_t ii = 0; success && ii < packer->getPageCount(); ii++) {
+            std::shared_ptr<Texture> texture = Texture::allocWithData(packer->getPageData(ii),
+                                                                      packer->getPageWidth(ii),
+                                                                      packer->getPageHeight(ii));
+            success = (texture != nullptr);
+            if (success) {
+                std::string name = ii == 0 ? key : key+"_"+std::to_string(ii);
+                texture->setName(name);
+                texture->bind();
+                if (mipmaps) { texture->buildMipMaps(); }
+                texture->setMinFilter(minflt);
+                texture->setMagFilter(magflt);
+                texture->setWrapS(wrapS);
+                texture->setWrapT(wrapT);
+                texture->unbind();
+                pages.push_back(texture);
+            }
+        }
+    }
+    
+    if (success) {
+        for(size_t ii = 0; ii < pages.size(); ii++) {
+            _assets[ii == 0 ? key : key+"_"+std::to_string(ii)] = pages[ii];
+        }
+        
+        JsonValue* child = json->get("pack").get();
+        for(int ii = 0; ii < child->size(); ii++) {
+            JsonValue* item = child->get(ii).get();
+            std::string name = item->key();
+            if (!packer->contains(name)) {
+                continue;
+            }
+            
+            float coords[4];
+            packer->getTexCoords(name,coords);
+            std::shared_ptr<Texture> texture = pages[packer->getRegion(name).page];
+            std::shared_ptr<Texture> subtexture = texture->getSubTexture(coords[0],coords[1],coords[2],coords[3]);
+            // Name the subtexture as if it had its own file
+            subtexture->setName(item->isString() ? item->asString() : item->getString("file",UNKNOWN_SOURCE));
+            _assets[name] = subtexture;
+        }
+    }
+    
+    if (callback != nullptr) {
+        callback(key,success);
+    }
+    dequeue(key);
 }
 
 /**
@@ -229,7 +481,24 @@ void TextureLoader::materialize(const std::shared_ptr<JsonValue>& json, SDL_Surf
  * @return true if the asset was successfully loaded
  */
 bool TextureLoader::read(const std::string key, const std::string source, LoaderCallback callback, bool async) {
-    if (_assets.find(key) != _assets.end() || _queue.find(key) != _queue.end()) {
+    if (_assets.find(key) != _assets.end() || queued(key)) {
+        return false;
+    }
+    
+    if (_cache != nullptr) {
+        if (_loader == nullptr || !async) {
+            enqueue(key);
+            materialize(key,preloadCached(source,_mipmaps),nullptr);
+            return _assets.find(key) != _assets.end();
+        }
+        _loader->addTask([=,this](void) {
+            this->enqueue(key);
+            std::shared_ptr<TextureCache::Image> image = this->preloadCached(source,_mipmaps);
+            this->schedule([=,this](void){
+                this->materialize(key,image,callback);
+                return false;
+            });
+        });
         return false;
     }
     
@@ -241,12 +510,12 @@ bool TextureLoader::read(const std::string key, const std::string source, Loader
         if (success) { 
 			_assets[key] = texture;
 		}
-        _queue.erase(key);
+        dequeue(key);
     } else {
         _loader->addTask([=,this](void) {
             this->enqueue(key);
             SDL_Surface* surface = this->preload(source);
-            Application::get()->schedule([=,this](void){
+            this->schedule([=,this](void){
                 this->materialize(key,surface,callback);
                 return false;
             });
@@ -290,6 +559,16 @@ bool TextureLoader::read(const std::string key, const std::string source, Loader
  *      "wrapS":        The s-coord wrap rule ("clamp", "repeat", or "mirrored")
  *      "wrapT":        The t-coord wrap rule ("clamp", "repeat", or "mirrored")
  *
+ * Alternatively, the entry may specify an atlas of packed images. Such
+ * an entry replaces "file" with the following values
+ *
+ *      "pack":         An object mapping keys to image paths (or to objects
+ *                      with a "file" attribute)
+ *      "padding":      The gutter around each image in pixels (int)
+ *      "maxsize":      The maximum width or height of an atlas page (int)
+ *
+ * The filter and wrap settings apply to every atlas page.
+ *
  * @param json      The directory entry for the asset
  * @param callback  An optional callback for asynchronous loading
  * @param async     Whether the asset was loaded asynchronously
@@ -298,11 +577,46 @@ bool TextureLoader::read(const std::string key, const std::string source, Loader
  */
 bool TextureLoader::read(const std::shared_ptr<JsonValue>& json, LoaderCallback callback, bool async) {
     std::string key = json->key();
-    if (_assets.find(key) != _assets.end() || _queue.find(key) != _queue.end()) {
+    if (_assets.find(key) != _assets.end() || queued(key)) {
+        return false;
+    }
+    
+    if (json->has("pack")) {
+        if (_loader == nullptr || !async) {
+            enqueue(key);
+            materializePack(json,preloadPack(json),nullptr);
+            return _assets.find(key) != _assets.end();
+        }
+        _loader->addTask([=,this](void) {
+            this->enqueue(key);
+            std::shared_ptr<TexturePacker> packer = this->preloadPack(json);
+            this->schedule([=,this](void){
+                this->materializePack(json,packer,callback);
+                return false;
+            });
+        });
         return false;
     }
     
     std::string source = json->getString("file",UNKNOWN_SOURCE);
+    if (_cache != nullptr) {
+        bool mipmaps = json->getBool("mipmaps",false);
+        if (_loader == nullptr || !async) {
+            enqueue(key);
+            materialize(json,preloadCached(source,mipmaps),nullptr);
+            return _assets.find(key) != _assets.end();
+        }
+        _loader->addTask([=,this](void) {
+            this->enqueue(key);
+            std::shared_ptr<TextureCache::Image> image = this->preloadCached(source,mipmaps);
+            this->schedule([=,this](void){
+                this->materialize(json,image,callback);
+                return false;
+            });
+        });
+        return false;
+    }
+    
     bool success = false;
     if (_loader == nullptr || !async) {
         enqueue(key);
@@ -311,12 +625,12 @@ bool TextureLoader::read(const std::shared_ptr<JsonValue>& json, LoaderCallback
         if (success) { 
 			_assets[key] = texture;
 		}
-        _queue.erase(key);
+        dequeue(key);
     } else {
         _loader->addTask([=,this](void) {
             this->enqueue(key);
             SDL_Surface* surface = this->preload(source);
-            Application::get()->schedule([=,this](void){
+            this->schedule([=,this](void){
                 this->materialize(json,surface,callback);
                 return false;
             });
@@ -353,7 +667,8 @@ bool TextureLoader::read(const std::shared_ptr<JsonValue>& json, LoaderCallback
  * are released.
  *
  * This version of the method not only unloads the given {@link Texture},
- * but also any texture atlases attached to it.
+ * but also any texture atlases attached to it. For a packed entry, it
+ * unloads every atlas page and packed image.
  *
  * @param json      The directory entry for the asset
  *
@@ -367,8 +682,22 @@ bool TextureLoader::purgeJson(const std::shared_ptr<JsonValue>& json) {
     }
     _assets.erase(it);
     
-    JsonValue* child = json->get("atlas").get();
     bool success = true;
+    JsonValue* child = json->get("pack").get();
+    if (child) {
+        for(int ii = 1; (it = _assets.find(key+"_"+std::to_string(ii))) != _assets.end(); ii++) {
+            _assets.erase(it);
+        }
+        for(int ii = 0; ii < child->size(); ii++) {
+            auto jt = _assets.find(child->get(ii)->key());
+            if (jt != _assets.end()) {
+                _assets.erase(jt);
+            }
+        }
+        return success;
+    }
+    
+    child = json->get("atlas").get();
     if (child) {
         for(int ii = 0; ii < child->size(); ii++) {
             JsonValue* item = child->get(ii).get();
@@ -9,6 +9,10 @@ R"(////////// SHADER BEGIN /////////
 //  coordinates. Finally, there is support for very simple blur effects, which
 //  are used for font labels.
 //
+//  When uInstanced is set, the shader draws instanced quads instead. The
+//  position attribute is then the corner of a unit square, and the quad
+//  transform, texture region, and color come from the instance attributes.
+//
 //  This shader was inspired by nanovg by Mikko Mononen (memon@inside.org).
 //
 //  CUGL MIT License:
@@ -49,6 +53,15 @@ out vec2 outTexCoord;
 in  vec2 aGradCoord;
 out vec2 outGradCoord;
 
+// Instance attributes (quad transform, texture region, and color)
+in vec4 aInstMatrix;
+in vec2 aInstOffset;
+in vec4 aInstTexRect;
+in vec4 aInstColor;
+
+// Whether to draw instanced quads
+uniform int uInstanced;
+
 // Matrices
 uniform mat4 uPerspective;
 
@@ -57,6 +70,18 @@ uniform float uDepth;
 
 // Transform and pass through                                                   
 void main(void) {
+    if (uInstanced != 0) {
+        // Texture coordinates are flipped relative to the quad
+        vec2 corner = aPosition.xy;
+        vec2 param  = vec2(corner.x,1.0-corner.y);
+        vec2 pos = mat2(aInstMatrix.xy,aInstMatrix.zw)*corner+aInstOffset;
+        gl_Position = uPerspective*vec4(pos,0,1);
+        outPosition = pos;
+        outColor = aInstColor;
+        outTexCoord = mix(aInstTexRect.xy,aInstTexRect.zw,param);
+        outGradCoord = param;
+        return;
+    }
     gl_Position = uPerspective*vec4(aPosition.xy,0,1);
     outPosition = aPosition.xy; // Need untransformed for scissor
     outColor = aColor;
@@ -0,0 +1,334 @@
+//
+//  CUCachedNode.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a scene graph node that caches the drawing of its
+//  descendants in a texture. The descendants are drawn once to an offscreen
+//  render target, and every render pass after that draws a single textured
+//  quad. The cache is only drawn again when a descendant changes. This is
+//  ideal for layers that are mostly static, such as backgrounds and props.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Author: Walker White
+//  Version: 7/3/24 (CUGL 3.0 reorganization)
+//
+#include <cugl/scene2/CUCachedNode.h>
+#include <cugl/scene2/CUScene2.h>
+#include <cugl/graphics/CUScissor.h>
+#include <cugl/graphics/CUTexture.h>
+#include <cugl/core/CUDisplay.h>
+#include <cugl/core/assets/CUJsonValue.h>
+#include <cmath>
+
+using namespace cugl;
+using namespace cugl::scene2;
+using namespace cugl::graphics;
+
+#pragma mark Constructors
+/**
+ * Creates an uninitialized cached node.
+ *
+ * You must initialize this CachedNode before use.
+ *
+ * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate a CachedNode
+ * on the heap, use one of the static constructors instead.
+ */
+CachedNode::CachedNode() :
+_density(1.0f),
+_cacheDirty(true),
+_refreshes(0) {
+    _classname = "CachedNode";
+    Display* display = Display::get();
+    if (display) {
+        _density = display->getPixelDensity();
+    }
+}
+
+/**
+ * Disposes all of the resources used by this node.
+ *
+ * A disposed CachedNode can be safely reinitialized. Any children owned by
+ * this node will be released. They will be deleted if no other object owns
+ * them.
+ *
+ * It is unsafe to call this on a CachedNode that is still currently inside
+ * of a scene graph.
+ */
+void CachedNode::dispose() {
+    _target = nullptr;
+    _cacheDirty = true;
+    _refreshes = 0;
+    SceneNode::dispose();
+}
+
+/**
+ * Initializes a node with the given JSON specificaton.
+ *
+ * This initializer is designed to receive the "data" object from the
+ * JSON passed to {@link Scene2Loader}. This JSON format supports all
+ * of the attribute values of its parent class. In addition, it supports
+ * the following additional attribute:
+ *
+ *      "density":  A number representing the pixels per point of the cache
+ *
+ * All attributes are optional. There are no required attributes.
+ *
+ * @param manager   The asset manager handling this asset
+ * @param data      The JSON object specifying the node
+ *
+ * @return true if initialization was successful.
+ */
+bool CachedNode::initWithData(const AssetManager* manager,
+                              const std::shared_ptr<JsonValue>& data) {
+    if (SceneNode::initWithData(manager, data)) {
+        _density = data->getFloat("density", _density);
+        _cacheDirty = true;
+        return true;
+    }
+    return false;
+}
+
+#pragma mark -
+#pragma mark Attributes
+/**
+ * Sets the pixel density of the cache.
+ *
+ * This is the number of texture pixels per point of the content size.
+ * By default, it is the pixel density of the display. Changing this
+ * value will cause the cache to be drawn again.
+ *
+ * @param density   The pixel density of the cache.
+ */
+void CachedNode::setDensity(float density) {
+    CUAssertLog(density > 0, "Density %f is not positive", density);
+    if (_density != density) {
+        _density = density;
+        _cacheDirty = true;
+    }
+}
+
+/**
+ * Sets the untransformed size of the node.
+ *
+ * The content size is the region covered by the cache. Changing the
+ * size will cause the cache to be drawn again.
+ *
+ * @param size  The untransformed size of the node.
+ */
+void CachedNode::setContentSize(const Size size) {
+    if (size != _contentSize) {
+        _cacheDirty = true;
+    }
+    SceneNode::setContentSize(size);
+}
+
+#pragma mark -
+#pragma mark Rendering
+/**
+ * Draws this node and all of its children with the given SpriteBatch.
+ *
+ * If the cache is dirty, this method draws the descendants of this node
+ * to the cache first. It then draws the cache as a single quad.
+ *
+ * @param batch     The SpriteBatch to draw with.
+ * @param transform The global transformation matrix.
+ * @param tint      The tint to blend with the node color.
+ */
+void CachedNode::render(const std::shared_ptr<SpriteBatch>& batch,
+                        const Affine2& transform, Color4 tint) {
+    if (!_isVisible) {
+        // Hidden nodes miss parent updates, so recompute when shown
+        _worldDirty = true;
+        return;
+    } else if (_contentSize.width <= 0 || _contentSize.height <= 0) {
+        // There is nothing to cache
+        SceneNode::render(batch, transform, tint);
+        return;
+    }
+
+    updateWorld(transform, tint);
+    if (_cacheDirty || _target == nullptr) {
+        refresh(batch);
+    }
+
+    std::shared_ptr<Scissor> active = batch->getScissor();
+    if (_scissor) {
+        std::shared_ptr<Scissor> local = Scissor::alloc(_scissor);
+        local->multiply(_world);
+        if (active) {
+            local->intersect(active);
+        }
+        batch->setScissor(local);
+    }
+
+    draw(batch,_world,_worldTint);
+
+    if (_scissor) {
+        batch->setScissor(active);
+    }
+}
+
+/**
+ * Draws the cache of this node via the given SpriteBatch.
+ *
+ * This method only draws the cached texture. It does not refresh the
+ * cache if it is dirty.
+ *
+ * @param batch     The SpriteBatch to draw with.
+ * @param transform The global transformation matrix.
+ * @param tint      The tint to blend with the node color.
+ */
+void CachedNode::draw(const std::shared_ptr<SpriteBatch>& batch,
+                      const Affine2& transform, Color4 tint) {
+    if (_target == nullptr) {
+        return;
+    }
+
+    // The cache has premultiplied alpha
+    GLenum srcRGB = batch->getSrcBlendRGB();
+    GLenum srcAlpha = batch->getSrcBlendAlpha();
+    GLenum dstRGB = batch->getDstBlendRGB();
+    GLenum dstAlpha = batch->getDstBlendAlpha();
+    batch->setSrcBlendFunc(GL_ONE);
+    batch->setDstBlendFunc(GL_ONE_MINUS_SRC_ALPHA);
+
+    batch->draw(_target->getTexture(), tint.getPremultiplied(),
+                Rect(Vec2::ZERO,_contentSize), Vec2::ZERO, transform);
+
+    batch->setSrcBlendFunc(srcRGB,srcAlpha);
+    batch->setDstBlendFunc(dstRGB,dstAlpha);
+}
+
+/**
+ * Prepares this node to be drawn, returning true if the children should be prepared.
+ *
+ * This method updates the world transform of this node, but always
+ * returns false. The descendants of this node are drawn in cache space
+ * (if they are drawn at all), so preparing them is wasted work.
+ *
+ * @param transform The global transformation matrix.
+ * @param tint      The tint to blend with the node color.
+ *
+ * @return false, as the children of this node should not be prepared.
+ */
+bool CachedNode::prepare(const Affine2& transform, Color4 tint) {
+    SceneNode::prepare(transform, tint);
+    return false;
+}
+
+#pragma mark -
+#pragma mark Internal Helpers
+/**
+ * Draws the descendants of this node to the cache.
+ *
+ * If the sprite batch is in the middle of a pass, that pass is ended
+ * and restarted with the same perspective, scissor, color, and blend
+ * state.
+ *
+ * @param batch     The SpriteBatch to draw with.
+ */
+void CachedNode::refresh(const std::shared_ptr<SpriteBatch>& batch) {
+    int width  = (int)std::ceil(_contentSize.width*_density);
+    int height = (int)std::ceil(_contentSize.height*_density);
+    if (_target == nullptr || _target->getWidth() != width || _target->getHeight() != height) {
+        _target = RenderTarget::alloc(width, height);
+        if (_target == nullptr) {
+            CULogError("Could not allocate a %dx%d cache for node '%s'",
+                       width, height, _name.c_str());
+            return;
+        }
+        _target->setClearColor(Color4::CLEAR);
+    }
+
+    // Capture the sprite batch state
+    bool drawing = batch->isDrawing();
+    Mat4 perspective = batch->getPerspective();
+    std::shared_ptr<Scissor> scissor = batch->getScissor();
+    GLenum equation = batch->getBlendEquation();
+    GLenum srcRGB = batch->getSrcBlendRGB();
+    GLenum srcAlpha = batch->getSrcBlendAlpha();
+    GLenum dstRGB = batch->getDstBlendRGB();
+    GLenum dstAlpha = batch->getDstBlendAlpha();
+    Color4 color = batch->getColor();
+    if (drawing) {
+        batch->end();
+    }
+
+    // Render targets always restore the screen, so remember the real one
+    GLint framebuffer = 0;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &framebuffer);
+
+    // The view bounds do not apply in cache space
+    bool culling = false;
+    if (_graph != nullptr) {
+        culling = _graph->_viewActive;
+        _graph->_viewActive = false;
+    }
+
+    // Flip the image so the texture is right side up
+    Mat4 matrix;
+    Mat4::createOrthographicOffCenter(0, _contentSize.width, 0, _contentSize.height,
+                                      -1, 1, &matrix);
+    matrix.scale(1,-1,1);
+
+    _target->begin();
+    batch->begin(matrix);
+    batch->setScissor(nullptr);
+    batch->setBlendEquation(GL_FUNC_ADD);
+    batch->setSrcBlendFunc(GL_SRC_ALPHA, GL_ONE);
+    batch->setDstBlendFunc(GL_ONE_MINUS_SRC_ALPHA);
+    batch->setColor(Color4::WHITE);
+    for(auto it = _children.begin(); it != _children.end(); ++it) {
+        (*it)->render(batch, Affine2::IDENTITY, Color4::WHITE);
+    }
+    batch->end();
+    _target->end();
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+
+    if (_graph != nullptr) {
+        _graph->_viewActive = culling;
+    }
+
+    // Restore the sprite batch state
+    batch->setPerspective(perspective);
+    batch->setScissor(scissor);
+    batch->setBlendEquation(equation);
+    batch->setSrcBlendFunc(srcRGB,srcAlpha);
+    batch->setDstBlendFunc(dstRGB,dstAlpha);
+    batch->setColor(color);
+    if (drawing) {
+        batch->begin();
+    }
+
+    _cacheDirty = false;
+    _refreshes++;
+}
@@ -777,8 +777,8 @@ public:
     std::vector<PathOrientation> orients;
     /** A tool for flattening splines */
     SplinePather flatner;
-    /** A toold for extruding paths */
-    SimpleExtruder extruder;
+    /** A tool for extruding paths (reused to avoid buffer allocation) */
+    MeshExtruder extruder;
     /* The spline "workspace" for an uncommited path */
     Spline2 spline;
     /** Whether there is an uncommitted path */
@@ -1082,9 +1082,8 @@ public:
                                 Color4 clear = state->fillColor;
                                 clear.a = 0;
                                 
-                                MeshExtruder extruder;
-                                extruder.clear();
                                 extruder.set(path->vertices,true);
+                                extruder.setMitreLimit(10.0f);
                                 extruder.setJoint(poly2::Joint::MITRE);
                                 
                                 switch (direction) {
@@ -1139,7 +1138,6 @@ public:
                             color.a *= state->globalAlpha;
                             
                             // Extrude the basic shape
-                            MeshExtruder extruder;
                             extruder.set(*path);
                             extruder.setMitreLimit(state->mitreLimit);
                             extruder.setEndCap(state->lineCap);
@@ -11,6 +11,10 @@
 //  class. You should set these values to manually arrange your scene graph
 //  elements
 //
+//  An ordered node can also (optionally) regroup its render queue to reduce
+//  the number of draw calls. Within a priority layer, draws that do not
+//  overlap are gathered together by texture and blend state.
+//
 //  This class uses our standard shared-pointer architecture.
 //
 //  1. The constructor does not perform any initialization; it just sets all
@@ -45,48 +49,21 @@
 //  Version: 7/3/24 (CUGL 3.0 reorganization)
 //
 #include <cugl/scene2/CUOrderedNode.h>
+#include <cugl/scene2/CUCachedNode.h>
+#include <cugl/scene2/CUTexturedNode.h>
+#include <cugl/scene2/CUWireNode.h>
 #include <cugl/graphics/CUScissor.h>
+#include <cugl/graphics/CUTexture.h>
+#include <typeinfo>
 
 using namespace cugl;
 using namespace cugl::scene2;
 using namespace cugl::graphics;
 
-#pragma mark Context
-/**
- * Creates a drawing context with the given parent object
- *
- * @param parent    The parent object for the inner class
- */
-OrderedNode::Context::Context(OrderedNode* parent) :
-node(nullptr),
-scissor(nullptr),
-canonical(0) {
-    this->parent = parent;
-    tint = Color4::WHITE;
-}
-       
-
-/**
- * Creates a copy of the given drawing context
- *
- * @param copy      The drawing context to copy
- */
-OrderedNode::Context::Context(const Context& copy) {
-    node = copy.node;
-    scissor = copy.scissor;
-    canonical = copy.canonical;
-    transform = copy.transform;
-    tint = copy.tint;
-}
-
-/**
- * Deletes this drawing context, disposing of all resources.
- */
-OrderedNode::Context::~Context() {
-    node = nullptr;
-    scissor = nullptr;
-}
+/** The number of batches to search back when regrouping a node */
+#define BATCH_WINDOW    32
 
+#pragma mark Context
 /**
  * Returns the value *a < *b
  *
@@ -145,8 +122,11 @@ bool OrderedNode::Context::sortCompare(Context* a, Context* b) {
  * on the heap, use one of the static constructors instead.
  */
 OrderedNode::OrderedNode() :
-_viewport(nullptr),
-_order(Order::PRE_ORDER) {
+_scissorSize(0),
+_viewport(-1),
+_order(Order::PRE_ORDER),
+_batching(false),
+_batchesSaved(0) {
     _classname = "OrderedNode";
 }
 
@@ -160,12 +140,15 @@ _order(Order::PRE_ORDER) {
  * a scene graph.
  */
 void OrderedNode::dispose() {
-    for(auto it = _entries.begin(); it != _entries.end(); ++it) {
-        delete *it;
-        *it = nullptr;
-    }
     _entries.clear();
-    _viewport = nullptr;
+    _queue.clear();
+    _batches.clear();
+    _scissors.clear();
+    _scissorSize = 0;
+    _active = nullptr;
+    _viewport = -1;
+    _batching = false;
+    _batchesSaved = 0;
     SceneNode::dispose();
 }
 
@@ -238,6 +221,7 @@ bool OrderedNode::initWithOrder(Order order, Rect bounds) {
  * the following additional attributes:
  *
  *      "order":    The sort order of this node.
+ *      "batching": Whether to regroup draws to reduce draw calls.
  *
  * Sort orders are specified as lower case strings representing the names
  * of the enum with dashes in place of underscores (e.g. "pre-order",
@@ -273,6 +257,7 @@ bool OrderedNode::initWithData(const AssetManager* manager,
                 _order = Order::POST_DESCEND;
             }
         }
+        _batching = data->getBool("batching", false);
         return true;
     }
     return false;
@@ -290,59 +275,83 @@ bool OrderedNode::initWithData(const AssetManager* manager,
  * @param transform The global transformation matrix.
  * @param tint      The tint to blend with the node color.
  */
-void OrderedNode::visit(const std::shared_ptr<SceneNode>& node, const Affine2& transform, Color4 tint) {
-    if (!node->isVisible()) { return; }
-
-    Affine2 matrix;
-    Affine2::multiply(node->getTransform(),transform,&matrix);
-    Color4 color = node->getColor();
-    if (node->hasRelativeColor()) {
-        color *= tint;
+void OrderedNode::visit(SceneNode* node, const Affine2& transform, Color4 tint) {
+    if (!node->isVisible()) {
+        node->_worldDirty = true;
+        return;
+    }
+    
+    // Barriers compute their own transform when rendered
+    bool barrier = (dynamic_cast<OrderedNode*>(node) != nullptr ||
+                    dynamic_cast<CachedNode*>(node) != nullptr);
+    if (!barrier) {
+        node->updateWorld(transform, tint);
     }
+    const Affine2& matrix = node->_world;
+    Color4 color = node->_worldTint;
     
     // We need to capture the important sprite batch state
-    std::shared_ptr<Scissor> previous = _viewport;
-    std::shared_ptr<Scissor> current = nullptr;
-    if (node->getScissor()) {
-        current = Scissor::alloc(node->getScissor());
-        current->setTransform(matrix);
-        if (previous) {
-            current->intersect(previous);
-        }
-        _viewport = current;
+    Sint32 previous = _viewport;
+    if (node->getScissor() && !barrier) {
+        _viewport = acquireScissor(node->getScissor(), matrix);
     }
     
     // Identify pre or post. Block at child ordered nodes
     bool ispost = (_order == Order::POST_ORDER || _order == Order::POST_ASCEND || _order == Order::POST_DESCEND);
-    bool barrier = node->getClassName() == getClassName();
     if (ispost && !barrier) {
-        auto children = node->getChildren();
-        for(auto it = children.begin(); it != children.end(); ++it) {
-            visit(*it, matrix, color);
+        for(auto it = node->_children.begin(); it != node->_children.end(); ++it) {
+            visit(it->get(), matrix, color);
         }
     }
     
     // Capture pre or post order traversal
-    Uint32 canonical = (_entries.empty() ? 0 : _entries.back()->canonical+1);
-    
-    Context* context = new Context(this);
+    Context context;
+    context.parent = this;
+    context.node = node;
+    context.transform = barrier ? transform : matrix;
+    context.scissor = _viewport;
+    context.tint = barrier ? tint : color;
+    context.canonical = (Uint32)_entries.size();
+    context.next = nullptr;
+    context.barrier = barrier;
     _entries.push_back(context);
-    context->node = node;
-    context->transform = barrier ? transform : matrix;
-    context->scissor = _viewport;
-    context->tint = barrier ? tint : color;
-    context->canonical = canonical;
     
     if (!ispost && !barrier) {
-        auto children = node->getChildren();
-        for(auto it = children.begin(); it != children.end(); ++it) {
-            visit(*it, matrix, color);
+        for(auto it = node->_children.begin(); it != node->_children.end(); ++it) {
+            visit(it->get(), matrix, color);
         }
     }
 
     _viewport = previous;
 }
 
+/**
+ * Returns a scissor mask for the given node, intersected with the viewport.
+ *
+ * The scissor mask is taken from a pool that is reused every render pass.
+ * The value returned is the index of the mask in that pool.
+ *
+ * @param scissor   The local scissor mask of the node
+ * @param transform The global transformation matrix of the node
+ *
+ * @return the index of the scissor mask for the given node
+ */
+Sint32 OrderedNode::acquireScissor(const std::shared_ptr<Scissor>& scissor,
+                                   const Affine2& transform) {
+    if (_scissorSize == _scissors.size()) {
+        _scissors.push_back(Scissor::alloc(scissor));
+    } else {
+        _scissors[_scissorSize]->set(scissor);
+    }
+    const std::shared_ptr<Scissor>& result = _scissors[_scissorSize];
+    result->setTransform(transform);
+    const std::shared_ptr<Scissor>& current = getMask(_viewport);
+    if (current) {
+        result->intersect(current);
+    }
+    return (Sint32)(_scissorSize++);
+}
+
 /**
  * Draws this node and all of its children with the given SpriteBatch.
  *
@@ -364,49 +373,196 @@ void OrderedNode::render(const std::shared_ptr<SpriteBatch>& batch, const Affine
         // Drop to standard for efficiency
         SceneNode::render(batch,transform,tint);
     } else {
-        Affine2 matrix;
-        Affine2::multiply(_combined,transform,&matrix);
-        Color4 color = _tintColor;
-        if (_hasParentColor) {
-            color *= tint;
-        }
+        updateWorld(transform, tint);
+        const Affine2& matrix = _world;
+        Color4 color = _worldTint;
         
         // Capture sprite batch context
-        std::shared_ptr<Scissor> active = batch->getScissor();
-        _viewport = active;
+        _active = batch->getScissor();
+        _viewport = -1;
+        _scissorSize = 0;
         if (_scissor) {
-            std::shared_ptr<Scissor> local = Scissor::alloc(_scissor);
-            local->setTransform(matrix);
-            if (active) {
-                local->intersect(active);
-            }
-            _viewport = local;
+            _viewport = acquireScissor(_scissor, matrix);
         }
 
         // Build and sort
-        for(auto it = _children.begin(); it != _children.end(); ++it) {
-            visit(*it, matrix, color);
+        _entries.clear();
+        if (queryChildren()) {
+            for(auto it = _culled.begin(); it != _culled.end(); ++it) {
+                visit(static_cast<SceneNode*>(*it), matrix, color);
+            }
+        } else {
+            for(auto it = _children.begin(); it != _children.end(); ++it) {
+                visit(it->get(), matrix, color);
+            }
         }
-
-        std::sort(_entries.begin(), _entries.end(), Context::sortCompare);
+        
+        _queue.clear();
         for(auto it = _entries.begin(); it != _entries.end(); ++it) {
+            _queue.push_back(&(*it));
+        }
+
+        std::sort(_queue.begin(), _queue.end(), Context::sortCompare);
+        if (_batching) {
+            batchEntries();
+        }
+        
+        // The batch scissor only changes when the context scissor does
+        Sint32 scissor = -1;
+        for(auto it = _queue.begin(); it != _queue.end(); ++it) {
             Context* context = *it;
-            batch->setScissor(context->scissor); // This is in render, so must be applied
-            if (context->node->getClassName() == getClassName()) {
+            if (context->scissor != scissor) {
+                batch->setScissor(getMask(context->scissor)); // This is in render, so must be applied
+                scissor = context->scissor;
+            }
+            if (context->barrier) {
                 // Render barrier at an ordered node
                 context->node->render(batch, context->transform, context->tint);
+                scissor = -2;
             } else {
                 context->node->draw(batch, context->transform, context->tint);
             }
         }
 
-        // Clean up and restore state
-        for(auto it = _entries.begin(); it != _entries.end(); ++it) {
-            delete *it;
-            *it = nullptr;
-        }
+        // Clean up and restore state (keeping the memory for the next pass)
+        batch->setScissor(_active);
         _entries.clear();
-        _viewport = nullptr;
-        batch->setScissor(active);
+        _queue.clear();
+        _viewport = -1;
+        _active = nullptr;
+    }
+}
+
+/**
+ * Regroups the sorted render queue to reduce the number of draw calls.
+ *
+ * The queue is processed one priority layer at a time. Within a layer,
+ * a node is moved earlier to join the most recent batch with the same
+ * drawing state, provided that it does not overlap any batch that it
+ * moves in front of. This method also computes the number of batches
+ * saved.
+ */
+void OrderedNode::batchEntries() {
+    _batchesSaved = 0;
+    size_t start = 0;
+    while (start < _queue.size()) {
+        float priority = _queue[start]->node->getPriority();
+        size_t end = start+1;
+        while (end < _queue.size() && _queue[end]->node->getPriority() == priority) {
+            end++;
+        }
+        _batchesSaved += batchLayer(start, end);
+        start = end;
+    }
+}
+
+/**
+ * Regroups the given priority layer of the render queue.
+ *
+ * The layer is the range [start,end) of the (sorted) render queue. The
+ * queue is rewritten in place.
+ *
+ * @param start     The first entry of the layer
+ * @param end       The entry after the last entry of the layer
+ *
+ * @return the number of batches saved in this layer
+ */
+Uint32 OrderedNode::batchLayer(size_t start, size_t end) {
+    if (end-start < 2) {
+        return 0;
+    }
+    
+    _batches.clear();
+    Uint32 before = 0;
+    Batch previous;
+    bool started = false;
+    for(size_t ii = start; ii < end; ii++) {
+        Context* context = _queue[ii];
+        context->next = nullptr;
+        
+        Batch item;
+        item.texture = 0;
+        item.gradient = nullptr;
+        item.scissor  = context->scissor;
+        item.blendEq  = GL_FUNC_ADD;
+        item.srcFactor = GL_SRC_ALPHA;
+        item.dstFactor = GL_ONE_MINUS_SRC_ALPHA;
+        item.lines   = false;
+        item.fixed   = false;
+        item.passive = false;
+        item.head = context;
+        item.tail = context;
+        
+        SceneNode* node = context->node;
+        TexturedNode* textured = dynamic_cast<TexturedNode*>(node);
+        if (textured != nullptr) {
+            auto texture = textured->getTexture();
+            item.texture  = texture == nullptr ? 0 : texture->getBuffer();
+            item.gradient = textured->getGradient().get();
+            item.blendEq  = textured->getBlendEquation();
+            item.srcFactor = textured->getSourceBlendFactor();
+            item.dstFactor = textured->getDestinationBlendFactor();
+            item.lines  = dynamic_cast<WireNode*>(node) != nullptr;
+            item.bounds = context->transform.transform(Rect(Vec2::ZERO,node->getContentSize()));
+        } else if (typeid(*node) == typeid(SceneNode)) {
+            item.passive = true;
+        } else {
+            item.fixed = true;
+        }
+        
+        // Count the batches in the original order
+        if (!item.passive) {
+            if (item.fixed || !started || previous.fixed || !previous.matches(item)) {
+                before++;
+            }
+            previous = item;
+            started  = true;
+        }
+        
+        // Find the most recent compatible batch we can move to
+        Batch* target = nullptr;
+        if (item.passive) {
+            target = _batches.empty() ? nullptr : &_batches.back();
+        } else if (!item.fixed) {
+            size_t limit = _batches.size() > BATCH_WINDOW ? _batches.size()-BATCH_WINDOW : 0;
+            for(size_t jj = _batches.size(); jj > limit; jj--) {
+                Batch* batch = &_batches[jj-1];
+                if (batch->fixed) {
+                    break;
+                } else if (batch->passive) {
+                    continue;
+                } else if (batch->matches(item)) {
+                    target = batch;
+                    break;
+                } else if (batch->bounds.doesIntersect(item.bounds)) {
+                    break;
+                }
+            }
+        }
+        
+        if (target != nullptr) {
+            target->tail->next = context;
+            target->tail = context;
+            if (!item.passive) {
+                target->bounds.merge(item.bounds);
+            }
+        } else {
+            _batches.push_back(item);
+        }
+    }
+    
+    // Rewrite the layer in batch order
+    Uint32 after = 0;
+    size_t pos = start;
+    for(auto it = _batches.begin(); it != _batches.end(); ++it) {
+        if (!it->passive) {
+            after++;
+        }
+        for(Context* context = it->head; context != nullptr; context = context->next) {
+            _queue[pos++] = context;
+        }
     }
+    CUAssertLog(pos == end, "Batching lost render entries");
+    _batches.clear();
+    return before > after ? before-after : 0;
 }
@@ -44,6 +44,7 @@
 //
 #include <cugl/core/assets/CUAssetManager.h>
 #include <cugl/core/util/CUDebug.h>
+#include <cugl/core/util/CUHashtools.h>
 #include <cugl/scene2/CUScene2Loader.h>
 #include <cugl/scene2/CUPathNode.h>
 #include <cugl/graphics/CUGradient.h>
@@ -69,7 +70,9 @@ _stroke(1.0f),
 _fringe(0.0f),
 _stencil(false),
 _joint(poly2::Joint::SQUARE),
-_endcap(poly2::EndCap::BUTT) {
+_endcap(poly2::EndCap::BUTT),
+_extruded(false),
+_extrusion(0) {
     _classname = "PathNode";
 }
 
@@ -351,6 +354,10 @@ std::shared_ptr<SceneNode> PathNode::copy(const std::shared_ptr<SceneNode>& dst)
         node->_border  = _border;
         node->_extruder = _extruder;
         node->_extrabounds = _extrabounds;
+        node->_extruded  = _extruded;
+        node->_extrusion = _extrusion;
+        node->_extmesh   = _extmesh;
+        node->_extborder = _extborder;
     }
     return dst;
 }
@@ -618,10 +625,24 @@ void PathNode::updateTextureCoords() {
 
 /**
  * Updates the extrusion polygon, based on the current settings.
+ *
+ * This method uses {@link SimpleExtruder}, as it is safe for framerate
+ * calculation. The result is memoized by a hash of the path, the stroke,
+ * the joint, the cap, and the fringe. If none of these have changed since
+ * the last extrusion, this method copies the cached meshes instead of
+ * extruding again. The mesh buffers are reused, so this does not allocate
+ * memory unless the extrusion grows.
  */
 void PathNode::updateExtrusion() {
-    _border.clear();
-    _mesh.clear();
+    size_t key = hashExtrusion();
+    if (_extruded && key == _extrusion) {
+        _mesh = _extmesh;
+        _border = _extborder;
+        return;
+    }
+
+    _extborder.clear();
+    _extmesh.clear();
     _polygon.clear();
 
     Color4 clear = Color4(255,255,255,0);
@@ -635,19 +656,19 @@ void PathNode::updateExtrusion() {
         _extruder.getPolygon(&_polygon);
         _extrabounds = _polygon.getBounds();
         _extrabounds.origin += _path.getBounds().origin;
-        _mesh.set(_polygon);
+        _extmesh.set(_polygon);
         
         if (_fringe > 0) {
             std::vector<Path2> outlines;
             _extruder.getBorder(outlines);
-            _border.command = GL_TRIANGLES;
+            _extborder.command = GL_TRIANGLES;
             for(auto it = outlines.begin(); it != outlines.end(); ++it) {
                 _extruder.clear();
                 _extruder.set(*it);
                 _extruder.setJoint(poly2::Joint::MITRE);
                 _extruder.setEndCap(poly2::EndCap::BUTT);
                 _extruder.calculate(0,_fringe);
-                _extruder.getMesh(&_border,Color4::WHITE,clear);
+                _extruder.getMesh(&_extborder,Color4::WHITE,clear);
             }
         }
     } else if (_fringe > 0) {
@@ -664,28 +685,50 @@ void PathNode::updateExtrusion() {
         _extruder.setJoint(poly2::Joint::MITRE);
         _extruder.setEndCap(poly2::EndCap::BUTT);
         _extruder.calculate(0,_fringe);
-        _border.command = GL_TRIANGLES;
+        _extborder.command = GL_TRIANGLES;
         _extruder.getPolygon(&_polygon);
-        _extruder.getMesh(&_border,Color4::WHITE,clear);
+        _extruder.getMesh(&_extborder,Color4::WHITE,clear);
         _extrabounds = _polygon.getBounds();
         _extrabounds.origin += _path.getBounds().origin;
     } else {
         GLuint white =  Color4::WHITE.getPacked();
         // Just make a wireframe
         for (auto it = _path.vertices.begin(); it != _path.vertices.end(); ++it) {
-            _mesh.vertices.emplace_back();
-            SpriteVertex* vert = &_mesh.vertices.back();
+            _extmesh.vertices.emplace_back();
+            SpriteVertex* vert = &_extmesh.vertices.back();
             vert->position = *it;
             vert->color = white;
         }
         for(Uint32 ii = 0; ii < _path.vertices.size()-1; ii++) {
-            _mesh.indices.push_back(ii  );
-            _mesh.indices.push_back(ii+1);
+            _extmesh.indices.push_back(ii  );
+            _extmesh.indices.push_back(ii+1);
         }
         if (_path.isClosed()) {
-            _mesh.indices.push_back((Uint32)_path.vertices.size()-1);
-            _mesh.indices.push_back(0);
+            _extmesh.indices.push_back((Uint32)_path.vertices.size()-1);
+            _extmesh.indices.push_back(0);
         }
         _extrabounds = _path.getBounds();
     }
+
+    _extrusion = key;
+    _extruded = true;
+    _mesh = _extmesh;
+    _border = _extborder;
+}
+
+/**
+ * Returns the content hash of the current extrusion inputs.
+ *
+ * The hash includes the path vertices, whether the path is closed, the
+ * stroke width, the joint, the end cap, and the fringe width.
+ *
+ * @return the content hash of the current extrusion inputs.
+ */
+size_t PathNode::hashExtrusion() const {
+    size_t result = 0;
+    size_t size = _path.vertices.size();
+    size_t points = hashtool::hash_bytes(_path.vertices.data(), size*sizeof(Vec2));
+    hashtool::hash_combine(result, size, points, _path.closed, _stroke,
+                           (int)_joint, (int)_endcap, _fringe);
+    return result;
 }
@@ -47,6 +47,7 @@
 #include <cugl/core/util/CUTimestamp.h>
 #include <cugl/core/math/polygon/CUSimpleExtruder.h>
 #include <cugl/core/math/polygon/CUEarclipTriangulator.h>
+#include <cugl/core/math/polygon/CUTriangulationCache.h>
 
 using namespace cugl;
 using namespace cugl::scene2;
@@ -182,11 +183,14 @@ std::shared_ptr<SceneNode> PolygonNode::copy(const std::shared_ptr<SceneNode>& d
  * Sets the polgon to the vertices expressed in texture space.
  *
  * The vertices will be triangulated with {@link EarclipTriangulator}.
+ * The triangulation uses the shared {@link TriangulationCache}, so shapes
+ * that repeat (such as animation frames) are only triangulated once.
  *
  * @param vertices  The vertices to texture
  */
 void PolygonNode::setPolygon(const std::vector<Vec2>& vertices) {
     EarclipTriangulator triangulator;
+    triangulator.setCache(TriangulationCache::get());
     _polygon.set(vertices);
     _polygon.indices.clear();
     triangulator.set(vertices);
@@ -43,10 +43,77 @@
 #include <cugl/core/util/CUStringTools.h>
 #include <sstream>
 #include <algorithm>
+#include <condition_variable>
+#include <mutex>
 
 using namespace cugl;
 using namespace cugl::scene2;
 
+/** The number of subtrees to prepare per thread (for load balancing) */
+#define PREPARE_TASKS   4
+
+#pragma mark Prepare State
+/**
+ * The shared state of a parallel prepare pass.
+ *
+ * This state is shared (via a shared pointer) by the scene and every task
+ * that it submits to the thread pool. A task that is still waiting in the
+ * pool after the pass is complete only touches this state, so it is safe
+ * for that task to outlive the scene.
+ */
+class Scene2::Prepare {
+public:
+    /** The roots of the subtrees to prepare */
+    std::vector<SceneNode*> nodes;
+    /** The next level of the graph during breadth-first expansion */
+    std::vector<SceneNode*> scratch;
+    /** The index of the next subtree to claim */
+    std::atomic<size_t> next;
+    /** The number of subtrees not yet prepared */
+    size_t remaining;
+    /** The tint of the scene (for the root children) */
+    Color4 tint;
+    /** The mutex protecting the remaining count */
+    std::mutex mutex;
+    /** The condition signaled when the remaining count reaches 0 */
+    std::condition_variable done;
+    
+    /**
+     * Creates an empty prepare state
+     */
+    Prepare() : next(0), remaining(0) {}
+    
+    /**
+     * Prepares subtrees until there are none left to claim.
+     *
+     * This method is called by the main thread and every worker thread.
+     */
+    void run() {
+        size_t count = 0;
+        size_t pos;
+        while ((pos = next.fetch_add(1)) < nodes.size()) {
+            SceneNode* node = nodes[pos];
+            if (node->_parent == nullptr) {
+                node->prepareSubtree(Affine2::IDENTITY, tint);
+            } else {
+                node->prepareSubtree(node->_parent->_world, node->_parent->_worldTint);
+            }
+            count++;
+        }
+        
+        if (count > 0) {
+            std::lock_guard<std::mutex> lock(mutex);
+            remaining -= count;
+            if (remaining == 0) {
+                done.notify_all();
+            }
+        }
+    }
+};
+
+#pragma mark -
+#pragma mark Constructors
+
 /**
  * Creates a new degenerate Scene on the stack.
  *
@@ -59,7 +126,12 @@ Scene2::Scene2() : Scene(),
 _color(Color4::WHITE),
 _blendEquation(GL_FUNC_ADD),
 _srcFactor(GL_SRC_ALPHA),
-_dstFactor(GL_ONE_MINUS_SRC_ALPHA)
+_dstFactor(GL_ONE_MINUS_SRC_ALPHA),
+_viewActive(false),
+_indexed(false),
+_unordered(false),
+_threads(nullptr),
+_prepare(nullptr)
 {}
 
 /**
@@ -72,6 +144,10 @@ void Scene2::dispose() {
     Scene::dispose();
     removeAllChildren();
     _color = Color4::WHITE;
+    _indexed = false;
+    _unordered = false;
+    _threads = nullptr;
+    _prepare = nullptr;
 }
 
 
@@ -181,6 +257,17 @@ const std::shared_ptr<scene2::SceneNode>& Scene2::getChild(unsigned int pos) con
  * @return the (first) child with the given tag.
  */
 std::shared_ptr<scene2::SceneNode> Scene2::getChildByTag(unsigned int tag) const  {
+    if (_indexed && tag != 0) {
+        scene2::SceneNode* result = nullptr;
+        auto range = _tagIndex.equal_range(tag);
+        for(auto it = range.first; it != range.second; ++it) {
+            if (result == nullptr || it->second->_childOffset < result->_childOffset) {
+                result = it->second;
+            }
+        }
+        return result == nullptr ? nullptr : _children[result->_childOffset];
+    }
+    
     for(auto it = _children.begin(); it != _children.end(); ++it) {
         if ((*it)->getTag() == tag) {
             return *it;
@@ -201,6 +288,18 @@ std::shared_ptr<scene2::SceneNode> Scene2::getChildByTag(unsigned int tag) const
  * @return the (first) child with the given name.
  */
 std::shared_ptr<scene2::SceneNode> Scene2::getChildByName(const std::string name) const {
+    if (_indexed && !name.empty()) {
+        scene2::SceneNode* result = nullptr;
+        auto range = _nameIndex.equal_range(std::hash<std::string>()(name));
+        for(auto it = range.first; it != range.second; ++it) {
+            if (it->second->_name == name &&
+                (result == nullptr || it->second->_childOffset < result->_childOffset)) {
+                result = it->second;
+            }
+        }
+        return result == nullptr ? nullptr : _children[result->_childOffset];
+    }
+    
     for(auto it = _children.begin(); it != _children.end(); ++it) {
         if ((*it)->getName() == name) {
             return *it;
@@ -227,6 +326,7 @@ void Scene2::addChild(const std::shared_ptr<scene2::SceneNode>& child) {
     _children.push_back(child);
     child->setParent(nullptr);
     child->pushScene(this);
+    indexChild(child.get());
 }
 
 /**
@@ -245,12 +345,15 @@ void Scene2::addChild(const std::shared_ptr<scene2::SceneNode>& child) {
 void Scene2::swapChild(const std::shared_ptr<scene2::SceneNode>& child1,
                        const std::shared_ptr<scene2::SceneNode>& child2,
                        bool inherit) {
+    unindexChild(child1.get());
     _children[child1->_childOffset] = child2;
     child2->_childOffset = child1->_childOffset;
+    child1->_childOffset = -1;
     child2->setParent(nullptr);
     child1->setParent(nullptr);
     child2->pushScene(this);
     child1->pushScene(nullptr);
+    indexChild(child2.get());
 
     // Check if we are dirty and/or inherit children
     if (inherit) {
@@ -266,28 +369,38 @@ void Scene2::swapChild(const std::shared_ptr<scene2::SceneNode>& child1,
  * Removes the child at the given position from this Node.
  *
  * Removing a child alters the position of every child after it.  Hence
- * it is unsafe to cache child positions.
+ * it is unsafe to cache child positions. If this scene is unordered, the
+ * last child is moved into the position instead.
  *
  * @param pos   The position of the child node which will be removed.
  */
 void Scene2::removeChild(unsigned int pos) {
     CUAssertLog(pos < _children.size(), "Position index out of bounds");
     std::shared_ptr<scene2::SceneNode> child = _children[pos];
+    unindexChild(child.get());
     child->setParent(nullptr);
     child->pushScene(nullptr);
     child->_childOffset = -1;
-    for(int ii = pos; ii < _children.size()-1; ii++) {
-        _children[ii] = _children[ii+1];
-        _children[ii]->_childOffset = ii;
+    if (_unordered) {
+        if (pos+1 < _children.size()) {
+            _children[pos] = _children.back();
+            _children[pos]->_childOffset = pos;
+        }
+    } else {
+        for(int ii = pos; ii < _children.size()-1; ii++) {
+            _children[ii] = _children[ii+1];
+            _children[ii]->_childOffset = ii;
+        }
     }
-    _children.resize(_children.size()-1);
+    _children.pop_back();
 }
 
 /**
  * Removes a child from this Node.
  *
  * Removing a child alters the position of every child after it.  Hence
- * it is unsafe to cache child positions.
+ * it is unsafe to cache child positions. If this scene is unordered, the
+ * last child is moved into the position instead.
  *
  * If the child is not in this node, nothing happens.
  *
@@ -343,6 +456,84 @@ void Scene2::removeAllChildren() {
         (*it)->pushScene(nullptr);
     }
     _children.clear();
+    _tagIndex.clear();
+    _nameIndex.clear();
+}
+
+/**
+ * Sets whether this scene indexes its children by tag and name.
+ *
+ * By default, {@link #getChildByTag} and {@link #getChildByName} search
+ * the children in order. An indexed scene keeps a hash table of its
+ * children, so these lookups (and the removal methods that use them)
+ * take constant time. Children with a tag of 0 or an empty name are
+ * not indexed.
+ *
+ * @param value Whether this scene indexes its children by tag and name.
+ */
+void Scene2::setIndexed(bool value) {
+    if (value == _indexed) {
+        return;
+    }
+    
+    _indexed = value;
+    _tagIndex.clear();
+    _nameIndex.clear();
+    if (_indexed) {
+        for(auto it = _children.begin(); it != _children.end(); ++it) {
+            indexChild(it->get());
+        }
+    }
+}
+
+/**
+ * Adds the given child to the tag and name indices of this scene.
+ *
+ * This method does nothing if this scene is not indexed.
+ *
+ * @param child The child to index
+ */
+void Scene2::indexChild(scene2::SceneNode* child) {
+    if (!_indexed) {
+        return;
+    }
+    if (child->_tag != 0) {
+        _tagIndex.emplace(child->_tag, child);
+    }
+    if (!child->_name.empty()) {
+        _nameIndex.emplace(child->_hashOfName, child);
+    }
+}
+
+/**
+ * Removes the given child from the tag and name indices of this scene.
+ *
+ * This method does nothing if this scene is not indexed.
+ *
+ * @param child The child to remove from the index
+ */
+void Scene2::unindexChild(scene2::SceneNode* child) {
+    if (!_indexed) {
+        return;
+    }
+    if (child->_tag != 0) {
+        auto range = _tagIndex.equal_range(child->_tag);
+        for(auto it = range.first; it != range.second; ++it) {
+            if (it->second == child) {
+                _tagIndex.erase(it);
+                break;
+            }
+        }
+    }
+    if (!child->_name.empty()) {
+        auto range = _nameIndex.equal_range(child->_hashOfName);
+        for(auto it = range.first; it != range.second; ++it) {
+            if (it->second == child) {
+                _nameIndex.erase(it);
+                break;
+            }
+        }
+    }
 }
 
 #pragma mark -
@@ -371,9 +562,92 @@ void Scene2::render() {
     _batch->setDstBlendFunc(_dstFactor);
     _batch->setBlendEquation(_blendEquation);
 
+    // The visible region is the clip box in scene coordinates
+    _viewBounds = _camera->getInverseProjectView().transform(Rect(-1,-1,2,2));
+    _viewActive = true;
+    if (_threads != nullptr) {
+        prepare();
+    }
     for(auto it = _children.begin(); it != _children.end(); ++it) {
         (*it)->render(_batch, Affine2::IDENTITY, _color);
     }
+    _viewActive = false;
 
     _batch->end();
 }
+
+/**
+ * Prepares all of the children in this scene in parallel.
+ *
+ * This is the first phase of {@link #render} when this scene has a
+ * thread pool. The scene graph is expanded breadth-first (preparing
+ * each node along the way) until there are enough subtrees to share
+ * among the threads. Those subtrees are then prepared in parallel,
+ * and this method returns once all of them are done.
+ *
+ * This method must be called after the view bounds are computed.
+ */
+void Scene2::prepare() {
+    // A task from a previous pass may still hold the old state
+    if (_prepare == nullptr || _prepare.use_count() > 1) {
+        _prepare = std::make_shared<Prepare>();
+    }
+    std::shared_ptr<Prepare> state = _prepare;
+    state->tint = _color;
+    state->nodes.clear();
+    for(auto it = _children.begin(); it != _children.end(); ++it) {
+        state->nodes.push_back(it->get());
+    }
+    
+    // Expand until there is enough work to share
+    size_t threads = _threads->getThreadCount();
+    size_t goal = (threads+1)*PREPARE_TASKS;
+    bool expanded = true;
+    while (expanded && state->nodes.size() < goal) {
+        expanded = false;
+        state->scratch.clear();
+        for(auto it = state->nodes.begin(); it != state->nodes.end(); ++it) {
+            SceneNode* node = *it;
+            if (node->_children.empty()) {
+                state->scratch.push_back(node);
+                continue;
+            }
+            
+            bool active;
+            if (node->_parent == nullptr) {
+                active = node->prepare(Affine2::IDENTITY, _color);
+            } else {
+                active = node->prepare(node->_parent->_world, node->_parent->_worldTint);
+            }
+            if (!active) {
+                continue;
+            } else if (node->queryChildren()) {
+                for(auto jt = node->_culled.begin(); jt != node->_culled.end(); ++jt) {
+                    state->scratch.push_back(static_cast<SceneNode*>(*jt));
+                }
+            } else {
+                for(auto jt = node->_children.begin(); jt != node->_children.end(); ++jt) {
+                    state->scratch.push_back(jt->get());
+                }
+            }
+            expanded = true;
+        }
+        state->nodes.swap(state->scratch);
+    }
+    
+    if (state->nodes.empty()) {
+        return;
+    }
+    
+    state->next = 0;
+    state->remaining = state->nodes.size();
+    size_t tasks = std::min(threads, state->nodes.size()-1);
+    for(size_t ii = 0; ii < tasks; ii++) {
+        _threads->addTask([state]() { state->run(); });
+    }
+    
+    // Do not wait on tasks that no worker has started
+    state->run();
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->done.wait(lock, [&]() { return state->remaining == 0; });
+}
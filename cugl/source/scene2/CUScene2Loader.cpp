@@ -88,6 +88,7 @@ bool Scene2Loader::init(const std::shared_ptr<ThreadPool>& threads) {
     _types["wire frame"] = Widget::WIRE;
     _types["sprite"] = Widget::ANIMATE;
     _types["order"] = Widget::ORDER;
+    _types["cached"] = Widget::CACHED;
     _types["canvas"] = Widget::CANVAS;
     _types["ninepatch"] = Widget::NINE;
     _types["label"] = Widget::LABEL;
@@ -178,6 +179,9 @@ std::shared_ptr<scene2::SceneNode> Scene2Loader::build(const std::string key,
     case Widget::ORDER:
         node = scene2::OrderedNode::allocWithData(manager,data);
         break;
+    case Widget::CACHED:
+        node = scene2::CachedNode::allocWithData(manager,data);
+        break;
     case Widget::CANVAS:
         node = scene2::CanvasNode::allocWithData(manager,data);
         break;
@@ -381,7 +385,7 @@ bool Scene2Loader::materialize(const std::shared_ptr<scene2::SceneNode>& node, L
     if (callback != nullptr) {
         callback(key,success);
     }
-    _queue.erase(key);
+    dequeue(key);
     return success;
 }
 
@@ -407,7 +411,7 @@ bool Scene2Loader::materialize(const std::shared_ptr<scene2::SceneNode>& node, L
  */
 bool Scene2Loader::read(const std::string key, const std::string source,
                         LoaderCallback callback, bool async) {
-    if (_assets.find(key) != _assets.end() || _queue.find(key) != _queue.end()) {
+    if (_assets.find(key) != _assets.end() || queued(key)) {
         return false;
     }
 
@@ -433,7 +437,7 @@ bool Scene2Loader::read(const std::string key, const std::string source,
             std::shared_ptr<JsonValue> json = (reader == nullptr ? nullptr : reader->readJson());
             std::shared_ptr<scene2::SceneNode> node = build(key,json);
             node->doLayout();
-            Application::get()->schedule([=,this](void) {
+            this->schedule([=,this](void) {
                 this->materialize(node,callback);
                 return false;
             });
@@ -478,7 +482,7 @@ bool Scene2Loader::read(const std::string key, const std::string source,
  */
 bool Scene2Loader::read(const std::shared_ptr<JsonValue>& json, LoaderCallback callback, bool async) {
     std::string key = json->key();
-    if (_assets.find(key) != _assets.end() || _queue.find(key) != _queue.end()) {
+    if (_assets.find(key) != _assets.end() || queued(key)) {
         return false;
     }
     
@@ -493,7 +497,7 @@ bool Scene2Loader::read(const std::shared_ptr<JsonValue>& json, LoaderCallback c
             this->enqueue(key);
             std::shared_ptr<scene2::SceneNode> node = build(key,json);
             node->doLayout();
-            Application::get()->schedule([=,this](void) {
+            this->schedule([=,this](void) {
                 this->materialize(node,callback);
                 return false;
             });
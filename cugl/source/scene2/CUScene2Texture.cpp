@@ -160,9 +160,15 @@ void Scene2Texture::render() {
     _batch->setDstBlendFunc(_dstFactor);
     _batch->setBlendEquation(_blendEquation);
 
+    _viewBounds = matrix.getInverse().transform(Rect(-1,-1,2,2));
+    _viewActive = true;
+    if (_threads != nullptr) {
+        prepare();
+    }
     for(auto it = _children.begin(); it != _children.end(); ++it) {
         (*it)->render(_batch, Affine2::IDENTITY, _color);
     }
+    _viewActive = false;
 
     _batch->end();
     _target->end();
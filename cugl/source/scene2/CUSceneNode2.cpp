@@ -47,6 +47,9 @@ using namespace cugl;
 using namespace cugl::scene2;
 using namespace cugl::graphics;
 
+/** The amount to enlarge the bounds of a child in the spatial index */
+#define CULL_MARGIN 16.0f
+
 #pragma mark Constructors
 /**
  * Creates an uninitialized node.
@@ -67,9 +70,14 @@ _anchor(Vec2::ANCHOR_BOTTOM_LEFT),
 _scale(Vec2::ONE),
 _angle(0),
 _useTransform(false),
+_worldDirty(true),
+_worldMoved(false),
+_proxy(-1),
 _parent(nullptr),
 _graph(nullptr),
 _childOffset(-2),
+_indexed(false),
+_unordered(false),
 _priority(0) {
     _classname = "SceneNode";
 }
@@ -154,6 +162,7 @@ bool SceneNode::initWithBounds(const Rect rect) {
  *      "scale":    A two-element number array
  *      "angle":    A number, representing the rotation in DEGREES, not radians
  *      "visible":  A boolean value
+ *      "culling":  A boolean value, representing if the node culls its children
  *
  * All attributes are optional.  There are no required attributes.
  *
@@ -198,6 +207,7 @@ bool SceneNode::initWithData(const AssetManager* manager,
     }
     
     _isVisible = data->getBool("visible",true);
+    setCulling(data->getBool("culling",false));
 
     bool transform = false;
     if (data->has("size")) {
@@ -247,6 +257,9 @@ void SceneNode::dispose() {
         removeFromParent();
     }
     removeAllChildren();
+    _index = nullptr;
+    _culled.clear();
+    _proxy = -1;
     _position = Vec2::ZERO;
     _anchor   = Vec2::ANCHOR_CENTER;
     _contentSize = Size::ZERO;
@@ -258,9 +271,16 @@ void SceneNode::dispose() {
     _transform = Affine2::IDENTITY;
     _useTransform = false;
     _combined = Affine2::IDENTITY;
+    _world = Affine2::IDENTITY;
+    _worldDirty = true;
+    _worldMoved = false;
     _parent = nullptr;
     _graph = nullptr;
     _childOffset = -2;
+    _indexed = false;
+    _unordered = false;
+    _tagIndex.clear();
+    _nameIndex.clear();
     _tag = 0;
     _name = "";
     _hashOfName = 0;
@@ -291,9 +311,9 @@ std::shared_ptr<SceneNode> SceneNode::copy(const std::shared_ptr<SceneNode>& dst
     dst->_transform = _transform;
     dst->_useTransform = _useTransform;
     dst->_combined = _combined;
-    dst->_tag = _tag;
-    dst->_name = _name;
-    dst->_hashOfName = _hashOfName;
+    dst->_worldDirty = true;
+    dst->setTag(_tag);
+    dst->setName(_name);
     dst->_priority = _priority;
     dst->_json = _json;
     return dst;
@@ -301,6 +321,61 @@ std::shared_ptr<SceneNode> SceneNode::copy(const std::shared_ptr<SceneNode>& dst
 
 #pragma mark -
 #pragma mark Attributes
+/**
+ * Sets a tag that is used to identify the node easily.
+ *
+ * This tag is used to quickly access a child node, since child position
+ * may change. To work properly, a tag should be unique within a scene
+ * graph. It is 0 if undefined.
+ *
+ * @param tag   A tag that is used to identify the node easily.
+ */
+void SceneNode::setTag(unsigned int tag) {
+    if (tag == _tag) {
+        return;
+    }
+    
+    // Keep the index of our container up to date
+    if (_parent != nullptr) {
+        _parent->unindexChild(this);
+        _tag = tag;
+        _parent->indexChild(this);
+    } else if (_graph != nullptr && _childOffset >= 0) {
+        _graph->unindexChild(this);
+        _tag = tag;
+        _graph->indexChild(this);
+    } else {
+        _tag = tag;
+    }
+}
+
+/**
+ * Sets a string that is used to identify the node.
+ *
+ * This name is used to access a child node, since child position may
+ * change. In addition, the name is useful for debugging. To work properly,
+ * a name should be unique within a scene graph. It is empty if undefined.
+ *
+ * @param name  A string that is used to identify the node.
+ */
+void SceneNode::setName(const std::string name) {
+    // Keep the index of our container up to date
+    if (_parent != nullptr) {
+        _parent->unindexChild(this);
+    } else if (_graph != nullptr && _childOffset >= 0) {
+        _graph->unindexChild(this);
+    }
+    
+    _name = name;
+    _hashOfName = std::hash<std::string>()(_name);
+    
+    if (_parent != nullptr) {
+        _parent->indexChild(this);
+    } else if (_graph != nullptr && _childOffset >= 0) {
+        _graph->indexChild(this);
+    }
+}
+
 
 /**
  * Sets the position of the node in its parent's coordinate system.
@@ -317,6 +392,9 @@ void SceneNode::setPosition(float x, float y) {
     _combined.m[4] += (x-_position.x);
     _combined.m[5] += (y-_position.y);
     _position.set(x,y);
+    _worldDirty = true;
+    reindex();
+    markDirty();
 }
 
 /**
@@ -335,7 +413,12 @@ void SceneNode::setPosition(float x, float y) {
 void SceneNode::setContentSize(const Size size) {
     _position += _anchor*(size-_contentSize);
     _contentSize.set(size);
-    if (!_useTransform) updateTransform();
+    if (!_useTransform) {
+        updateTransform();
+    } else {
+        reindex();
+        markDirty();
+    }
     if (_layout) {
         doLayout();
     }
@@ -370,6 +453,89 @@ void SceneNode::setAnchor(const Vec2 anchor) {
     }
 }
 
+/**
+ * Sets whether the node is visible.
+ *
+ * If a node is not visible, then it is not drawn. This means that its
+ * children are not visible as well, regardless of their visibility settings.
+ * The default value is true, making the node visible.
+ *
+ * If the parent of this node is culling its children, an invisible node
+ * is removed from the spatial index of the parent. Hence hiding a node
+ * is a cheap way to remove it from rendering without removing it from
+ * the scene graph.
+ *
+ * @param visible   true if the node is visible.
+ */
+void SceneNode::setVisible(bool visible) {
+    if (_isVisible == visible) {
+        return;
+    }
+    
+    _isVisible = visible;
+    if (_parent != nullptr) {
+        if (_parent->_index != nullptr) {
+            if (visible) {
+                _proxy = _parent->_index->insert(getSubtreeBounds(), this);
+            } else if (_proxy != -1) {
+                _parent->_index->remove(_proxy);
+                _proxy = -1;
+            }
+        }
+        _parent->reindex();
+    }
+    markDirty();
+}
+
+/**
+ * Marks this node as changed since it was last drawn.
+ *
+ * A {@link CachedNode} draws its descendants once to a texture, and only
+ * draws them again when one of them is marked as changed. Changes to the
+ * position, size, transform, color, visibility, or children of a node
+ * mark it automatically. However, changes that are specific to a
+ * subclass (such as a new texture or polygon) may not. In that case you
+ * should call this method directly.
+ *
+ * This method has no effect if the node has no {@link CachedNode}
+ * ancestor.
+ */
+void SceneNode::markDirty() {
+    for(SceneNode* node = _parent; node != nullptr; node = node->_parent) {
+        node->invalidateCache();
+    }
+}
+
+/**
+ * Returns the bounding box of this node and all of its visible descendants.
+ *
+ * This method returns the minimal axis-aligned bounding box that contains
+ * the bounding box of this node, together with the bounding boxes of all
+ * visible descendants, in the parent's coordinate system. It is the
+ * bounding box used when this node is culled by its parent.
+ *
+ * If this node is culling its children, the bounds of the children are
+ * taken from the spatial index, and so may be slightly larger than the
+ * children themselves.
+ *
+ * @return An AABB of this node and its visible descendants in the parent's coordinates.
+ */
+Rect SceneNode::getSubtreeBounds() const {
+    Rect bounds(Vec2::ZERO, _contentSize);
+    if (_index != nullptr) {
+        if (_index->size() > 0) {
+            bounds.merge(_index->getBounds());
+        }
+    } else {
+        for(auto it = _children.begin(); it != _children.end(); ++it) {
+            if ((*it)->_isVisible) {
+                bounds.merge((*it)->getSubtreeBounds());
+            }
+        }
+    }
+    return _combined.transform(bounds);
+}
+
 /**
  * Returns a string representation of this vector for debugging purposes.
  *
@@ -497,6 +663,74 @@ void SceneNode::updateTransform() {
         _combined.m[4] += _position.x-offset.x;
         _combined.m[5] += _position.y-offset.y;
      }
+    _worldDirty = true;
+    reindex();
+    markDirty();
+}
+
+/**
+ * Updates the cached world transform and tint of this node.
+ *
+ * The values are only recomputed if this node has changed, or if the
+ * parent values have changed. When the transform is the cached world
+ * transform of the parent (the normal case in {@link #render}), the
+ * parent change is known without comparing matrices. Otherwise, the
+ * transform and tint are compared to the values used last time.
+ *
+ * @param transform The global transformation matrix of the parent.
+ * @param tint      The tint of the parent.
+ *
+ * @return true if the cached values changed
+ */
+bool SceneNode::updateWorld(const Affine2& transform, Color4 tint) {
+    bool moved = _worldDirty;
+    if (_parent != nullptr && &transform == &(_parent->_world)) {
+        moved = moved || _parent->_worldMoved;
+    } else if (!moved) {
+        moved = (transform != _worldParent || tint != _tintParent);
+    }
+    
+    if (moved) {
+        Affine2::multiply(_combined,transform,&_world);
+        _worldParent = transform;
+        _tintParent  = tint;
+    }
+    
+    // Subclasses (e.g. buttons) may change the tint directly
+    if (moved || _tintColor != _tintLocal) {
+        _worldTint = _tintColor;
+        if (_hasParentColor) {
+            _worldTint *= tint;
+        }
+        _tintLocal = _tintColor;
+        moved = true;
+    }
+    
+    _worldDirty = false;
+    _worldMoved = moved;
+    return moved;
+}
+
+/**
+ * Updates the spatial indices containing this node.
+ *
+ * This method should be called whenever the bounds of this node change.
+ * It climbs the scene graph, updating the proxy of this node (or its
+ * ancestor) in the spatial index of every culling ancestor.
+ */
+void SceneNode::reindex() {
+    SceneNode* node = this;
+    while (node->_parent != nullptr) {
+        SceneNode* parent = node->_parent;
+        if (parent->_index != nullptr) {
+            // If the index is unchanged, so are the bounds of the ancestors
+            if (node->_proxy == -1 ||
+                !parent->_index->update(node->_proxy, node->getSubtreeBounds())) {
+                return;
+            }
+        }
+        node = parent;
+    }
 }
 
 /**
@@ -525,6 +759,83 @@ bool SceneNode::inContentBounds(const Vec2 point) {
 
 #pragma mark -
 #pragma mark Scene Graph
+/**
+ * Sets whether this node indexes its children by tag and name.
+ *
+ * By default, {@link #getChildByTag} and {@link #getChildByName} search
+ * the children in order. An indexed node keeps a hash table of its
+ * children, so these lookups (and the removal methods that use them)
+ * take constant time. This costs some memory for each child, and so it
+ * is only recommended for nodes with many children. Children with a tag
+ * of 0 or an empty name are not indexed.
+ *
+ * @param value Whether this node indexes its children by tag and name.
+ */
+void SceneNode::setIndexed(bool value) {
+    if (value == _indexed) {
+        return;
+    }
+    
+    _indexed = value;
+    _tagIndex.clear();
+    _nameIndex.clear();
+    if (_indexed) {
+        for(auto it = _children.begin(); it != _children.end(); ++it) {
+            indexChild(it->get());
+        }
+    }
+}
+
+/**
+ * Adds the given child to the tag and name indices of this node.
+ *
+ * This method does nothing if this node is not indexed.
+ *
+ * @param child The child to index
+ */
+void SceneNode::indexChild(SceneNode* child) {
+    if (!_indexed) {
+        return;
+    }
+    if (child->_tag != 0) {
+        _tagIndex.emplace(child->_tag, child);
+    }
+    if (!child->_name.empty()) {
+        _nameIndex.emplace(child->_hashOfName, child);
+    }
+}
+
+/**
+ * Removes the given child from the tag and name indices of this node.
+ *
+ * This method does nothing if this node is not indexed.
+ *
+ * @param child The child to remove from the index
+ */
+void SceneNode::unindexChild(SceneNode* child) {
+    if (!_indexed) {
+        return;
+    }
+    if (child->_tag != 0) {
+        auto range = _tagIndex.equal_range(child->_tag);
+        for(auto it = range.first; it != range.second; ++it) {
+            if (it->second == child) {
+                _tagIndex.erase(it);
+                break;
+            }
+        }
+    }
+    if (!child->_name.empty()) {
+        auto range = _nameIndex.equal_range(child->_hashOfName);
+        for(auto it = range.first; it != range.second; ++it) {
+            if (it->second == child) {
+                _nameIndex.erase(it);
+                break;
+            }
+        }
+    }
+}
+
 /**
  * Returns the child at the given position.
  *
@@ -573,6 +884,17 @@ const std::shared_ptr<SceneNode>& SceneNode::getChild(unsigned int pos) const {
  * @return the (first) child with the given tag.
  */
 std::shared_ptr<SceneNode> SceneNode::getChildByTag(unsigned int tag) const {
+    if (_indexed && tag != 0) {
+        SceneNode* result = nullptr;
+        auto range = _tagIndex.equal_range(tag);
+        for(auto it = range.first; it != range.second; ++it) {
+            if (result == nullptr || it->second->_childOffset < result->_childOffset) {
+                result = it->second;
+            }
+        }
+        return result == nullptr ? nullptr : _children[result->_childOffset];
+    }
+    
     for(auto it = _children.begin(); it != _children.end(); ++it) {
         if ((*it)->getTag() == tag) {
             return *it;
@@ -595,6 +917,18 @@ std::shared_ptr<SceneNode> SceneNode::getChildByTag(unsigned int tag) const {
  * @return the (first) child with the given name.
  */
 std::shared_ptr<SceneNode> SceneNode::getChildByName(const std::string name) const {
+    if (_indexed && !name.empty()) {
+        SceneNode* result = nullptr;
+        auto range = _nameIndex.equal_range(std::hash<std::string>()(name));
+        for(auto it = range.first; it != range.second; ++it) {
+            if (it->second->_name == name &&
+                (result == nullptr || it->second->_childOffset < result->_childOffset)) {
+                result = it->second;
+            }
+        }
+        return result == nullptr ? nullptr : _children[result->_childOffset];
+    }
+    
     for(auto it = _children.begin(); it != _children.end(); ++it) {
         if ((*it)->getName() == name) {
             return *it;
@@ -622,7 +956,13 @@ void SceneNode::addChild(const std::shared_ptr<SceneNode>& child) {
     _children.push_back(child);
     child->setParent(this);
     child->pushScene(_graph);
-    
+    indexChild(child.get());
+    if (_index != nullptr && child->_isVisible) {
+        child->_proxy = _index->insert(child->getSubtreeBounds(), child.get());
+    }
+    reindex();
+    invalidateCache();
+    markDirty();
 }
 
 /**
@@ -640,12 +980,24 @@ void SceneNode::addChild(const std::shared_ptr<SceneNode>& child) {
  */
 void SceneNode::swapChild(const std::shared_ptr<SceneNode>& child1,
                           const std::shared_ptr<SceneNode>& child2, bool inherit) {
+    unindexChild(child1.get());
     _children[child1->_childOffset] = child2;
     child2->_childOffset = child1->_childOffset;
+    child1->_childOffset = -1;
     child2->setParent(this);
     child1->setParent(nullptr);
     child2->pushScene(_graph);
     child1->pushScene(nullptr);
+    indexChild(child2.get());
+    if (_index != nullptr) {
+        if (child1->_proxy != -1) {
+            _index->remove(child1->_proxy);
+        }
+        if (child2->_isVisible) {
+            child2->_proxy = _index->insert(child2->getSubtreeBounds(), child2.get());
+        }
+    }
+    child1->_proxy = -1;
     
     // Check if we are dirty and/or inherit children
     if (inherit) {
@@ -655,34 +1007,54 @@ void SceneNode::swapChild(const std::shared_ptr<SceneNode>& child1,
             child2->addChild(*it);
         }
     }
+    reindex();
+    invalidateCache();
+    markDirty();
 }
 
 /**
  * Removes the child at the given position from this Node.
  *
  * Removing a child alters the position of every child after it.  Hence
- * it is unsafe to cache child positions.
+ * it is unsafe to cache child positions. If this node is unordered, the
+ * last child is moved into the position instead.
  *
  * @param pos   The position of the child node which will be removed.
  */
 void SceneNode::removeChild(unsigned int pos) {
     CUAssertLog(pos < _children.size(), "Position index out of bounds");
     std::shared_ptr<SceneNode> child = _children[pos];
+    unindexChild(child.get());
     child->setParent(nullptr);
     child->pushScene(nullptr);
     child->_childOffset = -1;
-    for(int ii = pos; ii < _children.size()-1; ii++) {
-        _children[ii] = _children[ii+1];
-        _children[ii]->_childOffset = ii;
+    if (_index != nullptr && child->_proxy != -1) {
+        _index->remove(child->_proxy);
     }
-    _children.resize(_children.size()-1);
+    child->_proxy = -1;
+    if (_unordered) {
+        if (pos+1 < _children.size()) {
+            _children[pos] = _children.back();
+            _children[pos]->_childOffset = pos;
+        }
+    } else {
+        for(int ii = pos; ii < _children.size()-1; ii++) {
+            _children[ii] = _children[ii+1];
+            _children[ii]->_childOffset = ii;
+        }
+    }
+    _children.pop_back();
+    reindex();
+    invalidateCache();
+    markDirty();
 }
 
 /**
  * Removes a child from this Node.
  *
  * Removing a child alters the position of every child after it.  Hence
- * it is unsafe to cache child positions.
+ * it is unsafe to cache child positions. If this node is unordered, the
+ * last child is moved into the position instead.
  *
  * If the child is not in this node, nothing happens.
  *
@@ -736,9 +1108,18 @@ void SceneNode::removeAllChildren() {
     for(auto it = _children.begin(); it != _children.end(); ++it) {
         (*it)->setParent(nullptr);
         (*it)->_childOffset = -1;
+        (*it)->_proxy = -1;
         (*it)->pushScene(nullptr);
     }
     _children.clear();
+    _tagIndex.clear();
+    _nameIndex.clear();
+    if (_index != nullptr) {
+        _index->clear();
+    }
+    reindex();
+    invalidateCache();
+    markDirty();
 }
 
 /**
@@ -789,28 +1170,33 @@ void SceneNode::doLayout() {
  * @param tint      The tint to blend with the Node color.
  */
 void SceneNode::render(const std::shared_ptr<SpriteBatch>& batch, const Affine2& transform, Color4 tint) {
-    if (!_isVisible) { return; }
-    
-    Affine2 matrix;
-    Affine2::multiply(_combined,transform,&matrix);
-    Color4 color = _tintColor;
-    if (_hasParentColor) {
-        color *= tint;
+    if (!_isVisible) {
+        // Hidden nodes miss parent updates, so recompute when shown
+        _worldDirty = true;
+        return;
     }
     
+    updateWorld(transform, tint);
+    
     std::shared_ptr<Scissor> active = batch->getScissor();
     if (_scissor) {
         std::shared_ptr<Scissor> local = Scissor::alloc(_scissor);
-        local->multiply(matrix);
+        local->multiply(_world);
         if (active) {
             local->intersect(active);
         }
         batch->setScissor(local);
     }
 
-    draw(batch,matrix,color);
-    for(auto it = _children.begin(); it != _children.end(); ++it) {
-        (*it)->render(batch, matrix, color);
+    draw(batch,_world,_worldTint);
+    if (queryChildren()) {
+        for(auto it = _culled.begin(); it != _culled.end(); ++it) {
+            static_cast<SceneNode*>(*it)->render(batch, _world, _worldTint);
+        }
+    } else {
+        for(auto it = _children.begin(); it != _children.end(); ++it) {
+            (*it)->render(batch, _world, _worldTint);
+        }
     }
 
     if (_scissor) {
@@ -818,6 +1204,142 @@ void SceneNode::render(const std::shared_ptr<SpriteBatch>& batch, const Affine2&
     }
 }
 
+/**
+ * Prepares this Node to be drawn, returning true if the children should be prepared.
+ *
+ * This method only worries about the current node. It updates the cached
+ * world transform and tint, exactly as {@link #render} would. Subclasses
+ * should override this method to generate any render data (e.g. vertices)
+ * that would otherwise be generated lazily in {@link #draw}.
+ *
+ * When a {@link Scene2} has a thread pool, it prepares disjoint subtrees
+ * of the scene graph in parallel before drawing them on the main thread.
+ * Therefore this method may be called from a worker thread. It may only
+ * modify this node, and it must not make any OpenGL calls or modify shared
+ * assets (like fonts). A node that cannot meet these requirements should
+ * leave its render data to {@link #draw}.
+ *
+ * This method returns false if the children of this node should not be
+ * prepared, such as when the node is not visible.
+ *
+ * @param transform The global transformation matrix.
+ * @param tint      The tint to blend with the Node color.
+ *
+ * @return true if the children of this node should be prepared.
+ */
+bool SceneNode::prepare(const Affine2& transform, Color4 tint) {
+    if (!_isVisible) {
+        _worldDirty = true;
+        return false;
+    }
+    updateWorld(transform, tint);
+    return true;
+}
+
+/**
+ * Sets whether this node culls its children against the view.
+ *
+ * A culling node keeps a spatial index of the bounds of its visible
+ * children (see {@link #getSubtreeBounds}). When the node is rendered as
+ * part of a {@link Scene2}, it only renders the children whose bounds
+ * intersect the visible region of the scene camera. Children are still
+ * rendered in order. This is intended for large worlds where most of
+ * the children are off-screen at any given time.
+ *
+ * Culling is only as precise as the child bounds. A node that draws
+ * outside of its content bounds (or the bounds of its descendants) may
+ * be culled while part of it is still on screen. In addition, culling
+ * assumes that the scene camera is orthographic.
+ *
+ * @param value Whether this node culls its children against the view.
+ */
+void SceneNode::setCulling(bool value) {
+    if (value == (_index != nullptr)) {
+        return;
+    }
+    
+    if (value) {
+        _index = std::make_shared<AABBTree>(CULL_MARGIN);
+        for(auto it = _children.begin(); it != _children.end(); ++it) {
+            if ((*it)->_isVisible) {
+                (*it)->_proxy = _index->insert((*it)->getSubtreeBounds(), it->get());
+            }
+        }
+    } else {
+        _index = nullptr;
+        _culled.clear();
+        for(auto it = _children.begin(); it != _children.end(); ++it) {
+            (*it)->_proxy = -1;
+        }
+    }
+    reindex();
+}
+
+/**
+ * Computes the children of this node that intersect the view.
+ *
+ * The children are stored in {@link #_culled}, in the order that they
+ * appear in this node. This method returns false if culling is not
+ * possible (because this node is not culling, or because it is not
+ * being rendered by a {@link Scene2}). In that case all children should
+ * be rendered.
+ *
+ * This method must be called after {@link #updateWorld}.
+ *
+ * @return true if the children were culled against the view.
+ */
+bool SceneNode::queryChildren() {
+    if (_index == nullptr || _graph == nullptr || !_graph->_viewActive) {
+        return false;
+    }
+    
+    // Culled children miss parent updates, so they must recompute
+    if (_worldMoved) {
+        for(auto it = _children.begin(); it != _children.end(); ++it) {
+            (*it)->_worldDirty = true;
+        }
+    }
+    
+    _culled.clear();
+    if (!_world.isInvertible()) {
+        return true;
+    }
+    
+    Rect bounds = _world.getInverse().transform(_graph->_viewBounds);
+    _index->query(bounds, _culled);
+    std::sort(_culled.begin(), _culled.end(), [](void* a, void* b) {
+        return static_cast<SceneNode*>(a)->_childOffset < static_cast<SceneNode*>(b)->_childOffset;
+    });
+    return true;
+}
+
+/**
+ * Prepares this node and all of its descendants to be drawn.
+ *
+ * This method calls {@link #prepare} on this node, and then recursively
+ * on each child (or each child in view if this node is culling). It
+ * does not use a sprite batch, and so distinct subtrees may be prepared
+ * on different threads at the same time.
+ *
+ * @param transform The global transformation matrix.
+ * @param tint      The tint to blend with the node color.
+ */
+void SceneNode::prepareSubtree(const Affine2& transform, Color4 tint) {
+    if (!prepare(transform, tint)) {
+        return;
+    }
+    
+    if (queryChildren()) {
+        for(auto it = _culled.begin(); it != _culled.end(); ++it) {
+            static_cast<SceneNode*>(*it)->prepareSubtree(_world, _worldTint);
+        }
+    } else {
+        for(auto it = _children.begin(); it != _children.end(); ++it) {
+            (*it)->prepareSubtree(_world, _worldTint);
+        }
+    }
+}
+
 /**
  * Returns the absolute color tinting this node.
  *
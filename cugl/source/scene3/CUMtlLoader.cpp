@@ -411,7 +411,7 @@ bool MtlLoader::materialize(const std::string key,
                             const std::shared_ptr<MaterialLib>& lib,
                             LoaderCallback callback) {
     if (lib == nullptr && !lib->matinfos.empty()) {
-        _queue.erase(key);
+        dequeue(key);
         if (callback != nullptr) {
             callback(key,false);
         }
@@ -460,7 +460,7 @@ bool MtlLoader::materialize(const std::string key,
         _assets[key] = lib->materials.begin()->second;
     }
     lib->complete = true;
-    _queue.erase(key);
+    dequeue(key);
     return true;
 }
 
@@ -492,7 +492,7 @@ bool MtlLoader::materialize(const std::string key,
  */
 bool MtlLoader::read(const std::string key, const std::string source,
                      LoaderCallback callback, bool async) {
-    if (_assets.find(key) != _assets.end() || _queue.find(key) != _queue.end()) {
+    if (_assets.find(key) != _assets.end() || queued(key)) {
         return false;
     }
 
@@ -505,7 +505,7 @@ bool MtlLoader::read(const std::string key, const std::string source,
         _loader->addTask([=,this](void) {
             this->enqueue(key);
             std::shared_ptr<MaterialLib> lib = this->preload(key,source);
-            Application::get()->schedule([=,this](void){
+            this->schedule([=,this](void){
                 this->materialize(key,lib,callback);
                 return false;
             });
@@ -581,7 +581,7 @@ bool MtlLoader::read(const std::string key, const std::string source,
 bool MtlLoader::read(const std::shared_ptr<JsonValue>& json,
                      LoaderCallback callback, bool async) {
     std::string key = json->key();
-    if (_assets.find(key) != _assets.end() || _queue.find(key) != _queue.end()) {
+    if (_assets.find(key) != _assets.end() || queued(key)) {
         return false;
     }
 
@@ -594,7 +594,7 @@ bool MtlLoader::read(const std::shared_ptr<JsonValue>& json,
         _loader->addTask([=,this](void) {
             this->enqueue(key);
             std::shared_ptr<MaterialLib> lib = this->preload(json);
-            Application::get()->schedule([=,this](void){
+            this->schedule([=,this](void){
                 this->materialize(key,lib,callback);
                 return false;
             });
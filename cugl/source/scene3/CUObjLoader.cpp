@@ -275,7 +275,7 @@ bool ObjLoader::materialize(const std::string key,
                             const std::shared_ptr<ObjModel>& model,
                             LoaderCallback callback) {
     if (model == nullptr) {
-        _queue.erase(key);
+        dequeue(key);
         if (callback != nullptr) {
             callback(key,false);
         }
@@ -323,7 +323,7 @@ bool ObjLoader::materialize(const std::string key,
     }
     
     _assets[key] = model;
-    _queue.erase(key);
+    dequeue(key);
     return success;
 }
 
@@ -350,7 +350,7 @@ bool ObjLoader::materialize(const std::string key,
  */
 bool ObjLoader::read(const std::string key, const std::string source,
                      LoaderCallback callback, bool async) {
-    if (_assets.find(key) != _assets.end() || _queue.find(key) != _queue.end()) {
+    if (_assets.find(key) != _assets.end() || queued(key)) {
         return false;
     }
 
@@ -363,7 +363,7 @@ bool ObjLoader::read(const std::string key, const std::string source,
         _loader->addTask([=,this](void) {
             this->enqueue(key);
             std::shared_ptr<ObjModel> model = this->preload(key,source);
-            Application::get()->schedule([=,this](void){
+            this->schedule([=,this](void){
                 this->materialize(key,model,callback);
                 return false;
             });
@@ -421,7 +421,7 @@ bool ObjLoader::read(const std::string key, const std::string source,
 bool ObjLoader::read(const std::shared_ptr<JsonValue>& json,
                      LoaderCallback callback, bool async) {
     std::string key = json->key();
-    if (_assets.find(key) != _assets.end() || _queue.find(key) != _queue.end()) {
+    if (_assets.find(key) != _assets.end() || queued(key)) {
         return false;
     }
 
@@ -435,7 +435,7 @@ bool ObjLoader::read(const std::shared_ptr<JsonValue>& json,
         _loader->addTask([=,this](void) {
             this->enqueue(key);
             std::shared_ptr<ObjModel> model = this->preload(json);
-            Application::get()->schedule([=,this](void){
+            this->schedule([=,this](void){
                 this->materialize(key,model,callback);
                 return false;
             });
@@ -201,8 +201,11 @@ std::shared_ptr<ModelInfo> ObjParser::parseObj(const std::string key,
     model->name = key;
     model->path = source;
      
+    // The numeric parsers need a null terminator, so copy each line
+    string line;
     while (reader->ready()) {
-        string line = reader->readLine();
+        line.clear();
+        reader->readLine(line);
         const char* begin = line.c_str();
         const char* end = begin+line.size();
          
@@ -321,8 +324,11 @@ std::shared_ptr<MaterialLib> ObjParser::parseMtl(const std::string key, const st
     
     std::string root = cugl::filetool::split_path(source).first;
      
+    // The numeric parsers need a null terminator, so copy each line
+    string line;
     while (reader->ready()) {
-        string line = reader->readLine();
+        line.clear();
+        reader->readLine(line);
         const char* begin = line.c_str();
         const char* end = begin+line.size();
          
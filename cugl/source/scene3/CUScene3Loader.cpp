@@ -186,7 +186,7 @@ bool Scene3Loader::materialize(const std::shared_ptr<scene3::SceneNode>& node, L
     if (callback != nullptr) {
         callback(key,success);
     }
-    _queue.erase(key);
+    dequeue(key);
     return true;
 }
 
@@ -212,7 +212,7 @@ bool Scene3Loader::materialize(const std::shared_ptr<scene3::SceneNode>& node, L
  */
 bool Scene3Loader::read(const std::string key, const std::string source,
                         LoaderCallback callback, bool async) {
-    if (_assets.find(key) != _assets.end() || _queue.find(key) != _queue.end()) {
+    if (_assets.find(key) != _assets.end() || queued(key)) {
         return false;
     }
     
@@ -236,7 +236,7 @@ bool Scene3Loader::read(const std::string key, const std::string source,
             std::shared_ptr<JsonReader> reader = JsonReader::allocWithAsset(path);
             std::shared_ptr<JsonValue> json = (reader == nullptr ? nullptr : reader->readJson());
             std::shared_ptr<scene3::SceneNode> node = build(key,json);
-            Application::get()->schedule([=,this](void) {
+            this->schedule([=,this](void) {
                 this->materialize(node,callback);
                 return false;
             });
@@ -274,7 +274,7 @@ bool Scene3Loader::read(const std::string key, const std::string source,
  */
 bool Scene3Loader::read(const std::shared_ptr<JsonValue>& json, LoaderCallback callback, bool async) {
     std::string key = json->key();
-    if (_assets.find(key) != _assets.end() || _queue.find(key) != _queue.end()) {
+    if (_assets.find(key) != _assets.end() || queued(key)) {
         return false;
     }
     
@@ -287,7 +287,7 @@ bool Scene3Loader::read(const std::shared_ptr<JsonValue>& json, LoaderCallback c
         _loader->addTask([=,this](void) {
             this->enqueue(key);
             std::shared_ptr<scene3::SceneNode> node = build(key,json);
-            Application::get()->schedule([=,this](void) {
+            this->schedule([=,this](void) {
                 this->materialize(node,callback);
                 return false;
             });
@@ -3,6 +3,8 @@
 #include <cstdlib>
 #include <ctime>
 #include <atomic>
+#include <thread>
+#include <algorithm>
 #include "displayobject.hpp"
 #include "FarmLogic.h"
 
@@ -34,14 +36,28 @@ void FarmvilleApp::onStartup()
     _batch = SpriteBatch::alloc();
     setClearColor(Color4(97, 227, 57, 255));
     _scene->setSpriteBatch(_batch);
-
-    _root = OrderedNode::allocWithOrder(OrderedNode::Order::ASCEND);
+    // Compute transforms and vertices on the other cores before drawing
+    int cores = (int)std::thread::hardware_concurrency();
+    _scene->setThreadPool(ThreadPool::alloc(std::max(1, cores-1)));
+
+    // Regroup the sorted sprites by texture so each layer draws in few calls
+    // and skip any sprites that are outside of the camera view
+    std::shared_ptr<OrderedNode> ordered = OrderedNode::allocWithOrder(OrderedNode::Order::ASCEND);
+    ordered->setBatching(true);
+    ordered->setCulling(true);
+    // Entities come and go by tag, and their draw order is the priority
+    ordered->setIndexed(true);
+    ordered->setUnordered(true);
+    _root = ordered;
     _scene->addChild(_root);
-    // Create an asset manager to load all assets
-    _assets = AssetManager::alloc();
+    // Create an asset manager to load all assets (decoding on every core)
+    _assets = AssetManager::alloc(std::max(1u, std::thread::hardware_concurrency()));
 
     // You have to attach the individual loaders for each asset type
-    _assets->attach<Texture>(TextureLoader::alloc()->getHook());
+    // Decoded textures are cached on disk so later launches skip the decoder
+    std::shared_ptr<TextureLoader> textures = TextureLoader::alloc();
+    textures->setCache(TextureCache::alloc(Application::get()->getSaveDirectory()+"texcache"));
+    _assets->attach<Texture>(textures->getHook());
     _assets->attach<Font>(FontLoader::alloc()->getHook());
 
     // This reads the given JSON file and uses it to load all other assets